@@ -365,8 +365,8 @@ ErrorMessageOr<void> CaptureClient::FinishCapture() {
 void CaptureClient::ProcessEvents(
     CaptureEventProcessor* capture_event_processor,
     const google::protobuf::RepeatedPtrField<ClientCaptureEvent>& events) {
+  capture_event_processor->ProcessEvents(events);
   for (const auto& event : events) {
-    capture_event_processor->ProcessEvent(event);
     if (event.event_case() == ClientCaptureEvent::kCaptureStarted) {
       absl::MutexLock lock{&state_mutex_};
       state_ = State::kStarted;
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "CaptureClient/ApiEventProcessor.h"
 #include "CaptureClient/GpuQueueSubmissionProcessor.h"
@@ -60,8 +61,24 @@ class CaptureEventProcessorForListener : public CaptureEventProcessor {
   ~CaptureEventProcessorForListener() override = default;
 
   void ProcessEvent(const orbit_grpc_protos::ClientCaptureEvent& event) override;
+  void ProcessEvents(
+      const google::protobuf::RepeatedPtrField<orbit_grpc_protos::ClientCaptureEvent>& events)
+      override;
 
  private:
+  // These convert the most frequent events to what is passed to the CaptureListener, and take care
+  // of everything else the processing of the event requires. They are shared by ProcessEvent, which
+  // passes the result to the listener right away, and ProcessEvents, which batches the results.
+  [[nodiscard]] orbit_client_protos::TimerInfo CreateTimerInfo(
+      const orbit_grpc_protos::SchedulingSlice& scheduling_slice);
+  [[nodiscard]] orbit_client_protos::TimerInfo CreateTimerInfo(
+      const orbit_grpc_protos::FunctionCall& function_call);
+  [[nodiscard]] orbit_client_data::CallstackEvent CreateCallstackEvent(
+      const orbit_grpc_protos::CallstackSample& callstack_sample);
+  [[nodiscard]] orbit_client_data::ThreadStateSliceInfo CreateThreadStateSliceInfo(
+      const orbit_grpc_protos::ThreadStateSlice& thread_state_slice);
+  void FlushBatches();
+
   void ProcessCaptureStarted(const orbit_grpc_protos::CaptureStarted& capture_started);
   void ProcessCaptureFinished(const orbit_grpc_protos::CaptureFinished& capture_finished);
   void ProcessSchedulingSlice(const orbit_grpc_protos::SchedulingSlice& scheduling_slice);
@@ -130,6 +147,11 @@ class CaptureEventProcessorForListener : public CaptureEventProcessor {
 
   GpuQueueSubmissionProcessor gpu_queue_submission_processor_;
   ApiEventProcessor api_event_processor_;
+
+  // Used by ProcessEvents. Only cleared between batches, so that they keep their capacity.
+  std::vector<orbit_client_protos::TimerInfo> timers_batch_;
+  std::vector<orbit_client_data::CallstackEvent> callstack_events_batch_;
+  std::vector<orbit_client_data::ThreadStateSliceInfo> thread_state_slices_batch_;
 };
 
 void CaptureEventProcessorForListener::ProcessEvent(const ClientCaptureEvent& event) {
@@ -262,6 +284,72 @@ void CaptureEventProcessorForListener::ProcessEvent(const ClientCaptureEvent& ev
   }
 }
 
+void CaptureEventProcessorForListener::ProcessEvents(
+    const google::protobuf::RepeatedPtrField<ClientCaptureEvent>& events) {
+  size_t timer_count = 0;
+  size_t callstack_event_count = 0;
+  size_t thread_state_slice_count = 0;
+  for (const ClientCaptureEvent& event : events) {
+    switch (event.event_case()) {
+      case ClientCaptureEvent::kSchedulingSlice:
+      case ClientCaptureEvent::kFunctionCall:
+        ++timer_count;
+        break;
+      case ClientCaptureEvent::kCallstackSample:
+        ++callstack_event_count;
+        break;
+      case ClientCaptureEvent::kThreadStateSlice:
+        ++thread_state_slice_count;
+        break;
+      default:
+        break;
+    }
+  }
+  timers_batch_.reserve(timer_count);
+  callstack_events_batch_.reserve(callstack_event_count);
+  thread_state_slices_batch_.reserve(thread_state_slice_count);
+
+  for (const ClientCaptureEvent& event : events) {
+    switch (event.event_case()) {
+      case ClientCaptureEvent::kSchedulingSlice:
+        timers_batch_.push_back(CreateTimerInfo(event.scheduling_slice()));
+        break;
+      case ClientCaptureEvent::kFunctionCall:
+        timers_batch_.push_back(CreateTimerInfo(event.function_call()));
+        break;
+      case ClientCaptureEvent::kCallstackSample:
+        callstack_events_batch_.push_back(CreateCallstackEvent(event.callstack_sample()));
+        break;
+      case ClientCaptureEvent::kThreadStateSlice:
+        thread_state_slices_batch_.push_back(
+            CreateThreadStateSliceInfo(event.thread_state_slice()));
+        break;
+      default:
+        // Keep the order in which the listener sees the batched events relative to all other
+        // events, as some of those also produce timers.
+        FlushBatches();
+        ProcessEvent(event);
+        break;
+    }
+  }
+  FlushBatches();
+}
+
+void CaptureEventProcessorForListener::FlushBatches() {
+  if (!timers_batch_.empty()) {
+    capture_listener_->OnTimers(timers_batch_);
+    timers_batch_.clear();
+  }
+  if (!callstack_events_batch_.empty()) {
+    capture_listener_->OnCallstackEvents(callstack_events_batch_);
+    callstack_events_batch_.clear();
+  }
+  if (!thread_state_slices_batch_.empty()) {
+    capture_listener_->OnThreadStateSlices(thread_state_slices_batch_);
+    thread_state_slices_batch_.clear();
+  }
+}
+
 void CaptureEventProcessorForListener::ProcessCaptureStarted(
     const orbit_grpc_protos::CaptureStarted& capture_started) {
   capture_listener_->OnCaptureStarted(capture_started, file_path_, frame_track_function_ids_);
@@ -274,6 +362,11 @@ void CaptureEventProcessorForListener::ProcessCaptureFinished(
 
 void CaptureEventProcessorForListener::ProcessSchedulingSlice(
     const SchedulingSlice& scheduling_slice) {
+  capture_listener_->OnTimer(CreateTimerInfo(scheduling_slice));
+}
+
+TimerInfo CaptureEventProcessorForListener::CreateTimerInfo(
+    const SchedulingSlice& scheduling_slice) {
   TimerInfo timer_info;
   uint64_t in_timestamp_ns = scheduling_slice.out_timestamp_ns() - scheduling_slice.duration_ns();
   timer_info.set_start(in_timestamp_ns);
@@ -286,7 +379,7 @@ void CaptureEventProcessorForListener::ProcessSchedulingSlice(
 
   gpu_queue_submission_processor_.UpdateBeginCaptureTime(in_timestamp_ns);
 
-  capture_listener_->OnTimer(timer_info);
+  return timer_info;
 }
 
 void CaptureEventProcessorForListener::ProcessInternedCallstack(
@@ -300,8 +393,13 @@ void CaptureEventProcessorForListener::ProcessInternedCallstack(
 
 void CaptureEventProcessorForListener::ProcessCallstackSample(
     const CallstackSample& callstack_sample) {
+  capture_listener_->OnCallstackEvent(CreateCallstackEvent(callstack_sample));
+}
+
+CallstackEvent CaptureEventProcessorForListener::CreateCallstackEvent(
+    const CallstackSample& callstack_sample) {
   uint64_t callstack_id = callstack_sample.callstack_id();
-  Callstack callstack = callstack_intern_pool_[callstack_id];
+  const Callstack& callstack = callstack_intern_pool_[callstack_id];
 
   SendCallstackToListenerIfNecessary(callstack_id, callstack);
 
@@ -311,10 +409,14 @@ void CaptureEventProcessorForListener::ProcessCallstackSample(
 
   gpu_queue_submission_processor_.UpdateBeginCaptureTime(callstack_sample.timestamp_ns());
 
-  capture_listener_->OnCallstackEvent(callstack_event);
+  return callstack_event;
 }
 
 void CaptureEventProcessorForListener::ProcessFunctionCall(const FunctionCall& function_call) {
+  capture_listener_->OnTimer(CreateTimerInfo(function_call));
+}
+
+TimerInfo CaptureEventProcessorForListener::CreateTimerInfo(const FunctionCall& function_call) {
   TimerInfo timer_info;
   timer_info.set_process_id(function_call.pid());
   timer_info.set_thread_id(function_call.tid());
@@ -333,7 +435,7 @@ void CaptureEventProcessorForListener::ProcessFunctionCall(const FunctionCall& f
 
   gpu_queue_submission_processor_.UpdateBeginCaptureTime(begin_timestamp_ns);
 
-  capture_listener_->OnTimer(timer_info);
+  return timer_info;
 }
 
 void CaptureEventProcessorForListener::ProcessInternedString(InternedString interned_string) {
@@ -581,6 +683,11 @@ void CaptureEventProcessorForListener::ProcessThreadNamesSnapshot(
 
 void CaptureEventProcessorForListener::ProcessThreadStateSlice(
     const ThreadStateSlice& thread_state_slice) {
+  capture_listener_->OnThreadStateSlice(CreateThreadStateSliceInfo(thread_state_slice));
+}
+
+ThreadStateSliceInfo CaptureEventProcessorForListener::CreateThreadStateSliceInfo(
+    const ThreadStateSlice& thread_state_slice) {
   ORBIT_CHECK(thread_state_slice.switch_out_or_wakeup_callstack_status() !=
               ThreadStateSlice::kWaitingForCallstack);
   std::optional<uint64_t> switch_out_or_wakeup_callstack_id =
@@ -611,7 +718,7 @@ void CaptureEventProcessorForListener::ProcessThreadStateSlice(
 
   gpu_queue_submission_processor_.UpdateBeginCaptureTime(slice_info.begin_timestamp_ns());
 
-  capture_listener_->OnThreadStateSlice(std::move(slice_info));
+  return slice_info;
 }
 
 void CaptureEventProcessorForListener::ProcessAddressInfo(const AddressInfo& address_info) {
@@ -72,6 +72,7 @@ using orbit_grpc_protos::WarningInstrumentingWithUserSpaceInstrumentationEvent;
 
 using ::testing::_;
 using ::testing::DoAll;
+using ::testing::InSequence;
 using ::testing::Return;
 using ::testing::SaveArg;
 
@@ -1535,4 +1536,79 @@ TEST(CaptureEventProcessor, CanHandleMultipleEvents) {
   EXPECT_EQ(actual_address_info->module_path(), kModuleName);
 }
 
+TEST(CaptureEventProcessor, ProcessEventsBatchesFrequentEventsInOrder) {
+  MockCaptureListener listener;
+  auto event_processor =
+      CaptureEventProcessor::CreateForCaptureListener(&listener, std::filesystem::path{}, {});
+
+  google::protobuf::RepeatedPtrField<ClientCaptureEvent> events;
+  AddAndInitializeInternedCallstack(*events.Add());
+
+  SchedulingSlice* scheduling_slice = events.Add()->mutable_scheduling_slice();
+  scheduling_slice->set_tid(24);
+  scheduling_slice->set_duration_ns(97);
+  scheduling_slice->set_out_timestamp_ns(100);
+
+  CallstackSample* callstack_sample = AddAndInitializeCallstackSample(*events.Add());
+  callstack_sample->set_timestamp_ns(110);
+
+  FunctionCall* function_call = events.Add()->mutable_function_call();
+  function_call->set_tid(24);
+  function_call->set_function_id(42);
+  function_call->set_duration_ns(10);
+  function_call->set_end_timestamp_ns(120);
+
+  PresentEvent* present_event = events.Add()->mutable_present_event();
+  present_event->set_begin_timestamp_ns(130);
+
+  ThreadStateSlice* thread_state_slice = events.Add()->mutable_thread_state_slice();
+  thread_state_slice->set_tid(24);
+  thread_state_slice->set_thread_state(ThreadStateSlice::kRunnable);
+  thread_state_slice->set_duration_ns(10);
+  thread_state_slice->set_end_timestamp_ns(150);
+  thread_state_slice->set_switch_out_or_wakeup_callstack_status(ThreadStateSlice::kNoCallstack);
+
+  std::vector<TimerInfo> actual_timers;
+  std::vector<CallstackEvent> actual_callstack_events;
+  std::vector<ThreadStateSliceInfo> actual_thread_state_slices;
+  {
+    InSequence sequence;
+    EXPECT_CALL(listener, OnUniqueCallstack).Times(1);
+    // All the events before the PresentEvent are passed in one batch per kind...
+    EXPECT_CALL(listener, OnTimers).WillOnce([&](absl::Span<const TimerInfo> timers) {
+      actual_timers.assign(timers.begin(), timers.end());
+    });
+    EXPECT_CALL(listener, OnCallstackEvents)
+        .WillOnce([&](absl::Span<const CallstackEvent> callstack_events) {
+          actual_callstack_events.assign(callstack_events.begin(), callstack_events.end());
+        });
+    EXPECT_CALL(listener, OnPresentEvent).Times(1);
+    // ...and the ones after it in new batches.
+    EXPECT_CALL(listener, OnThreadStateSlices)
+        .WillOnce([&](absl::Span<const ThreadStateSliceInfo> thread_state_slices) {
+          actual_thread_state_slices.assign(thread_state_slices.begin(),
+                                            thread_state_slices.end());
+        });
+  }
+  EXPECT_CALL(listener, OnTimer).Times(0);
+  EXPECT_CALL(listener, OnCallstackEvent).Times(0);
+  EXPECT_CALL(listener, OnThreadStateSlice).Times(0);
+
+  event_processor->ProcessEvents(events);
+
+  ASSERT_EQ(actual_timers.size(), 2);
+  EXPECT_EQ(actual_timers[0].type(), TimerInfo::kCoreActivity);
+  EXPECT_EQ(actual_timers[0].start(), 3);
+  EXPECT_EQ(actual_timers[1].function_id(), function_call->function_id());
+  EXPECT_EQ(actual_timers[1].start(), 110);
+
+  ASSERT_EQ(actual_callstack_events.size(), 1);
+  EXPECT_EQ(actual_callstack_events[0].timestamp_ns(), callstack_sample->timestamp_ns());
+  EXPECT_EQ(actual_callstack_events[0].callstack_id(), callstack_sample->callstack_id());
+
+  ASSERT_EQ(actual_thread_state_slices.size(), 1);
+  EXPECT_EQ(actual_thread_state_slices[0].begin_timestamp_ns(), 140);
+  EXPECT_EQ(actual_thread_state_slices[0].end_timestamp_ns(), 150);
+}
+
 }  // namespace orbit_capture_client
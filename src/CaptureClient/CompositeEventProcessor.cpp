@@ -20,6 +20,14 @@ class CompositeEventProcessor : public CaptureEventProcessor {
     }
   }
 
+  void ProcessEvents(
+      const google::protobuf::RepeatedPtrField<orbit_grpc_protos::ClientCaptureEvent>& events)
+      override {
+    for (auto& event_processor : event_processors_) {
+      event_processor->ProcessEvents(events);
+    }
+  }
+
  private:
   std::vector<std::unique_ptr<CaptureEventProcessor>> event_processors_;
 };
@@ -50,6 +50,11 @@ class MockCaptureListener : public CaptureListener {
   MOCK_METHOD(void, OnLostPerfRecordsEvent, (orbit_grpc_protos::LostPerfRecordsEvent), (override));
   MOCK_METHOD(void, OnOutOfOrderEventsDiscardedEvent,
               (orbit_grpc_protos::OutOfOrderEventsDiscardedEvent), (override));
+  MOCK_METHOD(void, OnTimers, (absl::Span<const orbit_client_protos::TimerInfo>), (override));
+  MOCK_METHOD(void, OnCallstackEvents, (absl::Span<const orbit_client_data::CallstackEvent>),
+              (override));
+  MOCK_METHOD(void, OnThreadStateSlices,
+              (absl::Span<const orbit_client_data::ThreadStateSliceInfo>), (override));
 };
 
 }  // namespace orbit_capture_client
@@ -46,6 +46,11 @@ class AbstractCaptureListener : public CaptureListener {
     GetMutableCaptureDataFromDerived().AddCallstackEvent(callstack_event);
   }
 
+  void OnCallstackEvents(
+      absl::Span<const orbit_client_data::CallstackEvent> callstack_events) override {
+    GetMutableCaptureDataFromDerived().AddCallstackEvents(callstack_events);
+  }
+
   void OnThreadName(uint32_t thread_id, std::string thread_name) override {
     GetMutableCaptureDataFromDerived().AddOrAssignThreadName(thread_id, std::move(thread_name));
   }
@@ -54,6 +59,11 @@ class AbstractCaptureListener : public CaptureListener {
     GetMutableCaptureDataFromDerived().AddThreadStateSlice(thread_state_slice);
   }
 
+  void OnThreadStateSlices(
+      absl::Span<const orbit_client_data::ThreadStateSliceInfo> thread_state_slices) override {
+    GetMutableCaptureDataFromDerived().AddThreadStateSlices(thread_state_slices);
+  }
+
   void OnTracepointEvent(orbit_client_data::TracepointEventInfo tracepoint_event_info) override {
     uint32_t capture_process_id = GetMutableCaptureDataFromDerived().process_id();
     bool is_same_pid_as_target = capture_process_id == tracepoint_event_info.pid();
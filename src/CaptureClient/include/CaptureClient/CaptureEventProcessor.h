@@ -23,6 +23,15 @@ class CaptureEventProcessor {
 
   virtual void ProcessEvent(const orbit_grpc_protos::ClientCaptureEvent& event) = 0;
 
+  // Processes a whole batch of events, usually all the events of one CaptureResponse, in order.
+  // Implementations can override this to amortize per-event costs over the batch.
+  virtual void ProcessEvents(
+      const google::protobuf::RepeatedPtrField<orbit_grpc_protos::ClientCaptureEvent>& events) {
+    for (const orbit_grpc_protos::ClientCaptureEvent& event : events) {
+      ProcessEvent(event);
+    }
+  }
+
   static std::unique_ptr<CaptureEventProcessor> CreateForCaptureListener(
       CaptureListener* capture_listener, std::optional<std::filesystem::path> file_path,
       absl::flat_hash_set<uint64_t> frame_track_function_ids);
@@ -6,6 +6,7 @@
 #define CAPTURE_CLIENT_CAPTURE_LISTENER_H_
 
 #include <absl/container/flat_hash_set.h>
+#include <absl/types/span.h>
 
 #include "ClientData/ApiStringEvent.h"
 #include "ClientData/ApiTrackValue.h"
@@ -78,6 +79,27 @@ class CaptureListener {
       orbit_grpc_protos::LostPerfRecordsEvent lost_perf_records_event) = 0;
   virtual void OnOutOfOrderEventsDiscardedEvent(
       orbit_grpc_protos::OutOfOrderEventsDiscardedEvent out_of_order_events_discarded_event) = 0;
+
+  // Batched variants of the callbacks for the most frequent events, used when a whole batch of
+  // events is processed at once. Events are passed in the order they were received. The default
+  // implementations simply forward each element to the corresponding single-event callback.
+  virtual void OnTimers(absl::Span<const orbit_client_protos::TimerInfo> timers) {
+    for (const orbit_client_protos::TimerInfo& timer_info : timers) {
+      OnTimer(timer_info);
+    }
+  }
+  virtual void OnCallstackEvents(
+      absl::Span<const orbit_client_data::CallstackEvent> callstack_events) {
+    for (const orbit_client_data::CallstackEvent& callstack_event : callstack_events) {
+      OnCallstackEvent(callstack_event);
+    }
+  }
+  virtual void OnThreadStateSlices(
+      absl::Span<const orbit_client_data::ThreadStateSliceInfo> thread_state_slices) {
+    for (const orbit_client_data::ThreadStateSliceInfo& thread_state_slice : thread_state_slices) {
+      OnThreadStateSlice(thread_state_slice);
+    }
+  }
 };
 
 }  // namespace orbit_capture_client
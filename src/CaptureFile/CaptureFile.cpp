@@ -14,6 +14,10 @@
 #include "OrbitBase/SafeStrerror.h"
 #include "ProtoSectionInputStreamImpl.h"
 
+#ifndef _WIN32
+#include "MemoryMappedProtoSectionInputStream.h"
+#endif
+
 namespace orbit_capture_file {
 
 namespace {
@@ -69,6 +73,8 @@ class CaptureFileImpl : public CaptureFile {
   ErrorMessageOr<void> WriteSectionList(const std::vector<CaptureFileSection>& section_list,
                                         uint64_t offset);
   [[nodiscard]] bool IsThereSectionWithOffsetAfterSectionList() const;
+  [[nodiscard]] std::unique_ptr<ProtoSectionInputStream> CreateProtoSectionInputStreamForFragment(
+      uint64_t offset, uint64_t size);
 
   std::filesystem::path file_path_;
   unique_fd fd_;
@@ -325,9 +331,27 @@ ErrorMessageOr<void> CaptureFileImpl::ReadFromSection(uint64_t section_number,
   return outcome::success();
 }
 
+std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateProtoSectionInputStreamForFragment(
+    uint64_t offset, uint64_t size) {
+#ifndef _WIN32
+  // Prefer reading from a memory mapping, this avoids copying the section through a read buffer.
+  // Fall back to buffered reads if the section cannot be mapped.
+  auto memory_mapped_input_stream_or_error =
+      orbit_capture_file_internal::MemoryMappedProtoSectionInputStream::Create(fd_, offset, size);
+  if (memory_mapped_input_stream_or_error.has_value()) {
+    return std::move(memory_mapped_input_stream_or_error.value());
+  }
+  ORBIT_ERROR("Falling back to buffered reads for \"%s\": %s", file_path_.string(),
+              memory_mapped_input_stream_or_error.error().message());
+#endif
+
+  return std::make_unique<orbit_capture_file_internal::ProtoSectionInputStreamImpl>(fd_, offset,
+                                                                                     size);
+}
+
 std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateCaptureSectionInputStream() {
-  return std::make_unique<orbit_capture_file_internal::ProtoSectionInputStreamImpl>(
-      fd_, header_.capture_section_offset, capture_section_size_);
+  return CreateProtoSectionInputStreamForFragment(header_.capture_section_offset,
+                                                  capture_section_size_);
 }
 
 std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateProtoSectionInputStream(
@@ -335,8 +359,7 @@ std::unique_ptr<ProtoSectionInputStream> CaptureFileImpl::CreateProtoSectionInpu
   ORBIT_CHECK(section_number < section_list_.size());
   const auto& section_info = section_list_[section_number];
 
-  return std::make_unique<orbit_capture_file_internal::ProtoSectionInputStreamImpl>(
-      fd_, section_info.offset, section_info.size);
+  return CreateProtoSectionInputStreamForFragment(section_info.offset, section_info.size);
 }
 
 std::optional<uint64_t> CaptureFileImpl::FindSectionByType(uint64_t section_type) const {
@@ -18,4 +18,8 @@ static_assert(kFileSignature.size() == 4);
 
 constexpr uint32_t kFileVersion = 1;
 
+// Since file input is not trusted, we limit the size of a single length-delimited message in a
+// proto section to 1Mb. This is the maximum size of messages written by Orbit.
+constexpr uint64_t kMaximumMessageSize = 1024 * 1024;  // 1Mb
+
 #endif  // CAPTURE_FILE_CONSTANTS_H_
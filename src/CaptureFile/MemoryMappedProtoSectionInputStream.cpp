@@ -0,0 +1,149 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "MemoryMappedProtoSectionInputStream.h"
+
+#include <absl/strings/str_format.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "CaptureFileConstants.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/SafeStrerror.h"
+
+namespace orbit_capture_file_internal {
+
+// A varint32 never takes more than 5 bytes.
+constexpr uint64_t kMaxVarint32Size = 5;
+
+MemoryMappedProtoSectionInputStream::MemoryMappedProtoSectionInputStream(
+    void* mapping, size_t mapping_size, size_t section_offset_in_mapping, uint64_t section_size)
+    : mapping_{mapping},
+      mapping_size_{mapping_size},
+      section_begin_{static_cast<const uint8_t*>(mapping) + section_offset_in_mapping},
+      section_size_{section_size} {
+  // An empty section is not mapped.
+  if (mapping_ == nullptr) return;
+  // The advice is only a hint, reading works the same way if the kernel ignores it.
+  if (madvise(mapping_, mapping_size_, MADV_SEQUENTIAL) != 0) {
+    ORBIT_ERROR("madvise(MADV_SEQUENTIAL) on capture file section: %s", SafeStrerror(errno));
+  }
+  PrefetchAhead();
+}
+
+MemoryMappedProtoSectionInputStream::~MemoryMappedProtoSectionInputStream() {
+  if (mapping_ == nullptr) return;
+  if (munmap(mapping_, mapping_size_) != 0) {
+    ORBIT_ERROR("Unable to unmap capture file section: %s", SafeStrerror(errno));
+  }
+}
+
+ErrorMessageOr<std::unique_ptr<MemoryMappedProtoSectionInputStream>>
+MemoryMappedProtoSectionInputStream::Create(const orbit_base::unique_fd& fd,
+                                            uint64_t section_offset, uint64_t section_size) {
+  struct stat file_stat {};
+  if (fstat(fd.get(), &file_stat) != 0) {
+    return ErrorMessage{absl::StrFormat("Unable to stat capture file: %s", SafeStrerror(errno))};
+  }
+
+  // Accessing a mapped page past the end of the file raises SIGBUS, so the whole section needs to
+  // be backed by the file.
+  const auto file_size = static_cast<uint64_t>(file_stat.st_size);
+  if (section_offset > file_size || section_size > file_size - section_offset) {
+    return ErrorMessage{absl::StrFormat(
+        "The section [%d, %d) does not fit into the capture file of size %d", section_offset,
+        section_offset + section_size, file_size)};
+  }
+
+  // mmap fails for a length of zero, but there is nothing to read from an empty section anyway.
+  if (section_size == 0) {
+    return std::unique_ptr<MemoryMappedProtoSectionInputStream>(
+        new MemoryMappedProtoSectionInputStream(nullptr, 0, 0, 0));
+  }
+
+  // The offset passed to mmap has to be a multiple of the page size.
+  const auto page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t mapping_offset = section_offset - section_offset % page_size;
+  const size_t section_offset_in_mapping = section_offset - mapping_offset;
+  const size_t mapping_size = section_offset_in_mapping + section_size;
+
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd.get(),
+                       static_cast<off_t>(mapping_offset));
+  if (mapping == MAP_FAILED) {
+    return ErrorMessage{
+        absl::StrFormat("Unable to map capture file section: %s", SafeStrerror(errno))};
+  }
+
+  return std::unique_ptr<MemoryMappedProtoSectionInputStream>(
+      new MemoryMappedProtoSectionInputStream(mapping, mapping_size, section_offset_in_mapping,
+                                              section_size));
+}
+
+void MemoryMappedProtoSectionInputStream::PrefetchAhead() {
+  const size_t current_offset_in_mapping =
+      (section_begin_ - static_cast<const uint8_t*>(mapping_)) + current_position_;
+
+  // Issue the next WILLNEED advice once half of the previously prefetched window has been consumed,
+  // so that the next window is ready by the time we get there.
+  if (prefetched_until_ >= mapping_size_ ||
+      current_offset_in_mapping + kPrefetchWindowSize / 2 < prefetched_until_) {
+    return;
+  }
+
+  const size_t prefetch_size = std::min(kPrefetchWindowSize, mapping_size_ - prefetched_until_);
+  if (madvise(static_cast<uint8_t*>(mapping_) + prefetched_until_, prefetch_size, MADV_WILLNEED) !=
+      0) {
+    ORBIT_ERROR("madvise(MADV_WILLNEED) on capture file section: %s", SafeStrerror(errno));
+  }
+  prefetched_until_ += prefetch_size;
+}
+
+ErrorMessageOr<void> MemoryMappedProtoSectionInputStream::ReadMessage(
+    google::protobuf::Message* message) {
+  const uint64_t bytes_left = section_size_ - current_position_;
+  const uint8_t* current_data = section_begin_ + current_position_;
+
+  // Only hand the bytes that can belong to the size field to the CodedInputStream, this way we do
+  // not run into the INT_MAX limit CodedInputStream has on the buffer size.
+  google::protobuf::io::CodedInputStream coded_input_stream{
+      current_data, static_cast<int>(std::min(bytes_left, kMaxVarint32Size))};
+
+  uint32_t message_size = 0;
+  if (!coded_input_stream.ReadVarint32(&message_size)) {
+    return ErrorMessage{"Unexpected end of section while reading message size"};
+  }
+  const auto size_field_size = static_cast<uint64_t>(coded_input_stream.CurrentPosition());
+
+  // Since file input is not trusted, do a sanity check for message size, we limit our messages to
+  // 1Mb maximum size.
+  if (message_size > kMaximumMessageSize) {
+    return ErrorMessage{
+        absl::StrFormat("The message size %d is too big (maximum allowed message size is %d)",
+                        message_size, kMaximumMessageSize)};
+  }
+
+  if (message_size > bytes_left - size_field_size) {
+    return ErrorMessage{"Unexpected end of section while reading the message"};
+  }
+
+  // Parse directly from the mapping, there is no intermediate copy of the message bytes.
+  message->ParseFromArray(current_data + size_field_size, static_cast<int>(message_size));
+
+  if (message->ByteSizeLong() != message_size) {
+    return ErrorMessage{absl::StrFormat(
+        "The message size %d of the parsed message is different from the parsed size %d",
+        message->ByteSizeLong(), message_size)};
+  }
+
+  current_position_ += size_field_size + message_size;
+  PrefetchAhead();
+
+  return outcome::success();
+}
+
+}  // namespace orbit_capture_file_internal
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEMORY_MAPPED_PROTO_SECTION_INPUT_STREAM_H_
+#define MEMORY_MAPPED_PROTO_SECTION_INPUT_STREAM_H_
+
+#include <google/protobuf/message.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "CaptureFile/ProtoSectionInputStream.h"
+#include "OrbitBase/File.h"
+#include "OrbitBase/Result.h"
+
+namespace orbit_capture_file_internal {
+
+// This class is used to read proto messages from a section of capture file by mapping the section
+// into memory. Messages are parsed directly from the mapping, which avoids copying every byte of
+// the section into an intermediate buffer first. The mapping is read sequentially and the kernel
+// is asked to prefetch the pages right ahead of the current position.
+class MemoryMappedProtoSectionInputStream : public orbit_capture_file::ProtoSectionInputStream {
+ public:
+  MemoryMappedProtoSectionInputStream(const MemoryMappedProtoSectionInputStream&) = delete;
+  MemoryMappedProtoSectionInputStream& operator=(const MemoryMappedProtoSectionInputStream&) =
+      delete;
+  ~MemoryMappedProtoSectionInputStream() override;
+
+  // Maps `section_size` bytes of the file starting at `section_offset`. An empty section is not
+  // mapped, reading from it fails like reading past the end of any section. Returns an error if the
+  // section does not fit into the file, or if the file cannot be mapped. The mapping does not
+  // depend on `fd` staying open.
+  [[nodiscard]] static ErrorMessageOr<std::unique_ptr<MemoryMappedProtoSectionInputStream>> Create(
+      const orbit_base::unique_fd& fd, uint64_t section_offset, uint64_t section_size);
+
+  ErrorMessageOr<void> ReadMessage(google::protobuf::Message* message) override;
+
+ private:
+  MemoryMappedProtoSectionInputStream(void* mapping, size_t mapping_size,
+                                      size_t section_offset_in_mapping, uint64_t section_size);
+
+  void PrefetchAhead();
+
+  static constexpr size_t kPrefetchWindowSize = 4 * 1024 * 1024;  // 4Mb
+
+  void* mapping_;
+  size_t mapping_size_;
+  const uint8_t* section_begin_;
+  uint64_t section_size_;
+  uint64_t current_position_ = 0;
+  // Offset in the mapping (not in the section) up to which WILLNEED advice has been given. It is
+  // always page-aligned or equal to mapping_size_.
+  size_t prefetched_until_ = 0;
+};
+
+}  // namespace orbit_capture_file_internal
+
+#endif  // MEMORY_MAPPED_PROTO_SECTION_INPUT_STREAM_H_
@@ -0,0 +1,126 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "GrpcProtos/capture.pb.h"
+#include "MemoryMappedProtoSectionInputStream.h"
+#include "OrbitBase/TemporaryFile.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_capture_file_internal {
+
+using orbit_grpc_protos::ClientCaptureEvent;
+using orbit_test_utils::HasError;
+using orbit_test_utils::HasNoError;
+
+static ClientCaptureEvent CreateInternedStringCaptureEvent(uint64_t key, const std::string& str) {
+  ClientCaptureEvent event;
+  orbit_grpc_protos::InternedString* interned_string = event.mutable_interned_string();
+  interned_string->set_key(key);
+  interned_string->set_intern(str);
+  return event;
+}
+
+static std::string SerializeDelimited(const std::vector<ClientCaptureEvent>& events) {
+  std::string result;
+  {
+    google::protobuf::io::StringOutputStream string_output_stream{&result};
+    google::protobuf::io::CodedOutputStream coded_output_stream{&string_output_stream};
+    for (const ClientCaptureEvent& event : events) {
+      coded_output_stream.WriteVarint32(event.ByteSizeLong());
+      event.SerializeToCodedStream(&coded_output_stream);
+    }
+  }
+  return result;
+}
+
+TEST(MemoryMappedProtoSectionInputStream, ReadsMessagesFromUnalignedSection) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  // Put the section behind more than a page of unrelated bytes at an offset that is not
+  // page-aligned.
+  const std::string padding(5000, 'x');
+  const std::string section = SerializeDelimited({CreateInternedStringCaptureEvent(1, "first"),
+                                                  CreateInternedStringCaptureEvent(2, "second")});
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), padding), HasNoError());
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), section), HasNoError());
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), padding), HasNoError());
+
+  auto input_stream_or_error = MemoryMappedProtoSectionInputStream::Create(
+      temporary_file.fd(), padding.size(), section.size());
+  ASSERT_THAT(input_stream_or_error, HasNoError());
+  std::unique_ptr<MemoryMappedProtoSectionInputStream> input_stream =
+      std::move(input_stream_or_error.value());
+
+  ClientCaptureEvent event;
+  ASSERT_THAT(input_stream->ReadMessage(&event), HasNoError());
+  EXPECT_EQ(event.interned_string().key(), 1);
+  EXPECT_EQ(event.interned_string().intern(), "first");
+
+  ASSERT_THAT(input_stream->ReadMessage(&event), HasNoError());
+  EXPECT_EQ(event.interned_string().key(), 2);
+  EXPECT_EQ(event.interned_string().intern(), "second");
+
+  // Do not read past the end of the section into the padding.
+  EXPECT_THAT(input_stream->ReadMessage(&event),
+              HasError("Unexpected end of section while reading message size"));
+}
+
+TEST(MemoryMappedProtoSectionInputStream, TruncatedMessage) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  const std::string section =
+      SerializeDelimited({CreateInternedStringCaptureEvent(42, "truncated")});
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), section), HasNoError());
+
+  auto input_stream_or_error =
+      MemoryMappedProtoSectionInputStream::Create(temporary_file.fd(), 0, section.size() - 1);
+  ASSERT_THAT(input_stream_or_error, HasNoError());
+
+  ClientCaptureEvent event;
+  EXPECT_THAT(input_stream_or_error.value()->ReadMessage(&event),
+              HasError("Unexpected end of section while reading the message"));
+}
+
+TEST(MemoryMappedProtoSectionInputStream, SectionDoesNotFitIntoFile) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), "Not a very long file"), HasNoError());
+
+  EXPECT_THAT(MemoryMappedProtoSectionInputStream::Create(temporary_file.fd(), 10, 100),
+              HasError("does not fit into the capture file"));
+}
+
+TEST(MemoryMappedProtoSectionInputStream, EmptySection) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  orbit_base::TemporaryFile temporary_file = std::move(temporary_file_or_error.value());
+
+  ASSERT_THAT(orbit_base::WriteFully(temporary_file.fd(), "Not a very long file"), HasNoError());
+
+  for (uint64_t offset : {uint64_t{0}, uint64_t{10}, uint64_t{20}}) {
+    auto input_stream_or_error =
+        MemoryMappedProtoSectionInputStream::Create(temporary_file.fd(), offset, 0);
+    ASSERT_THAT(input_stream_or_error, HasNoError());
+    ClientCaptureEvent event;
+    EXPECT_THAT(input_stream_or_error.value()->ReadMessage(&event),
+                HasError("Unexpected end of section while reading message size"));
+  }
+  EXPECT_THAT(MemoryMappedProtoSectionInputStream::Create(temporary_file.fd(), 21, 0),
+              HasError("does not fit into the capture file"));
+}
+
+}  // namespace orbit_capture_file_internal
@@ -4,13 +4,12 @@
 
 #include "ProtoSectionInputStreamImpl.h"
 
+#include "CaptureFileConstants.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/MakeUniqueForOverwrite.h"
 
 namespace orbit_capture_file_internal {
 
-constexpr uint64_t kMaximumMessageSize = 1024 * 1024;  // 1Mb
-
 ErrorMessageOr<void> ProtoSectionInputStreamImpl::ReadMessage(google::protobuf::Message* message) {
   // CodedInputStream imposes a hard limit on the total number of bytes it will read. It's INT_MAX
   // by default and it cannot be increased past that. To work around the limitation, reinitialize
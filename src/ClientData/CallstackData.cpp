@@ -7,10 +7,13 @@
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
 
-#include <mutex>
+#include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackEventRun.h"
 #include "ClientData/CallstackInfo.h"
 #include "ClientData/CallstackType.h"
 #include "ClientData/ModuleAndFunctionLookup.h"
@@ -19,84 +22,154 @@
 namespace orbit_client_data {
 
 void CallstackData::AddCallstackEvent(CallstackEvent callstack_event) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  ORBIT_CHECK(unique_callstacks_.contains(callstack_event.callstack_id()));
+  ORBIT_CHECK(HasCallstack(callstack_event.callstack_id()));
+  absl::MutexLock lock{&write_mutex_};
   RegisterTime(callstack_event.timestamp_ns());
-  callstack_events_by_tid_[callstack_event.thread_id()].emplace(callstack_event.timestamp_ns(),
-                                                                callstack_event);
+  AddCallstackEventLocked(callstack_event);
+}
+
+void CallstackData::AddCallstackEvents(absl::Span<const CallstackEvent> callstack_events) {
+  for (const CallstackEvent& callstack_event : callstack_events) {
+    ORBIT_CHECK(HasCallstack(callstack_event.callstack_id()));
+  }
+  absl::MutexLock lock{&write_mutex_};
+  for (const CallstackEvent& callstack_event : callstack_events) {
+    RegisterTime(callstack_event.timestamp_ns());
+    AddCallstackEventLocked(callstack_event);
+  }
 }
 
 void CallstackData::RegisterTime(uint64_t time) {
-  if (time > max_time_) max_time_ = time;
-  if (time > 0 && time < min_time_) min_time_ = time;
+  if (time > max_time_.load(std::memory_order_relaxed)) {
+    max_time_.store(time, std::memory_order_relaxed);
+  }
+  if (time > 0 && time < min_time_.load(std::memory_order_relaxed)) {
+    min_time_.store(time, std::memory_order_relaxed);
+  }
+}
+
+// Merges the last two runs as long as the older one is not at least twice as large as the newer
+// one. This keeps the number of runs of a thread logarithmic in the number of its events, while
+// each event is copied a logarithmic number of times at most.
+static void MergeTrailingRuns(std::vector<std::shared_ptr<CallstackEventRun>>* runs) {
+  while (runs->size() >= 2 &&
+         (*runs)[runs->size() - 2]->size() <= 2 * (*runs)[runs->size() - 1]->size()) {
+    CallstackEventRun::View older = (*runs)[runs->size() - 2]->GetView();
+    CallstackEventRun::View newer = (*runs)[runs->size() - 1]->GetView();
+    auto merged = std::make_shared<CallstackEventRun>();
+    size_t older_index = 0;
+    size_t newer_index = 0;
+    while (older_index < older.size() || newer_index < newer.size()) {
+      if (newer_index == newer.size() ||
+          (older_index < older.size() &&
+           older[older_index].timestamp_ns() <= newer[newer_index].timestamp_ns())) {
+        merged->Append(older[older_index++]);
+      } else {
+        merged->Append(newer[newer_index++]);
+      }
+    }
+    runs->pop_back();
+    runs->back() = std::move(merged);
+  }
+}
+
+void CallstackData::AddCallstackEventLocked(const CallstackEvent& callstack_event) {
+  const uint64_t timestamp_ns = callstack_event.timestamp_ns();
+  auto [tid_and_runs_it, thread_inserted] = runs_by_tid_.try_emplace(callstack_event.thread_id());
+  std::vector<std::shared_ptr<CallstackEventRun>>& runs = tid_and_runs_it->second;
+
+  // Events are unique by thread and timestamp: drop the event if there already is one for this
+  // thread with the same timestamp. Runs are never empty, and in the common case of an event more
+  // recent than all others of the thread this only takes one comparison.
+  for (size_t run_index = 0; run_index < runs.size(); ++run_index) {
+    CallstackEventRun::View view = runs[run_index]->GetView();
+    if (run_index == runs.size() - 1 && view.back().timestamp_ns() < timestamp_ns) break;
+    const size_t index = view.LowerBound(timestamp_ns);
+    if (index < view.size() && view[index].timestamp_ns() == timestamp_ns) return;
+  }
+
+  bool runs_changed = thread_inserted;
+  if (runs.empty() || runs.back()->GetView().back().timestamp_ns() > timestamp_ns) {
+    MergeTrailingRuns(&runs);
+    runs.push_back(std::make_shared<CallstackEventRun>());
+    runs_changed = true;
+  }
+  runs.back()->Append(callstack_event);
+
+  if (runs_changed) PublishEventsSnapshot();
+}
+
+void CallstackData::PublishEventsSnapshot() {
+  auto snapshot = std::make_shared<EventsSnapshot>();
+  for (const auto& [tid, runs] : runs_by_tid_) {
+    snapshot->runs_by_tid.try_emplace(tid, runs.begin(), runs.end());
+  }
+  std::atomic_store(&events_snapshot_, std::shared_ptr<const EventsSnapshot>{std::move(snapshot)});
 }
 
 void CallstackData::AddUniqueCallstack(uint64_t callstack_id, CallstackInfo callstack) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  absl::MutexLock lock{&unique_callstacks_mutex_};
   unique_callstacks_[callstack_id] = std::make_shared<CallstackInfo>(std::move(callstack));
 }
 
 uint32_t CallstackData::GetCallstackEventsCount() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
   uint32_t count = 0;
-  for (const auto& tid_and_events : callstack_events_by_tid_) {
-    count += tid_and_events.second.size();
+  for (const auto& [unused_tid, runs] : snapshot->runs_by_tid) {
+    for (const auto& run : runs) {
+      count += run->size();
+    }
   }
   return count;
 }
 
 std::vector<orbit_client_data::CallstackEvent> CallstackData::GetCallstackEventsInTimeRange(
     uint64_t time_begin, uint64_t time_end) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
   std::vector<CallstackEvent> callstack_events;
-  for (const auto& tid_and_events : callstack_events_by_tid_) {
-    const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events.second;
-    for (auto event_it = events.lower_bound(time_begin); event_it != events.end(); ++event_it) {
-      uint64_t time = event_it->first;
-      if (time < time_end) {
-        callstack_events.push_back(event_it->second);
-      } else {
-        break;
-      }
-    }
-  }
+  if (time_begin >= time_end) return callstack_events;
+  ForEachCallstackEventInTimeRange(time_begin, time_end - 1,
+                                   [&callstack_events](const CallstackEvent& event) {
+                                     callstack_events.push_back(event);
+                                   });
   return callstack_events;
 }
 
 uint32_t CallstackData::GetCallstackEventsOfTidCount(uint32_t thread_id) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  const auto& tid_and_events_it = callstack_events_by_tid_.find(thread_id);
-  if (tid_and_events_it == callstack_events_by_tid_.end()) {
+  std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
+  const auto& tid_and_runs_it = snapshot->runs_by_tid.find(thread_id);
+  if (tid_and_runs_it == snapshot->runs_by_tid.end()) {
     return 0;
   }
-  return tid_and_events_it->second.size();
+  uint32_t count = 0;
+  for (const auto& run : tid_and_runs_it->second) {
+    count += run->size();
+  }
+  return count;
+}
+
+std::vector<uint32_t> CallstackData::GetThreadIds() const {
+  std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
+  std::vector<uint32_t> thread_ids;
+  thread_ids.reserve(snapshot->runs_by_tid.size());
+  for (const auto& [tid, unused_runs] : snapshot->runs_by_tid) {
+    thread_ids.push_back(tid);
+  }
+  return thread_ids;
 }
 
 std::vector<CallstackEvent> CallstackData::GetCallstackEventsOfTidInTimeRange(
     uint32_t tid, uint64_t time_begin, uint64_t time_end) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
   std::vector<CallstackEvent> callstack_events;
-
-  auto tid_and_events_it = callstack_events_by_tid_.find(tid);
-  if (tid_and_events_it == callstack_events_by_tid_.end()) {
-    return callstack_events;
-  }
-
-  const absl::btree_map<uint64_t, CallstackEvent>& events = tid_and_events_it->second;
-  for (auto event_it = events.lower_bound(time_begin); event_it != events.end(); ++event_it) {
-    uint64_t time = event_it->first;
-    if (time < time_end) {
-      callstack_events.push_back(event_it->second);
-    } else {
-      break;
-    }
-  }
+  if (time_begin >= time_end) return callstack_events;
+  ForEachCallstackEventOfTidInTimeRange(tid, time_begin, time_end - 1,
+                                        [&callstack_events](const CallstackEvent& event) {
+                                          callstack_events.push_back(event);
+                                        });
   return callstack_events;
 }
 
 void CallstackData::AddCallstackFromKnownCallstackData(const CallstackEvent& event,
                                                        const CallstackData& known_callstack_data) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
   uint64_t callstack_id = event.callstack_id();
   std::shared_ptr<CallstackInfo> unique_callstack =
       known_callstack_data.GetCallstackPtr(callstack_id);
@@ -104,13 +177,17 @@ void CallstackData::AddCallstackFromKnownCallstackData(const CallstackEvent& eve
     return;
   }
 
-  // The insertion only happens if the hash isn't already present.
-  unique_callstacks_.emplace(callstack_id, std::move(unique_callstack));
-  callstack_events_by_tid_[event.thread_id()].emplace(event.timestamp_ns(), event);
+  {
+    absl::MutexLock lock{&unique_callstacks_mutex_};
+    // The insertion only happens if the hash isn't already present.
+    unique_callstacks_.emplace(callstack_id, std::move(unique_callstack));
+  }
+  absl::MutexLock lock{&write_mutex_};
+  AddCallstackEventLocked(event);
 }
 
 const CallstackInfo* CallstackData::GetCallstack(uint64_t callstack_id) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  absl::MutexLock lock{&unique_callstacks_mutex_};
   auto it = unique_callstacks_.find(callstack_id);
   if (it != unique_callstacks_.end()) {
     return it->second.get();
@@ -119,18 +196,31 @@ const CallstackInfo* CallstackData::GetCallstack(uint64_t callstack_id) const {
 }
 
 bool CallstackData::HasCallstack(uint64_t callstack_id) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  absl::MutexLock lock{&unique_callstacks_mutex_};
   return unique_callstacks_.contains(callstack_id);
 }
 
 std::shared_ptr<CallstackInfo> CallstackData::GetCallstackPtr(uint64_t callstack_id) const {
+  absl::MutexLock lock{&unique_callstacks_mutex_};
   auto it = unique_callstacks_.find(callstack_id);
   if (it != unique_callstacks_.end()) {
-    return unique_callstacks_.at(callstack_id);
+    return it->second;
   }
   return nullptr;
 }
 
+// Calls `action` on all the events in `runs`, in no particular order.
+template <typename Action>
+static void ForEachEventOfRuns(const std::vector<std::shared_ptr<const CallstackEventRun>>& runs,
+                               Action&& action) {
+  for (const auto& run : runs) {
+    CallstackEventRun::View events = run->GetView();
+    for (size_t index = 0; index < events.size(); ++index) {
+      std::invoke(action, events[index]);
+    }
+  }
+}
+
 static bool IsPcInFunctionsToStopUnwindingAt(
     const std::map<uint64_t, uint64_t>& absolute_address_to_size_of_functions_to_stop_unwinding_at,
     uint64_t pc) {
@@ -150,20 +240,23 @@ static bool IsPcInFunctionsToStopUnwindingAt(
 void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
     const std::map<uint64_t, uint64_t>&
         absolute_address_to_size_of_functions_to_stop_unwinding_at) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  absl::MutexLock write_lock{&write_mutex_};
+  absl::MutexLock unique_callstacks_lock{&unique_callstacks_mutex_};
+  // Holding `write_mutex_`, this is the current state of the events.
+  std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
 
   absl::flat_hash_set<uint64_t> callstack_ids_to_filter;
 
-  for (auto& [tid, timestamps_and_callstack_events] : callstack_events_by_tid_) {
+  for (const auto& [tid, runs] : snapshot->runs_by_tid) {
     uint64_t count_for_this_thread = 0;
 
     // Count the number of occurrences of each outer frame for this thread.
     absl::flat_hash_map<uint64_t, uint64_t> count_by_outer_frame;
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+    ForEachEventOfRuns(runs, [&](const CallstackEvent& event) ABSL_NO_THREAD_SAFETY_ANALYSIS {
       const CallstackInfo& callstack = *unique_callstacks_.at(event.callstack_id());
       ORBIT_CHECK(callstack.type() != CallstackType::kFilteredByMajorityOutermostFrame);
       if (callstack.type() != CallstackType::kComplete) {
-        continue;
+        return;
       }
 
       const auto& frames = callstack.frames();
@@ -174,7 +267,7 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
         ++count_for_this_thread;
         ++count_by_outer_frame[outer_frame];
       }
-    }
+    });
 
     // Find the outer frame with the most occurrences.
     if (count_by_outer_frame.empty()) {
@@ -205,11 +298,11 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
     // doesn't match the (super)majority outer frame.
     // Note that if a CallstackEvent from another thread references a filtered CallstackInfo, that
     // CallstackEvent will also be affected.
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+    ForEachEventOfRuns(runs, [&](const CallstackEvent& event) ABSL_NO_THREAD_SAFETY_ANALYSIS {
       const CallstackInfo& callstack = *unique_callstacks_.at(event.callstack_id());
       ORBIT_CHECK(callstack.type() != CallstackType::kFilteredByMajorityOutermostFrame);
       if (callstack.type() != CallstackType::kComplete) {
-        continue;
+        return;
       }
 
       const auto& frames = unique_callstacks_.at(event.callstack_id())->frames();
@@ -220,7 +313,7 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
               absolute_address_to_size_of_functions_to_stop_unwinding_at, outermost_frame)) {
         callstack_ids_to_filter.insert(event.callstack_id());
       }
-    }
+    });
   }
 
   // Change the type of the recorded CallstackInfos.
@@ -232,13 +325,13 @@ void CallstackData::UpdateCallstackTypeBasedOnMajorityStart(
 
   // Count how many CallstackEvents had their CallstackInfo affected by the type change.
   uint64_t affected_event_count = 0;
-  for (auto& [tid, timestamps_and_callstack_events] : callstack_events_by_tid_) {
-    for (const auto& [unused_timestamp_ns, event] : timestamps_and_callstack_events) {
+  for (const auto& [unused_tid, runs] : snapshot->runs_by_tid) {
+    ForEachEventOfRuns(runs, [&](const CallstackEvent& event) ABSL_NO_THREAD_SAFETY_ANALYSIS {
       if (unique_callstacks_.at(event.callstack_id())->type() ==
           CallstackType::kFilteredByMajorityOutermostFrame) {
         ++affected_event_count;
       }
-    }
+    });
   }
 
   uint32_t callstack_event_count = GetCallstackEventsCount();
@@ -5,8 +5,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <limits>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -200,4 +203,105 @@ TEST(CallstackData, FilterCallstackEventsBasedOnMajorityStartExcludesFunctionToS
                                                                          event4, event5, event6}));
 }
 
+TEST(CallstackData, OutOfOrderEventsAreReturnedSortedAndDeduplicated) {
+  CallstackData callstack_data;
+
+  constexpr uint32_t kTid = 42;
+  constexpr uint64_t kCallstackId = 12;
+  callstack_data.AddUniqueCallstack(kCallstackId, CallstackInfo{{0x11, 0x10},
+                                                                CallstackType::kComplete});
+
+  // Mostly increasing timestamps, with stragglers and duplicates.
+  std::vector<uint64_t> timestamps;
+  for (uint64_t timestamp = 1000; timestamp < 4000; timestamp += 10) {
+    timestamps.push_back(timestamp);
+    if (timestamp % 170 == 0) timestamps.push_back(timestamp - 5);
+    if (timestamp % 290 == 0) timestamps.push_back(timestamp - 20);
+  }
+  timestamps.push_back(3);
+  for (uint64_t timestamp : timestamps) {
+    callstack_data.AddCallstackEvent(CallstackEvent{timestamp, kCallstackId, kTid});
+  }
+
+  std::vector<uint64_t> expected_timestamps = timestamps;
+  std::sort(expected_timestamps.begin(), expected_timestamps.end());
+  expected_timestamps.erase(std::unique(expected_timestamps.begin(), expected_timestamps.end()),
+                            expected_timestamps.end());
+
+  EXPECT_EQ(callstack_data.GetCallstackEventsCount(), expected_timestamps.size());
+  EXPECT_EQ(callstack_data.GetCallstackEventsOfTidCount(kTid), expected_timestamps.size());
+  EXPECT_EQ(callstack_data.min_time(), 3);
+  EXPECT_EQ(callstack_data.max_time(), 3990);
+
+  std::vector<uint64_t> actual_timestamps;
+  callstack_data.ForEachCallstackEvent([&actual_timestamps](const CallstackEvent& event) {
+    actual_timestamps.push_back(event.timestamp_ns());
+  });
+  EXPECT_EQ(actual_timestamps, expected_timestamps);
+
+  std::vector<CallstackEvent> events_in_range =
+      callstack_data.GetCallstackEventsOfTidInTimeRange(kTid, 1695, 1710);
+  std::vector<uint64_t> timestamps_in_range;
+  for (const CallstackEvent& event : events_in_range) {
+    timestamps_in_range.push_back(event.timestamp_ns());
+  }
+  EXPECT_THAT(timestamps_in_range, testing::ElementsAre(1695, 1700));
+}
+
+TEST(CallstackData, AddCallstackEventsIsEquivalentToAddingOneByOne) {
+  CallstackData callstack_data;
+
+  constexpr uint64_t kCallstackId = 12;
+  callstack_data.AddUniqueCallstack(kCallstackId, CallstackInfo{{0x11, 0x10},
+                                                                CallstackType::kComplete});
+
+  const std::vector<CallstackEvent> events{{300, kCallstackId, 1}, {100, kCallstackId, 2},
+                                           {200, kCallstackId, 1}, {300, kCallstackId, 1},
+                                           {400, kCallstackId, 2}};
+  callstack_data.AddCallstackEvents(events);
+
+  EXPECT_EQ(callstack_data.GetCallstackEventsCount(), 4);
+  EXPECT_EQ(callstack_data.GetCallstackEventsOfTidCount(1), 2);
+  EXPECT_EQ(callstack_data.GetCallstackEventsOfTidCount(2), 2);
+  EXPECT_THAT(callstack_data.GetThreadIds(), testing::UnorderedElementsAre(1, 2));
+  EXPECT_EQ(callstack_data.min_time(), 100);
+  EXPECT_EQ(callstack_data.max_time(), 400);
+}
+
+TEST(CallstackData, QueriesWhileAddingEvents) {
+  CallstackData callstack_data;
+
+  constexpr uint64_t kCallstackId = 12;
+  callstack_data.AddUniqueCallstack(kCallstackId, CallstackInfo{{0x11, 0x10},
+                                                                CallstackType::kComplete});
+
+  constexpr uint64_t kEventCountPerThread = 100'000;
+  constexpr uint32_t kThreadCount = 4;
+  std::atomic<bool> done = false;
+  std::thread writer{[&callstack_data, &done] {
+    for (uint64_t timestamp = 1; timestamp <= kEventCountPerThread; ++timestamp) {
+      for (uint32_t tid = 0; tid < kThreadCount; ++tid) {
+        callstack_data.AddCallstackEvent(CallstackEvent{timestamp, kCallstackId, tid});
+      }
+    }
+    done = true;
+  }};
+
+  // Every query has to observe a prefix of the events of each thread, in order.
+  while (!done) {
+    for (uint32_t tid = 0; tid < kThreadCount; ++tid) {
+      uint64_t expected_timestamp = 1;
+      callstack_data.ForEachCallstackEventOfTidInTimeRange(
+          tid, 0, std::numeric_limits<uint64_t>::max(),
+          [&expected_timestamp](const CallstackEvent& event) {
+            EXPECT_EQ(event.timestamp_ns(), expected_timestamp);
+            ++expected_timestamp;
+          });
+    }
+  }
+  writer.join();
+
+  EXPECT_EQ(callstack_data.GetCallstackEventsCount(), kThreadCount * kEventCountPerThread);
+}
+
 }  // namespace orbit_client_data
@@ -0,0 +1,55 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/CallstackEventRun.h"
+
+#include <algorithm>
+
+namespace orbit_client_data {
+
+void CallstackEventRun::Append(const CallstackEvent& event) {
+  const size_t index = size_.load(std::memory_order_relaxed);
+  if (index > 0) {
+    ORBIT_CHECK(GetView().back().timestamp_ns() <= event.timestamp_ns());
+  }
+  if (index == chunks_.size() * kChunkSize) AllocateNewChunk();
+
+  new (&(*chunks_.back())[index % kChunkSize]) CallstackEvent{event};
+  size_.store(index + 1, std::memory_order_release);
+}
+
+void CallstackEventRun::AllocateNewChunk() {
+  const Chunk** directory = directory_.load(std::memory_order_relaxed);
+  if (chunks_.size() == directory_capacity_) {
+    // Grow the directory geometrically so that copying it stays amortized O(1) per chunk.
+    const size_t new_capacity = std::max<size_t>(2 * directory_capacity_, 16);
+    auto new_directory = std::make_unique<const Chunk*[]>(new_capacity);
+    std::copy(directory, directory + chunks_.size(), new_directory.get());
+    directory = new_directory.get();
+    directory_capacity_ = new_capacity;
+    directories_.push_back(std::move(new_directory));
+    directory_.store(directory, std::memory_order_release);
+  }
+
+  // Readers never look at this slot before the size covering it has been published.
+  const size_t chunk_index = chunks_.size();
+  directory[chunk_index] = chunks_.emplace_back(std::make_unique<Chunk>()).get();
+}
+
+size_t CallstackEventRun::View::LowerBound(uint64_t timestamp_ns) const {
+  size_t begin = 0;
+  size_t count = size_;
+  while (count > 0) {
+    const size_t step = count / 2;
+    if ((*this)[begin + step].timestamp_ns() < timestamp_ns) {
+      begin += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return begin;
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,46 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+#include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackEventRun.h"
+
+namespace orbit_client_data {
+
+TEST(CallstackEventRun, AppendAndLowerBound) {
+  constexpr size_t kEventCount = 40 * CallstackEventRun::kChunkSize + 3;
+  CallstackEventRun run;
+  EXPECT_EQ(run.size(), 0);
+  EXPECT_EQ(run.GetView().LowerBound(0), 0);
+
+  // Each timestamp is added twice: timestamps only have to be non-decreasing within a run.
+  for (uint64_t i = 0; i < kEventCount; ++i) {
+    run.Append(CallstackEvent{10 * (i / 2), i, 42});
+  }
+  EXPECT_EQ(run.size(), kEventCount);
+
+  CallstackEventRun::View view = run.GetView();
+  ASSERT_EQ(view.size(), kEventCount);
+  for (uint64_t i = 0; i < kEventCount; ++i) {
+    EXPECT_EQ(view[i].callstack_id(), i);
+  }
+  EXPECT_EQ(view.back().callstack_id(), kEventCount - 1);
+
+  EXPECT_EQ(view.LowerBound(0), 0);
+  EXPECT_EQ(view.LowerBound(1), 2);
+  EXPECT_EQ(view.LowerBound(10 * 3000), 6000);
+  EXPECT_EQ(view.LowerBound(10 * 3000 - 1), 6000);
+  EXPECT_EQ(view.LowerBound(std::numeric_limits<uint64_t>::max()), kEventCount);
+
+  // A view only covers the events that were appended before it was taken.
+  run.Append(CallstackEvent{10 * kEventCount, kEventCount, 42});
+  EXPECT_EQ(view.size(), kEventCount);
+  EXPECT_EQ(run.GetView().size(), kEventCount + 1);
+}
+
+}  // namespace orbit_client_data
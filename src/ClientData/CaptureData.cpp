@@ -10,6 +10,7 @@
 #include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -26,6 +27,10 @@ using orbit_symbol_provider::ModuleIdentifier;
 
 namespace orbit_client_data {
 
+namespace {
+constexpr size_t kThreadStateSliceChunkSize = SpillableTimeSeries<ThreadStateSliceInfo>::kChunkSize;
+}  // namespace
+
 CaptureData::CaptureData(CaptureStarted capture_started,
                          std::optional<std::filesystem::path> file_path,
                          absl::flat_hash_set<uint64_t> frame_track_function_ids,
@@ -53,29 +58,71 @@ CaptureData::CaptureData(CaptureStarted capture_started,
   }
 }
 
-void CaptureData::ForEachThreadStateSliceIntersectingTimeRange(
-    uint32_t thread_id, uint64_t min_timestamp, uint64_t max_timestamp,
-    const std::function<void(const ThreadStateSliceInfo&)>& action) const {
+void CaptureData::AddThreadStateSlice(ThreadStateSliceInfo state_slice) {
   absl::MutexLock lock{&thread_state_slices_mutex_};
-  auto tid_thread_state_slices_it = thread_state_slices_.find(thread_id);
-  if (tid_thread_state_slices_it == thread_state_slices_.end()) {
-    return;
+  AddThreadStateSliceLocked(std::move(state_slice));
+}
+
+void CaptureData::AddThreadStateSlices(absl::Span<const ThreadStateSliceInfo> state_slices) {
+  absl::MutexLock lock{&thread_state_slices_mutex_};
+  for (const ThreadStateSliceInfo& state_slice : state_slices) {
+    AddThreadStateSliceLocked(state_slice);
   }
+}
 
-  const std::vector<ThreadStateSliceInfo>& tid_thread_state_slices =
+void CaptureData::AddThreadStateSliceLocked(ThreadStateSliceInfo state_slice) {
+  const uint32_t tid = state_slice.tid();
+  // The slices in memory are bounded over all threads in SpillThreadStateSlicesIfNecessary, not per
+  // thread, as a capture can have thousands of threads.
+  auto [tid_thread_state_slices_it, inserted] =
+      thread_state_slices_.try_emplace(tid, std::numeric_limits<size_t>::max());
+  SpillableTimeSeries<ThreadStateSliceInfo>& tid_thread_state_slices =
       tid_thread_state_slices_it->second;
-  auto slice_it = std::lower_bound(tid_thread_state_slices.begin(), tid_thread_state_slices.end(),
-                                   min_timestamp,
-                                   [](const ThreadStateSliceInfo& slice, uint64_t min_timestamp) {
-                                     return slice.end_timestamp_ns() < min_timestamp;
-                                   });
-  while (slice_it != tid_thread_state_slices.end() &&
-         slice_it->begin_timestamp_ns() < max_timestamp) {
-    action(*slice_it);
-    ++slice_it;
+  if (inserted && spill_file_ != nullptr) {
+    tid_thread_state_slices.SetSpillFile(spill_file_.get());
+  }
+  tid_thread_state_slices.Add(std::move(state_slice));
+  ++num_thread_state_slices_in_memory_;
+
+  if (spill_file_ == nullptr) return;
+  if (tid_thread_state_slices.size() % kThreadStateSliceChunkSize == 0) {
+    tids_of_full_thread_state_slice_chunks_in_memory_.push_back(tid);
+  }
+  SpillThreadStateSlicesIfNecessary();
+}
+
+void CaptureData::SpillThreadStateSlicesIfNecessary() {
+  while (num_thread_state_slices_in_memory_ > kMaxThreadStateSlicesInMemory &&
+         !tids_of_full_thread_state_slice_chunks_in_memory_.empty()) {
+    const uint32_t tid = tids_of_full_thread_state_slice_chunks_in_memory_.front();
+    tids_of_full_thread_state_slice_chunks_in_memory_.pop_front();
+    // If spilling fails, the slices of this thread stay in memory from now on.
+    if (thread_state_slices_.at(tid).SpillOldestChunk()) {
+      num_thread_state_slices_in_memory_ -= kThreadStateSliceChunkSize;
+    }
   }
 }
 
+const SpillableTimeSeries<ThreadStateSliceInfo>* CaptureData::FindThreadStateSlices(
+    uint32_t thread_id) const {
+  absl::MutexLock lock{&thread_state_slices_mutex_};
+  auto tid_thread_state_slices_it = thread_state_slices_.find(thread_id);
+  if (tid_thread_state_slices_it == thread_state_slices_.end()) {
+    return nullptr;
+  }
+  return &tid_thread_state_slices_it->second;
+}
+
+void CaptureData::ForEachThreadStateSliceIntersectingTimeRange(
+    uint32_t thread_id, uint64_t min_timestamp, uint64_t max_timestamp,
+    const std::function<void(const ThreadStateSliceInfo&)>& action) const {
+  const SpillableTimeSeries<ThreadStateSliceInfo>* thread_state_slices =
+      FindThreadStateSlices(thread_id);
+  if (thread_state_slices == nullptr) return;
+
+  thread_state_slices->ForEachIntersectingTimeRange(min_timestamp, max_timestamp, action);
+}
+
 const ScopeStats& CaptureData::GetScopeStatsOrDefault(ScopeId scope_id) const {
   return all_scopes_->GetScopeStatsOrDefault(scope_id);
 }
@@ -94,6 +141,8 @@ void CaptureData::AddScopeStats(ScopeId scope_id, ScopeStats stats) {
 void CaptureData::OnCaptureComplete() {
   thread_track_data_provider_->OnCaptureComplete();
   all_scopes_->OnCaptureComplete();
+  // No more timers are added, so the stored ones can be indexed by scope.
+  all_scopes_->SetTimers(*scope_id_provider_, GetAllScopeTimers(kAllValidScopeTypes));
 }
 
 void CaptureData::FilterBrokenCallstacks() {
@@ -236,6 +285,10 @@ const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
   return all_scopes_->GetSortedTimerDurationsForScopeId(scope_id);
 }
 
+const ScopeTimerIndex* CaptureData::GetTimerIndexForScopeId(ScopeId scope_id) const {
+  return all_scopes_->GetTimerIndexForScopeId(scope_id);
+}
+
 [[nodiscard]] std::vector<const TimerInfo*> CaptureData::GetAllScopeTimers(
     const absl::flat_hash_set<ScopeType> types, uint64_t min_tick, uint64_t max_tick) const {
   std::vector<const TimerInfo*> result;
@@ -267,6 +320,10 @@ const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
 
 [[nodiscard]] std::vector<const TimerInfo*> CaptureData::GetTimersForScope(
     ScopeId scope_id, uint64_t min_tick, uint64_t max_tick) const {
+  if (all_scopes_->AreTimersSet()) {
+    return all_scopes_->GetTimersForScopeId(scope_id, min_tick, max_tick);
+  }
+
   const std::vector<const TimerInfo*> all_timers =
       GetAllScopeTimers({GetScopeInfo(scope_id).GetType()}, min_tick, max_tick);
   std::vector<const TimerInfo*> result;
@@ -279,24 +336,29 @@ const std::vector<uint64_t>* CaptureData::GetSortedTimerDurationsForScopeId(
 
 [[nodiscard]] std::optional<ThreadStateSliceInfo>
 CaptureData::FindThreadStateSliceInfoFromTimestamp(int64_t thread_id, uint64_t timestamp) const {
-  absl::MutexLock lock{&thread_state_slices_mutex_};
-  if (!thread_state_slices_.contains(thread_id)) {
-    return std::nullopt;
-  }
+  const SpillableTimeSeries<ThreadStateSliceInfo>* thread_state_slices =
+      FindThreadStateSlices(thread_id);
+  if (thread_state_slices == nullptr) return std::nullopt;
 
-  const std::vector<ThreadStateSliceInfo>& thread_state_bar = thread_state_slices_.at(thread_id);
-  auto slice = std::upper_bound(
-      thread_state_bar.begin(), thread_state_bar.end(), timestamp,
-      [](uint64_t a,
-         const ThreadStateSliceInfo& b) -> bool {  // compare based on ending timestamps
-        return a < b.end_timestamp_ns();
-      });
+  return thread_state_slices->FindContainingTimestamp(timestamp);
+}
 
-  if (slice == thread_state_bar.end() || timestamp < slice->begin_timestamp_ns()) {
-    return std::nullopt;
+ErrorMessageOr<void> CaptureData::EnableDiskBackedStorage() {
+  absl::MutexLock lock{&thread_state_slices_mutex_};
+  if (spill_file_ != nullptr) return outcome::success();
+
+  OUTCOME_TRY(auto&& spill_file, SpillFile::Create());
+  spill_file_ = std::move(spill_file);
+  // The order in which the chunks were filled across threads is not known, so the slices already
+  // added are spilled thread by thread.
+  for (auto& [tid, tid_thread_state_slices] : thread_state_slices_) {
+    tid_thread_state_slices.SetSpillFile(spill_file_.get());
+    tids_of_full_thread_state_slice_chunks_in_memory_.insert(
+        tids_of_full_thread_state_slice_chunks_in_memory_.end(),
+        tid_thread_state_slices.size() / kThreadStateSliceChunkSize, tid);
   }
-
-  return *slice;
+  SpillThreadStateSlicesIfNecessary();
+  return outcome::success();
 }
 
 }  // namespace orbit_client_data
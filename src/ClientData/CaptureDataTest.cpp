@@ -332,4 +332,82 @@ TEST_F(CaptureDataTest, FindThreadStateSliceInfoFromTimestamp) {
             std::nullopt);
 }
 
-}  // namespace orbit_client_data
\ No newline at end of file
+TEST_F(CaptureDataTest, DiskBackedThreadStateSlices) {
+  ASSERT_FALSE(capture_data_.IsDiskBacked());
+  ASSERT_FALSE(capture_data_.EnableDiskBackedStorage().has_error());
+  EXPECT_TRUE(capture_data_.IsDiskBacked());
+
+  // Enough slices for the oldest ones to be moved to disk.
+  constexpr uint64_t kSliceCount = 100'000;
+  constexpr uint64_t kSliceDuration = 10;
+  auto create_slice = [](uint64_t index) {
+    return ThreadStateSliceInfo{kFirstTid,
+                                orbit_grpc_protos::ThreadStateSlice::kRunning,
+                                index * kSliceDuration,
+                                (index + 1) * kSliceDuration,
+                                ThreadStateSliceInfo::WakeupReason::kNotApplicable,
+                                kInvalidPidAndTid,
+                                kInvalidPidAndTid,
+                                index};
+  };
+  for (uint64_t i = 0; i < kSliceCount; ++i) {
+    capture_data_.AddThreadStateSlice(create_slice(i));
+  }
+
+  EXPECT_THAT(capture_data_.FindThreadStateSliceInfoFromTimestamp(kFirstTid, 42 * kSliceDuration),
+              Optional(create_slice(42)));
+  EXPECT_THAT(capture_data_.FindThreadStateSliceInfoFromTimestamp(
+                  kFirstTid, (kSliceCount - 1) * kSliceDuration + 1),
+              Optional(create_slice(kSliceCount - 1)));
+
+  uint64_t visited_slice_count = 0;
+  uint64_t expected_callstack_id = 0;
+  capture_data_.ForEachThreadStateSliceIntersectingTimeRange(
+      kFirstTid, 0, kSliceCount * kSliceDuration, [&](const ThreadStateSliceInfo& slice) {
+        EXPECT_EQ(slice.switch_out_or_wakeup_callstack_id(), expected_callstack_id++);
+        ++visited_slice_count;
+      });
+  EXPECT_EQ(visited_slice_count, kSliceCount);
+}
+
+TEST_F(CaptureDataTest, DiskBackedThreadStateSlicesAreBoundedOverAllThreads) {
+  constexpr size_t kChunkSize = SpillableTimeSeries<ThreadStateSliceInfo>::kChunkSize;
+  // Each thread alone stays far below the bound, but all of them together do not.
+  constexpr uint32_t kThreadCount = 64;
+  constexpr uint64_t kSlicesPerThread = 2 * kChunkSize + 1;
+  static_assert(kThreadCount * kSlicesPerThread > 2 * CaptureData::kMaxThreadStateSlicesInMemory);
+  auto create_slice = [](uint32_t tid, uint64_t index) {
+    return ThreadStateSliceInfo{tid,
+                                orbit_grpc_protos::ThreadStateSlice::kRunning,
+                                index * 10,
+                                (index + 1) * 10,
+                                ThreadStateSliceInfo::WakeupReason::kNotApplicable,
+                                kInvalidPidAndTid,
+                                kInvalidPidAndTid,
+                                index};
+  };
+
+  // Add half of the slices before and half after enabling the disk-backed storage.
+  for (uint64_t i = 0; i < kSlicesPerThread; ++i) {
+    if (i == kSlicesPerThread / 2) {
+      ASSERT_FALSE(capture_data_.EnableDiskBackedStorage().has_error());
+    }
+    for (uint32_t tid = 1; tid <= kThreadCount; ++tid) {
+      capture_data_.AddThreadStateSlice(create_slice(tid, i));
+    }
+    EXPECT_LE(capture_data_.GetNumThreadStateSlicesInMemory(),
+              CaptureData::kMaxThreadStateSlicesInMemory + kThreadCount * kChunkSize);
+  }
+  EXPECT_LE(capture_data_.GetNumThreadStateSlicesInMemory(),
+            CaptureData::kMaxThreadStateSlicesInMemory);
+
+  for (uint32_t tid = 1; tid <= kThreadCount; ++tid) {
+    EXPECT_THAT(capture_data_.FindThreadStateSliceInfoFromTimestamp(tid, 42 * 10),
+                Optional(create_slice(tid, 42)));
+    EXPECT_THAT(capture_data_.FindThreadStateSliceInfoFromTimestamp(
+                    tid, (kSlicesPerThread - 1) * 10),
+                Optional(create_slice(tid, kSlicesPerThread - 1)));
+  }
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,54 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/FunctionAddressIndex.h"
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+FunctionAddressIndex::FunctionAddressIndex(absl::Span<const FunctionInfo* const> functions) {
+  addresses_.reserve(functions.size());
+  sizes_.reserve(functions.size());
+  functions_.reserve(functions.size());
+  for (const FunctionInfo* function : functions) {
+    ORBIT_CHECK(addresses_.empty() || addresses_.back() < function->address());
+    addresses_.push_back(function->address());
+    sizes_.push_back(function->size());
+    functions_.push_back(function);
+  }
+}
+
+size_t FunctionAddressIndex::FindLastIndexNotGreaterThan(uint64_t virtual_address) const {
+  if (addresses_.empty() || addresses_.front() > virtual_address) return kNotFound;
+
+  // Invariant: the result is in [base, base + count). The condition only selects the next base,
+  // which compilers turn into a conditional move instead of a hard to predict branch.
+  const uint64_t* base = addresses_.data();
+  size_t count = addresses_.size();
+  while (count > 1) {
+    const size_t half = count / 2;
+    base = (base[half] <= virtual_address) ? base + half : base;
+    count -= half;
+  }
+  return static_cast<size_t>(base - addresses_.data());
+}
+
+const FunctionInfo* FunctionAddressIndex::FindFunctionByExactAddress(
+    uint64_t virtual_address) const {
+  const size_t index = FindLastIndexNotGreaterThan(virtual_address);
+  if (index == kNotFound || addresses_[index] != virtual_address) return nullptr;
+  return functions_[index];
+}
+
+const FunctionInfo* FunctionAddressIndex::FindFunctionContainingAddress(
+    uint64_t virtual_address) const {
+  const size_t index = FindLastIndexNotGreaterThan(virtual_address);
+  if (index == kNotFound) return nullptr;
+  // The end address itself is treated as part of the function.
+  if (addresses_[index] + sizes_[index] < virtual_address) return nullptr;
+  return functions_[index];
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,72 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "ClientData/FunctionAddressIndex.h"
+#include "ClientData/FunctionInfo.h"
+
+namespace orbit_client_data {
+
+TEST(FunctionAddressIndex, Empty) {
+  FunctionAddressIndex index{{}};
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_EQ(index.FindFunctionByExactAddress(0), nullptr);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x1000), nullptr);
+}
+
+TEST(FunctionAddressIndex, FindsFunctions) {
+  FunctionInfo foo{"/path/to/module", "buildid", 0x1000, 0x10, "foo()"};
+  FunctionInfo bar{"/path/to/module", "buildid", 0x1010, 0x20, "bar()"};
+  FunctionInfo baz{"/path/to/module", "buildid", 0x2000, 0x8, "baz()"};
+  FunctionAddressIndex index{{&foo, &bar, &baz}};
+  EXPECT_EQ(index.size(), 3);
+
+  EXPECT_EQ(index.FindFunctionByExactAddress(0x1000), &foo);
+  EXPECT_EQ(index.FindFunctionByExactAddress(0x1010), &bar);
+  EXPECT_EQ(index.FindFunctionByExactAddress(0x2000), &baz);
+  EXPECT_EQ(index.FindFunctionByExactAddress(0x1001), nullptr);
+  EXPECT_EQ(index.FindFunctionByExactAddress(0x3000), nullptr);
+
+  EXPECT_EQ(index.FindFunctionContainingAddress(0xfff), nullptr);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x1000), &foo);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x100f), &foo);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x1010), &bar);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x1030), &bar);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x1031), nullptr);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x2004), &baz);
+  EXPECT_EQ(index.FindFunctionContainingAddress(0x2009), nullptr);
+}
+
+TEST(FunctionAddressIndex, AgreesWithMapLookup) {
+  std::vector<FunctionInfo> function_infos;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    // Gaps between some of the functions.
+    function_infos.emplace_back("/path/to/module", "buildid", 0x1000 + i * 0x40,
+                                0x20 + (i % 3) * 0x10, "function");
+  }
+  std::map<uint64_t, const FunctionInfo*> functions_by_address;
+  std::vector<const FunctionInfo*> functions;
+  for (const FunctionInfo& function_info : function_infos) {
+    functions_by_address.emplace(function_info.address(), &function_info);
+    functions.push_back(&function_info);
+  }
+  FunctionAddressIndex index{functions};
+
+  for (uint64_t address = 0xf00; address < 0x1000 + 1000 * 0x40 + 0x100; address += 7) {
+    const FunctionInfo* expected = nullptr;
+    auto it = functions_by_address.upper_bound(address);
+    if (it != functions_by_address.begin()) {
+      --it;
+      if (it->second->address() + it->second->size() >= address) expected = it->second;
+    }
+    EXPECT_EQ(index.FindFunctionContainingAddress(address), expected) << address;
+  }
+}
+
+}  // namespace orbit_client_data
@@ -4,6 +4,8 @@
 
 #include "ClientData/ModuleAndFunctionLookup.h"
 
+#include <algorithm>
+
 #include "ClientData/CaptureData.h"
 #include "ClientData/LinuxAddressInfo.h"
 #include "ModuleUtils/VirtualAndAbsoluteAddresses.h"
@@ -149,6 +151,84 @@ const FunctionInfo* FindFunctionByAddress(const ProcessData& process,
   return module->FindFunctionByVirtualAddress(virtual_address, is_exact);
 }
 
+std::vector<SymbolizedAddress> SymbolizeAddresses(const ModuleManager& module_manager,
+                                                  const CaptureData& capture_data,
+                                                  absl::Span<const uint64_t> absolute_addresses) {
+  std::vector<uint64_t> sorted_addresses(absolute_addresses.begin(), absolute_addresses.end());
+  std::sort(sorted_addresses.begin(), sorted_addresses.end());
+  sorted_addresses.erase(std::unique(sorted_addresses.begin(), sorted_addresses.end()),
+                         sorted_addresses.end());
+
+  const ProcessData& process = *capture_data.process();
+  std::vector<SymbolizedAddress> sorted_results;
+  sorted_results.reserve(sorted_addresses.size());
+  // The module containing the previous address, which is likely to also contain the current one.
+  std::optional<ModuleInMemory> module_in_memory;
+  const ModuleData* module = nullptr;
+  const std::string* module_path = nullptr;
+  const std::string* module_build_id = nullptr;
+  uint64_t load_bias = 0;
+  uint64_t executable_segment_offset = 0;
+
+  for (uint64_t absolute_address : sorted_addresses) {
+    if (!module_in_memory.has_value() || absolute_address >= module_in_memory->end()) {
+      module = nullptr;
+      ErrorMessageOr<ModuleInMemory> module_or_error =
+          process.FindModuleByAddress(absolute_address);
+      if (module_or_error.has_value()) {
+        module_in_memory.emplace(std::move(module_or_error.value()));
+      } else {
+        module_in_memory.reset();
+      }
+    }
+    if (module_in_memory.has_value() && module == nullptr) {
+      // Can fail for the first addresses of a module and succeed for the following ones.
+      module = module_manager.GetModuleByModuleInMemoryAndAbsoluteAddress(*module_in_memory,
+                                                                          absolute_address);
+      if (module != nullptr) {
+        module_path = &module->file_path();
+        module_build_id = &module->build_id();
+        load_bias = module->load_bias();
+        executable_segment_offset = module->executable_segment_offset();
+      }
+    }
+
+    SymbolizedAddress& result = sorted_results.emplace_back();
+    const FunctionInfo* function = nullptr;
+    if (module != nullptr) {
+      result.module_path = module_path;
+      result.module_build_id = module_build_id;
+      const uint64_t virtual_address = orbit_module_utils::SymbolAbsoluteAddressToVirtualAddress(
+          absolute_address, module_in_memory->start(), load_bias, executable_segment_offset);
+      function = module->FindFunctionByVirtualAddress(virtual_address, /*is_exact=*/false);
+    }
+    if (function != nullptr) {
+      result.function_absolute_address = orbit_module_utils::SymbolVirtualAddressToAbsoluteAddress(
+          function->address(), module_in_memory->start(), load_bias, executable_segment_offset);
+      result.function_name = &function->pretty_name();
+      continue;
+    }
+
+    const LinuxAddressInfo* address_info = capture_data.GetAddressInfo(absolute_address);
+    if (address_info == nullptr) continue;
+    result.function_absolute_address = absolute_address - address_info->offset_in_function();
+    if (!address_info->function_name().empty()) {
+      result.function_name = &address_info->function_name();
+    }
+    if (module == nullptr && !address_info->module_path().empty()) {
+      result.module_path = &address_info->module_path();
+    }
+  }
+
+  std::vector<SymbolizedAddress> results;
+  results.reserve(absolute_addresses.size());
+  for (uint64_t absolute_address : absolute_addresses) {
+    auto it = std::lower_bound(sorted_addresses.begin(), sorted_addresses.end(), absolute_address);
+    results.push_back(sorted_results[it - sorted_addresses.begin()]);
+  }
+  return results;
+}
+
 [[nodiscard]] const ModuleData* FindModuleByAddress(const ProcessData& process,
                                                     const ModuleManager& module_manager,
                                                     uint64_t absolute_address) {
@@ -2,15 +2,24 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/str_format.h>
 #include <gtest/gtest.h>
 #include <stdint.h>
 
+#include <filesystem>
+#include <vector>
+
+#include "ClientData/CaptureData.h"
+#include "ClientData/LinuxAddressInfo.h"
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientData/ModuleManager.h"
+#include "GrpcProtos/capture.pb.h"
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/symbol.pb.h"
 #include "SymbolProvider/ModuleIdentifier.h"
 
+using orbit_grpc_protos::CaptureStarted;
 using orbit_grpc_protos::ModuleInfo;
 using orbit_grpc_protos::ModuleSymbols;
 using orbit_grpc_protos::SymbolInfo;
@@ -55,4 +64,78 @@ TEST(ModuleAndFunctionLookup, FindFunctionByModulePathBuildIdAndVirtualAddress)
   EXPECT_EQ(function_info->address(), kFunctionVirtualAddress);
 }
 
+TEST(ModuleAndFunctionLookup, SymbolizeAddressesAgreesWithSingleAddressLookups) {
+  constexpr const char* kModuleFilePath = "/path/to/module";
+  constexpr const char* kModuleBuildId = "build_id";
+  constexpr uint64_t kModuleStart = 0x40000;
+  constexpr uint64_t kModuleEnd = 0x50000;
+  constexpr const char* kOtherModuleFilePath = "/path/to/other_module";
+
+  ModuleInfo module_info;
+  module_info.set_file_path(kModuleFilePath);
+  module_info.set_build_id(kModuleBuildId);
+  module_info.set_load_bias(0x1000);
+  module_info.set_executable_segment_offset(0x1000);
+  module_info.set_address_start(kModuleStart);
+  module_info.set_address_end(kModuleEnd);
+
+  ModuleManager module_manager;
+  std::ignore = module_manager.AddOrUpdateModules({module_info});
+  ModuleSymbols module_symbols;
+  for (uint64_t virtual_address : {0x2000, 0x2100, 0x3000}) {
+    SymbolInfo* symbol_info = module_symbols.add_symbol_infos();
+    symbol_info->set_demangled_name(absl::StrFormat("function_at_%#x()", virtual_address));
+    symbol_info->set_address(virtual_address);
+    symbol_info->set_size(0x80);
+  }
+  module_manager.GetMutableModuleByModuleIdentifier({kModuleFilePath, kModuleBuildId})
+      ->AddSymbols(module_symbols);
+
+  CaptureData capture_data{CaptureStarted{}, std::filesystem::path{},
+                           absl::flat_hash_set<uint64_t>{}, CaptureData::DataSource::kLiveCapture};
+  capture_data.mutable_process()->AddOrUpdateModuleInfo(module_info);
+  capture_data.InsertAddressInfo(
+      LinuxAddressInfo{0x60010, 0x10, kOtherModuleFilePath, "function_in_other_module()"});
+  capture_data.InsertAddressInfo(LinuxAddressInfo{0x60020, 0x20, "", ""});
+
+  // Unsorted, with duplicates, and covering functions, gaps between functions, other modules and
+  // unknown addresses.
+  const std::vector<uint64_t> absolute_addresses{
+      0x41100, 0x60010, 0x41010, 0x42008, 0x41010, 0x30000, 0x60020, 0x41110, 0x41090, 0x41000,
+      0x42100, 0x70000, 0x41100};
+  std::vector<SymbolizedAddress> symbolized_addresses =
+      SymbolizeAddresses(module_manager, capture_data, absolute_addresses);
+  ASSERT_EQ(symbolized_addresses.size(), absolute_addresses.size());
+
+  bool found_function_in_module = false;
+  for (size_t i = 0; i < absolute_addresses.size(); ++i) {
+    const uint64_t absolute_address = absolute_addresses[i];
+    const SymbolizedAddress& symbolized_address = symbolized_addresses[i];
+    EXPECT_EQ(symbolized_address.function_absolute_address,
+              FindFunctionAbsoluteAddressByInstructionAbsoluteAddress(module_manager, capture_data,
+                                                                      absolute_address));
+    EXPECT_EQ(*symbolized_address.function_name,
+              GetFunctionNameByAddress(module_manager, capture_data, absolute_address));
+    const auto& [module_path, module_build_id] =
+        FindModulePathAndBuildIdByAddress(module_manager, capture_data, absolute_address);
+    EXPECT_EQ(*symbolized_address.module_path, module_path);
+    if (module_build_id.has_value()) {
+      ASSERT_NE(symbolized_address.module_build_id, nullptr);
+      EXPECT_EQ(*symbolized_address.module_build_id, module_build_id.value());
+    } else {
+      EXPECT_EQ(symbolized_address.module_build_id, nullptr);
+    }
+    if (*symbolized_address.module_path == kModuleFilePath &&
+        *symbolized_address.function_name != kUnknownFunctionOrModuleName) {
+      found_function_in_module = true;
+    }
+  }
+  EXPECT_TRUE(found_function_in_module);
+  EXPECT_EQ(*symbolized_addresses[1].function_name, "function_in_other_module()");
+  EXPECT_EQ(symbolized_addresses[1].function_absolute_address, 0x60000);
+  EXPECT_EQ(*symbolized_addresses[1].module_path, kOtherModuleFilePath);
+  EXPECT_EQ(*symbolized_addresses[11].function_name, kUnknownFunctionOrModuleName);
+  EXPECT_EQ(symbolized_addresses[11].function_absolute_address, std::nullopt);
+}
+
 }  // namespace orbit_client_data
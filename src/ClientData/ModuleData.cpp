@@ -135,9 +135,10 @@ bool ModuleData::UpdateIfChangedAndUnload(ModuleInfo new_module_info) {
 
   ORBIT_LOG("Module %s contained symbols. Because the module changed, those are now removed.",
             module_info_.file_path());
-  functions_.clear();
+  RetireFunctions();
   hash_to_function_map_.clear();
   loaded_symbols_completeness_ = SymbolCompleteness::kNoSymbols;
+  PublishFunctionAddressIndex();
 
   return true;
 }
@@ -162,24 +163,11 @@ bool ModuleData::UpdateIfChangedAndNotLoaded(orbit_grpc_protos::ModuleInfo new_m
 
 const FunctionInfo* ModuleData::FindFunctionByVirtualAddress(uint64_t virtual_address,
                                                              bool is_exact) const {
-  absl::MutexLock lock(&mutex_);
-  if (functions_.empty()) return nullptr;
-
-  if (is_exact) {
-    auto it = functions_.find(virtual_address);
-    return (it != functions_.end()) ? it->second.get() : nullptr;
-  }
+  const FunctionAddressIndex* index = function_address_index_.load(std::memory_order_acquire);
+  if (index == nullptr) return nullptr;
 
-  auto it = functions_.upper_bound(virtual_address);
-  if (it == functions_.begin()) return nullptr;
-
-  --it;
-  FunctionInfo* function = it->second.get();
-  ORBIT_CHECK(function->address() <= virtual_address);
-
-  if (function->address() + function->size() < virtual_address) return nullptr;
-
-  return function;
+  if (is_exact) return index->FindFunctionByExactAddress(virtual_address);
+  return index->FindFunctionContainingAddress(virtual_address);
 }
 
 const FunctionInfo* ModuleData::FindFunctionFromHash(uint64_t hash) const {
@@ -219,64 +207,106 @@ bool ModuleData::AreAtLeastFallbackSymbolsLoaded() const {
 }
 
 void ModuleData::AddSymbols(const orbit_grpc_protos::ModuleSymbols& module_symbols) {
-  absl::MutexLock lock(&mutex_);
-  AddSymbolsInternal(module_symbols, SymbolCompleteness::kDebugSymbols);
+  SymbolsBuilder builder{module_id()};
+  builder.AddSymbols(module_symbols);
+  AddSymbols(std::move(builder));
 }
 
 void ModuleData::AddFallbackSymbols(const orbit_grpc_protos::ModuleSymbols& module_symbols) {
-  absl::MutexLock lock(&mutex_);
-  AddSymbolsInternal(module_symbols, SymbolCompleteness::kDynamicLinkingAndUnwindInfo);
+  SymbolsBuilder builder{module_id()};
+  builder.AddSymbols(module_symbols);
+  AddFallbackSymbols(std::move(builder));
 }
 
-void ModuleData::AddSymbolsInternal(const orbit_grpc_protos::ModuleSymbols& module_symbols,
-                                    ModuleData::SymbolCompleteness completeness) {
-  mutex_.AssertHeld();
-  ORBIT_CHECK(loaded_symbols_completeness_ < completeness);
-  functions_.clear();
-  hash_to_function_map_.clear();
+void ModuleData::AddSymbols(SymbolsBuilder builder) {
+  PublishSymbols(std::move(builder), SymbolCompleteness::kDebugSymbols);
+}
 
-  uint32_t address_reuse_counter = 0;
-  uint32_t name_reuse_counter = 0;
-  for (const orbit_grpc_protos::SymbolInfo& symbol_info : module_symbols.symbol_infos()) {
-    auto [inserted_it, success_functions] = functions_.try_emplace(
-        symbol_info.address(), std::make_unique<FunctionInfo>(symbol_info, module_info_.file_path(),
-                                                              module_info_.build_id()));
-    FunctionInfo* function = inserted_it->second.get();
-    // It happens that the same address has multiple symbol names associated
-    // with it. For example: (all the same address)
-    // __cxxabiv1::__enum_type_info::~__enum_type_info()
-    // __cxxabiv1::__shim_type_info::~__shim_type_info()
-    // __cxxabiv1::__array_type_info::~__array_type_info()
-    // __cxxabiv1::__class_type_info::~__class_type_info()
-    // __cxxabiv1::__pbase_type_info::~__pbase_type_info()
-    if (success_functions) {
-      ORBIT_CHECK(!function->pretty_name().empty());
-      // Be careful about the scope, the key is a string_view. This is done to avoid name
-      // duplication.
-      bool success_function_name =
-          name_to_function_info_map_.try_emplace(function->pretty_name(), function).second;
-      if (!success_function_name) {
-        name_reuse_counter++;
-      }
-
-      hash_to_function_map_.try_emplace(function->GetPrettyNameHash(), function);
-    } else {
-      address_reuse_counter++;
-    }
+void ModuleData::AddFallbackSymbols(SymbolsBuilder builder) {
+  PublishSymbols(std::move(builder), SymbolCompleteness::kDynamicLinkingAndUnwindInfo);
+}
+
+void ModuleData::SymbolsBuilder::AddSymbols(orbit_grpc_protos::ModuleSymbols module_symbols) {
+  for (orbit_grpc_protos::SymbolInfo& symbol_info : *module_symbols.mutable_symbol_infos()) {
+    AddSymbol(symbol_info.address(), symbol_info.size(),
+              std::move(*symbol_info.mutable_demangled_name()));
+  }
+}
+
+void ModuleData::SymbolsBuilder::AddSymbol(uint64_t address, uint64_t size,
+                                           std::string demangled_name) {
+  auto [inserted_it, success_functions] = functions_.try_emplace(address);
+  // It happens that the same address has multiple symbol names associated
+  // with it. For example: (all the same address)
+  // __cxxabiv1::__enum_type_info::~__enum_type_info()
+  // __cxxabiv1::__shim_type_info::~__shim_type_info()
+  // __cxxabiv1::__array_type_info::~__array_type_info()
+  // __cxxabiv1::__class_type_info::~__class_type_info()
+  // __cxxabiv1::__pbase_type_info::~__pbase_type_info()
+  if (!success_functions) {
+    address_reuse_counter_++;
+    return;
   }
-  if (address_reuse_counter != 0) {
+  inserted_it->second = std::make_unique<FunctionInfo>(
+      module_id_.file_path, module_id_.build_id, address, size, std::move(demangled_name));
+  FunctionInfo* function = inserted_it->second.get();
+
+  ORBIT_CHECK(!function->pretty_name().empty());
+  // Be careful about the scope, the key is a string_view. This is done to avoid name
+  // duplication.
+  bool success_function_name =
+      name_to_function_info_map_.try_emplace(function->pretty_name(), function).second;
+  if (!success_function_name) {
+    name_reuse_counter_++;
+  }
+
+  hash_to_function_map_.try_emplace(function->GetPrettyNameHash(), function);
+}
+
+void ModuleData::PublishSymbols(SymbolsBuilder builder, SymbolCompleteness completeness) {
+  {
+    absl::MutexLock lock(&mutex_);
+    ORBIT_CHECK(loaded_symbols_completeness_ < completeness);
+    ORBIT_CHECK(builder.module_id_.file_path == module_info_.file_path());
+    ORBIT_CHECK(builder.module_id_.build_id == module_info_.build_id());
+    RetireFunctions();
+    functions_ = std::move(builder.functions_);
+    // The previous maps end up in `builder`, and are destroyed after releasing the mutex.
+    std::swap(name_to_function_info_map_, builder.name_to_function_info_map_);
+    std::swap(hash_to_function_map_, builder.hash_to_function_map_);
+    loaded_symbols_completeness_ = completeness;
+    PublishFunctionAddressIndex();
+  }
+
+  if (builder.address_reuse_counter_ != 0) {
     ORBIT_LOG("Warning: %d absolute addresses are used by more than one symbol for \"%s\"",
-              address_reuse_counter, module_info_.name());
+              builder.address_reuse_counter_, builder.module_id_.file_path);
   }
-  if (name_reuse_counter != 0) {
+  if (builder.name_reuse_counter_ != 0) {
     ORBIT_LOG(
         "Warning: %d function name collisions happened (functions with the same demangled name) "
         "for \"%s\". This is currently not supported by presets, since presets are based on the "
         "demangled name.",
-        name_reuse_counter, module_info_.name());
+        builder.name_reuse_counter_, builder.module_id_.file_path);
   }
+}
 
-  loaded_symbols_completeness_ = completeness;
+void ModuleData::PublishFunctionAddressIndex() {
+  std::vector<const FunctionInfo*> functions;
+  functions.reserve(functions_.size());
+  for (const auto& [unused_address, function] : functions_) {
+    functions.push_back(function.get());
+  }
+  const FunctionAddressIndex* index =
+      function_address_indices_.emplace_back(std::make_unique<FunctionAddressIndex>(functions))
+          .get();
+  function_address_index_.store(index, std::memory_order_release);
+}
+
+void ModuleData::RetireFunctions() {
+  if (functions_.empty()) return;
+  retired_functions_.push_back(std::move(functions_));
+  functions_.clear();
 }
 
 }  // namespace orbit_client_data
@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "ClientData/ModuleData.h"
@@ -180,6 +181,58 @@ TEST(ModuleData, FindFunctionFromHash) {
   }
 }
 
+TEST(ModuleData, SymbolsBuilderAddsSymbolsInChunks) {
+  constexpr const char* kModuleFilePath = "/test/file/path";
+  constexpr const char* kBuildId = "build_id";
+  ModuleInfo module_info{};
+  module_info.set_file_path(kModuleFilePath);
+  module_info.set_build_id(kBuildId);
+
+  ModuleSymbols first_chunk;
+  SymbolInfo* symbol = first_chunk.add_symbol_infos();
+  symbol->set_demangled_name("foo()");
+  symbol->set_address(0x1000);
+  symbol->set_size(0x10);
+  ModuleSymbols second_chunk;
+  symbol = second_chunk.add_symbol_infos();
+  symbol->set_demangled_name("bar()");
+  symbol->set_address(0x2000);
+  symbol->set_size(0x20);
+  // Same address as foo(), ignored.
+  symbol = second_chunk.add_symbol_infos();
+  symbol->set_demangled_name("foo_alias()");
+  symbol->set_address(0x1000);
+  symbol->set_size(0x10);
+
+  ModuleData::SymbolsBuilder builder{{kModuleFilePath, kBuildId}};
+  builder.AddSymbols(first_chunk);
+  builder.AddSymbols(second_chunk);
+  builder.AddSymbol(0x3000, 0x8, "baz()");
+  EXPECT_EQ(builder.GetFunctionCount(), 3);
+
+  ModuleData module{module_info};
+  module.AddSymbols(std::move(builder));
+  EXPECT_EQ(module.GetLoadedSymbolsCompleteness(), ModuleData::SymbolCompleteness::kDebugSymbols);
+  ASSERT_EQ(module.GetFunctions().size(), 3);
+
+  const FunctionInfo* foo = module.FindFunctionByVirtualAddress(0x1000, true);
+  ASSERT_NE(foo, nullptr);
+  EXPECT_EQ(foo->pretty_name(), "foo()");
+  EXPECT_EQ(foo->module_path(), kModuleFilePath);
+  EXPECT_EQ(foo->module_build_id(), kBuildId);
+  EXPECT_EQ(module.FindFunctionByVirtualAddress(0x2010, false),
+            module.FindFunctionFromPrettyName("bar()"));
+  const FunctionInfo* baz = module.FindFunctionFromPrettyName("baz()");
+  ASSERT_NE(baz, nullptr);
+  EXPECT_EQ(module.FindFunctionFromHash(baz->GetPrettyNameHash()), baz);
+  EXPECT_EQ(module.FindFunctionFromPrettyName("foo_alias()"), nullptr);
+
+  // Symbols built for a different module are rejected.
+  ModuleData other_module{ModuleInfo{}};
+  EXPECT_DEATH(other_module.AddSymbols(ModuleData::SymbolsBuilder{{kModuleFilePath, kBuildId}}),
+               "Check failed");
+}
+
 TEST(ModuleData, UpdateIfChangedAndUnload) {
   constexpr const char* kName = "Example Name";
   constexpr const char* kFilePath = "/test/file/path";
@@ -261,6 +314,36 @@ TEST(ModuleData, UpdateIfChangedAndUnload) {
   EXPECT_DEATH((void)module.UpdateIfChangedAndUnload(module_info), "Check failed");
 }
 
+TEST(ModuleData, FunctionsStayAliveAfterSymbolsChange) {
+  ModuleInfo module_info{};
+  module_info.set_file_path("/test/file/path");
+  ModuleData module{module_info};
+
+  ModuleSymbols fallback_symbols;
+  SymbolInfo* symbol_info = fallback_symbols.add_symbol_infos();
+  symbol_info->set_demangled_name("fallback_name");
+  symbol_info->set_address(0x1000);
+  symbol_info->set_size(0x100);
+  module.AddFallbackSymbols(fallback_symbols);
+  const FunctionInfo* fallback_function = module.FindFunctionByVirtualAddress(0x1010, false);
+  ASSERT_NE(fallback_function, nullptr);
+
+  ModuleSymbols debug_symbols = fallback_symbols;
+  debug_symbols.mutable_symbol_infos(0)->set_demangled_name("debug_name");
+  module.AddSymbols(debug_symbols);
+  const FunctionInfo* debug_function = module.FindFunctionByVirtualAddress(0x1010, false);
+  ASSERT_NE(debug_function, nullptr);
+  EXPECT_EQ(debug_function->pretty_name(), "debug_name");
+
+  module_info.set_file_size(1);
+  EXPECT_TRUE(module.UpdateIfChangedAndUnload(module_info));
+  EXPECT_EQ(module.FindFunctionByVirtualAddress(0x1010, false), nullptr);
+
+  // A reader that found these functions before the symbols changed can still use them.
+  EXPECT_EQ(fallback_function->pretty_name(), "fallback_name");
+  EXPECT_EQ(debug_function->pretty_name(), "debug_name");
+}
+
 TEST(ModuleData, UpdateIfChangedAndNotLoaded) {
   constexpr const char* kName = "Example Name";
   constexpr const char* kFilePath = "/test/file/path";
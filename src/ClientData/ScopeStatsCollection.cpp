@@ -5,6 +5,8 @@
 
 #include "ClientData/ScopeStatsCollection.h"
 
+#include <utility>
+
 #include "OrbitBase/Logging.h"
 
 namespace orbit_client_data {
@@ -13,22 +15,26 @@ static const ScopeStats kDefaultScopeStats;
 
 ScopeStatsCollection::ScopeStatsCollection(ScopeIdProvider& scope_id_provider,
                                            const std::vector<const TimerInfo*>& timers) {
+  absl::flat_hash_map<ScopeId, std::vector<const TimerInfo*>> scope_id_to_timers;
   for (const TimerInfo* timer : timers) {
     std::optional<ScopeId> scope_id = scope_id_provider.ProvideId(*timer);
     if (scope_id.has_value()) {
       UpdateScopeStats(scope_id.value(), *timer);
+      scope_id_to_timers[scope_id.value()].push_back(timer);
     }
   }
 
   OnCaptureComplete();
+  SetTimersByScopeId(std::move(scope_id_to_timers));
 }
 
 void ScopeStatsCollection::UpdateScopeStats(ScopeId scope_id, const TimerInfo& timer) {
   ScopeStats& stats = scope_stats_[scope_id];
   const uint64_t elapsed_nanos = timer.end() - timer.start();
   stats.UpdateStats(elapsed_nanos);
-  scope_id_to_timer_durations_[scope_id].push_back(elapsed_nanos);
-  timer_durations_are_sorted_ = false;
+  scope_id_to_timer_index_[scope_id].AddTimer(timer.start(), timer.end());
+  timer_indices_are_built_ = false;
+  timers_are_set_ = false;
 }
 
 void ScopeStatsCollection::SetScopeStats(ScopeId scope_id, const ScopeStats stats) {
@@ -51,26 +57,71 @@ const ScopeStats& ScopeStatsCollection::GetScopeStatsOrDefault(ScopeId scope_id)
 
 const std::vector<uint64_t>* ScopeStatsCollection::GetSortedTimerDurationsForScopeId(
     ScopeId scope_id) {
-  if (!timer_durations_are_sorted_) {
+  const ScopeTimerIndex* timer_index = GetTimerIndexForScopeId(scope_id);
+  if (timer_index == nullptr) return nullptr;
+  return &timer_index->GetSortedDurations();
+}
+
+const ScopeTimerIndex* ScopeStatsCollection::GetTimerIndexForScopeId(ScopeId scope_id) const {
+  if (!timer_indices_are_built_) {
     ORBIT_ERROR(
-        "Calling GetSortedTimerDurationsForScopeId on unsorted timers. Must call OnDataChanged() "
-        "first.");
+        "Calling GetTimerIndexForScopeId on timer indices not built yet. Must call "
+        "OnCaptureComplete() first.");
     return nullptr;
   }
-  if (const auto durations_it = scope_id_to_timer_durations_.find(scope_id);
-      durations_it != scope_id_to_timer_durations_.end()) {
-    return &durations_it->second;
+  if (const auto timer_index_it = scope_id_to_timer_index_.find(scope_id);
+      timer_index_it != scope_id_to_timer_index_.end()) {
+    return &timer_index_it->second;
   }
   return nullptr;
 }
 
+std::vector<const TimerInfo*> ScopeStatsCollection::GetTimersForScopeId(ScopeId scope_id,
+                                                                       uint64_t min_tick,
+                                                                       uint64_t max_tick) const {
+  ORBIT_CHECK(timers_are_set_);
+  if (const auto timer_index_it = scope_id_to_timer_index_.find(scope_id);
+      timer_index_it != scope_id_to_timer_index_.end()) {
+    return timer_index_it->second.GetTimersInTimeRange(min_tick, max_tick);
+  }
+  return {};
+}
+
+void ScopeStatsCollection::SetTimers(ScopeIdProvider& scope_id_provider,
+                                     const std::vector<const TimerInfo*>& timers) {
+  absl::flat_hash_map<ScopeId, std::vector<const TimerInfo*>> scope_id_to_timers;
+  for (const TimerInfo* timer : timers) {
+    std::optional<ScopeId> scope_id = scope_id_provider.ProvideId(*timer);
+    if (scope_id.has_value()) scope_id_to_timers[scope_id.value()].push_back(timer);
+  }
+  SetTimersByScopeId(std::move(scope_id_to_timers));
+}
+
+void ScopeStatsCollection::SetTimersByScopeId(
+    absl::flat_hash_map<ScopeId, std::vector<const TimerInfo*>> scope_id_to_timers) {
+  for (auto& [scope_id, timer_index] : scope_id_to_timer_index_) {
+    auto timers_it = scope_id_to_timers.find(scope_id);
+    if (timers_it == scope_id_to_timers.end()) {
+      timer_index.SetTimers({});
+    } else {
+      timer_index.SetTimers(std::move(timers_it->second));
+      scope_id_to_timers.erase(timers_it);
+    }
+  }
+  // Scopes whose stats were not updated with these timers still get their timers looked up.
+  for (auto& [scope_id, scope_timers] : scope_id_to_timers) {
+    scope_id_to_timer_index_[scope_id].SetTimers(std::move(scope_timers));
+  }
+  timers_are_set_ = true;
+}
+
 void ScopeStatsCollection::OnCaptureComplete() {
-  if (timer_durations_are_sorted_) return;
+  if (timer_indices_are_built_) return;
 
-  for (auto& [unused_id, timer_durations] : scope_id_to_timer_durations_) {
-    absl::c_sort(timer_durations);
+  for (auto& [unused_id, timer_index] : scope_id_to_timer_index_) {
+    timer_index.Build();
   }
-  timer_durations_are_sorted_ = true;
+  timer_indices_are_built_ = true;
 }
 
 }  // namespace orbit_client_data
\ No newline at end of file
@@ -82,6 +82,7 @@ TEST(ScopeStatsCollectionTest, AddTimersWithUpdateStats) {
 
   const auto* timer_durations = collection.GetSortedTimerDurationsForScopeId(kScopeId1);
   EXPECT_THAT(timer_durations, IsNull());
+  EXPECT_FALSE(collection.AreTimersSet());
   collection.OnCaptureComplete();
   timer_durations = collection.GetSortedTimerDurationsForScopeId(kScopeId1);
   EXPECT_THAT(*timer_durations, ElementsAre(kOrderedDiffs[0], kOrderedDiffs[1], kOrderedDiffs[2]));
@@ -105,6 +106,48 @@ TEST(ScopeStatsCollectionTest, CreateWithTimers) {
   ExpectStatsAreEqual(collection.GetScopeStatsOrDefault(kScopeId1), kScope1Stats);
   const auto* timer_durations = collection.GetSortedTimerDurationsForScopeId(kScopeId1);
   EXPECT_THAT(*timer_durations, ElementsAre(kOrderedDiffs[0], kOrderedDiffs[1], kOrderedDiffs[2]));
+
+  ASSERT_TRUE(collection.AreTimersSet());
+  EXPECT_THAT(collection.GetTimersForScopeId(kScopeId1, kStarts[1], kEnds[2]),
+              ElementsAre(&kTimersScopeId1[1], &kTimersScopeId1[2]));
+  EXPECT_THAT(collection.GetTimersForScopeId(kScopeId2, 0, 1000), ElementsAre(&kTimerScopeId2));
+}
+
+TEST(ScopeStatsCollectionTest, SetTimers) {
+  ScopeStatsCollection collection = ScopeStatsCollection();
+  for (TimerInfo timer : kTimersScopeId1) {
+    collection.UpdateScopeStats(kScopeId1, timer);
+  }
+  collection.OnCaptureComplete();
+
+  MockScopeIdProvider mock_scope_id_provider;
+  EXPECT_CALL(mock_scope_id_provider, ProvideId).WillRepeatedly(Return(kScopeId1));
+  collection.SetTimers(mock_scope_id_provider,
+                       {&kTimersScopeId1[2], &kTimersScopeId1[0], &kTimersScopeId1[1]});
+  ASSERT_TRUE(collection.AreTimersSet());
+  EXPECT_THAT(collection.GetTimersForScopeId(kScopeId1, 0, kStarts[1]),
+              ElementsAre(&kTimersScopeId1[0], &kTimersScopeId1[1]));
+  EXPECT_THAT(collection.GetTimersForScopeId(kScopeId2, 0, kStarts[1]), ElementsAre());
+
+  collection.UpdateScopeStats(kScopeId2, kTimerScopeId2);
+  EXPECT_FALSE(collection.AreTimersSet());
+}
+
+TEST(ScopeStatsCollectionTest, IndexesTimersOnCaptureComplete) {
+  ScopeStatsCollection collection = ScopeStatsCollection();
+  for (TimerInfo timer : kTimersScopeId1) {
+    collection.UpdateScopeStats(kScopeId1, timer);
+  }
+  EXPECT_THAT(collection.GetTimerIndexForScopeId(kScopeId1), IsNull());
+  collection.OnCaptureComplete();
+  EXPECT_THAT(collection.GetTimerIndexForScopeId(kScopeId2), IsNull());
+
+  const ScopeTimerIndex* timer_index = collection.GetTimerIndexForScopeId(kScopeId1);
+  ASSERT_NE(timer_index, nullptr);
+  EXPECT_EQ(timer_index->GetTimerCount(), kNumTimers);
+  EXPECT_EQ(timer_index->CountTimersInTimeRange(kStarts[1], kStarts[2]), 2);
+  EXPECT_EQ(timer_index->FindDurationPercentileInTimeRange(kStarts[0], kStarts[2], 50),
+            kOrderedDiffs[1]);
 }
 
-}  // namespace orbit_client_data
\ No newline at end of file
+}  // namespace orbit_client_data
@@ -0,0 +1,293 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/ScopeTimerIndex.h"
+
+#include <absl/algorithm/container.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+ScopeTimerIndex::RankedBitVector::RankedBitVector(size_t size) : words_((size + 63) / 64) {}
+
+void ScopeTimerIndex::RankedBitVector::BuildRanks() {
+  ones_before_word_.resize(words_.size() + 1);
+  ones_before_word_[0] = 0;
+  for (size_t i = 0; i < words_.size(); ++i) {
+    ones_before_word_[i + 1] = ones_before_word_[i] + __builtin_popcountll(words_[i]);
+  }
+}
+
+size_t ScopeTimerIndex::RankedBitVector::RankOfOnes(size_t index) const {
+  const size_t word_index = index / 64;
+  const size_t bit_index = index % 64;
+  size_t rank = ones_before_word_[word_index];
+  if (bit_index != 0) {
+    rank += __builtin_popcountll(words_[word_index] & ((uint64_t{1} << bit_index) - 1));
+  }
+  return rank;
+}
+
+void ScopeTimerIndex::AddTimer(uint64_t start_ns, uint64_t end_ns) {
+  if (is_built_) {
+    // Recover the durations, in start order, that were dropped when building the index.
+    durations_.resize(starts_.size());
+    for (size_t i = 0; i < starts_.size(); ++i) {
+      durations_[i] = duration_prefix_sums_[i + 1] - duration_prefix_sums_[i];
+    }
+  }
+  starts_.push_back(start_ns);
+  durations_.push_back(end_ns - start_ns);
+  is_built_ = false;
+}
+
+void ScopeTimerIndex::Build() {
+  if (is_built_) return;
+  const size_t timer_count = starts_.size();
+
+  std::vector<size_t> positions(timer_count);
+  std::iota(positions.begin(), positions.end(), 0);
+  absl::c_stable_sort(positions, [this](size_t lhs, size_t rhs) {
+    return starts_[lhs] < starts_[rhs];
+  });
+  std::vector<uint64_t> starts(timer_count);
+  std::vector<uint64_t> durations(timer_count);
+  for (size_t i = 0; i < timer_count; ++i) {
+    starts[i] = starts_[positions[i]];
+    durations[i] = durations_[positions[i]];
+  }
+  starts_ = std::move(starts);
+  durations_ = std::move(durations);
+
+  // Ties between equal durations are broken by position, so that each timer has its own rank.
+  std::iota(positions.begin(), positions.end(), 0);
+  absl::c_stable_sort(positions, [this](size_t lhs, size_t rhs) {
+    return durations_[lhs] < durations_[rhs];
+  });
+  std::vector<size_t> ranks(timer_count);
+  sorted_durations_.resize(timer_count);
+  for (size_t rank = 0; rank < timer_count; ++rank) {
+    ranks[positions[rank]] = rank;
+    sorted_durations_[rank] = durations_[positions[rank]];
+  }
+
+  duration_prefix_sums_.resize(timer_count + 1);
+  duration_prefix_sums_[0] = 0;
+  for (size_t i = 0; i < timer_count; ++i) {
+    duration_prefix_sums_[i + 1] = duration_prefix_sums_[i] + durations_[i];
+  }
+  mean_duration_ns_ = timer_count == 0 ? 0
+                                       : static_cast<double>(duration_prefix_sums_[timer_count]) /
+                                             static_cast<double>(timer_count);
+  squared_deviation_prefix_sums_.resize(timer_count + 1);
+  squared_deviation_prefix_sums_[0] = 0;
+  for (size_t i = 0; i < timer_count; ++i) {
+    const double deviation = static_cast<double>(durations_[i]) - mean_duration_ns_;
+    squared_deviation_prefix_sums_[i + 1] =
+        squared_deviation_prefix_sums_[i] + deviation * deviation;
+  }
+
+  size_t level_count = 0;
+  while ((size_t{1} << level_count) < timer_count) ++level_count;
+  rank_bits_per_level_.clear();
+  zeros_per_level_.clear();
+  std::vector<size_t> ranks_with_zero_bit;
+  std::vector<size_t> ranks_with_one_bit;
+  for (size_t level = 0; level < level_count; ++level) {
+    const size_t shift = level_count - 1 - level;
+    RankedBitVector& bits = rank_bits_per_level_.emplace_back(timer_count);
+    ranks_with_zero_bit.clear();
+    ranks_with_one_bit.clear();
+    for (size_t i = 0; i < timer_count; ++i) {
+      if (((ranks[i] >> shift) & 1) != 0) {
+        bits.Set(i);
+        ranks_with_one_bit.push_back(ranks[i]);
+      } else {
+        ranks_with_zero_bit.push_back(ranks[i]);
+      }
+    }
+    bits.BuildRanks();
+    zeros_per_level_.push_back(ranks_with_zero_bit.size());
+    absl::c_copy(ranks_with_zero_bit, ranks.begin());
+    absl::c_copy(ranks_with_one_bit, ranks.begin() + ranks_with_zero_bit.size());
+  }
+
+  durations_.clear();
+  durations_.shrink_to_fit();
+  is_built_ = true;
+}
+
+void ScopeTimerIndex::SetTimers(std::vector<const orbit_client_protos::TimerInfo*> timers) {
+  absl::c_stable_sort(timers, [](const orbit_client_protos::TimerInfo* lhs,
+                                 const orbit_client_protos::TimerInfo* rhs) {
+    return lhs->start() < rhs->start();
+  });
+  max_timer_duration_ns_ = 0;
+  for (const orbit_client_protos::TimerInfo* timer : timers) {
+    max_timer_duration_ns_ = std::max(max_timer_duration_ns_, timer->end() - timer->start());
+  }
+  timers_by_start_ = std::move(timers);
+}
+
+std::vector<const orbit_client_protos::TimerInfo*> ScopeTimerIndex::GetTimersInTimeRange(
+    uint64_t min_tick, uint64_t max_tick) const {
+  // Timers of the same scope can overlap, so their ends are not ordered. But none of the timers
+  // starting before `min_tick - max_timer_duration_ns_` can reach `min_tick`.
+  const uint64_t min_start = min_tick - std::min(min_tick, max_timer_duration_ns_);
+  const auto begin = absl::c_lower_bound(
+      timers_by_start_, min_start,
+      [](const orbit_client_protos::TimerInfo* timer, uint64_t start) {
+        return timer->start() < start;
+      });
+  std::vector<const orbit_client_protos::TimerInfo*> result;
+  for (auto it = begin; it != timers_by_start_.end() && (*it)->start() <= max_tick; ++it) {
+    if ((*it)->end() >= min_tick) result.push_back(*it);
+  }
+  return result;
+}
+
+const std::vector<uint64_t>& ScopeTimerIndex::GetSortedDurations() const {
+  ORBIT_CHECK(is_built_);
+  return sorted_durations_;
+}
+
+std::pair<size_t, size_t> ScopeTimerIndex::GetPositionRange(uint64_t min_start_ns,
+                                                            uint64_t max_start_ns) const {
+  ORBIT_CHECK(is_built_);
+  if (min_start_ns > max_start_ns) return {0, 0};
+  const auto begin = std::lower_bound(starts_.begin(), starts_.end(), min_start_ns);
+  const auto end = std::upper_bound(begin, starts_.end(), max_start_ns);
+  return {begin - starts_.begin(), end - starts_.begin()};
+}
+
+size_t ScopeTimerIndex::CountRanksBelow(size_t begin, size_t end, size_t rank) const {
+  if (rank >= sorted_durations_.size()) return end - begin;
+  const size_t level_count = rank_bits_per_level_.size();
+  size_t count = 0;
+  for (size_t level = 0; level < level_count; ++level) {
+    const RankedBitVector& bits = rank_bits_per_level_[level];
+    const size_t ones_before_begin = bits.RankOfOnes(begin);
+    const size_t ones_before_end = bits.RankOfOnes(end);
+    if (((rank >> (level_count - 1 - level)) & 1) != 0) {
+      count += (end - ones_before_end) - (begin - ones_before_begin);
+      begin = zeros_per_level_[level] + ones_before_begin;
+      end = zeros_per_level_[level] + ones_before_end;
+    } else {
+      begin -= ones_before_begin;
+      end -= ones_before_end;
+    }
+  }
+  return count;
+}
+
+size_t ScopeTimerIndex::FindNthSmallestRank(size_t begin, size_t end, size_t n) const {
+  ORBIT_CHECK(n < end - begin);
+  const size_t level_count = rank_bits_per_level_.size();
+  size_t rank = 0;
+  for (size_t level = 0; level < level_count; ++level) {
+    const RankedBitVector& bits = rank_bits_per_level_[level];
+    const size_t ones_before_begin = bits.RankOfOnes(begin);
+    const size_t ones_before_end = bits.RankOfOnes(end);
+    const size_t zeros_in_range = (end - begin) - (ones_before_end - ones_before_begin);
+    if (n < zeros_in_range) {
+      begin -= ones_before_begin;
+      end -= ones_before_end;
+    } else {
+      n -= zeros_in_range;
+      rank |= size_t{1} << (level_count - 1 - level);
+      begin = zeros_per_level_[level] + ones_before_begin;
+      end = zeros_per_level_[level] + ones_before_end;
+    }
+  }
+  return rank;
+}
+
+size_t ScopeTimerIndex::CountTimersInTimeRange(uint64_t min_start_ns,
+                                               uint64_t max_start_ns) const {
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+  return end - begin;
+}
+
+ScopeStats ScopeTimerIndex::ComputeStatsInTimeRange(uint64_t min_start_ns,
+                                                    uint64_t max_start_ns) const {
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+  ScopeStats stats;
+  const size_t count = end - begin;
+  if (count == 0) return stats;
+
+  stats.set_count(count);
+  stats.set_total_time_ns(duration_prefix_sums_[end] - duration_prefix_sums_[begin]);
+  stats.set_min_ns(sorted_durations_[FindNthSmallestRank(begin, end, 0)]);
+  stats.set_max_ns(sorted_durations_[FindNthSmallestRank(begin, end, count - 1)]);
+  // The variance around the mean of the range, from the squared deviations around the mean of all
+  // timers: E[(x - mean)^2] = E[(x - global_mean)^2] - (mean - global_mean)^2.
+  const double mean = static_cast<double>(stats.total_time_ns()) / static_cast<double>(count);
+  const double mean_squared_deviation =
+      (squared_deviation_prefix_sums_[end] - squared_deviation_prefix_sums_[begin]) /
+      static_cast<double>(count);
+  const double mean_offset = mean - mean_duration_ns_;
+  stats.set_variance_ns(std::max(0.0, mean_squared_deviation - mean_offset * mean_offset));
+  return stats;
+}
+
+std::optional<uint64_t> ScopeTimerIndex::FindNthShortestDurationInTimeRange(uint64_t min_start_ns,
+                                                                           uint64_t max_start_ns,
+                                                                           size_t n) const {
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+  if (n >= end - begin) return std::nullopt;
+  return sorted_durations_[FindNthSmallestRank(begin, end, n)];
+}
+
+std::optional<uint64_t> ScopeTimerIndex::FindDurationPercentileInTimeRange(
+    uint64_t min_start_ns, uint64_t max_start_ns, double percentile) const {
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+  const size_t count = end - begin;
+  if (count == 0) return std::nullopt;
+  const double clamped_percentile = std::clamp(percentile, 0.0, 100.0);
+  const auto at_most_count =
+      static_cast<size_t>(std::ceil(clamped_percentile / 100.0 * static_cast<double>(count)));
+  const size_t n = std::min(std::max<size_t>(at_most_count, 1), count) - 1;
+  return sorted_durations_[FindNthSmallestRank(begin, end, n)];
+}
+
+size_t ScopeTimerIndex::CountDurationsInTimeRange(uint64_t min_start_ns, uint64_t max_start_ns,
+                                                  uint64_t min_duration_ns,
+                                                  uint64_t max_duration_ns) const {
+  if (min_duration_ns > max_duration_ns) return 0;
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+  const size_t min_rank =
+      absl::c_lower_bound(sorted_durations_, min_duration_ns) - sorted_durations_.begin();
+  const size_t end_rank =
+      absl::c_upper_bound(sorted_durations_, max_duration_ns) - sorted_durations_.begin();
+  return CountRanksBelow(begin, end, end_rank) - CountRanksBelow(begin, end, min_rank);
+}
+
+std::vector<size_t> ScopeTimerIndex::CountDurationsPerBinInTimeRange(
+    uint64_t min_start_ns, uint64_t max_start_ns,
+    absl::Span<const uint64_t> bin_boundaries_ns) const {
+  if (bin_boundaries_ns.size() < 2) return {};
+  ORBIT_CHECK(std::is_sorted(bin_boundaries_ns.begin(), bin_boundaries_ns.end()));
+  const auto [begin, end] = GetPositionRange(min_start_ns, max_start_ns);
+
+  std::vector<size_t> counts;
+  counts.reserve(bin_boundaries_ns.size() - 1);
+  size_t count_below_bin = CountRanksBelow(
+      begin, end,
+      absl::c_lower_bound(sorted_durations_, bin_boundaries_ns[0]) - sorted_durations_.begin());
+  for (size_t i = 1; i < bin_boundaries_ns.size(); ++i) {
+    const size_t count_below_next_bin = CountRanksBelow(
+        begin, end,
+        absl::c_lower_bound(sorted_durations_, bin_boundaries_ns[i]) - sorted_durations_.begin());
+    counts.push_back(count_below_next_bin - count_below_bin);
+    count_below_bin = count_below_next_bin;
+  }
+  return counts;
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,192 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/algorithm/container.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ClientData/ScopeStats.h"
+#include "ClientData/ScopeTimerIndex.h"
+#include "ClientProtos/capture_data.pb.h"
+
+namespace orbit_client_data {
+
+using ::testing::ElementsAre;
+using orbit_client_protos::TimerInfo;
+
+namespace {
+
+struct Timer {
+  uint64_t start;
+  uint64_t end;
+};
+
+// Visits all the timers, which is what the index saves the queries from.
+std::vector<uint64_t> GetSortedDurationsInTimeRange(const std::vector<Timer>& timers,
+                                                    uint64_t min_start, uint64_t max_start) {
+  std::vector<uint64_t> durations;
+  for (const Timer& timer : timers) {
+    if (min_start <= timer.start && timer.start <= max_start) {
+      durations.push_back(timer.end - timer.start);
+    }
+  }
+  absl::c_sort(durations);
+  return durations;
+}
+
+}  // namespace
+
+TEST(ScopeTimerIndex, IsBuiltAndEmptyByDefault) {
+  ScopeTimerIndex index;
+  EXPECT_TRUE(index.IsBuilt());
+  EXPECT_EQ(index.GetTimerCount(), 0);
+  EXPECT_TRUE(index.GetSortedDurations().empty());
+  EXPECT_EQ(index.CountTimersInTimeRange(0, 100), 0);
+  EXPECT_EQ(index.ComputeStatsInTimeRange(0, 100).count(), 0);
+  EXPECT_EQ(index.FindDurationPercentileInTimeRange(0, 100, 50), std::nullopt);
+  EXPECT_EQ(index.CountDurationsInTimeRange(0, 100, 0, 100), 0);
+}
+
+TEST(ScopeTimerIndex, NeedsToBeBuiltAfterAddingTimers) {
+  ScopeTimerIndex index;
+  index.AddTimer(1000, 1500);
+  EXPECT_FALSE(index.IsBuilt());
+  index.Build();
+  EXPECT_TRUE(index.IsBuilt());
+  index.AddTimer(200, 210);
+  EXPECT_FALSE(index.IsBuilt());
+  index.Build();
+  EXPECT_THAT(index.GetSortedDurations(), ElementsAre(10, 500));
+}
+
+TEST(ScopeTimerIndex, AnswersQueriesInTimeRange) {
+  ScopeTimerIndex index;
+  // Timers are not added in order of start.
+  index.AddTimer(6789, 9789);
+  index.AddTimer(1000, 1500);
+  index.AddTimer(2050, 2059);
+  index.AddTimer(4000, 4500);
+  index.Build();
+
+  EXPECT_THAT(index.GetSortedDurations(), ElementsAre(9, 500, 500, 3000));
+  EXPECT_EQ(index.CountTimersInTimeRange(1000, 4000), 3);
+  EXPECT_EQ(index.CountTimersInTimeRange(1001, 3999), 1);
+  EXPECT_EQ(index.CountTimersInTimeRange(4000, 1000), 0);
+
+  const ScopeStats stats = index.ComputeStatsInTimeRange(2000, 10000);
+  EXPECT_EQ(stats.count(), 3);
+  EXPECT_EQ(stats.total_time_ns(), 3509);
+  EXPECT_EQ(stats.min_ns(), 9);
+  EXPECT_EQ(stats.max_ns(), 3000);
+
+  EXPECT_EQ(index.FindNthShortestDurationInTimeRange(2000, 10000, 0), 9);
+  EXPECT_EQ(index.FindNthShortestDurationInTimeRange(2000, 10000, 2), 3000);
+  EXPECT_EQ(index.FindNthShortestDurationInTimeRange(2000, 10000, 3), std::nullopt);
+  EXPECT_EQ(index.FindDurationPercentileInTimeRange(0, 10000, 0), 9);
+  EXPECT_EQ(index.FindDurationPercentileInTimeRange(0, 10000, 50), 500);
+  EXPECT_EQ(index.FindDurationPercentileInTimeRange(0, 10000, 75.1), 3000);
+  EXPECT_EQ(index.FindDurationPercentileInTimeRange(0, 10000, 100), 3000);
+
+  EXPECT_EQ(index.CountDurationsInTimeRange(0, 10000, 500, 500), 2);
+  EXPECT_EQ(index.CountDurationsInTimeRange(0, 4000, 10, 3000), 2);
+  const std::vector<uint64_t> bin_boundaries{0, 10, 500, 501, 5000};
+  EXPECT_THAT(index.CountDurationsPerBinInTimeRange(0, 10000, bin_boundaries),
+              ElementsAre(1, 0, 2, 1));
+}
+
+TEST(ScopeTimerIndex, DurationsAreKeptWhenAddingTimersAfterBuilding) {
+  ScopeTimerIndex index;
+  index.AddTimer(4000, 4500);
+  index.AddTimer(1000, 1009);
+  index.Build();
+  index.AddTimer(2000, 5000);
+  index.Build();
+
+  EXPECT_THAT(index.GetSortedDurations(), ElementsAre(9, 500, 3000));
+  EXPECT_EQ(index.ComputeStatsInTimeRange(0, 4000).total_time_ns(), 3509);
+}
+
+TEST(ScopeTimerIndex, GetTimersInTimeRange) {
+  std::vector<TimerInfo> timers(4);
+  // A long timer that starts long before others, and nested timers.
+  timers[0].set_start(100);
+  timers[0].set_end(5000);
+  timers[1].set_start(1000);
+  timers[1].set_end(1100);
+  timers[2].set_start(1010);
+  timers[2].set_end(1020);
+  timers[3].set_start(3000);
+  timers[3].set_end(3100);
+
+  ScopeTimerIndex index;
+  EXPECT_TRUE(index.GetTimersInTimeRange(0, 10000).empty());
+  index.SetTimers({&timers[3], &timers[1], &timers[0], &timers[2]});
+
+  EXPECT_THAT(index.GetTimersInTimeRange(0, 10000),
+              ElementsAre(&timers[0], &timers[1], &timers[2], &timers[3]));
+  EXPECT_THAT(index.GetTimersInTimeRange(1050, 2000), ElementsAre(&timers[0], &timers[1]));
+  EXPECT_THAT(index.GetTimersInTimeRange(1020, 1020),
+              ElementsAre(&timers[0], &timers[1], &timers[2]));
+  EXPECT_THAT(index.GetTimersInTimeRange(5001, 10000), ElementsAre());
+  EXPECT_THAT(index.GetTimersInTimeRange(0, 99), ElementsAre());
+}
+
+TEST(ScopeTimerIndex, MatchesVisitingAllTimers) {
+  std::mt19937_64 random{42};
+  std::uniform_int_distribution<uint64_t> start_distribution{0, 100'000};
+  std::uniform_int_distribution<uint64_t> duration_distribution{0, 1'000};
+
+  ScopeTimerIndex index;
+  std::vector<Timer> timers;
+  for (size_t i = 0; i < 1'000; ++i) {
+    const uint64_t start = start_distribution(random);
+    const uint64_t end = start + duration_distribution(random);
+    index.AddTimer(start, end);
+    timers.push_back({start, end});
+  }
+  index.Build();
+
+  for (size_t query = 0; query < 100; ++query) {
+    uint64_t min_start = start_distribution(random);
+    uint64_t max_start = start_distribution(random);
+    if (min_start > max_start) std::swap(min_start, max_start);
+    const std::vector<uint64_t> durations =
+        GetSortedDurationsInTimeRange(timers, min_start, max_start);
+
+    ASSERT_EQ(index.CountTimersInTimeRange(min_start, max_start), durations.size());
+    for (size_t n = 0; n < durations.size(); n += 7) {
+      EXPECT_EQ(index.FindNthShortestDurationInTimeRange(min_start, max_start, n), durations[n]);
+    }
+
+    const ScopeStats stats = index.ComputeStatsInTimeRange(min_start, max_start);
+    ASSERT_EQ(stats.count(), durations.size());
+    if (durations.empty()) continue;
+    const uint64_t total = absl::c_accumulate(durations, uint64_t{0});
+    EXPECT_EQ(stats.total_time_ns(), total);
+    EXPECT_EQ(stats.min_ns(), durations.front());
+    EXPECT_EQ(stats.max_ns(), durations.back());
+    const double mean = static_cast<double>(total) / static_cast<double>(durations.size());
+    double squared_deviation_sum = 0;
+    for (uint64_t duration : durations) {
+      squared_deviation_sum += (static_cast<double>(duration) - mean) *
+                               (static_cast<double>(duration) - mean);
+    }
+    EXPECT_NEAR(stats.variance_ns(),
+                squared_deviation_sum / static_cast<double>(durations.size()), 1e-3);
+
+    const uint64_t min_duration = duration_distribution(random);
+    const uint64_t max_duration = min_duration + duration_distribution(random);
+    EXPECT_EQ(index.CountDurationsInTimeRange(min_start, max_start, min_duration, max_duration),
+              absl::c_upper_bound(durations, max_duration) -
+                  absl::c_lower_bound(durations, min_duration));
+  }
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,43 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ClientData/SpillFile.h"
+
+#include <absl/strings/str_format.h>
+
+#include "OrbitBase/File.h"
+
+namespace orbit_client_data {
+
+ErrorMessageOr<std::unique_ptr<SpillFile>> SpillFile::Create() {
+  OUTCOME_TRY(orbit_base::TemporaryFile file, orbit_base::TemporaryFile::Create("orbit_spill"));
+  return std::unique_ptr<SpillFile>(new SpillFile(std::move(file)));
+}
+
+ErrorMessageOr<uint64_t> SpillFile::Append(const void* data, size_t size) {
+  // Holding the lock during the write guarantees that the blocks do not overlap and that there are
+  // no holes in the file.
+  absl::MutexLock lock{&mutex_};
+  const uint64_t offset = size_;
+  OUTCOME_TRY(orbit_base::WriteFullyAtOffset(file_.fd(), data, size, offset));
+  size_ += size;
+  return offset;
+}
+
+ErrorMessageOr<void> SpillFile::Read(uint64_t offset, void* data, size_t size) const {
+  ORBIT_CHECK(offset + size <= this->size());
+  OUTCOME_TRY(size_t bytes_read, orbit_base::ReadFullyAtOffset(file_.fd(), data, size, offset));
+  if (bytes_read < size) {
+    return ErrorMessage{absl::StrFormat("Unexpected end of spill file \"%s\" at offset %u",
+                                        file_.file_path().string(), offset + bytes_read)};
+  }
+  return outcome::success();
+}
+
+uint64_t SpillFile::size() const {
+  absl::MutexLock lock{&mutex_};
+  return size_;
+}
+
+}  // namespace orbit_client_data
@@ -0,0 +1,37 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ClientData/SpillFile.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_client_data {
+
+using orbit_test_utils::HasNoError;
+using orbit_test_utils::HasValue;
+
+TEST(SpillFile, AppendAndRead) {
+  auto spill_file_or_error = SpillFile::Create();
+  ASSERT_THAT(spill_file_or_error, HasNoError());
+  std::unique_ptr<SpillFile> spill_file = std::move(spill_file_or_error.value());
+  EXPECT_EQ(spill_file->size(), 0);
+
+  constexpr std::string_view kFirst = "first block";
+  constexpr std::string_view kSecond = "second";
+  EXPECT_THAT(spill_file->Append(kFirst.data(), kFirst.size()), HasValue(0));
+  EXPECT_THAT(spill_file->Append(kSecond.data(), kSecond.size()), HasValue(kFirst.size()));
+  EXPECT_EQ(spill_file->size(), kFirst.size() + kSecond.size());
+
+  std::string buffer(kSecond.size(), '\0');
+  EXPECT_THAT(spill_file->Read(kFirst.size(), buffer.data(), buffer.size()), HasNoError());
+  EXPECT_EQ(buffer, kSecond);
+}
+
+}  // namespace orbit_client_data
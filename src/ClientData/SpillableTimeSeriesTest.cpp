@@ -0,0 +1,174 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "ClientData/SpillFile.h"
+#include "ClientData/SpillableTimeSeries.h"
+
+namespace orbit_client_data {
+
+namespace {
+
+class TestInterval {
+ public:
+  TestInterval(uint64_t begin_timestamp_ns, uint64_t end_timestamp_ns)
+      : begin_timestamp_ns_{begin_timestamp_ns}, end_timestamp_ns_{end_timestamp_ns} {}
+
+  [[nodiscard]] uint64_t begin_timestamp_ns() const { return begin_timestamp_ns_; }
+  [[nodiscard]] uint64_t end_timestamp_ns() const { return end_timestamp_ns_; }
+
+ private:
+  uint64_t begin_timestamp_ns_;
+  uint64_t end_timestamp_ns_;
+};
+
+using TestTimeSeries = SpillableTimeSeries<TestInterval>;
+
+// Interval i covers [10 * i, 10 * i + 5].
+void AddIntervals(TestTimeSeries& time_series, size_t count) {
+  for (uint64_t i = 0; i < count; ++i) {
+    time_series.Add(TestInterval{10 * i, 10 * i + 5});
+  }
+}
+
+std::vector<uint64_t> GetBeginTimestampsInTimeRange(const TestTimeSeries& time_series,
+                                                    uint64_t min_timestamp,
+                                                    uint64_t max_timestamp) {
+  std::vector<uint64_t> result;
+  time_series.ForEachIntersectingTimeRange(
+      min_timestamp, max_timestamp,
+      [&result](const TestInterval& interval) { result.push_back(interval.begin_timestamp_ns()); });
+  return result;
+}
+
+std::unique_ptr<SpillFile> CreateSpillFile() {
+  auto spill_file_or_error = SpillFile::Create();
+  ORBIT_CHECK(spill_file_or_error.has_value());
+  return std::move(spill_file_or_error.value());
+}
+
+}  // namespace
+
+TEST(SpillableTimeSeries, InMemoryOnly) {
+  TestTimeSeries time_series{TestTimeSeries::kChunkSize};
+  EXPECT_TRUE(time_series.empty());
+
+  AddIntervals(time_series, 3 * TestTimeSeries::kChunkSize);
+  EXPECT_EQ(time_series.size(), 3 * TestTimeSeries::kChunkSize);
+  EXPECT_EQ(time_series.num_spilled_elements(), 0);
+
+  EXPECT_THAT(GetBeginTimestampsInTimeRange(time_series, 15, 31),
+              ::testing::ElementsAre(10, 20, 30));
+  EXPECT_THAT(GetBeginTimestampsInTimeRange(time_series, 16, 19), ::testing::IsEmpty());
+}
+
+TEST(SpillableTimeSeries, SpillsOldestChunksAndReadsThemBack) {
+  constexpr size_t kChunkSize = TestTimeSeries::kChunkSize;
+  std::unique_ptr<SpillFile> spill_file = CreateSpillFile();
+
+  // Setting the spill file late spills what is in excess right away.
+  TestTimeSeries time_series{2 * kChunkSize};
+  AddIntervals(time_series, 3 * kChunkSize + 1);
+  EXPECT_EQ(time_series.num_spilled_elements(), 0);
+  time_series.SetSpillFile(spill_file.get());
+  EXPECT_EQ(time_series.num_spilled_elements(), 2 * kChunkSize);
+  EXPECT_EQ(time_series.size(), 3 * kChunkSize + 1);
+
+  TestTimeSeries spilled_time_series{2 * kChunkSize};
+  spilled_time_series.SetSpillFile(spill_file.get());
+  AddIntervals(spilled_time_series, 5 * kChunkSize + 7);
+  EXPECT_EQ(spilled_time_series.size(), 5 * kChunkSize + 7);
+  EXPECT_EQ(spilled_time_series.num_spilled_elements(), 4 * kChunkSize);
+  EXPECT_EQ(spill_file->size(), 6 * kChunkSize * sizeof(TestInterval));
+
+  // A range spanning the last spilled chunk and the first element kept in memory.
+  const uint64_t last_spilled_begin = 10 * (4 * kChunkSize - 1);
+  EXPECT_THAT(
+      GetBeginTimestampsInTimeRange(spilled_time_series, last_spilled_begin - 10,
+                                    last_spilled_begin + 11),
+      ::testing::ElementsAre(last_spilled_begin - 10, last_spilled_begin, last_spilled_begin + 10));
+
+  // A range within the first spilled chunk.
+  EXPECT_THAT(GetBeginTimestampsInTimeRange(spilled_time_series, 0, 25),
+              ::testing::ElementsAre(0, 10, 20));
+
+  // All elements are visited exactly once.
+  EXPECT_EQ(GetBeginTimestampsInTimeRange(spilled_time_series, 0,
+                                          std::numeric_limits<uint64_t>::max())
+                .size(),
+            spilled_time_series.size());
+
+  std::optional<TestInterval> found = spilled_time_series.FindContainingTimestamp(10 * 42 + 3);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->begin_timestamp_ns(), 10 * 42);
+  EXPECT_FALSE(spilled_time_series.FindContainingTimestamp(10 * 42 + 7).has_value());
+
+  found = spilled_time_series.FindContainingTimestamp(10 * (5 * kChunkSize + 6));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->begin_timestamp_ns(), 10 * (5 * kChunkSize + 6));
+  EXPECT_FALSE(
+      spilled_time_series.FindContainingTimestamp(10 * (5 * kChunkSize + 7)).has_value());
+}
+
+TEST(SpillableTimeSeries, FindsOverlappingElements) {
+  constexpr size_t kChunkSize = TestTimeSeries::kChunkSize;
+  std::unique_ptr<SpillFile> spill_file = CreateSpillFile();
+  TestTimeSeries time_series{kChunkSize};
+  time_series.SetSpillFile(spill_file.get());
+
+  // The first interval covers all the other ones but the last.
+  time_series.Add(TestInterval{0, 10 * 3 * kChunkSize});
+  for (uint64_t i = 1; i <= 3 * kChunkSize; ++i) {
+    time_series.Add(TestInterval{10 * i, 10 * i + 5});
+  }
+  EXPECT_GT(time_series.num_spilled_elements(), 0);
+
+  EXPECT_THAT(GetBeginTimestampsInTimeRange(time_series, 10 * 2000 + 7, 10 * 2001 + 1),
+              ::testing::ElementsAre(0, 10 * 2001));
+  EXPECT_THAT(GetBeginTimestampsInTimeRange(time_series, 10 * 3 * kChunkSize + 1,
+                                            10 * 3 * kChunkSize + 2),
+              ::testing::ElementsAre(10 * 3 * kChunkSize));
+
+  std::optional<TestInterval> found = time_series.FindContainingTimestamp(10 * 2000 + 7);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->begin_timestamp_ns(), 0);
+  found = time_series.FindContainingTimestamp(10 * 3 * kChunkSize + 3);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->begin_timestamp_ns(), 10 * 3 * kChunkSize);
+}
+
+TEST(SpillableTimeSeries, QueriesSeeTheElementsAddedSoFarWhileAdding) {
+  constexpr size_t kChunkSize = TestTimeSeries::kChunkSize;
+  constexpr size_t kElementCount = 20 * kChunkSize;
+  std::unique_ptr<SpillFile> spill_file = CreateSpillFile();
+  TestTimeSeries time_series{2 * kChunkSize};
+  time_series.SetSpillFile(spill_file.get());
+
+  std::thread writer{[&time_series] { AddIntervals(time_series, kElementCount); }};
+  size_t visited_count = 0;
+  while (visited_count < kElementCount) {
+    const std::vector<uint64_t> begin_timestamps =
+        GetBeginTimestampsInTimeRange(time_series, 0, std::numeric_limits<uint64_t>::max());
+    // No ASSERT_* here, as returning before joining `writer` would terminate the test.
+    EXPECT_GE(begin_timestamps.size(), visited_count);
+    for (size_t i = 0; i < begin_timestamps.size() && !testing::Test::HasFailure(); ++i) {
+      EXPECT_EQ(begin_timestamps[i], 10 * i);
+    }
+    if (testing::Test::HasFailure()) break;
+    visited_count = begin_timestamps.size();
+  }
+  writer.join();
+  EXPECT_EQ(time_series.num_spilled_elements(), 18 * kChunkSize);
+}
+
+}  // namespace orbit_client_data
@@ -5,18 +5,24 @@
 #ifndef CLIENT_DATA_CALLSTACK_DATA_H_
 #define CLIENT_DATA_CALLSTACK_DATA_H_
 
-#include <absl/container/btree_map.h>
+#include <absl/base/thread_annotations.h>
 #include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/types/span.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
-#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "CallstackType.h"
 #include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackEventRun.h"
 #include "ClientData/CallstackInfo.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "ModuleManager.h"
@@ -24,6 +30,9 @@
 
 namespace orbit_client_data {
 
+// Holds the unique callstacks of a capture and the CallstackEvents referencing them. Events can be
+// added while they are being queried from other threads; queries never block the addition of
+// events, and the other way round.
 class CallstackData {
  public:
   explicit CallstackData() = default;
@@ -38,6 +47,8 @@ class CallstackData {
   // Assume that callstack_event.callstack_hash is filled correctly and the
   // Callstack with the corresponding id is already in unique_callstacks_.
   void AddCallstackEvent(orbit_client_data::CallstackEvent callstack_event);
+  // Same as calling AddCallstackEvent for each event, but only acquires the internal lock once.
+  void AddCallstackEvents(absl::Span<const orbit_client_data::CallstackEvent> callstack_events);
   void AddUniqueCallstack(uint64_t callstack_id, CallstackInfo callstack);
   void AddCallstackFromKnownCallstackData(const orbit_client_data::CallstackEvent& event,
                                           const CallstackData& known_callstack_data);
@@ -49,65 +60,56 @@ class CallstackData {
 
   [[nodiscard]] uint32_t GetCallstackEventsOfTidCount(uint32_t thread_id) const;
 
+  // Ids of the threads with at least one CallstackEvent, in no particular order.
+  [[nodiscard]] std::vector<uint32_t> GetThreadIds() const;
+
   [[nodiscard]] std::vector<orbit_client_data::CallstackEvent> GetCallstackEventsOfTidInTimeRange(
       uint32_t tid, uint64_t time_begin, uint64_t time_end) const;
 
   template <typename Action>
   void ForEachCallstackEvent(Action&& action) const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    for (const auto& [unused_tid, events] : callstack_events_by_tid_) {
-      for (const auto& [unused_timestamp, event] : events) {
-        std::invoke(std::forward<Action>(action), event);
-      }
+    std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
+    for (const auto& [unused_tid, runs] : snapshot->runs_by_tid) {
+      ForEachEventOfRunsInTimeRange(runs, 0, std::numeric_limits<uint64_t>::max(), action);
     }
   }
 
   template <typename Action>
   void ForEachCallstackEventInTimeRange(uint64_t min_timestamp, uint64_t max_timestamp,
                                         Action&& action) const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
     ORBIT_CHECK(min_timestamp <= max_timestamp);
-    for (const auto& [unused_tid, events] : callstack_events_by_tid_) {
-      for (auto event_it = events.lower_bound(min_timestamp);
-           event_it != events.upper_bound(max_timestamp); ++event_it) {
-        std::invoke(std::forward<Action>(action), event_it->second);
-      }
+    std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
+    for (const auto& [unused_tid, runs] : snapshot->runs_by_tid) {
+      ForEachEventOfRunsInTimeRange(runs, min_timestamp, max_timestamp, action);
     }
   }
 
   template <typename Action>
   void ForEachCallstackEventOfTidInTimeRange(uint32_t tid, uint64_t min_timestamp,
                                              uint64_t max_timestamp, Action&& action) const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
     ORBIT_CHECK(min_timestamp <= max_timestamp);
-    const auto& tid_and_events_it = callstack_events_by_tid_.find(tid);
-    if (tid_and_events_it == callstack_events_by_tid_.end()) {
+    std::shared_ptr<const EventsSnapshot> snapshot = GetEventsSnapshot();
+    const auto& tid_and_runs_it = snapshot->runs_by_tid.find(tid);
+    if (tid_and_runs_it == snapshot->runs_by_tid.end()) {
       return;
     }
-    const auto& events = tid_and_events_it->second;
-    for (auto event_it = events.lower_bound(min_timestamp);
-         event_it != events.upper_bound(max_timestamp); ++event_it) {
-      std::invoke(std::forward<Action>(action), event_it->second);
-    }
+    ForEachEventOfRunsInTimeRange(tid_and_runs_it->second, min_timestamp, max_timestamp, action);
   }
 
-  [[nodiscard]] uint64_t max_time() const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    return max_time_;
-  }
+  [[nodiscard]] uint64_t max_time() const { return max_time_.load(std::memory_order_relaxed); }
 
-  [[nodiscard]] uint64_t min_time() const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    return min_time_;
-  }
+  [[nodiscard]] uint64_t min_time() const { return min_time_.load(std::memory_order_relaxed); }
 
   [[nodiscard]] const CallstackInfo* GetCallstack(uint64_t callstack_id) const;
 
   [[nodiscard]] bool HasCallstack(uint64_t callstack_id) const;
 
+  // The internal mutex is held while calling `action`, so that the type of a callstack cannot
+  // change during the iteration (see UpdateCallstackTypeBasedOnMajorityStart). Hence, `action` must
+  // not call back into this object.
   template <typename Action>
   void ForEachUniqueCallstack(Action&& action) const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    absl::MutexLock lock{&unique_callstacks_mutex_};
     for (const auto& [callstack_id, callstack_ptr] : unique_callstacks_) {
       std::invoke(std::forward<Action>(action), callstack_id, *callstack_ptr);
     }
@@ -122,18 +124,78 @@ class CallstackData {
           absolute_address_to_size_of_functions_to_stop_unwinding_at);
 
  private:
+  using Runs = std::vector<std::shared_ptr<const CallstackEventRun>>;
+
+  // The CallstackEvents of each thread are stored in one or more runs sorted by timestamp. Events
+  // are expected to arrive mostly in order, so usually a thread has a single run; an event older
+  // than the last one of its thread starts a new run.
+  struct EventsSnapshot {
+    absl::flat_hash_map<uint32_t, Runs> runs_by_tid;
+  };
+
+  // Calls `action` on the events in `runs` with timestamp in [min_timestamp, max_timestamp], in
+  // order of timestamp.
+  template <typename Action>
+  static void ForEachEventOfRunsInTimeRange(const Runs& runs, uint64_t min_timestamp,
+                                            uint64_t max_timestamp, Action&& action) {
+    if (runs.size() == 1) {
+      CallstackEventRun::View view = runs[0]->GetView();
+      for (size_t index = view.LowerBound(min_timestamp);
+           index < view.size() && view[index].timestamp_ns() <= max_timestamp; ++index) {
+        std::invoke(action, view[index]);
+      }
+      return;
+    }
+
+    // Merge the runs. There are only a few of them, so a linear scan for the next event is enough.
+    std::vector<std::pair<CallstackEventRun::View, size_t>> views_and_indices;
+    for (const auto& run : runs) {
+      CallstackEventRun::View view = run->GetView();
+      views_and_indices.emplace_back(view, view.LowerBound(min_timestamp));
+    }
+    while (true) {
+      const CallstackEvent* next_event = nullptr;
+      size_t* next_index = nullptr;
+      for (auto& [view, index] : views_and_indices) {
+        if (index == view.size() || view[index].timestamp_ns() > max_timestamp) continue;
+        if (next_event == nullptr || view[index].timestamp_ns() < next_event->timestamp_ns()) {
+          next_event = &view[index];
+          next_index = &index;
+        }
+      }
+      if (next_event == nullptr) return;
+      ++*next_index;
+      std::invoke(action, *next_event);
+    }
+  }
+
+  [[nodiscard]] std::shared_ptr<const EventsSnapshot> GetEventsSnapshot() const {
+    return std::atomic_load(&events_snapshot_);
+  }
+
+  void AddCallstackEventLocked(const CallstackEvent& callstack_event)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_mutex_);
+  void PublishEventsSnapshot() ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_mutex_);
+
   [[nodiscard]] std::shared_ptr<CallstackInfo> GetCallstackPtr(uint64_t callstack_id) const;
 
-  void RegisterTime(uint64_t time);
+  void RegisterTime(uint64_t time) ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_mutex_);
+
+  // Serializes the writers. Readers never take this lock: they work on the last published
+  // EventsSnapshot, which is replaced as a whole (read-copy-update) when a thread or a run is
+  // added. Events appended to a run that is already part of a snapshot are visible through it.
+  absl::Mutex write_mutex_;
+  absl::flat_hash_map<uint32_t, std::vector<std::shared_ptr<CallstackEventRun>>> runs_by_tid_
+      ABSL_GUARDED_BY(write_mutex_);
+  // Only accessed with std::atomic_load and std::atomic_store.
+  std::shared_ptr<const EventsSnapshot> events_snapshot_ = std::make_shared<EventsSnapshot>();
 
-  // Use a reentrant mutex so that calls to the ForEach... methods can be nested.
-  // E.g., one might want to nest ForEachCallstackEvent and ForEachFrameInCallstack.
-  mutable std::recursive_mutex mutex_;
-  absl::flat_hash_map<uint64_t, std::shared_ptr<CallstackInfo>> unique_callstacks_;
-  absl::flat_hash_map<uint32_t, absl::btree_map<uint64_t, CallstackEvent>> callstack_events_by_tid_;
+  mutable absl::Mutex unique_callstacks_mutex_;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<CallstackInfo>> unique_callstacks_
+      ABSL_GUARDED_BY(unique_callstacks_mutex_);
 
-  uint64_t max_time_ = 0;
-  uint64_t min_time_ = std::numeric_limits<uint64_t>::max();
+  std::atomic<uint64_t> max_time_ = 0;
+  std::atomic<uint64_t> min_time_ = std::numeric_limits<uint64_t>::max();
 };
 
 }  // namespace orbit_client_data
@@ -0,0 +1,100 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_CALLSTACK_EVENT_RUN_H_
+#define CLIENT_DATA_CALLSTACK_EVENT_RUN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "ClientData/CallstackEvent.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+// Append-only sequence of CallstackEvents whose timestamps are non-decreasing, stored in chunks of
+// fixed size that never move once allocated.
+//
+// There can be one writer calling Append and any number of concurrent readers, none of which
+// block: the writer fully constructs an event (and the chunk holding it) before publishing the new
+// size with release semantics. Readers first take a View, which captures the size and the chunk
+// directory once, and then only access the events that were published at that point.
+class CallstackEventRun {
+  static_assert(std::is_trivially_copyable_v<CallstackEvent> &&
+                    std::is_trivially_destructible_v<CallstackEvent>,
+                "Events are placed into raw storage and never destroyed");
+
+ public:
+  static constexpr size_t kChunkSize = 1024;
+
+  CallstackEventRun() = default;
+  CallstackEventRun(const CallstackEventRun&) = delete;
+  CallstackEventRun& operator=(const CallstackEventRun&) = delete;
+  CallstackEventRun(CallstackEventRun&&) = delete;
+  CallstackEventRun& operator=(CallstackEventRun&&) = delete;
+  ~CallstackEventRun() = default;
+
+  // Only to be called by the writer. The timestamp of `event` must not be smaller than the one of
+  // the last event appended.
+  void Append(const CallstackEvent& event);
+
+  [[nodiscard]] size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  class View {
+   public:
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] const CallstackEvent& operator[](size_t index) const {
+      const Chunk* chunk = chunks_[index / kChunkSize];
+      return *std::launder(reinterpret_cast<const CallstackEvent*>(&(*chunk)[index % kChunkSize]));
+    }
+    [[nodiscard]] const CallstackEvent& back() const { return (*this)[size_ - 1]; }
+
+    // Returns the index of the first event with a timestamp not smaller than `timestamp_ns`, or
+    // size() if there is none.
+    [[nodiscard]] size_t LowerBound(uint64_t timestamp_ns) const;
+
+   private:
+    friend class CallstackEventRun;
+    using Chunk =
+        std::array<std::aligned_storage_t<sizeof(CallstackEvent), alignof(CallstackEvent)>,
+                   kChunkSize>;
+    View(size_t size, const Chunk* const* chunks) : size_{size}, chunks_{chunks} {}
+
+    size_t size_;
+    const Chunk* const* chunks_;
+  };
+
+  // The View stays valid as long as this object is alive.
+  [[nodiscard]] View GetView() const {
+    // The size needs to be loaded before the directory: a directory published before the size
+    // always contains all the chunks needed for that size.
+    const size_t size = size_.load(std::memory_order_acquire);
+    return View{size, directory_.load(std::memory_order_acquire)};
+  }
+
+ private:
+  using Chunk = View::Chunk;
+
+  void AllocateNewChunk();
+
+  std::atomic<size_t> size_ = 0;
+  std::atomic<const Chunk**> directory_ = nullptr;
+
+  // Only accessed by the writer. Directories that were replaced by larger ones are kept around as
+  // readers might still be accessing them.
+  size_t directory_capacity_ = 0;
+  std::vector<std::unique_ptr<const Chunk*[]>> directories_;
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_CALLSTACK_EVENT_RUN_H_
@@ -5,13 +5,17 @@
 #ifndef CLIENT_DATA_CAPTURE_DATA_H_
 #define CLIENT_DATA_CAPTURE_DATA_H_
 
+#include <absl/base/thread_annotations.h>
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
+#include <absl/container/node_hash_map.h>
 #include <absl/synchronization/mutex.h>
+#include <absl/types/span.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -32,6 +36,9 @@
 #include "ClientData/ScopeInfo.h"
 #include "ClientData/ScopeStats.h"
 #include "ClientData/ScopeStatsCollection.h"
+#include "ClientData/ScopeTimerIndex.h"
+#include "ClientData/SpillFile.h"
+#include "ClientData/SpillableTimeSeries.h"
 #include "ClientData/ThreadStateSliceInfo.h"
 #include "ClientData/ThreadTrackDataProvider.h"
 #include "ClientData/TimerData.h"
@@ -43,6 +50,7 @@
 #include "GrpcProtos/process.pb.h"
 #include "GrpcProtos/tracepoint.pb.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/Result.h"
 
 namespace orbit_client_data {
 
@@ -116,13 +124,12 @@ class CaptureData {
     return thread_state_slices_.count(tid) > 0;
   }
 
-  void AddThreadStateSlice(ThreadStateSliceInfo state_slice) {
-    absl::MutexLock lock{&thread_state_slices_mutex_};
-    thread_state_slices_[state_slice.tid()].emplace_back(std::move(state_slice));
-  }
+  void AddThreadStateSlice(ThreadStateSliceInfo state_slice);
+  void AddThreadStateSlices(absl::Span<const ThreadStateSliceInfo> state_slices);
 
   // Allows the caller to iterate `action` over all the thread state slices of the specified thread
-  // in the time range while holding for the whole time the internal mutex, acquired only once.
+  // in the time range. The internal mutex is only held to look up the thread, so slices can be
+  // added concurrently: `action` is called on the slices added before the iteration started.
   void ForEachThreadStateSliceIntersectingTimeRange(
       uint32_t thread_id, uint64_t min_timestamp, uint64_t max_timestamp,
       const std::function<void(const ThreadStateSliceInfo&)>& action) const;
@@ -161,6 +168,10 @@ class CaptureData {
     callstack_data_.AddCallstackEvent(std::move(callstack_event));
   }
 
+  void AddCallstackEvents(absl::Span<const orbit_client_data::CallstackEvent> callstack_events) {
+    callstack_data_.AddCallstackEvents(callstack_events);
+  }
+
   void FilterBrokenCallstacks();
 
   void AddUniqueTracepointInfo(uint64_t tracepoint_id, TracepointInfo tracepoint_info) {
@@ -244,6 +255,8 @@ class CaptureData {
 
   [[nodiscard]] const std::vector<uint64_t>* GetSortedTimerDurationsForScopeId(
       ScopeId scope_id) const;
+  // Returns nullptr if the scope has no timers or if the capture is not complete yet.
+  [[nodiscard]] const ScopeTimerIndex* GetTimerIndexForScopeId(ScopeId scope_id) const;
 
   // Returns all the timers corresponding to scopes with non-invalid ids
   [[nodiscard]] std::vector<const TimerInfo*> GetAllScopeTimers(
@@ -262,7 +275,32 @@ class CaptureData {
   [[nodiscard]] std::optional<ThreadStateSliceInfo> FindThreadStateSliceInfoFromTimestamp(
       int64_t thread_id, uint64_t timestamp) const;
 
+  // In a disk-backed capture, older thread state slices are moved to a temporary file on disk and
+  // read back on demand, so that at most about `kMaxThreadStateSlicesInMemory` of them, over all
+  // threads, stay in memory for long captures. Timers and callstack events are always kept in
+  // memory.
+  ErrorMessageOr<void> EnableDiskBackedStorage();
+  [[nodiscard]] bool IsDiskBacked() const {
+    absl::MutexLock lock{&thread_state_slices_mutex_};
+    return spill_file_ != nullptr;
+  }
+  [[nodiscard]] size_t GetNumThreadStateSlicesInMemory() const {
+    absl::MutexLock lock{&thread_state_slices_mutex_};
+    return num_thread_state_slices_in_memory_;
+  }
+
+  // Each thread additionally keeps its most recent, not yet full chunk of slices in memory.
+  static constexpr size_t kMaxThreadStateSlicesInMemory =
+      64 * SpillableTimeSeries<ThreadStateSliceInfo>::kChunkSize;
+
  private:
+  void AddThreadStateSliceLocked(ThreadStateSliceInfo state_slice)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(thread_state_slices_mutex_);
+  void SpillThreadStateSlicesIfNecessary()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(thread_state_slices_mutex_);
+  [[nodiscard]] const SpillableTimeSeries<ThreadStateSliceInfo>* FindThreadStateSlices(
+      uint32_t thread_id) const;
+
   orbit_grpc_protos::CaptureStarted capture_started_;
 
   orbit_client_data::ProcessData process_;
@@ -284,9 +322,18 @@ class CaptureData {
 
   absl::flat_hash_map<uint32_t, std::string> thread_names_;
 
-  // For each thread, assume sorted by timestamp and not overlapping.
-  absl::flat_hash_map<uint32_t, std::vector<ThreadStateSliceInfo>> thread_state_slices_
+  // Only set for disk-backed captures. Declared before the data that refers to it.
+  std::unique_ptr<SpillFile> spill_file_ ABSL_GUARDED_BY(thread_state_slices_mutex_);
+
+  // For each thread, assume sorted by timestamp. Time series are never removed and node_hash_map
+  // keeps them in place, so that they can be queried after releasing the mutex.
+  absl::node_hash_map<uint32_t, SpillableTimeSeries<ThreadStateSliceInfo>> thread_state_slices_
+      ABSL_GUARDED_BY(thread_state_slices_mutex_);
+  // Only maintained for disk-backed captures: the thread ids of the full chunks of slices that are
+  // still in memory, in the order they were filled, so that the oldest ones are spilled first.
+  std::deque<uint32_t> tids_of_full_thread_state_slice_chunks_in_memory_
       ABSL_GUARDED_BY(thread_state_slices_mutex_);
+  size_t num_thread_state_slices_in_memory_ ABSL_GUARDED_BY(thread_state_slices_mutex_) = 0;
   mutable absl::Mutex thread_state_slices_mutex_;
 
   // Only access this field from the main thread.
@@ -0,0 +1,49 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_FUNCTION_ADDRESS_INDEX_H_
+#define CLIENT_DATA_FUNCTION_ADDRESS_INDEX_H_
+
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "ClientData/FunctionInfo.h"
+
+namespace orbit_client_data {
+
+// Immutable index from virtual addresses to the functions of a module. Addresses and sizes are
+// stored in contiguous arrays next to the function pointers, so that a lookup is a branchless
+// binary search over a plain array that never dereferences a FunctionInfo.
+//
+// As the index is never modified after construction, it can be read from any number of threads
+// without synchronization. The FunctionInfos are not owned by the index.
+class FunctionAddressIndex {
+ public:
+  // `functions` must be sorted by address, without duplicate addresses.
+  explicit FunctionAddressIndex(absl::Span<const FunctionInfo* const> functions);
+
+  [[nodiscard]] size_t size() const { return addresses_.size(); }
+
+  // Returns the function starting exactly at `virtual_address`, or nullptr.
+  [[nodiscard]] const FunctionInfo* FindFunctionByExactAddress(uint64_t virtual_address) const;
+  // Returns the function with the largest address that is not greater than `virtual_address`,
+  // provided that `virtual_address` is not past the end of that function, or nullptr.
+  [[nodiscard]] const FunctionInfo* FindFunctionContainingAddress(uint64_t virtual_address) const;
+
+ private:
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+  // Returns the index of the last address not greater than `virtual_address`, or kNotFound.
+  [[nodiscard]] size_t FindLastIndexNotGreaterThan(uint64_t virtual_address) const;
+
+  std::vector<uint64_t> addresses_;
+  std::vector<uint64_t> sizes_;
+  std::vector<const FunctionInfo*> functions_;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_FUNCTION_ADDRESS_INDEX_H_
@@ -5,6 +5,13 @@
 #ifndef CLIENT_DATA_MODULE_AND_FUNCTION_LOOKUP_H_
 #define CLIENT_DATA_MODULE_AND_FUNCTION_LOOKUP_H_
 
+#include <absl/types/span.h>
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "CaptureData.h"
 #include "FunctionInfo.h"
 #include "ModuleManager.h"
@@ -39,6 +46,26 @@ FindModulePathAndBuildIdByAddress(const ModuleManager& module_manager,
                                                         const ModuleManager& module_manager,
                                                         uint64_t absolute_address, bool is_exact);
 
+// The result of symbolizing one absolute address with SymbolizeAddresses. The strings are owned
+// by the ModuleManager or the CaptureData, exactly as for the functions returning a reference.
+struct SymbolizedAddress {
+  // Same as FindFunctionAbsoluteAddressByInstructionAbsoluteAddress.
+  std::optional<uint64_t> function_absolute_address;
+  // Same as GetFunctionNameByAddress.
+  const std::string* function_name = &kUnknownFunctionOrModuleName;
+  // Same as FindModulePathAndBuildIdByAddress, with nullptr for an unknown build id.
+  const std::string* module_path = &kUnknownFunctionOrModuleName;
+  const std::string* module_build_id = nullptr;
+};
+
+// Symbolizes many absolute addresses at once, and returns the results in the order of
+// `absolute_addresses`. This is equivalent to, but much faster than, calling the functions above
+// for each address: addresses are sorted and deduplicated first, so that each distinct address is
+// resolved only once and consecutive addresses in the same module share the module lookup.
+[[nodiscard]] std::vector<SymbolizedAddress> SymbolizeAddresses(
+    const ModuleManager& module_manager, const CaptureData& capture_data,
+    absl::Span<const uint64_t> absolute_addresses);
+
 [[nodiscard]] const orbit_client_data::ModuleData* FindModuleByAddress(
     const ProcessData& process, const ModuleManager& module_manager, uint64_t absolute_address);
 
@@ -5,6 +5,7 @@
 #ifndef CLIENT_DATA_MODULE_DATA_H_
 #define CLIENT_DATA_MODULE_DATA_H_
 
+#include <atomic>
 #include <cinttypes>
 #include <cstdint>
 #include <map>
@@ -13,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "ClientData/FunctionAddressIndex.h"
 #include "ClientData/FunctionInfo.h"
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/symbol.pb.h"
@@ -24,6 +26,9 @@
 namespace orbit_client_data {
 
 // Represents information about a module on the client. This class if fully synchronized.
+// FindFunctionByVirtualAddress doesn't take the mutex: it reads an immutable FunctionAddressIndex
+// that is rebuilt and published atomically whenever the symbols change. The functions that an index
+// returns stay alive as long as the module, even after the symbols changed.
 class ModuleData final {
  public:
   explicit ModuleData(orbit_grpc_protos::ModuleInfo module_info);
@@ -64,14 +69,48 @@ class ModuleData final {
   [[nodiscard]] bool AreDebugSymbolsLoaded() const;
   [[nodiscard]] bool AreAtLeastFallbackSymbolsLoaded() const;
 
+  // Builds the function tables of a module from its symbols, which can be added in chunks while
+  // they are being loaded. This is meant to be done on a worker thread, as it doesn't involve the
+  // ModuleData: the finished tables are then published with AddSymbols or AddFallbackSymbols,
+  // which only need to swap them in. This class is not thread-safe.
+  class SymbolsBuilder {
+   public:
+    explicit SymbolsBuilder(orbit_symbol_provider::ModuleIdentifier module_id)
+        : module_id_{std::move(module_id)} {}
+
+    // The names are moved out of `module_symbols` rather than copied.
+    void AddSymbols(orbit_grpc_protos::ModuleSymbols module_symbols);
+    void AddSymbol(uint64_t address, uint64_t size, std::string demangled_name);
+
+    [[nodiscard]] const orbit_symbol_provider::ModuleIdentifier& module_id() const {
+      return module_id_;
+    }
+    [[nodiscard]] size_t GetFunctionCount() const { return functions_.size(); }
+
+   private:
+    friend class ModuleData;
+
+    orbit_symbol_provider::ModuleIdentifier module_id_;
+    std::map<uint64_t, std::unique_ptr<FunctionInfo>> functions_;
+    absl::flat_hash_map<std::string_view, FunctionInfo*> name_to_function_info_map_;
+    absl::flat_hash_map<uint64_t, FunctionInfo*> hash_to_function_map_;
+    uint32_t address_reuse_counter_ = 0;
+    uint32_t name_reuse_counter_ = 0;
+  };
+
   void AddSymbols(const orbit_grpc_protos::ModuleSymbols& module_symbols);
   void AddFallbackSymbols(const orbit_grpc_protos::ModuleSymbols& module_symbols);
+  // `builder` must have been created with the module_id() of this module.
+  void AddSymbols(SymbolsBuilder builder);
+  void AddFallbackSymbols(SymbolsBuilder builder);
 
  private:
   [[nodiscard]] bool NeedsUpdate(const orbit_grpc_protos::ModuleInfo& new_module_info) const;
 
-  void AddSymbolsInternal(const orbit_grpc_protos::ModuleSymbols& module_symbols,
-                          SymbolCompleteness completeness);
+  void PublishSymbols(SymbolsBuilder builder, SymbolCompleteness completeness);
+  void PublishFunctionAddressIndex() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves `functions_` to `retired_functions_`, leaving it empty.
+  void RetireFunctions() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   mutable absl::Mutex mutex_;
   orbit_grpc_protos::ModuleInfo module_info_ ABSL_GUARDED_BY(mutex_);
@@ -86,6 +125,16 @@ class ModuleData final {
   // presets are based on a hash of the functions pretty name. This should be changed to not use
   // hashes anymore.
   absl::flat_hash_map<uint64_t, FunctionInfo*> hash_to_function_map_ ABSL_GUARDED_BY(mutex_);
+
+  // Lock-free readers can still be using a previously published index, or a function they got from
+  // it, so all published indices and the functions they were built from are kept alive as long as
+  // the module. Symbols are only replaced by more complete ones, or removed when a module without
+  // build id changes, so this is a handful of tables per module.
+  std::vector<std::unique_ptr<const FunctionAddressIndex>> function_address_indices_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<std::map<uint64_t, std::unique_ptr<FunctionInfo>>> retired_functions_
+      ABSL_GUARDED_BY(mutex_);
+  std::atomic<const FunctionAddressIndex*> function_address_index_ = nullptr;
 };
 
 }  // namespace orbit_client_data
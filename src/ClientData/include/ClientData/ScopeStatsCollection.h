@@ -8,12 +8,13 @@
 
 #include "ClientData/ScopeIdProvider.h"
 #include "ClientData/ScopeStats.h"
+#include "ClientData/ScopeTimerIndex.h"
 #include "ClientData/TimerTrackDataIdManager.h"
 
 namespace orbit_client_data {
 
 // ScopeStatsCollection holds a subset of all Scopes in a capture keeping track of their stats and
-// ordered durations.
+// of a ScopeTimerIndex of their timers, which provides their ordered durations.
 class ScopeStatsCollection {
  public:
   explicit ScopeStatsCollection() = default;
@@ -23,18 +24,34 @@ class ScopeStatsCollection {
   [[nodiscard]] std::vector<ScopeId> GetAllProvidedScopeIds() const;
   [[nodiscard]] const ScopeStats& GetScopeStatsOrDefault(ScopeId scope_id) const;
   [[nodiscard]] const std::vector<uint64_t>* GetSortedTimerDurationsForScopeId(ScopeId scope_id);
-
-  // Calling this function causes the timer durations to no longer be sorted. OnCaptureComplete()
-  // *must* be called after UpdateScopeStats and before GetSortedTimerDurationsForScopeId().
+  [[nodiscard]] const ScopeTimerIndex* GetTimerIndexForScopeId(ScopeId scope_id) const;
+  // Returns whether the stored timers of all scopes are set, i.e., `GetTimersForScopeId` can be
+  // used. Calling UpdateScopeStats unsets them.
+  [[nodiscard]] bool AreTimersSet() const { return timers_are_set_; }
+  // Returns the timers of the scope that intersect [min_tick, max_tick], ordered by start.
+  [[nodiscard]] std::vector<const TimerInfo*> GetTimersForScopeId(ScopeId scope_id,
+                                                                  uint64_t min_tick,
+                                                                  uint64_t max_tick) const;
+
+  // Calling this function causes the timer indices to no longer be built. OnCaptureComplete()
+  // *must* be called after UpdateScopeStats and before GetSortedTimerDurationsForScopeId() or
+  // GetTimerIndexForScopeId().
   void UpdateScopeStats(ScopeId scope_id, const TimerInfo& timer);
   // TODO(b/249046906): Remove this test-only function.
   void SetScopeStats(ScopeId scope_id, ScopeStats stats);
   void OnCaptureComplete();
+  // Sets the stored timers, which have to outlive the collection, on the timer indices of their
+  // scopes.
+  void SetTimers(ScopeIdProvider& scope_id_provider, const std::vector<const TimerInfo*>& timers);
 
  private:
+  void SetTimersByScopeId(
+      absl::flat_hash_map<ScopeId, std::vector<const TimerInfo*>> scope_id_to_timers);
+
   absl::flat_hash_map<ScopeId, ScopeStats> scope_stats_;
-  absl::flat_hash_map<ScopeId, std::vector<uint64_t>> scope_id_to_timer_durations_;
-  bool timer_durations_are_sorted_ = true;
+  absl::flat_hash_map<ScopeId, ScopeTimerIndex> scope_id_to_timer_index_;
+  bool timer_indices_are_built_ = true;
+  bool timers_are_set_ = false;
 };
 
 }  // namespace orbit_client_data
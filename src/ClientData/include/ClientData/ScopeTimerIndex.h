@@ -0,0 +1,117 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_SCOPE_TIMER_INDEX_H_
+#define CLIENT_DATA_SCOPE_TIMER_INDEX_H_
+
+#include <absl/types/span.h>
+#include <stdint.h>
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ClientData/ScopeStats.h"
+#include "ClientProtos/capture_data.pb.h"
+
+namespace orbit_client_data {
+
+// Indexes the start times and durations of the timers of one scope, so that the statistics, the
+// duration percentiles and the duration histograms of the timers starting in any time range can be
+// computed in logarithmic time, without visiting the timers.
+// Timers are appended with `AddTimer` while the capture is running, in any order. `Build` has to be
+// called before any query; adding a timer afterwards invalidates the index until the next `Build`.
+// All time ranges are inclusive and refer to the start of the timers, except the one of
+// `GetTimersInTimeRange`.
+// The timers themselves are only known once they are stored, so they are set separately, with
+// `SetTimers`, to look them up by time range without visiting the timers of other scopes.
+class ScopeTimerIndex {
+ public:
+  void AddTimer(uint64_t start_ns, uint64_t end_ns);
+  void Build();
+
+  // The timers have to outlive the index. Their order doesn't matter.
+  void SetTimers(std::vector<const orbit_client_protos::TimerInfo*> timers);
+  // Returns the timers set with `SetTimers` that intersect [min_tick, max_tick], ordered by start.
+  [[nodiscard]] std::vector<const orbit_client_protos::TimerInfo*> GetTimersInTimeRange(
+      uint64_t min_tick, uint64_t max_tick) const;
+
+  [[nodiscard]] bool IsBuilt() const { return is_built_; }
+  [[nodiscard]] size_t GetTimerCount() const { return starts_.size(); }
+
+  // The durations of all the timers, in ascending order.
+  [[nodiscard]] const std::vector<uint64_t>& GetSortedDurations() const;
+
+  [[nodiscard]] size_t CountTimersInTimeRange(uint64_t min_start_ns, uint64_t max_start_ns) const;
+  [[nodiscard]] ScopeStats ComputeStatsInTimeRange(uint64_t min_start_ns,
+                                                   uint64_t max_start_ns) const;
+
+  // Returns the `n`-th shortest duration (starting from 0) of the timers in the time range, or
+  // std::nullopt if there are not more than `n` of them.
+  [[nodiscard]] std::optional<uint64_t> FindNthShortestDurationInTimeRange(uint64_t min_start_ns,
+                                                                           uint64_t max_start_ns,
+                                                                           size_t n) const;
+  // Returns the shortest duration that at least `percentile` percent of the durations of the timers
+  // in the time range do not exceed, or std::nullopt if the time range has no timer.
+  [[nodiscard]] std::optional<uint64_t> FindDurationPercentileInTimeRange(uint64_t min_start_ns,
+                                                                          uint64_t max_start_ns,
+                                                                          double percentile) const;
+
+  [[nodiscard]] size_t CountDurationsInTimeRange(uint64_t min_start_ns, uint64_t max_start_ns,
+                                                 uint64_t min_duration_ns,
+                                                 uint64_t max_duration_ns) const;
+  // Counts the durations of the timers in the time range that fall in each of the bins
+  // [bin_boundaries_ns[i], bin_boundaries_ns[i + 1]). The boundaries must be ascending.
+  [[nodiscard]] std::vector<size_t> CountDurationsPerBinInTimeRange(
+      uint64_t min_start_ns, uint64_t max_start_ns,
+      absl::Span<const uint64_t> bin_boundaries_ns) const;
+
+ private:
+  // A bit vector that counts the ones before any position in constant time.
+  class RankedBitVector {
+   public:
+    explicit RankedBitVector(size_t size);
+    void Set(size_t index) { words_[index / 64] |= uint64_t{1} << (index % 64); }
+    void BuildRanks();
+    // Returns the number of ones in [0, index).
+    [[nodiscard]] size_t RankOfOnes(size_t index) const;
+
+   private:
+    std::vector<uint64_t> words_;
+    std::vector<size_t> ones_before_word_;
+  };
+
+  // Returns the positions [begin, end) in start order of the timers in the time range.
+  [[nodiscard]] std::pair<size_t, size_t> GetPositionRange(uint64_t min_start_ns,
+                                                           uint64_t max_start_ns) const;
+  // Counts the timers at the positions [begin, end) whose duration rank is below `rank`.
+  [[nodiscard]] size_t CountRanksBelow(size_t begin, size_t end, size_t rank) const;
+  [[nodiscard]] size_t FindNthSmallestRank(size_t begin, size_t end, size_t n) const;
+
+  // The start of each timer, ordered by start once built. The durations are only kept until the
+  // index is built, as `duration_prefix_sums_` holds them too.
+  std::vector<uint64_t> starts_;
+  std::vector<uint64_t> durations_;
+  bool is_built_ = true;
+
+  std::vector<const orbit_client_protos::TimerInfo*> timers_by_start_;
+  uint64_t max_timer_duration_ns_ = 0;
+
+  std::vector<uint64_t> sorted_durations_;
+  // Prefix sums over the timers in start order of the durations and of the squared deviations of
+  // the durations from their mean over all timers.
+  std::vector<uint64_t> duration_prefix_sums_;
+  std::vector<double> squared_deviation_prefix_sums_;
+  double mean_duration_ns_ = 0;
+  // A wavelet matrix over the ranks of the durations in `sorted_durations_`, in start order: level
+  // `l` holds bit `l` of each rank, counting from the most significant one, with the timers
+  // stably partitioned by the bits of the previous levels.
+  std::vector<RankedBitVector> rank_bits_per_level_;
+  std::vector<size_t> zeros_per_level_;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_SCOPE_TIMER_INDEX_H_
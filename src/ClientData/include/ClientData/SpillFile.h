@@ -0,0 +1,51 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_SPILL_FILE_H_
+#define CLIENT_DATA_SPILL_FILE_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "OrbitBase/Result.h"
+#include "OrbitBase/TemporaryFile.h"
+
+namespace orbit_client_data {
+
+// Append-only temporary file that capture data which is not needed in memory right now can be
+// moved to. Blocks of data are appended at the end of the file and read back by their offset. The
+// file is removed when this object is destroyed.
+// This class is thread-safe.
+class SpillFile {
+ public:
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+  SpillFile(SpillFile&&) = delete;
+  SpillFile& operator=(SpillFile&&) = delete;
+
+  [[nodiscard]] static ErrorMessageOr<std::unique_ptr<SpillFile>> Create();
+
+  // Writes `size` bytes at the end of the file and returns the offset they were written at.
+  [[nodiscard]] ErrorMessageOr<uint64_t> Append(const void* data, size_t size);
+
+  // Reads `size` bytes previously appended at `offset`.
+  [[nodiscard]] ErrorMessageOr<void> Read(uint64_t offset, void* data, size_t size) const;
+
+  [[nodiscard]] uint64_t size() const;
+
+ private:
+  explicit SpillFile(orbit_base::TemporaryFile file) : file_{std::move(file)} {}
+
+  orbit_base::TemporaryFile file_;
+  mutable absl::Mutex mutex_;
+  uint64_t size_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_SPILL_FILE_H_
@@ -0,0 +1,344 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CLIENT_DATA_SPILLABLE_TIME_SERIES_H_
+#define CLIENT_DATA_SPILLABLE_TIME_SERIES_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ClientData/SpillFile.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_client_data {
+
+// Sequence of elements of type T, each covering the time range
+// [T::begin_timestamp_ns(), T::end_timestamp_ns()]. Elements are assumed to be added sorted by
+// begin timestamp, and may overlap.
+//
+// Elements are stored in chunks of `kChunkSize`. For each skip block of `kSkipBlockSize` elements,
+// the maximum end timestamp of all the elements up to the end of the block is kept, so that queries
+// skip the elements that end before the queried time range with a binary search, and then only
+// visit the elements that start before its end: a query takes O(log n + k) if the elements do not
+// overlap.
+//
+// By default all elements are kept in memory. Once a SpillFile is set, the oldest chunks are moved
+// to the file as soon as more than `max_elements_in_memory` elements are held in memory, or when
+// the owner calls SpillOldestChunk to bound the memory of several time series together. Queries
+// that reach into the spilled time range load the corresponding chunks back from the file; the
+// most recently loaded chunks are cached.
+//
+// Elements are written to the file as they are in memory, so T has to be trivially copyable.
+// Add, SetSpillFile and SpillOldestChunk must not be called concurrently, but queries can be run
+// from any number of threads, also while elements are being added: a query visits a snapshot of the
+// elements added before it started, and does not block Add.
+template <typename T>
+class SpillableTimeSeries {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SpillableTimeSeries writes the elements to disk byte by byte");
+
+ public:
+  static constexpr size_t kChunkSize = 4096;
+  static constexpr size_t kSkipBlockSize = 64;
+  static constexpr size_t kDefaultMaxElementsInMemory = 16 * kChunkSize;
+  static constexpr size_t kMaxCachedChunks = 8;
+
+  explicit SpillableTimeSeries(size_t max_elements_in_memory = kDefaultMaxElementsInMemory)
+      : max_elements_in_memory_{std::max(max_elements_in_memory, kChunkSize)},
+        chunk_list_{std::make_shared<ChunkList>(kInitialChunkListCapacity)} {}
+
+  // Starts moving elements to `spill_file` from now on. The file needs to outlive this object.
+  void SetSpillFile(SpillFile* spill_file) {
+    ORBIT_CHECK(spill_file_ == nullptr);
+    spill_file_ = spill_file;
+    is_spilling_enabled_ = true;
+    SpillIfNecessary();
+  }
+
+  void Add(T element) {
+    max_end_timestamp_ns_ = std::max(max_end_timestamp_ns_, element.end_timestamp_ns());
+    if (open_chunk_ == nullptr || open_chunk_size_ == kChunkSize) {
+      open_chunk_ = std::make_shared<Chunk>(element.begin_timestamp_ns());
+      open_chunk_size_ = 0;
+    }
+    new (&open_chunk_->in_memory_elements[open_chunk_size_]) T(std::move(element));
+    open_chunk_->max_end_timestamp_ns_per_skip_block[open_chunk_size_ / kSkipBlockSize].store(
+        max_end_timestamp_ns_, std::memory_order_relaxed);
+    ++open_chunk_size_;
+    open_chunk_->size.store(open_chunk_size_, std::memory_order_release);
+    // A chunk is only published once it holds an element.
+    if (open_chunk_size_ == 1) AppendChunk(open_chunk_);
+
+    size_.fetch_add(1, std::memory_order_relaxed);
+    SpillIfNecessary();
+  }
+
+  [[nodiscard]] size_t size() const { return size_.load(std::memory_order_relaxed); }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+  [[nodiscard]] size_t num_spilled_elements() const {
+    return num_spilled_elements_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] size_t num_elements_in_memory() const { return size() - num_spilled_elements(); }
+
+  // Moves the oldest chunk still in memory to the SpillFile. That chunk has to be full, i.e., at
+  // least `num_spilled_elements() + kChunkSize` elements have to have been added. Returns false if
+  // nothing was spilled because no SpillFile is set or spilling has failed.
+  bool SpillOldestChunk() {
+    if (!is_spilling_enabled_) return false;
+    std::shared_ptr<const Chunk>& chunk_slot = chunk_list_->chunks[first_in_memory_chunk_index_];
+    ORBIT_CHECK(chunk_slot->size.load(std::memory_order_relaxed) == kChunkSize);
+
+    ErrorMessageOr<uint64_t> file_offset_or_error =
+        spill_file_->Append(chunk_slot->in_memory_elements.get(), kChunkSize * sizeof(T));
+    if (file_offset_or_error.has_error()) {
+      // What has already been spilled can still be read back.
+      ORBIT_ERROR("Unable to spill data to disk, keeping it in memory from now on: %s",
+                  file_offset_or_error.error().message());
+      is_spilling_enabled_ = false;
+      return false;
+    }
+
+    // Readers that still hold the in-memory chunk keep its elements alive.
+    std::atomic_store(&chunk_slot, std::shared_ptr<const Chunk>{std::make_shared<Chunk>(
+                                       *chunk_slot, file_offset_or_error.value())});
+    ++first_in_memory_chunk_index_;
+    num_spilled_elements_.fetch_add(kChunkSize, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Calls `action` on all elements that intersect [min_timestamp, max_timestamp), in order.
+  void ForEachIntersectingTimeRange(uint64_t min_timestamp, uint64_t max_timestamp,
+                                    const std::function<void(const T&)>& action) const {
+    VisitElementsEndingAtOrAfter(min_timestamp, [&](const T& element) {
+      if (element.begin_timestamp_ns() >= max_timestamp) return false;
+      if (element.end_timestamp_ns() >= min_timestamp) action(element);
+      return true;
+    });
+  }
+
+  // Returns the first element whose time range contains `timestamp`, if any.
+  [[nodiscard]] std::optional<T> FindContainingTimestamp(uint64_t timestamp) const {
+    if (timestamp == std::numeric_limits<uint64_t>::max()) return std::nullopt;
+    std::optional<T> result;
+    VisitElementsEndingAtOrAfter(timestamp + 1, [&](const T& element) {
+      if (element.begin_timestamp_ns() > timestamp) return false;
+      if (element.end_timestamp_ns() > timestamp) {
+        result.emplace(element);
+        return false;
+      }
+      return true;
+    });
+    return result;
+  }
+
+ private:
+  static constexpr size_t kSkipBlocksPerChunk = kChunkSize / kSkipBlockSize;
+  static constexpr size_t kInitialChunkListCapacity = 16;
+
+  using ElementStorage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+  // Only the writer modifies a chunk, and only the last one, by appending elements: readers first
+  // read `size` and then only access the elements and skip blocks before it.
+  struct Chunk {
+    // The elements are default-initialized, i.e., not zero-filled, so that only the pages that are
+    // actually written to are committed, e.g., for the many threads with only a few elements.
+    explicit Chunk(uint64_t begin_timestamp_ns)
+        : in_memory_elements{new ElementStorage[kChunkSize]},
+          begin_timestamp_ns{begin_timestamp_ns} {}
+
+    // A spilled copy of the full chunk `in_memory_chunk`, whose elements are at `file_offset`.
+    Chunk(const Chunk& in_memory_chunk, uint64_t file_offset)
+        : file_offset{file_offset},
+          begin_timestamp_ns{in_memory_chunk.begin_timestamp_ns},
+          size{in_memory_chunk.size.load(std::memory_order_relaxed)} {
+      for (size_t i = 0; i < kSkipBlocksPerChunk; ++i) {
+        max_end_timestamp_ns_per_skip_block[i].store(
+            in_memory_chunk.max_end_timestamp_ns_per_skip_block[i].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+      }
+    }
+
+    [[nodiscard]] const T* GetInMemoryElements() const {
+      return std::launder(reinterpret_cast<const T*>(in_memory_elements.get()));
+    }
+
+    // Null once spilled.
+    std::unique_ptr<ElementStorage[]> in_memory_elements;
+    std::optional<uint64_t> file_offset;
+    uint64_t begin_timestamp_ns;
+    std::atomic<size_t> size{0};
+    // For each skip block, the maximum end timestamp of all the elements of the time series up to
+    // the end of the block, which does not decrease from one skip block to the next.
+    std::array<std::atomic<uint64_t>, kSkipBlocksPerChunk> max_end_timestamp_ns_per_skip_block{};
+  };
+
+  // Readers access `chunk_list_` and its chunks only through std::atomic_load: the writer replaces
+  // the list when it needs to grow, and replaces a chunk with its spilled copy.
+  struct ChunkList {
+    explicit ChunkList(size_t capacity) : chunks(capacity) {}
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    std::atomic<size_t> size{0};
+  };
+
+  // Elements read back from the SpillFile. T is not necessarily default-constructible, so the
+  // bytes are read into suitably aligned storage and accessed through `begin()` and `end()`.
+  class LoadedChunk {
+   public:
+    explicit LoadedChunk(size_t num_elements) : storage_(num_elements) {}
+    [[nodiscard]] void* data() { return storage_.data(); }
+    [[nodiscard]] const T* begin() const {
+      return std::launder(reinterpret_cast<const T*>(storage_.data()));
+    }
+    [[nodiscard]] const T* end() const { return begin() + storage_.size(); }
+
+   private:
+    std::vector<ElementStorage> storage_;
+  };
+
+  void AppendChunk(std::shared_ptr<const Chunk> chunk) {
+    const size_t chunk_count = chunk_list_->size.load(std::memory_order_relaxed);
+    if (chunk_count == chunk_list_->chunks.size()) {
+      auto grown_chunk_list = std::make_shared<ChunkList>(2 * chunk_count);
+      std::copy(chunk_list_->chunks.begin(), chunk_list_->chunks.end(),
+                grown_chunk_list->chunks.begin());
+      grown_chunk_list->size.store(chunk_count, std::memory_order_relaxed);
+      std::atomic_store(&chunk_list_, std::move(grown_chunk_list));
+    }
+    // Readers do not access the slots past `size`.
+    chunk_list_->chunks[chunk_count] = std::move(chunk);
+    chunk_list_->size.store(chunk_count + 1, std::memory_order_release);
+  }
+
+  void SpillIfNecessary() {
+    // As `max_elements_in_memory_` is at least `kChunkSize`, the oldest chunk in memory is full
+    // whenever more elements than that are in memory.
+    while (num_elements_in_memory() > max_elements_in_memory_) {
+      if (!SpillOldestChunk()) return;
+    }
+  }
+
+  // Returns the chunk from the cache, or reads it from the SpillFile. Returns nullptr if the chunk
+  // cannot be read.
+  [[nodiscard]] std::shared_ptr<const LoadedChunk> LoadChunk(size_t chunk_index,
+                                                             const Chunk& spilled_chunk) const {
+    {
+      absl::MutexLock lock{&cache_mutex_};
+      auto cached_it =
+          std::find_if(cached_chunks_.begin(), cached_chunks_.end(),
+                       [chunk_index](const auto& cached) { return cached.first == chunk_index; });
+      if (cached_it != cached_chunks_.end()) {
+        cached_chunks_.splice(cached_chunks_.begin(), cached_chunks_, cached_it);
+        return cached_chunks_.front().second;
+      }
+    }
+
+    const size_t num_elements = spilled_chunk.size.load(std::memory_order_relaxed);
+    auto chunk = std::make_shared<LoadedChunk>(num_elements);
+    ErrorMessageOr<void> result = spill_file_->Read(spilled_chunk.file_offset.value(),
+                                                    chunk->data(), num_elements * sizeof(T));
+    if (result.has_error()) {
+      ORBIT_ERROR("Unable to read spilled data back from disk: %s", result.error().message());
+      return nullptr;
+    }
+
+    absl::MutexLock lock{&cache_mutex_};
+    cached_chunks_.emplace_front(chunk_index, chunk);
+    if (cached_chunks_.size() > kMaxCachedChunks) cached_chunks_.pop_back();
+    return chunk;
+  }
+
+  // Calls `visitor` in order on the elements, starting from the first skip block that holds an
+  // element ending at or after `timestamp`, until `visitor` returns false.
+  template <typename Visitor>
+  void VisitElementsEndingAtOrAfter(uint64_t timestamp, Visitor&& visitor) const {
+    const std::shared_ptr<const ChunkList> chunk_list = std::atomic_load(&chunk_list_);
+    const size_t chunk_count = chunk_list->size.load(std::memory_order_acquire);
+    auto get_chunk = [&chunk_list](size_t chunk_index) {
+      return std::atomic_load(&chunk_list->chunks[chunk_index]);
+    };
+    // The index of the first skip block among the first `size` elements of `chunk` whose maximum
+    // end timestamp is at least `timestamp`, or the number of skip blocks if there is none.
+    auto find_skip_block = [timestamp](const Chunk& chunk, size_t size) {
+      const size_t skip_block_count = (size + kSkipBlockSize - 1) / kSkipBlockSize;
+      auto skip_block_it = std::partition_point(
+          chunk.max_end_timestamp_ns_per_skip_block.begin(),
+          chunk.max_end_timestamp_ns_per_skip_block.begin() + skip_block_count,
+          [timestamp](const std::atomic<uint64_t>& max_end_timestamp_ns) {
+            return max_end_timestamp_ns.load(std::memory_order_relaxed) < timestamp;
+          });
+      return static_cast<size_t>(skip_block_it - chunk.max_end_timestamp_ns_per_skip_block.begin());
+    };
+
+    size_t first_chunk_index = 0;
+    size_t last_chunk_index = chunk_count;
+    while (first_chunk_index < last_chunk_index) {
+      const size_t chunk_index = first_chunk_index + (last_chunk_index - first_chunk_index) / 2;
+      const std::shared_ptr<const Chunk> chunk = get_chunk(chunk_index);
+      const size_t size = chunk->size.load(std::memory_order_acquire);
+      if (find_skip_block(*chunk, size) * kSkipBlockSize >= size) {
+        first_chunk_index = chunk_index + 1;
+      } else {
+        last_chunk_index = chunk_index;
+      }
+    }
+
+    for (size_t chunk_index = first_chunk_index; chunk_index < chunk_count; ++chunk_index) {
+      const std::shared_ptr<const Chunk> chunk = get_chunk(chunk_index);
+      const size_t size = chunk->size.load(std::memory_order_acquire);
+      const size_t first_element_index =
+          chunk_index == first_chunk_index ? find_skip_block(*chunk, size) * kSkipBlockSize : 0;
+
+      std::shared_ptr<const LoadedChunk> loaded_chunk;
+      const T* elements = nullptr;
+      if (chunk->file_offset.has_value()) {
+        loaded_chunk = LoadChunk(chunk_index, *chunk);
+        if (loaded_chunk == nullptr) continue;
+        elements = loaded_chunk->begin();
+      } else {
+        elements = chunk->GetInMemoryElements();
+      }
+      for (size_t i = first_element_index; i < size; ++i) {
+        if (!visitor(elements[i])) return;
+      }
+    }
+  }
+
+  size_t max_elements_in_memory_;
+  SpillFile* spill_file_ = nullptr;
+  bool is_spilling_enabled_ = false;
+  std::atomic<size_t> size_ = 0;
+  std::atomic<size_t> num_spilled_elements_ = 0;
+
+  // Only accessed by the writer.
+  std::shared_ptr<Chunk> open_chunk_;
+  size_t open_chunk_size_ = 0;
+  size_t first_in_memory_chunk_index_ = 0;
+  uint64_t max_end_timestamp_ns_ = 0;
+
+  std::shared_ptr<ChunkList> chunk_list_;
+
+  mutable absl::Mutex cache_mutex_;
+  // Most recently used first.
+  mutable std::list<std::pair<size_t, std::shared_ptr<const LoadedChunk>>> cached_chunks_
+      ABSL_GUARDED_BY(cache_mutex_);
+};
+
+}  // namespace orbit_client_data
+
+#endif  // CLIENT_DATA_SPILLABLE_TIME_SERIES_H_
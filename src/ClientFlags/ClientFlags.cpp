@@ -46,6 +46,9 @@ ABSL_FLAG(std::string, instance_symbols_folder, "",
 ABSL_FLAG(bool, enforce_full_redraw, false,
           "Enforce full redraw every frame (used for performance measurements)");
 
+ABSL_FLAG(bool, parallel_track_updates, false,
+          "Update the primitives of the visible tracks on multiple threads");
+
 // VSI
 ABSL_FLAG(std::string, target_process, "",
           "Process name or path. Specify this together with --target_instance to skip the "
@@ -94,4 +97,8 @@ ABSL_FLAG(bool, tracepoint_callstack_collection, false,
 ABSL_FLAG(bool, symbol_store_support, false, "Enable experimental symbol store support.");
 
 // Disables retrieving symbols from the instance. This is intended for symbol store e2e tests.
-ABSL_FLAG(bool, disable_instance_symbols, false, "Disable retrieving symbols from the instance.");
\ No newline at end of file
+ABSL_FLAG(bool, disable_instance_symbols, false, "Disable retrieving symbols from the instance.");
+
+ABSL_FLAG(bool, disk_backed_capture, false,
+          "Move older capture data to a temporary file on disk during live captures, so that the "
+          "memory used by the client stays bounded for long captures.");
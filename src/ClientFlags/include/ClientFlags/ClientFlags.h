@@ -47,6 +47,8 @@ ABSL_DECLARE_FLAG(std::string, instance_symbols_folder);
 
 ABSL_DECLARE_FLAG(bool, enforce_full_redraw);
 
+ABSL_DECLARE_FLAG(bool, parallel_track_updates);
+
 // VSI
 ABSL_DECLARE_FLAG(std::string, target_process);
 ABSL_DECLARE_FLAG(std::string, target_instance);
@@ -82,4 +84,7 @@ ABSL_DECLARE_FLAG(bool, symbol_store_support);
 // Disables retrieving symbols from the instance.
 ABSL_DECLARE_FLAG(bool, disable_instance_symbols);
 
+// Enables moving older capture data to disk during live captures.
+ABSL_DECLARE_FLAG(bool, disk_backed_capture);
+
 #endif  // CLIENT_FLAGS_CLIENT_FLAGS_H_
@@ -4,13 +4,16 @@
 
 #include "ClientModel/SamplingDataPostProcessor.h"
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <absl/hash/hash.h>
 
 #include <algorithm>
 #include <cstdint>
-#include <memory>
+#include <limits>
 #include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -20,9 +23,8 @@
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/ParallelFor.h"
 #include "OrbitBase/ThreadConstants.h"
-#include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
 
 using orbit_client_data::CallstackData;
 using orbit_client_data::CallstackEvent;
@@ -32,6 +34,7 @@ using orbit_client_data::CaptureData;
 using orbit_client_data::ModuleManager;
 using orbit_client_data::PostProcessedSamplingData;
 using orbit_client_data::SampledFunction;
+using orbit_client_data::SymbolizedAddress;
 using orbit_client_data::ThreadID;
 using orbit_client_data::ThreadSampleData;
 
@@ -39,74 +42,143 @@ namespace orbit_client_model {
 
 namespace {
 
-using CallstackInfoAsPairWithLvalueRefToFrames =
-    std::pair<const std::vector<uint64_t>&, CallstackType>;
+// Number of distinct callstacks of a thread that FillThreadSampleDataCounts processes as one task.
+constexpr size_t kCallstacksPerTask = 256;
 
-// CallstackInfoHash and CallstackInfoEq allow heterogeneous lookup in
-// SamplingDataPostProcessor::resolved_callstack_to_id_;
-struct CallstackInfoHash {
-  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
-
-  size_t operator()(const CallstackInfo& o) const { return absl::Hash<CallstackInfo>{}(o); }
-
-  size_t operator()(const CallstackInfoAsPairWithLvalueRefToFrames& p) const {
-    return absl::Hash<CallstackInfoAsPairWithLvalueRefToFrames>{}(p);
+// Concatenates the events of all threads by callstack id. Callstack ids are split into one shard
+// per hardware thread, and each shard is merged in parallel.
+ThreadSampleData CreateSummary(const std::vector<ThreadSampleData>& thread_sample_data) {
+  ThreadSampleData summary;
+  summary.thread_id = orbit_base::kAllProcessThreadsTid;
+  for (const ThreadSampleData& data : thread_sample_data) {
+    summary.samples_count += data.samples_count;
   }
-};
 
-struct CallstackInfoEq {
-  using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
+  const size_t shard_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<absl::flat_hash_map<uint64_t, std::vector<CallstackEvent>>> shards(shard_count);
+  orbit_base::ParallelFor(shard_count, [&thread_sample_data, &shards,
+                                        shard_count](size_t shard_index) {
+    absl::flat_hash_map<uint64_t, std::vector<CallstackEvent>>& shard = shards[shard_index];
+    for (const ThreadSampleData& data : thread_sample_data) {
+      for (const auto& [callstack_id, events] : data.sampled_callstack_id_to_events) {
+        if (absl::Hash<uint64_t>{}(callstack_id) % shard_count != shard_index) continue;
+        std::vector<CallstackEvent>& shard_events = shard[callstack_id];
+        shard_events.insert(shard_events.end(), events.begin(), events.end());
+      }
+    }
+  });
 
-  bool operator()(const CallstackInfo& lhs, const CallstackInfo& rhs) const {
-    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.frames().begin(),
-                      rhs.frames().end()) &&
-           lhs.type() == rhs.type();
+  size_t callstack_count = 0;
+  for (const auto& shard : shards) callstack_count += shard.size();
+  summary.sampled_callstack_id_to_events.reserve(callstack_count);
+  for (auto& shard : shards) {
+    for (auto& [callstack_id, events] : shard) {
+      summary.sampled_callstack_id_to_events.emplace(callstack_id, std::move(events));
+    }
   }
+  return summary;
+}
 
-  bool operator()(const CallstackInfo& lhs,
-                  const CallstackInfoAsPairWithLvalueRefToFrames& rhs) const {
-    return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.first.begin(),
-                      rhs.first.end()) &&
-           lhs.type() == rhs.second;
-  }
-};
+// Sorts and deduplicates the frames of a callstack that count for statistics: all of them for
+// kComplete callstacks, only the innermost one otherwise, as it's the only one known to be correct.
+// Note that, in the vast majority of cases, the innermost frame is also the only one available.
+std::vector<uint64_t> GetUniqueFramesForStatistics(const CallstackInfo& callstack) {
+  ORBIT_CHECK(!callstack.frames().empty());
+  if (callstack.type() != CallstackType::kComplete) return {callstack.frames()[0]};
+
+  // We need to consider duplicated frames (because of recursion) only once. We should use a set
+  // for better time complexity but sorting and comparing adjacent elements is faster in practice
+  // for a number of elements in the order of the number of frames in a callstack.
+  std::vector<uint64_t> frames(callstack.frames().begin(), callstack.frames().end());
+  std::sort(frames.begin(), frames.end());
+  frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+  return frames;
+}
 
+// Post-processes the CallstackEvents of a capture, or of a selection, into
+// PostProcessedSamplingData. Every address and callstack is resolved and symbolized only once per
+// run. Nothing is kept between runs, as the results depend on the loaded symbols and on the types
+// of the callstacks.
 class SamplingDataPostProcessor {
  public:
-  explicit SamplingDataPostProcessor() = default;
-  SamplingDataPostProcessor& operator=(const SamplingDataPostProcessor& other) = default;
-  SamplingDataPostProcessor(const SamplingDataPostProcessor& other) = default;
+  [[nodiscard]] PostProcessedSamplingData ProcessSamples(const CallstackData& callstack_data,
+                                                         const CaptureData& capture_data,
+                                                         const ModuleManager& module_manager,
+                                                         bool generate_summary);
 
-  SamplingDataPostProcessor(SamplingDataPostProcessor&& other) = default;
-  SamplingDataPostProcessor& operator=(SamplingDataPostProcessor&& other) = default;
+ private:
+  using CallstackInfoAsPairWithLvalueRefToFrames =
+      std::pair<const std::vector<uint64_t>&, CallstackType>;
 
-  PostProcessedSamplingData ProcessSamples(const CallstackData& callstack_data,
-                                           const CaptureData& capture_data,
-                                           const ModuleManager& module_manager,
-                                           bool generate_summary);
+  // CallstackInfoHash and CallstackInfoEq allow heterogeneous lookup in resolved_callstack_to_id_.
+  struct CallstackInfoHash {
+    using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
 
- private:
-  void ResolveCallstacks(const CallstackData& callstack_data, const CaptureData& capture_data,
-                         const ModuleManager& module_manager);
+    size_t operator()(const CallstackInfo& o) const { return absl::Hash<CallstackInfo>{}(o); }
+
+    size_t operator()(const CallstackInfoAsPairWithLvalueRefToFrames& p) const {
+      return absl::Hash<CallstackInfoAsPairWithLvalueRefToFrames>{}(p);
+    }
+  };
 
-  void MapAddressToFunctionAddress(uint64_t absolute_address, const CaptureData& capture_data,
-                                   const ModuleManager& module_manager);
+  struct CallstackInfoEq {
+    using is_transparent = void;  // Makes this functor transparent, enabling heterogeneous lookup.
 
-  void FillThreadSampleDataSampleReports(const CaptureData& capture_data,
+    bool operator()(const CallstackInfo& lhs, const CallstackInfo& rhs) const {
+      return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.frames().begin(),
+                        rhs.frames().end()) &&
+             lhs.type() == rhs.type();
+    }
+
+    bool operator()(const CallstackInfo& lhs,
+                    const CallstackInfoAsPairWithLvalueRefToFrames& rhs) const {
+      return std::equal(lhs.frames().begin(), lhs.frames().end(), rhs.first.begin(),
+                        rhs.first.end()) &&
+             lhs.type() == rhs.second;
+    }
+  };
+
+  struct SymbolizedFunction {
+    std::string name;
+    std::string module_path;
+  };
+
+  using ThreadIdToSampleData = absl::flat_hash_map<ThreadID, ThreadSampleData>;
+
+  // Completes the per-thread counters of the events of `callstack_data` with the resolved and
+  // symbolized data.
+  [[nodiscard]] PostProcessedSamplingData PostProcessCountedSamples(
+      ThreadIdToSampleData thread_id_to_sample_data, const CallstackData& callstack_data,
+      const CaptureData& capture_data, const ModuleManager& module_manager);
+
+  // Resolves the callstacks of `callstack_data` that were not resolved yet, and returns the ids of
+  // all its callstacks.
+  [[nodiscard]] std::vector<uint64_t> ResolveNewCallstacks(const CallstackData& callstack_data,
+                                                           const CaptureData& capture_data,
+                                                           const ModuleManager& module_manager);
+
+  void MapNewAddressesToFunctionAddresses(
+      const std::vector<std::pair<uint64_t, CallstackInfo>>& new_callstacks,
+      const CaptureData& capture_data, const ModuleManager& module_manager);
+
+  // Counts the sampled and resolved addresses of each thread from its callstacks, in parallel
+  // over the threads and over chunks of their callstacks.
+  void FillThreadSampleDataCounts(const CallstackData& callstack_data,
+                                  ThreadIdToSampleData* thread_id_to_sample_data) const;
+
+  void FillThreadSampleDataSampleReports(ThreadIdToSampleData* thread_id_to_sample_data,
+                                         const CaptureData& capture_data,
                                          const ModuleManager& module_manager);
 
-  // Filled by ProcessSamples.
-  absl::flat_hash_map<ThreadID, ThreadSampleData> thread_id_to_sample_data_;
+  absl::flat_hash_map<uint64_t, uint64_t> exact_address_to_function_address_;
   absl::flat_hash_map<uint64_t, CallstackInfo> id_to_resolved_callstack_;
-  absl::flat_hash_map<orbit_client_data::CallstackInfo, uint64_t, CallstackInfoHash,
-                      CallstackInfoEq>
+  absl::flat_hash_map<CallstackInfo, uint64_t, CallstackInfoHash, CallstackInfoEq>
       resolved_callstack_to_id_;
   absl::flat_hash_map<uint64_t, uint64_t> original_id_to_resolved_callstack_id_;
-  absl::flat_hash_map<uint64_t, absl::flat_hash_set<uint64_t>>
-      function_address_to_sampled_callstack_ids_;
-  absl::flat_hash_map<uint64_t, uint64_t> exact_address_to_function_address_;
+  absl::flat_hash_map<uint64_t, SymbolizedFunction> resolved_address_to_symbolized_function_;
 };
 
+
 }  // namespace
 
 PostProcessedSamplingData CreatePostProcessedSamplingData(const CallstackData& callstack_data,
@@ -118,147 +190,99 @@ PostProcessedSamplingData CreatePostProcessedSamplingData(const CallstackData& c
                                                     generate_summary);
 }
 
-namespace {
 PostProcessedSamplingData SamplingDataPostProcessor::ProcessSamples(
     const CallstackData& callstack_data, const CaptureData& capture_data,
     const ModuleManager& module_manager, bool generate_summary) {
-  // Unique call stacks and per thread data
-  callstack_data.ForEachCallstackEvent([this, &callstack_data,
-                                        generate_summary](const CallstackEvent& event) {
-    const CallstackInfo* callstack_info = callstack_data.GetCallstack(event.callstack_id());
-    ORBIT_CHECK(callstack_info != nullptr);
-
-    std::vector<uint64_t> sorted_frames;
-    ORBIT_CHECK(!callstack_info->frames().empty());
-    if (callstack_info->type() == CallstackType::kComplete) {
-      for (uint64_t frame : callstack_info->frames()) {
-        sorted_frames.push_back(frame);
-      }
-    } else {
-      // For non-kComplete callstacks, only use the innermost frame for statistics, as it's the only
-      // one known to be correct. Note that, in the vast majority of cases, the innermost frame is
-      // also the only one available.
-      sorted_frames.push_back(callstack_info->frames()[0]);
-    }
-
-    // We need to consider duplicated frames (because of recursion) only once. We should use a set
-    // for better time complexity but sorting and comparing adjacent elements is faster in practice
-    // for a number of elements in the order of the number of frames in a callstack.
-    std::sort(sorted_frames.begin(), sorted_frames.end());
-
-    ThreadSampleData* thread_sample_data = &thread_id_to_sample_data_[event.thread_id()];
-    thread_sample_data->thread_id = event.thread_id();
-    thread_sample_data->samples_count++;
-    thread_sample_data->sampled_callstack_id_to_events[event.callstack_id()].emplace_back(event);
-    for (size_t i = 0; i < sorted_frames.size(); ++i) {
-      if (i != 0 && sorted_frames[i] == sorted_frames[i - 1]) {
-        continue;
-      }
-      thread_sample_data->sampled_address_to_count[sorted_frames[i]]++;
-    }
-
-    if (!generate_summary) {
-      return;
-    }
-    ThreadSampleData* all_thread_sample_data =
-        &thread_id_to_sample_data_[orbit_base::kAllProcessThreadsTid];
-    all_thread_sample_data->thread_id = orbit_base::kAllProcessThreadsTid;
-    all_thread_sample_data->samples_count++;
-    all_thread_sample_data->sampled_callstack_id_to_events[event.callstack_id()].emplace_back(
-        event);
-    for (size_t i = 0; i < sorted_frames.size(); ++i) {
-      if (i != 0 && sorted_frames[i] == sorted_frames[i - 1]) {
-        continue;
-      }
-      all_thread_sample_data->sampled_address_to_count[sorted_frames[i]]++;
-    }
+  // Each thread is counted in parallel.
+  const std::vector<uint32_t> thread_ids = callstack_data.GetThreadIds();
+  std::vector<ThreadSampleData> thread_sample_data(thread_ids.size());
+  orbit_base::ParallelFor(thread_ids.size(), [&callstack_data, &thread_ids,
+                                              &thread_sample_data](size_t index) {
+    ThreadSampleData& data = thread_sample_data[index];
+    data.thread_id = thread_ids[index];
+    callstack_data.ForEachCallstackEventOfTidInTimeRange(
+        thread_ids[index], 0, std::numeric_limits<uint64_t>::max(),
+        [&data](const CallstackEvent& event) {
+          data.samples_count++;
+          data.sampled_callstack_id_to_events[event.callstack_id()].emplace_back(event);
+        });
   });
 
-  ResolveCallstacks(callstack_data, capture_data, module_manager);
-
-  for (auto& sample_data_it : thread_id_to_sample_data_) {
-    ThreadSampleData* thread_sample_data = &sample_data_it.second;
-
-    // Address count per sample per thread
-    for (const auto& [sampled_callstack_id, callstack_events] :
-         thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t callstack_count = callstack_events.size();
-      uint64_t resolved_callstack_id = original_id_to_resolved_callstack_id_[sampled_callstack_id];
-      const CallstackInfo& resolved_callstack = id_to_resolved_callstack_.at(resolved_callstack_id);
-
-      // "Exclusive" stat.
-      ORBIT_CHECK(!resolved_callstack.frames().empty());
-      thread_sample_data->resolved_address_to_exclusive_count[resolved_callstack.frames()[0]] +=
-          callstack_count;
-
-      absl::flat_hash_set<uint64_t> unique_resolved_addresses;
-      if (resolved_callstack.type() == CallstackType::kComplete) {
-        for (uint64_t resolved_address : resolved_callstack.frames()) {
-          unique_resolved_addresses.insert(resolved_address);
-        }
-      } else {
-        // For non-kComplete callstacks, only use the innermost frame for statistics.
-        unique_resolved_addresses.insert(resolved_callstack.frames()[0]);
-      }
+  ThreadIdToSampleData thread_id_to_sample_data;
+  if (generate_summary && !thread_sample_data.empty()) {
+    thread_id_to_sample_data.emplace(orbit_base::kAllProcessThreadsTid,
+                                     CreateSummary(thread_sample_data));
+  }
+  for (ThreadSampleData& data : thread_sample_data) {
+    const ThreadID thread_id = data.thread_id;
+    thread_id_to_sample_data.emplace(thread_id, std::move(data));
+  }
+  return PostProcessCountedSamples(std::move(thread_id_to_sample_data), callstack_data,
+                                   capture_data, module_manager);
+}
 
-      // "Inclusive" stat.
-      for (uint64_t resolved_address : unique_resolved_addresses) {
-        thread_sample_data->resolved_address_to_count[resolved_address] += callstack_count;
-      }
+PostProcessedSamplingData SamplingDataPostProcessor::PostProcessCountedSamples(
+    ThreadIdToSampleData thread_id_to_sample_data, const CallstackData& callstack_data,
+    const CaptureData& capture_data, const ModuleManager& module_manager) {
+  const std::vector<uint64_t> callstack_ids =
+      ResolveNewCallstacks(callstack_data, capture_data, module_manager);
 
-      // "Unwind errors" stat.
-      if (resolved_callstack.type() != CallstackType::kComplete) {
-        thread_sample_data->resolved_address_to_error_count[resolved_callstack.frames()[0]] +=
-            callstack_count;
+  absl::flat_hash_map<uint64_t, CallstackInfo> id_to_resolved_callstack;
+  absl::flat_hash_map<uint64_t, uint64_t> original_id_to_resolved_callstack_id;
+  absl::flat_hash_map<uint64_t, absl::flat_hash_set<uint64_t>>
+      function_address_to_sampled_callstack_ids;
+  original_id_to_resolved_callstack_id.reserve(callstack_ids.size());
+  for (uint64_t callstack_id : callstack_ids) {
+    const uint64_t resolved_callstack_id = original_id_to_resolved_callstack_id_.at(callstack_id);
+    const CallstackInfo& resolved_callstack = id_to_resolved_callstack_.at(resolved_callstack_id);
+    original_id_to_resolved_callstack_id.emplace(callstack_id, resolved_callstack_id);
+    id_to_resolved_callstack.try_emplace(resolved_callstack_id, resolved_callstack);
+
+    if (resolved_callstack.type() == CallstackType::kComplete) {
+      for (uint64_t function_address : resolved_callstack.frames()) {
+        function_address_to_sampled_callstack_ids[function_address].insert(callstack_id);
       }
-    }
-
-    // For each thread, sort resolved (function) addresses by inclusive count.
-    for (const auto& address_count_it : thread_sample_data->resolved_address_to_count) {
-      const uint64_t address = address_count_it.first;
-      const uint32_t count = address_count_it.second;
-      thread_sample_data->sorted_count_to_resolved_address.insert(std::make_pair(count, address));
+    } else {
+      // For non-kComplete callstacks, only use the innermost frame for statistics.
+      function_address_to_sampled_callstack_ids[resolved_callstack.frames()[0]].insert(
+          callstack_id);
     }
   }
 
-  FillThreadSampleDataSampleReports(capture_data, module_manager);
+  FillThreadSampleDataCounts(callstack_data, &thread_id_to_sample_data);
+  FillThreadSampleDataSampleReports(&thread_id_to_sample_data, capture_data, module_manager);
 
-  return {std::move(thread_id_to_sample_data_), std::move(id_to_resolved_callstack_),
-          std::move(original_id_to_resolved_callstack_id_),
-          std::move(function_address_to_sampled_callstack_ids_)};
+  return {std::move(thread_id_to_sample_data), std::move(id_to_resolved_callstack),
+          std::move(original_id_to_resolved_callstack_id),
+          std::move(function_address_to_sampled_callstack_ids)};
 }
 
-void SamplingDataPostProcessor::ResolveCallstacks(const CallstackData& callstack_data,
-                                                  const CaptureData& capture_data,
-                                                  const ModuleManager& module_manager) {
-  callstack_data.ForEachUniqueCallstack([this, &capture_data, &module_manager](
+std::vector<uint64_t> SamplingDataPostProcessor::ResolveNewCallstacks(
+    const CallstackData& callstack_data, const CaptureData& capture_data,
+    const ModuleManager& module_manager) {
+  std::vector<uint64_t> callstack_ids;
+  std::vector<std::pair<uint64_t, CallstackInfo>> new_callstacks;
+  callstack_data.ForEachUniqueCallstack([this, &callstack_ids, &new_callstacks](
                                             uint64_t callstack_id, const CallstackInfo& callstack) {
+    callstack_ids.push_back(callstack_id);
+    if (!original_id_to_resolved_callstack_id_.contains(callstack_id)) {
+      new_callstacks.emplace_back(callstack_id, callstack);
+    }
+  });
+
+  MapNewAddressesToFunctionAddresses(new_callstacks, capture_data, module_manager);
+
+  for (const auto& [callstack_id, callstack] : new_callstacks) {
     // A "resolved callstack" is a callstack where every address is replaced by the start address of
     // the function (if known).
     std::vector<uint64_t> resolved_callstack_frames;
 
     for (uint64_t address : callstack.frames()) {
-      if (!exact_address_to_function_address_.contains(address)) {
-        MapAddressToFunctionAddress(address, capture_data, module_manager);
-      }
       auto function_address_it = exact_address_to_function_address_.find(address);
       ORBIT_CHECK(function_address_it != exact_address_to_function_address_.end());
       resolved_callstack_frames.push_back(function_address_it->second);
     }
 
-    if (callstack.type() == CallstackType::kComplete) {
-      for (uint64_t function_address : resolved_callstack_frames) {
-        // Create a new entry if it doesn't exist.
-        auto it = function_address_to_sampled_callstack_ids_.try_emplace(function_address).first;
-        it->second.insert(callstack_id);
-      }
-    } else {
-      // For non-kComplete callstacks, only use the innermost frame for statistics.
-      auto it = function_address_to_sampled_callstack_ids_.try_emplace(resolved_callstack_frames[0])
-                    .first;
-      it->second.insert(callstack_id);
-    }
-
     CallstackType resolved_callstack_type = callstack.type();
 
     // Check if we already have this resolved callstack, and if not, create one.
@@ -279,27 +303,176 @@ void SamplingDataPostProcessor::ResolveCallstacks(const CallstackData& callstack
     }
 
     original_id_to_resolved_callstack_id_[callstack_id] = resolved_callstack_id;
-  });
+  }
+
+  return callstack_ids;
 }
 
-void SamplingDataPostProcessor::MapAddressToFunctionAddress(uint64_t absolute_address,
-                                                            const CaptureData& capture_data,
-                                                            const ModuleManager& module_manager) {
+void SamplingDataPostProcessor::MapNewAddressesToFunctionAddresses(
+    const std::vector<std::pair<uint64_t, CallstackInfo>>& new_callstacks,
+    const CaptureData& capture_data, const ModuleManager& module_manager) {
   // SamplingDataPostProcessor relies heavily on the association between address and function
   // address held by exact_address_to_function_address_, otherwise each address is considered a
   // different function. We are storing this mapping for faster lookup.
-  std::optional<uint64_t> absolute_function_address_option =
-      orbit_client_data::FindFunctionAbsoluteAddressByInstructionAbsoluteAddress(
-          module_manager, capture_data, absolute_address);
-  uint64_t absolute_function_address = absolute_function_address_option.value_or(absolute_address);
+  absl::flat_hash_set<uint64_t> unique_new_addresses;
+  for (const auto& [unused_callstack_id, callstack] : new_callstacks) {
+    for (uint64_t address : callstack.frames()) {
+      if (!exact_address_to_function_address_.contains(address)) {
+        unique_new_addresses.insert(address);
+      }
+    }
+  }
+  if (unique_new_addresses.empty()) return;
+
+  const std::vector<uint64_t> absolute_addresses(unique_new_addresses.begin(),
+                                                 unique_new_addresses.end());
+  const std::vector<SymbolizedAddress> symbolized_addresses =
+      orbit_client_data::SymbolizeAddresses(module_manager, capture_data, absolute_addresses);
+
+  exact_address_to_function_address_.reserve(exact_address_to_function_address_.size() +
+                                             absolute_addresses.size());
+  for (size_t i = 0; i < absolute_addresses.size(); ++i) {
+    exact_address_to_function_address_[absolute_addresses[i]] =
+        symbolized_addresses[i].function_absolute_address.value_or(absolute_addresses[i]);
+  }
+}
 
-  exact_address_to_function_address_[absolute_address] = absolute_function_address;
+void SamplingDataPostProcessor::FillThreadSampleDataCounts(
+    const CallstackData& callstack_data, ThreadIdToSampleData* thread_id_to_sample_data) const {
+  struct Counts {
+    absl::flat_hash_map<uint64_t, uint32_t> sampled_address_to_count;
+    absl::flat_hash_map<uint64_t, uint32_t> resolved_address_to_count;
+    absl::flat_hash_map<uint64_t, uint32_t> resolved_address_to_exclusive_count;
+    absl::flat_hash_map<uint64_t, uint32_t> resolved_address_to_error_count;
+  };
+  // The distinct callstacks of a thread, [begin, end) in its `callstack_ids_and_counts`.
+  struct Task {
+    size_t thread_index;
+    size_t begin;
+    size_t end;
+    Counts counts;
+  };
+
+  // Split the callstacks of each thread into tasks, with each thread's tasks next to each other.
+  std::vector<ThreadSampleData*> thread_sample_data;
+  std::vector<std::vector<std::pair<uint64_t, uint32_t>>> callstack_ids_and_counts;
+  std::vector<size_t> first_task_indices;
+  std::vector<Task> tasks;
+  for (auto& [unused_thread_id, data] : *thread_id_to_sample_data) {
+    const size_t thread_index = thread_sample_data.size();
+    thread_sample_data.push_back(&data);
+    std::vector<std::pair<uint64_t, uint32_t>>& thread_callstack_ids_and_counts =
+        callstack_ids_and_counts.emplace_back();
+    thread_callstack_ids_and_counts.reserve(data.sampled_callstack_id_to_events.size());
+    for (const auto& [callstack_id, events] : data.sampled_callstack_id_to_events) {
+      thread_callstack_ids_and_counts.emplace_back(callstack_id, events.size());
+    }
+    first_task_indices.push_back(tasks.size());
+    for (size_t begin = 0; begin < thread_callstack_ids_and_counts.size();
+         begin += kCallstacksPerTask) {
+      tasks.push_back(Task{thread_index, begin,
+                           std::min(begin + kCallstacksPerTask,
+                                    thread_callstack_ids_and_counts.size()),
+                           Counts{}});
+    }
+  }
+  first_task_indices.push_back(tasks.size());
+
+  orbit_base::ParallelFor(tasks.size(), [this, &callstack_data, &callstack_ids_and_counts,
+                                         &tasks](size_t task_index) {
+    Task& task = tasks[task_index];
+    Counts& counts = task.counts;
+    for (size_t i = task.begin; i < task.end; ++i) {
+      const auto [sampled_callstack_id, callstack_count] =
+          callstack_ids_and_counts[task.thread_index][i];
+
+      const CallstackInfo* callstack_info = callstack_data.GetCallstack(sampled_callstack_id);
+      ORBIT_CHECK(callstack_info != nullptr);
+      for (uint64_t address : GetUniqueFramesForStatistics(*callstack_info)) {
+        counts.sampled_address_to_count[address] += callstack_count;
+      }
+
+      uint64_t resolved_callstack_id =
+          original_id_to_resolved_callstack_id_.at(sampled_callstack_id);
+      const CallstackInfo& resolved_callstack = id_to_resolved_callstack_.at(resolved_callstack_id);
+
+      // "Exclusive" stat.
+      ORBIT_CHECK(!resolved_callstack.frames().empty());
+      counts.resolved_address_to_exclusive_count[resolved_callstack.frames()[0]] +=
+          callstack_count;
+
+      // "Inclusive" stat.
+      for (uint64_t resolved_address : GetUniqueFramesForStatistics(resolved_callstack)) {
+        counts.resolved_address_to_count[resolved_address] += callstack_count;
+      }
+
+      // "Unwind errors" stat.
+      if (resolved_callstack.type() != CallstackType::kComplete) {
+        counts.resolved_address_to_error_count[resolved_callstack.frames()[0]] += callstack_count;
+      }
+    }
+  });
+
+  // Merge the counts of the tasks of each thread, with the threads in parallel.
+  orbit_base::ParallelFor(thread_sample_data.size(), [&thread_sample_data, &first_task_indices,
+                                                      &tasks](size_t thread_index) {
+    ThreadSampleData* data = thread_sample_data[thread_index];
+    auto merge = [](absl::flat_hash_map<uint64_t, uint32_t>& from,
+                    absl::flat_hash_map<uint64_t, uint32_t>* to) {
+      if (to->empty()) {
+        *to = std::move(from);
+        return;
+      }
+      for (const auto& [address, count] : from) (*to)[address] += count;
+    };
+    for (size_t task_index = first_task_indices[thread_index];
+         task_index < first_task_indices[thread_index + 1]; ++task_index) {
+      Counts& counts = tasks[task_index].counts;
+      merge(counts.sampled_address_to_count, &data->sampled_address_to_count);
+      merge(counts.resolved_address_to_count, &data->resolved_address_to_count);
+      merge(counts.resolved_address_to_exclusive_count,
+            &data->resolved_address_to_exclusive_count);
+      merge(counts.resolved_address_to_error_count, &data->resolved_address_to_error_count);
+    }
+
+    // For each thread, sort resolved (function) addresses by inclusive count.
+    for (const auto& [address, count] : data->resolved_address_to_count) {
+      data->sorted_count_to_resolved_address.insert(std::make_pair(count, address));
+    }
+  });
 }
 
 void SamplingDataPostProcessor::FillThreadSampleDataSampleReports(
-    const CaptureData& capture_data, const ModuleManager& module_manager) {
-  for (auto& data : thread_id_to_sample_data_) {
-    ThreadSampleData* thread_sample_data = &data.second;
+    ThreadIdToSampleData* thread_id_to_sample_data, const CaptureData& capture_data,
+    const ModuleManager& module_manager) {
+  absl::flat_hash_set<uint64_t> unique_new_resolved_addresses;
+  for (const auto& [unused_thread_id, thread_sample_data] : *thread_id_to_sample_data) {
+    for (const auto& [unused_count, absolute_address] :
+         thread_sample_data.sorted_count_to_resolved_address) {
+      if (!resolved_address_to_symbolized_function_.contains(absolute_address)) {
+        unique_new_resolved_addresses.insert(absolute_address);
+      }
+    }
+  }
+  const std::vector<uint64_t> resolved_addresses(unique_new_resolved_addresses.begin(),
+                                                 unique_new_resolved_addresses.end());
+  const std::vector<SymbolizedAddress> symbolized_addresses =
+      orbit_client_data::SymbolizeAddresses(module_manager, capture_data, resolved_addresses);
+  for (size_t i = 0; i < resolved_addresses.size(); ++i) {
+    resolved_address_to_symbolized_function_.emplace(
+        resolved_addresses[i], SymbolizedFunction{*symbolized_addresses[i].function_name,
+                                                  *symbolized_addresses[i].module_path});
+  }
+
+  std::vector<ThreadSampleData*> thread_sample_data_to_fill;
+  thread_sample_data_to_fill.reserve(thread_id_to_sample_data->size());
+  for (auto& [unused_thread_id, thread_sample_data] : *thread_id_to_sample_data) {
+    thread_sample_data_to_fill.push_back(&thread_sample_data);
+  }
+
+  orbit_base::ParallelFor(thread_sample_data_to_fill.size(), [this, &thread_sample_data_to_fill](
+                                                                 size_t index) {
+    ThreadSampleData* thread_sample_data = thread_sample_data_to_fill[index];
     std::vector<SampledFunction>* sampled_functions = &thread_sample_data->sampled_functions;
 
     for (auto sorted_it = thread_sample_data->sorted_count_to_resolved_address.rbegin();
@@ -307,9 +480,11 @@ void SamplingDataPostProcessor::FillThreadSampleDataSampleReports(
       uint32_t num_occurrences = sorted_it->first;
       uint64_t absolute_address = sorted_it->second;
 
+      const SymbolizedFunction& symbolized_function =
+          resolved_address_to_symbolized_function_.at(absolute_address);
+
       SampledFunction function;
-      function.name = orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data,
-                                                                  absolute_address);
+      function.name = symbolized_function.name;
 
       function.inclusive = num_occurrences;
       function.inclusive_percent = 100.f * num_occurrences / thread_sample_data->samples_count;
@@ -334,14 +509,11 @@ void SamplingDataPostProcessor::FillThreadSampleDataSampleReports(
         function.unwind_errors_percent = 100.f * it->second / thread_sample_data->samples_count;
       }
       function.absolute_address = absolute_address;
-      function.module_path =
-          orbit_client_data::GetModulePathByAddress(module_manager, capture_data, absolute_address);
+      function.module_path = symbolized_function.module_path;
 
       sampled_functions->push_back(function);
     }
-  }
+  });
 }
 
-}  // namespace
-
 }  // namespace orbit_client_model
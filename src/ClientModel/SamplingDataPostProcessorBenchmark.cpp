@@ -0,0 +1,161 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how long CreatePostProcessedSamplingData takes to post-process a large synthetic
+// capture, and a selection of a tenth of the capture. Events are spread unevenly over the threads,
+// like in a typical capture where a few threads are much busier than the others.
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/flags/flag.h>
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+#include <absl/strings/str_format.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ClientData/CallstackData.h"
+#include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackInfo.h"
+#include "ClientData/CallstackType.h"
+#include "ClientData/CaptureData.h"
+#include "ClientData/LinuxAddressInfo.h"
+#include "ClientData/ModuleManager.h"
+#include "ClientData/PostProcessedSamplingData.h"
+#include "ClientModel/SamplingDataPostProcessor.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
+
+ABSL_FLAG(uint64_t, samples, 50'000'000, "Number of sampled callstacks");
+ABSL_FLAG(uint32_t, threads, 64, "Number of sampled threads");
+ABSL_FLAG(uint32_t, callstacks, 50'000, "Number of distinct callstacks");
+ABSL_FLAG(uint32_t, functions, 10'000, "Number of distinct functions in the callstacks");
+ABSL_FLAG(uint32_t, max_frames, 32, "Maximum number of frames of a callstack");
+
+namespace {
+
+using orbit_client_data::CallstackEvent;
+using orbit_client_data::CallstackInfo;
+using orbit_client_data::CallstackType;
+using orbit_client_data::CaptureData;
+using orbit_client_data::PostProcessedSamplingData;
+using orbit_client_model::CreatePostProcessedSamplingData;
+
+constexpr uint64_t kFirstFunctionAddress = 0x100000;
+constexpr uint64_t kFunctionSize = 0x100;
+constexpr uint64_t kSamplingPeriodNs = 1'000'000;
+constexpr size_t kEventsPerBatch = 1 << 20;
+
+std::unique_ptr<CaptureData> CreateCaptureData(uint64_t sample_count, uint32_t thread_count,
+                                               uint32_t callstack_count, uint32_t function_count,
+                                               uint32_t max_frame_count) {
+  auto capture_data = std::make_unique<CaptureData>(
+      orbit_grpc_protos::CaptureStarted{}, std::filesystem::path{}, absl::flat_hash_set<uint64_t>{},
+      CaptureData::DataSource::kLiveCapture);
+  std::mt19937_64 random{42};
+
+  std::uniform_int_distribution<uint32_t> function_distribution{0, function_count - 1};
+  std::uniform_int_distribution<uint64_t> offset_distribution{0, kFunctionSize - 1};
+  std::uniform_int_distribution<uint32_t> frame_count_distribution{1, max_frame_count};
+  std::bernoulli_distribution unwinding_error_distribution{0.05};
+  absl::flat_hash_set<uint64_t> addresses;
+  for (uint64_t callstack_id = 1; callstack_id <= callstack_count; ++callstack_id) {
+    std::vector<uint64_t> frames(frame_count_distribution(random));
+    for (uint64_t& frame : frames) {
+      frame = kFirstFunctionAddress + function_distribution(random) * kFunctionSize +
+              offset_distribution(random);
+      addresses.insert(frame);
+    }
+    const CallstackType type = unwinding_error_distribution(random)
+                                   ? CallstackType::kDwarfUnwindingError
+                                   : CallstackType::kComplete;
+    capture_data->AddUniqueCallstack(callstack_id, CallstackInfo{std::move(frames), type});
+  }
+  for (uint64_t address : addresses) {
+    const uint64_t function_index = (address - kFirstFunctionAddress) / kFunctionSize;
+    capture_data->InsertAddressInfo(orbit_client_data::LinuxAddressInfo{
+        address, (address - kFirstFunctionAddress) % kFunctionSize, "/path/to/module",
+        absl::StrFormat("function%u", function_index)});
+  }
+
+  // Thread i gets about twice as many samples as thread i + 1, and callstacks with small ids are
+  // sampled more often than the others.
+  std::vector<double> thread_weights;
+  for (uint32_t i = 0; i < thread_count; ++i) thread_weights.push_back(1.0 / (1u << (i % 16)));
+  std::discrete_distribution<uint32_t> thread_distribution{thread_weights.begin(),
+                                                           thread_weights.end()};
+  std::geometric_distribution<uint64_t> callstack_distribution{10.0 / callstack_count};
+  std::vector<CallstackEvent> events;
+  events.reserve(kEventsPerBatch);
+  for (uint64_t i = 0; i < sample_count; ++i) {
+    const uint64_t callstack_id = callstack_distribution(random) % callstack_count + 1;
+    const uint32_t thread_id = thread_distribution(random) + 1;
+    events.emplace_back(i * kSamplingPeriodNs / thread_count, callstack_id, thread_id);
+    if (events.size() == kEventsPerBatch || i + 1 == sample_count) {
+      capture_data->AddCallstackEvents(events);
+      events.clear();
+    }
+  }
+  return capture_data;
+}
+
+template <typename Function>
+absl::Duration Measure(Function&& function) {
+  const absl::Time start = absl::Now();
+  function();
+  return absl::Now() - start;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  absl::SetProgramUsageMessage(
+      "Measures the time to post-process the sampling data of a large synthetic capture");
+  absl::ParseCommandLine(argc, argv);
+
+  const uint64_t sample_count = absl::GetFlag(FLAGS_samples);
+  const uint32_t thread_count = absl::GetFlag(FLAGS_threads);
+  const uint32_t callstack_count = absl::GetFlag(FLAGS_callstacks);
+  const uint32_t function_count = absl::GetFlag(FLAGS_functions);
+  const uint32_t max_frame_count = absl::GetFlag(FLAGS_max_frames);
+  ORBIT_CHECK(sample_count > 0 && thread_count > 0 && callstack_count > 0 && function_count > 0 &&
+              max_frame_count > 0);
+
+  std::unique_ptr<CaptureData> capture_data = CreateCaptureData(
+      sample_count, thread_count, callstack_count, function_count, max_frame_count);
+  const orbit_client_data::CallstackData& callstack_data = capture_data->GetCallstackData();
+  orbit_client_data::ModuleManager module_manager;
+  PostProcessedSamplingData post_processed_sampling_data;
+  const absl::Duration capture_duration = Measure([&]() {
+    post_processed_sampling_data =
+        CreatePostProcessedSamplingData(callstack_data, *capture_data, module_manager);
+  });
+  ORBIT_CHECK(post_processed_sampling_data.GetSummary() != nullptr);
+  ORBIT_CHECK(post_processed_sampling_data.GetSummary()->samples_count == sample_count);
+
+  orbit_client_data::CallstackData selection_callstack_data;
+  const uint64_t selection_end_ns = callstack_data.max_time() / 10;
+  callstack_data.ForEachCallstackEventInTimeRange(
+      0, selection_end_ns, [&](const CallstackEvent& event) {
+        selection_callstack_data.AddCallstackFromKnownCallstackData(event, callstack_data);
+      });
+  const absl::Duration selection_duration = Measure([&]() {
+    post_processed_sampling_data =
+        CreatePostProcessedSamplingData(selection_callstack_data, *capture_data, module_manager);
+  });
+
+  ORBIT_LOG("Post-processed %u samples of %u threads, with %u distinct callstacks, on %u threads",
+            sample_count, thread_count, callstack_count, std::thread::hardware_concurrency());
+  ORBIT_LOG("Capture: %s", absl::FormatDuration(capture_duration));
+  ORBIT_LOG("Selection of %u samples: %s", selection_callstack_data.GetCallstackEventsCount(),
+            absl::FormatDuration(selection_duration));
+  return 0;
+}
@@ -25,14 +25,19 @@ using orbit_grpc_protos::GetDebugInfoFileRequest;
 using orbit_grpc_protos::GetDebugInfoFileResponse;
 using orbit_grpc_protos::GetModuleListRequest;
 using orbit_grpc_protos::GetModuleListResponse;
+using orbit_grpc_protos::GetModuleSymbolsRequest;
+using orbit_grpc_protos::GetModuleSymbolsResponse;
 using orbit_grpc_protos::GetProcessListRequest;
 using orbit_grpc_protos::GetProcessListResponse;
 using orbit_grpc_protos::GetProcessMemoryRequest;
 using orbit_grpc_protos::GetProcessMemoryResponse;
 using orbit_grpc_protos::ModuleInfo;
+using orbit_grpc_protos::ModuleSymbols;
 using orbit_grpc_protos::ProcessInfo;
 
 constexpr uint64_t kGrpcDefaultTimeoutMilliseconds = 3000;
+// Loading the symbols of a large module on the instance can take a while.
+constexpr uint64_t kGrpcLoadModuleSymbolsTimeoutMilliseconds = 120'000;
 
 std::unique_ptr<grpc::ClientContext> CreateContext(
     uint64_t timeout_milliseconds = kGrpcDefaultTimeoutMilliseconds) {
@@ -122,6 +127,52 @@ ErrorMessageOr<orbit_base::NotFoundOr<std::filesystem::path>> ProcessClient::Fin
   return ErrorMessage{error_message};
 }
 
+ErrorMessageOr<orbit_base::NotFoundOr<ModuleSymbols>> ProcessClient::LoadModuleSymbols(
+    const std::string& module_path, const std::string& build_id, uint64_t load_bias,
+    absl::Span<const std::string> additional_search_directories) {
+  ORBIT_SCOPE_FUNCTION;
+  GetModuleSymbolsRequest request;
+  request.set_module_path(module_path);
+  request.set_build_id(build_id);
+  request.set_load_bias(load_bias);
+  *request.mutable_additional_search_directories() = {additional_search_directories.begin(),
+                                                      additional_search_directories.end()};
+
+  const std::unique_ptr<grpc::ClientContext> context =
+      CreateContext(kGrpcLoadModuleSymbolsTimeoutMilliseconds);
+  std::unique_ptr<grpc::ClientReader<GetModuleSymbolsResponse>> reader =
+      process_service_->GetModuleSymbols(context.get(), request);
+
+  ModuleSymbols module_symbols;
+  GetModuleSymbolsResponse response;
+  while (reader->Read(&response)) {
+    module_symbols.mutable_symbol_infos()->Reserve(module_symbols.symbol_infos_size() +
+                                                   response.symbol_infos_size());
+    for (orbit_grpc_protos::SymbolInfo& symbol_info : *response.mutable_symbol_infos()) {
+      *module_symbols.add_symbol_infos() = std::move(symbol_info);
+    }
+  }
+  const grpc::Status status = reader->Finish();
+
+  if (status.ok()) return module_symbols;
+
+  if (status.error_code() == grpc::StatusCode::NOT_FOUND) {
+    return orbit_base::NotFound{status.error_message()};
+  }
+
+  const std::string error_message = absl::StrFormat(
+      "Error occurred while trying to load symbols on the remote. Error code: %d. Error message: "
+      "%s",
+      status.error_code(), status.error_message());
+  ORBIT_ERROR("%s", error_message);
+
+  // As for `GetDebugInfoFile`, StatusCode::UNKNOWN comes with a deliberate error message.
+  if (status.error_code() == grpc::StatusCode::UNKNOWN) {
+    return ErrorMessage(status.error_message());
+  }
+  return ErrorMessage{error_message};
+}
+
 ErrorMessageOr<std::string> ProcessClient::LoadProcessMemory(uint32_t pid, uint64_t address,
                                                              uint64_t size) {
   ORBIT_SCOPE_FUNCTION;
@@ -47,6 +47,10 @@ class ProcessManagerImpl final : public ProcessManager {
       const std::string& module_path,
       absl::Span<const std::string> additional_search_directories) override;
 
+  ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>> LoadModuleSymbols(
+      const std::string& module_path, const std::string& build_id, uint64_t load_bias,
+      absl::Span<const std::string> additional_search_directories) override;
+
   void Start();
   void ShutdownAndWait() override;
 
@@ -86,6 +90,14 @@ ErrorMessageOr<orbit_base::NotFoundOr<std::filesystem::path>> ProcessManagerImpl
   return process_client_->FindDebugInfoFile(module_path, additional_search_directories);
 }
 
+ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>>
+ProcessManagerImpl::LoadModuleSymbols(const std::string& module_path, const std::string& build_id,
+                                      uint64_t load_bias,
+                                      absl::Span<const std::string> additional_search_directories) {
+  return process_client_->LoadModuleSymbols(module_path, build_id, load_bias,
+                                            additional_search_directories);
+}
+
 void ProcessManagerImpl::Start() {
   ORBIT_CHECK(!worker_thread_.joinable());
   worker_thread_ = std::thread([this] { WorkerFunction(); });
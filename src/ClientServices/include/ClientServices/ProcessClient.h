@@ -20,6 +20,7 @@
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/process.pb.h"
 #include "GrpcProtos/services.grpc.pb.h"
+#include "GrpcProtos/symbol.pb.h"
 #include "OrbitBase/NotFoundOr.h"
 #include "OrbitBase/Result.h"
 
@@ -39,6 +40,13 @@ class ProcessClient {
   [[nodiscard]] ErrorMessageOr<orbit_base::NotFoundOr<std::filesystem::path>> FindDebugInfoFile(
       const std::string& module_path, absl::Span<const std::string> additional_search_directories);
 
+  // Loads the symbols of a module on the instance, without transferring the symbols file. Returns
+  // NotFound if no symbols file was found on the instance.
+  [[nodiscard]] ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>>
+  LoadModuleSymbols(const std::string& module_path, const std::string& build_id,
+                    uint64_t load_bias,
+                    absl::Span<const std::string> additional_search_directories);
+
   [[nodiscard]] ErrorMessageOr<std::string> LoadProcessMemory(uint32_t pid, uint64_t address,
                                                               uint64_t size);
 
@@ -61,6 +61,11 @@ class ProcessManager {
       const std::string& module_path,
       absl::Span<const std::string> additional_search_directories) = 0;
 
+  virtual ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>>
+  LoadModuleSymbols(const std::string& module_path, const std::string& build_id,
+                    uint64_t load_bias,
+                    absl::Span<const std::string> additional_search_directories) = 0;
+
   // Note that this method waits for the worker thread to stop, which could
   // take up to refresh_timeout.
   virtual void ShutdownAndWait() = 0;
@@ -7,6 +7,9 @@
 #include <absl/strings/str_split.h>
 #include <stdint.h>
 
+#include <numeric>
+#include <vector>
+
 #include "OrbitBase/Sort.h"
 
 namespace orbit_code_report {
@@ -29,8 +32,13 @@ static std::vector<std::string_view> SplitIntoLines(std::string_view source_file
   // We will show each source code line above the first related instruction
   absl::flat_hash_map<size_t, uint64_t> source_line_to_first_instruction_offset;
 
+  std::vector<uint64_t> addresses(function_info.size());
+  std::iota(addresses.begin(), addresses.end(), function_info.address());
+  const std::vector<ErrorMessageOr<orbit_grpc_protos::LineInfo>> line_infos =
+      elf->GetLineInfos(addresses);
+
   for (uint64_t current_offset = 0; current_offset < function_info.size(); ++current_offset) {
-    const auto line_info_or_error = elf->GetLineInfo(current_offset + function_info.address());
+    const auto& line_info_or_error = line_infos[current_offset];
     if (line_info_or_error.has_error()) continue;
     if (line_info_or_error.value().source_file() != location_info.source_file()) continue;
     if (line_info_or_error.value().source_line() == 0) continue;
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <limits>
 #include <optional>
+#include <vector>
 
 #include "ClientData/PostProcessedSamplingData.h"
 #include "OrbitBase/Logging.h"
@@ -19,12 +20,22 @@ SourceCodeReport::SourceCodeReport(std::string_view source_file,
                                    const orbit_client_data::ThreadSampleData& thread_sample_data,
                                    uint32_t total_samples_in_capture)
     : total_samples_in_capture_(total_samples_in_capture) {
+  std::vector<uint64_t> sampled_offsets;
+  std::vector<uint64_t> sampled_addresses;
   for (size_t offset = 0; offset < function.size(); ++offset) {
+    if (thread_sample_data.GetCountForAddress(absolute_address + offset) == 0) continue;
+    sampled_offsets.push_back(offset);
+    sampled_addresses.push_back(function.address() + offset);
+  }
+  const std::vector<ErrorMessageOr<orbit_grpc_protos::LineInfo>> line_infos =
+      elf_file->GetLineInfos(sampled_addresses);
+
+  for (size_t i = 0; i < sampled_offsets.size(); ++i) {
+    const uint64_t offset = sampled_offsets[i];
     const uint32_t current_samples =
         thread_sample_data.GetCountForAddress(absolute_address + offset);
-    if (current_samples == 0) continue;
 
-    const auto maybe_current_line_info = elf_file->GetLineInfo(function.address() + offset);
+    const auto& maybe_current_line_info = line_infos[i];
     if (!maybe_current_line_info.has_value()) continue;
 
     const auto& current_line_info = maybe_current_line_info.value();
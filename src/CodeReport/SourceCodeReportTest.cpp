@@ -27,6 +27,7 @@ class MockElfFile : public orbit_object_utils::ElfFile {
   MOCK_METHOD(const std::vector<orbit_grpc_protos::ModuleInfo::ObjectSegment>&, GetObjectSegments,
               (), (const, override));
 
+  MOCK_METHOD(void, SetSymbolCreationExecutor, (orbit_base::Executor*), (override));
   MOCK_METHOD(bool, HasDynsym, (), (const, override));
   MOCK_METHOD(bool, HasDebugInfo, (), (const, override));
   MOCK_METHOD(bool, HasGnuDebuglink, (), (const, override));
@@ -0,0 +1,255 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "DataViews/FunctionSearchIndex.h"
+
+#include <absl/strings/ascii.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "Introspection/Introspection.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/ParallelFor.h"
+
+using orbit_client_data::FunctionInfo;
+
+namespace orbit_data_views {
+
+namespace {
+
+constexpr size_t kTrigramLength = 3;
+constexpr size_t kFunctionsPerChunk = 16384;
+
+[[nodiscard]] uint32_t GetTrigramAt(std::string_view string, size_t position) {
+  return (static_cast<uint32_t>(static_cast<uint8_t>(string[position])) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(string[position + 1])) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(string[position + 2]));
+}
+
+// Keeps the elements of the sorted `indices` that are also in the sorted `other_indices`.
+void IntersectSortedIndices(std::vector<uint64_t>* indices,
+                            const std::vector<uint32_t>& other_indices) {
+  // When `indices` is much smaller, binary searches are cheaper than walking `other_indices`.
+  constexpr size_t kBinarySearchSizeRatio = 16;
+  if (indices->size() * kBinarySearchSizeRatio < other_indices.size()) {
+    indices->erase(std::remove_if(indices->begin(), indices->end(),
+                                  [&other_indices](uint64_t index) {
+                                    return !std::binary_search(other_indices.begin(),
+                                                               other_indices.end(), index);
+                                  }),
+                   indices->end());
+    return;
+  }
+  std::vector<uint64_t> intersection;
+  std::set_intersection(indices->begin(), indices->end(), other_indices.begin(),
+                        other_indices.end(), std::back_inserter(intersection));
+  *indices = std::move(intersection);
+}
+
+}  // namespace
+
+void FunctionSearchIndex::AddFunctions(absl::Span<const FunctionInfo* const> functions) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_CHECK(size() + functions.size() <= std::numeric_limits<uint32_t>::max());
+  const size_t first_function_index = size();
+
+  for (const FunctionInfo* function : functions) {
+    ORBIT_CHECK(function != nullptr);
+    const size_t name_offset = lowercase_names_.size();
+    lowercase_names_.append(function->pretty_name());
+    std::transform(lowercase_names_.begin() + name_offset, lowercase_names_.end(),
+                   lowercase_names_.begin() + name_offset, absl::ascii_tolower);
+    lowercase_names_.push_back('\0');
+    name_offsets_.push_back(lowercase_names_.size());
+
+    auto [module_it, inserted] = module_path_to_index_.try_emplace(
+        function->module_path(), static_cast<uint32_t>(lowercase_module_file_names_.size()));
+    if (inserted) {
+      lowercase_module_file_names_.push_back(absl::AsciiStrToLower(
+          std::filesystem::path(function->module_path()).filename().string()));
+      module_function_indices_.emplace_back();
+    }
+    module_function_indices_[module_it->second].push_back(function_module_indices_.size());
+    function_module_indices_.push_back(module_it->second);
+    is_function_removed_.push_back(false);
+  }
+
+  // The posting lists of each chunk of new functions are built in parallel. They are then appended
+  // chunk by chunk, so that all posting lists remain sorted.
+  const size_t new_function_count = size() - first_function_index;
+  const size_t chunk_count = (new_function_count + kFunctionsPerChunk - 1) / kFunctionsPerChunk;
+  std::vector<absl::flat_hash_map<uint32_t, std::vector<uint32_t>>> trigrams_per_chunk(chunk_count);
+  orbit_base::ParallelFor(chunk_count, [this, first_function_index,
+                                        &trigrams_per_chunk](size_t chunk_index) {
+    const size_t begin = first_function_index + chunk_index * kFunctionsPerChunk;
+    const size_t end = std::min(begin + kFunctionsPerChunk, size());
+    for (size_t function_index = begin; function_index < end; ++function_index) {
+      const std::string_view name = GetLowercaseName(function_index);
+      for (size_t position = 0; position + kTrigramLength <= name.size(); ++position) {
+        std::vector<uint32_t>& function_indices =
+            trigrams_per_chunk[chunk_index][GetTrigramAt(name, position)];
+        // The same trigram can occur more than once in a name.
+        if (function_indices.empty() || function_indices.back() != function_index) {
+          function_indices.push_back(static_cast<uint32_t>(function_index));
+        }
+      }
+    }
+  });
+
+  for (absl::flat_hash_map<uint32_t, std::vector<uint32_t>>& chunk_trigrams : trigrams_per_chunk) {
+    for (auto& [trigram, chunk_function_indices] : chunk_trigrams) {
+      std::vector<uint32_t>& function_indices = trigram_to_function_indices_[trigram];
+      function_indices.insert(function_indices.end(), chunk_function_indices.begin(),
+                              chunk_function_indices.end());
+    }
+  }
+}
+
+std::vector<uint64_t> FunctionSearchIndex::RemoveFunctionsOfModule(const std::string& module_path) {
+  auto module_it = module_path_to_index_.find(module_path);
+  if (module_it == module_path_to_index_.end()) return {};
+
+  // The module keeps its index, in case functions of the same module are added again.
+  std::vector<uint64_t> removed_function_indices =
+      std::move(module_function_indices_[module_it->second]);
+  module_function_indices_[module_it->second].clear();
+  for (uint64_t function_index : removed_function_indices) {
+    is_function_removed_[function_index] = true;
+  }
+  removed_function_count_ += removed_function_indices.size();
+  return removed_function_indices;
+}
+
+void FunctionSearchIndex::Clear() {
+  lowercase_names_.clear();
+  name_offsets_ = {0};
+  function_module_indices_.clear();
+  is_function_removed_.clear();
+  removed_function_count_ = 0;
+  lowercase_module_file_names_.clear();
+  module_function_indices_.clear();
+  module_path_to_index_.clear();
+  trigram_to_function_indices_.clear();
+}
+
+std::vector<uint64_t> FunctionSearchIndex::FindFunctionsWithNameContaining(
+    std::string_view token) const {
+  std::vector<uint64_t> function_indices;
+
+  if (token.size() < kTrigramLength) {
+    // Too short to use the posting lists, but a search through all names at once is still fast.
+    size_t position = lowercase_names_.find(token);
+    while (position != std::string::npos) {
+      const size_t function_index =
+          std::upper_bound(name_offsets_.begin(), name_offsets_.end(), position) -
+          name_offsets_.begin() - 1;
+      if (!is_function_removed_[function_index]) function_indices.push_back(function_index);
+      position = lowercase_names_.find(token, name_offsets_[function_index + 1]);
+    }
+    return function_indices;
+  }
+
+  std::vector<const std::vector<uint32_t>*> posting_lists;
+  for (size_t position = 0; position + kTrigramLength <= token.size(); ++position) {
+    auto it = trigram_to_function_indices_.find(GetTrigramAt(token, position));
+    if (it == trigram_to_function_indices_.end()) return {};
+    posting_lists.push_back(&it->second);
+  }
+  // Start from the shortest posting list, so that the candidates shrink as fast as possible.
+  std::sort(posting_lists.begin(), posting_lists.end(),
+            [](const std::vector<uint32_t>* lhs, const std::vector<uint32_t>* rhs) {
+              return std::make_pair(lhs->size(), lhs) < std::make_pair(rhs->size(), rhs);
+            });
+  posting_lists.erase(std::unique(posting_lists.begin(), posting_lists.end()),
+                      posting_lists.end());
+
+  function_indices.assign(posting_lists.front()->begin(), posting_lists.front()->end());
+  for (auto it = posting_lists.begin() + 1; it != posting_lists.end() && !function_indices.empty();
+       ++it) {
+    IntersectSortedIndices(&function_indices, **it);
+  }
+
+  // Containing all the trigrams of the token doesn't mean containing the token.
+  function_indices.erase(std::remove_if(function_indices.begin(), function_indices.end(),
+                                        [this, token](uint64_t function_index) {
+                                          return is_function_removed_[function_index] ||
+                                                 GetLowercaseName(function_index).find(token) ==
+                                                     std::string_view::npos;
+                                        }),
+                         function_indices.end());
+  return function_indices;
+}
+
+std::vector<uint64_t> FunctionSearchIndex::FindFunctionsOfModulesContaining(
+    std::string_view token) const {
+  std::vector<uint64_t> function_indices;
+  size_t matching_module_count = 0;
+  for (size_t module_index = 0; module_index < lowercase_module_file_names_.size();
+       ++module_index) {
+    if (lowercase_module_file_names_[module_index].find(token) == std::string::npos) continue;
+    ++matching_module_count;
+    function_indices.insert(function_indices.end(), module_function_indices_[module_index].begin(),
+                            module_function_indices_[module_index].end());
+  }
+  if (matching_module_count > 1) std::sort(function_indices.begin(), function_indices.end());
+  return function_indices;
+}
+
+std::vector<uint64_t> FunctionSearchIndex::FindFunctions(
+    absl::Span<const std::string> tokens) const {
+  ORBIT_SCOPE_FUNCTION;
+  std::vector<std::string_view> non_empty_tokens;
+  for (const std::string& token : tokens) {
+    if (!token.empty()) non_empty_tokens.emplace_back(token);
+  }
+
+  if (non_empty_tokens.empty()) {
+    std::vector<uint64_t> all_function_indices;
+    all_function_indices.reserve(size() - removed_function_count_);
+    for (size_t function_index = 0; function_index < size(); ++function_index) {
+      if (!is_function_removed_[function_index]) all_function_indices.push_back(function_index);
+    }
+    return all_function_indices;
+  }
+
+  // Use the index for the longest token, which usually matches the fewest functions, and only
+  // check the other tokens against these functions.
+  std::stable_sort(
+      non_empty_tokens.begin(), non_empty_tokens.end(),
+      [](std::string_view lhs, std::string_view rhs) { return lhs.size() > rhs.size(); });
+
+  std::vector<uint64_t> name_matches = FindFunctionsWithNameContaining(non_empty_tokens.front());
+  std::vector<uint64_t> module_matches = FindFunctionsOfModulesContaining(non_empty_tokens.front());
+  std::vector<uint64_t> function_indices;
+  function_indices.reserve(name_matches.size() + module_matches.size());
+  std::set_union(name_matches.begin(), name_matches.end(), module_matches.begin(),
+                 module_matches.end(), std::back_inserter(function_indices));
+
+  for (auto token_it = non_empty_tokens.begin() + 1; token_it != non_empty_tokens.end();
+       ++token_it) {
+    const std::string_view token = *token_it;
+    std::vector<bool> is_token_in_module_file_name(lowercase_module_file_names_.size());
+    for (size_t module_index = 0; module_index < lowercase_module_file_names_.size();
+         ++module_index) {
+      is_token_in_module_file_name[module_index] =
+          lowercase_module_file_names_[module_index].find(token) != std::string::npos;
+    }
+    function_indices.erase(
+        std::remove_if(function_indices.begin(), function_indices.end(),
+                       [this, token, &is_token_in_module_file_name](uint64_t function_index) {
+                         return !is_token_in_module_file_name[function_module_indices_
+                                                                  [function_index]] &&
+                                GetLowercaseName(function_index).find(token) ==
+                                    std::string_view::npos;
+                       }),
+        function_indices.end());
+  }
+  return function_indices;
+}
+
+}  // namespace orbit_data_views
@@ -0,0 +1,130 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_format.h>
+#include <absl/strings/str_split.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "ClientData/FunctionInfo.h"
+#include "DataViews/FunctionSearchIndex.h"
+
+using orbit_client_data::FunctionInfo;
+
+namespace orbit_data_views {
+
+namespace {
+
+std::vector<const FunctionInfo*> GetPointers(const std::vector<FunctionInfo>& functions) {
+  std::vector<const FunctionInfo*> pointers;
+  for (const FunctionInfo& function : functions) pointers.push_back(&function);
+  return pointers;
+}
+
+std::vector<std::string> Tokenize(const std::string& filter) {
+  return absl::StrSplit(absl::AsciiStrToLower(filter), ' ');
+}
+
+}  // namespace
+
+TEST(FunctionSearchIndex, FindsFunctionsByNameAndModule) {
+  const std::vector<FunctionInfo> functions{
+      {"/path/to/libfoo.so", "buildid", 0x1000, 0x10, "foo()"},
+      {"/path/to/libfoo.so", "buildid", 0x2000, 0x10, "FooBar(int)"},
+      {"/path/to/Game", "buildid", 0x3000, 0x10, "bar::Tick()"},
+      {"/path/to/Game", "buildid", 0x4000, 0x10, "main"},
+  };
+  FunctionSearchIndex index;
+  index.AddFunctions(GetPointers(functions));
+  EXPECT_EQ(index.size(), 4);
+
+  EXPECT_THAT(index.FindFunctions(Tokenize("")), testing::ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(index.FindFunctions(Tokenize("foo")), testing::ElementsAre(0, 1));
+  EXPECT_THAT(index.FindFunctions(Tokenize("BAR")), testing::ElementsAre(1, 2));
+  EXPECT_THAT(index.FindFunctions(Tokenize("r")), testing::ElementsAre(1, 2));
+  EXPECT_THAT(index.FindFunctions(Tokenize("bar::tick()")), testing::ElementsAre(2));
+  EXPECT_THAT(index.FindFunctions(Tokenize("game")), testing::ElementsAre(2, 3));
+  EXPECT_THAT(index.FindFunctions(Tokenize("ai game")), testing::ElementsAre(3));
+  EXPECT_THAT(index.FindFunctions(Tokenize("libfoo bar")), testing::ElementsAre(1));
+  EXPECT_THAT(index.FindFunctions(Tokenize("foo  ")), testing::ElementsAre(0, 1));
+  // Tokens don't match across the names of consecutive functions, nor across name and module.
+  EXPECT_THAT(index.FindFunctions(Tokenize(")foo")), testing::IsEmpty());
+  EXPECT_THAT(index.FindFunctions(Tokenize("mainGame")), testing::IsEmpty());
+  // The directory of the module is not considered.
+  EXPECT_THAT(index.FindFunctions(Tokenize("path")), testing::IsEmpty());
+
+  index.Clear();
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_THAT(index.FindFunctions(Tokenize("foo")), testing::IsEmpty());
+}
+
+TEST(FunctionSearchIndex, RemovesFunctionsOfModule) {
+  const std::vector<FunctionInfo> functions{
+      {"/path/to/libfoo.so", "buildid", 0x1000, 0x10, "foo()"},
+      {"/path/to/Game", "buildid", 0x3000, 0x10, "bar::Tick()"},
+      {"/path/to/libfoo.so", "buildid", 0x2000, 0x10, "FooBar(int)"},
+      {"/path/to/Game", "buildid", 0x4000, 0x10, "main"},
+  };
+  FunctionSearchIndex index;
+  index.AddFunctions(GetPointers(functions));
+
+  EXPECT_THAT(index.RemoveFunctionsOfModule("/path/to/libfoo.so"), testing::ElementsAre(0, 2));
+  EXPECT_THAT(index.RemoveFunctionsOfModule("/path/to/libfoo.so"), testing::IsEmpty());
+  EXPECT_THAT(index.RemoveFunctionsOfModule("/path/to/libbar.so"), testing::IsEmpty());
+  EXPECT_EQ(index.size(), 4);
+  EXPECT_EQ(index.GetRemovedFunctionCount(), 2);
+
+  // The other functions keep their index.
+  EXPECT_THAT(index.FindFunctions(Tokenize("")), testing::ElementsAre(1, 3));
+  EXPECT_THAT(index.FindFunctions(Tokenize("foo")), testing::IsEmpty());
+  EXPECT_THAT(index.FindFunctions(Tokenize("bar")), testing::ElementsAre(1));
+  EXPECT_THAT(index.FindFunctions(Tokenize("o")), testing::IsEmpty());
+  EXPECT_THAT(index.FindFunctions(Tokenize("libfoo")), testing::IsEmpty());
+  EXPECT_THAT(index.FindFunctions(Tokenize("game")), testing::ElementsAre(1, 3));
+
+  // Functions of a removed module can be added again.
+  const std::vector<FunctionInfo> added_again_functions{functions[0]};
+  index.AddFunctions(GetPointers(added_again_functions));
+  EXPECT_EQ(index.size(), 5);
+  EXPECT_THAT(index.FindFunctions(Tokenize("foo")), testing::ElementsAre(4));
+  EXPECT_THAT(index.FindFunctions(Tokenize("libfoo")), testing::ElementsAre(4));
+}
+
+TEST(FunctionSearchIndex, AgreesWithSubstringSearch) {
+  std::vector<FunctionInfo> functions;
+  for (int i = 0; i < 50000; ++i) {
+    functions.emplace_back(absl::StrFormat("/path/to/module%d.so", i % 7), "buildid", i, 0x10,
+                           absl::StrFormat("Namespace%d::Function%d<int, %d>()", i % 13, i, i % 5));
+  }
+  FunctionSearchIndex index;
+  // Adding the functions in two batches must give the same result as adding them all at once.
+  const std::vector<const FunctionInfo*> pointers = GetPointers(functions);
+  index.AddFunctions(absl::MakeConstSpan(pointers).subspan(0, 20000));
+  index.AddFunctions(absl::MakeConstSpan(pointers).subspan(20000));
+
+  for (const char* filter :
+       {"namespace3 ", "function12", "1 ion4", "module3 <int, 2>", "e5::f", "99", "6.so 7"}) {
+    const std::vector<std::string> tokens = Tokenize(filter);
+    std::vector<uint64_t> expected_indices;
+    for (size_t i = 0; i < functions.size(); ++i) {
+      const std::string name = absl::AsciiStrToLower(functions[i].pretty_name());
+      const std::string module = std::filesystem::path{functions[i].module_path()}.filename();
+      if (std::all_of(tokens.begin(), tokens.end(), [&](const std::string& token) {
+            return name.find(token) != std::string::npos ||
+                   module.find(token) != std::string::npos;
+          })) {
+        expected_indices.push_back(i);
+      }
+    }
+    EXPECT_EQ(index.FindFunctions(tokens), expected_indices) << filter;
+  }
+}
+
+}  // namespace orbit_data_views
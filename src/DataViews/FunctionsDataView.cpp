@@ -22,9 +22,7 @@
 #include "DataViews/DataViewType.h"
 #include "Introspection/Introspection.h"
 #include "OrbitBase/Append.h"
-#include "OrbitBase/Chunk.h"
 #include "OrbitBase/Logging.h"
-#include "OrbitBase/TaskGroup.h"
 
 using orbit_client_data::CaptureData;
 using orbit_client_data::FunctionInfo;
@@ -207,59 +205,35 @@ DataView::ActionStatus FunctionsDataView::GetActionStatus(
 void FunctionsDataView::DoFilter() {
   ORBIT_SCOPE(absl::StrFormat("FunctionsDataView::DoFilter [%u]", functions_.size()).c_str());
   filter_tokens_ = absl::StrSplit(absl::AsciiStrToLower(filter_), ' ');
-
-  constexpr size_t kNumFunctionsPerTask = 1024;
-  std::vector<absl::Span<const FunctionInfo*>> chunks =
-      orbit_base::CreateChunksOfSize(functions_, kNumFunctionsPerTask);
-  std::vector<std::vector<uint64_t>> task_results(chunks.size());
-  orbit_base::TaskGroup task_group;
-
-  for (size_t i = 0; i < chunks.size(); ++i) {
-    task_group.AddTask([& chunk = chunks[i], &result = task_results[i], this]() {
-      ORBIT_SCOPE("FunctionsDataView::DoFilter Task");
-      for (const FunctionInfo*& function : chunk) {
-        ORBIT_CHECK(function != nullptr);
-        std::string name = absl::AsciiStrToLower(function->pretty_name());
-        std::string module = absl::AsciiStrToLower(
-            std::filesystem::path(function->module_path()).filename().string());
-
-        const auto is_token_found = [&name, &module](const std::string& token) {
-          return name.find(token) != std::string::npos || module.find(token) != std::string::npos;
-        };
-
-        if (std::all_of(filter_tokens_.begin(), filter_tokens_.end(), is_token_found)) {
-          size_t function_index = &function - functions_.data();
-          ORBIT_CHECK(function_index < functions_.size());
-          result.push_back(function_index);
-        }
-      }
-    });
-  }
-
-  task_group.Wait();
-  indices_.clear();
-  for (std::vector<uint64_t>& result : task_results) {
-    indices_.insert(indices_.end(), result.begin(), result.end());
-  }
+  indices_ = search_index_.FindFunctions(filter_tokens_);
 }
 
 void FunctionsDataView::AddFunctions(
     std::vector<const orbit_client_data::FunctionInfo*> functions) {
   functions_.insert(functions_.end(), functions.begin(), functions.end());
+  search_index_.AddFunctions(functions);
   OnDataChanged();
 }
 
 void FunctionsDataView::RemoveFunctionsOfModule(const std::string& module_path) {
-  functions_.erase(std::remove_if(functions_.begin(), functions_.end(),
-                                  [&module_path](const FunctionInfo* function_info) {
-                                    return function_info->module_path() == module_path;
-                                  }),
-                   functions_.end());
+  const std::vector<uint64_t> removed_indices = search_index_.RemoveFunctionsOfModule(module_path);
+  if (removed_indices.empty()) return;
+
+  // Removed functions leave a hole, so that the indices of the other functions in `functions_`
+  // still match the ones in the search index. Once most of `functions_` are holes, both are
+  // compacted, which keeps the cost of removing a module proportional to its size on average.
+  for (uint64_t index : removed_indices) functions_[index] = nullptr;
+  if (2 * search_index_.GetRemovedFunctionCount() > functions_.size()) {
+    functions_.erase(std::remove(functions_.begin(), functions_.end(), nullptr), functions_.end());
+    search_index_.Clear();
+    search_index_.AddFunctions(functions_);
+  }
   OnDataChanged();
 }
 
 void FunctionsDataView::ClearFunctions() {
   functions_.clear();
+  search_index_.Clear();
   OnDataChanged();
 }
 
@@ -193,6 +193,21 @@ TEST_F(FunctionsDataViewTest, RemoveFunctionsOfModule) {
 
   view_.RemoveFunctionsOfModule(functions_[3].module_path());  // Should do nothing.
   ASSERT_EQ(view_.GetNumElements(), 3);
+
+  // Removing most functions compacts the view, which must still show the remaining ones.
+  view_.RemoveFunctionsOfModule(functions_[0].module_path());
+  ASSERT_EQ(view_.GetNumElements(), 2);
+  EXPECT_THAT((std::array{view_.GetValue(0, 1), view_.GetValue(1, 1)}),
+              testing::UnorderedElementsAre(functions_[1].pretty_name(),
+                                            functions_[4].pretty_name()));
+
+  view_.AddFunctions({&functions_[2]});
+  ASSERT_EQ(view_.GetNumElements(), 3);
+  view_.RemoveFunctionsOfModule(functions_[1].module_path());
+  ASSERT_EQ(view_.GetNumElements(), 2);
+  EXPECT_THAT((std::array{view_.GetValue(0, 1), view_.GetValue(1, 1)}),
+              testing::UnorderedElementsAre(functions_[2].pretty_name(),
+                                            functions_[4].pretty_name()));
 }
 
 const std::string kSelectedFunctionString = "H";
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DATA_VIEWS_FUNCTION_SEARCH_INDEX_H_
+#define DATA_VIEWS_FUNCTION_SEARCH_INDEX_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/types/span.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ClientData/FunctionInfo.h"
+
+namespace orbit_data_views {
+
+// Index to quickly find the functions whose name or module file name contain some search tokens,
+// ignoring case. Functions are identified by the order in which they were added.
+//
+// The lowercase names are stored one after the other in a single string, and for each trigram
+// (sequence of three characters) a posting list holds the (sorted) indices of the functions whose
+// name contains it. A token of at least three characters can only be contained in the names of
+// the functions in all the posting lists of its trigrams, which usually are few, so that only
+// these names need to be checked. Module file names are few and simply checked one by one.
+//
+// Adding functions only appends to the posting lists. Removing the functions of a module only marks
+// them as removed, so that the indices of the other functions don't change: removed functions are
+// no longer found, but keep their index and their space until the index is rebuilt. This class is
+// not thread-safe.
+class FunctionSearchIndex {
+ public:
+  void AddFunctions(absl::Span<const orbit_client_data::FunctionInfo* const> functions);
+  // Returns the sorted indices of the functions that were removed.
+  std::vector<uint64_t> RemoveFunctionsOfModule(const std::string& module_path);
+  void Clear();
+
+  // The number of functions added since the last Clear, including the removed ones.
+  [[nodiscard]] size_t size() const { return function_module_indices_.size(); }
+  [[nodiscard]] size_t GetRemovedFunctionCount() const { return removed_function_count_; }
+
+  // Returns the sorted indices of the functions for which each token is contained in the name or in
+  // the module file name. The tokens must be lowercase. Empty tokens are ignored.
+  [[nodiscard]] std::vector<uint64_t> FindFunctions(absl::Span<const std::string> tokens) const;
+
+ private:
+  [[nodiscard]] std::string_view GetLowercaseName(size_t function_index) const {
+    return std::string_view{lowercase_names_}.substr(
+        name_offsets_[function_index],
+        name_offsets_[function_index + 1] - name_offsets_[function_index] - 1);
+  }
+  [[nodiscard]] std::vector<uint64_t> FindFunctionsWithNameContaining(
+      std::string_view token) const;
+  [[nodiscard]] std::vector<uint64_t> FindFunctionsOfModulesContaining(
+      std::string_view token) const;
+
+  // Each name is followed by a '\0', so that no token (which has no '\0') matches across names.
+  std::string lowercase_names_;
+  // The offset of the name of each function in `lowercase_names_`, and the final size.
+  std::vector<size_t> name_offsets_{0};
+  std::vector<uint32_t> function_module_indices_;
+  std::vector<bool> is_function_removed_;
+  size_t removed_function_count_ = 0;
+
+  std::vector<std::string> lowercase_module_file_names_;
+  // The functions of each module that are not removed.
+  std::vector<std::vector<uint64_t>> module_function_indices_;
+  absl::flat_hash_map<std::string, uint32_t> module_path_to_index_;
+
+  absl::flat_hash_map<uint32_t, std::vector<uint32_t>> trigram_to_function_indices_;
+};
+
+}  // namespace orbit_data_views
+
+#endif  // DATA_VIEWS_FUNCTION_SEARCH_INDEX_H_
@@ -11,6 +11,7 @@
 #include "ClientData/FunctionInfo.h"
 #include "DataViews/AppInterface.h"
 #include "DataViews/DataView.h"
+#include "DataViews/FunctionSearchIndex.h"
 
 namespace orbit_data_views {
 class FunctionsDataView : public DataView {
@@ -65,6 +66,7 @@ class FunctionsDataView : public DataView {
   }
 
   std::vector<const orbit_client_data::FunctionInfo*> functions_;
+  FunctionSearchIndex search_index_;
 };
 
 }  // namespace orbit_data_views
@@ -27,6 +27,7 @@
 #include "MizarBase/AbsoluteAddress.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/Result.h"
+#include "OrbitBase/ThreadPool.h"
 
 using ::orbit_mizar_base::AbsoluteAddress;
 using ::orbit_mizar_base::ForEachFrame;
@@ -163,6 +164,7 @@ static ErrorMessageOr<void> FindAndLoadSymbols(orbit_symbols::SymbolHelper& symb
   OUTCOME_TRY(const auto symbols_path, FindSymbolsPath(symbol_helper, module_data));
 
   orbit_object_utils::ObjectFileInfo object_file_info{module_data.load_bias()};
+  object_file_info.symbol_creation_executor = orbit_base::ThreadPool::GetDefaultThreadPool();
   OUTCOME_TRY(orbit_grpc_protos::ModuleSymbols symbols,
               orbit_symbols::SymbolHelper::LoadSymbolsFromFile(symbols_path, object_file_info));
   module_data.AddSymbols(symbols);
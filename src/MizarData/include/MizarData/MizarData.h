@@ -6,6 +6,7 @@
 #define MIZAR_DATA_MIZAR_DATA_H_
 
 #include <absl/container/flat_hash_set.h>
+#include <absl/types/span.h>
 
 #include <memory>
 #include <optional>
@@ -98,6 +99,8 @@ class MizarData : public orbit_capture_client::AbstractCaptureListener<MizarData
   }
   void OnThreadStateSlice(orbit_client_data::ThreadStateSliceInfo /*thread_state_slice*/) override {
   }
+  void OnThreadStateSlices(
+      absl::Span<const orbit_client_data::ThreadStateSliceInfo> /*thread_state_slices*/) override {}
   void OnApiStringEvent(const orbit_client_data::ApiStringEvent& /*unused*/) override {}
   void OnApiTrackValue(const orbit_client_data::ApiTrackValue&) override {}
   void OnWarningEvent(orbit_grpc_protos::WarningEvent /*warning_event*/) override {}
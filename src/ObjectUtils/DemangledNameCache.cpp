@@ -0,0 +1,62 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ObjectUtils/DemangledNameCache.h"
+
+#include <absl/hash/hash.h>
+#include <llvm/Demangle/Demangle.h>
+#include <stdint.h>
+
+namespace orbit_object_utils {
+
+namespace {
+
+// The names llvm::demangle doesn't return unchanged start with one of these characters: Itanium
+// ("_Z", "___Z"), Rust ("_R"), D ("_D") and Microsoft ("?") manglings. Other names, like the ones
+// of C functions, are not worth caching.
+[[nodiscard]] bool MightBeMangled(std::string_view name) {
+  return !name.empty() && (name.front() == '_' || name.front() == '?');
+}
+
+}  // namespace
+
+DemangledNameCache::DemangledNameCache(size_t max_cached_bytes)
+    : max_cached_bytes_per_shard_{max_cached_bytes / kShardCount} {}
+
+std::string DemangledNameCache::Demangle(std::string_view name) {
+  if (!MightBeMangled(name)) return std::string{name};
+
+  // The flat_hash_map of each shard takes the tags of its slots from the low bits of the same hash,
+  // so the shard comes from the high bits.
+  const uint64_t hash = absl::Hash<std::string_view>{}(name);
+  Shard& shard = shards_[hash >> (64 - kShardIndexBits)];
+  {
+    absl::MutexLock lock{&shard.mutex};
+    auto it = shard.mangled_to_demangled_name.find(name);
+    if (it != shard.mangled_to_demangled_name.end()) return it->second;
+  }
+
+  // Demangle without holding the lock. Two threads might demangle the same name at the same time,
+  // which is harmless.
+  std::string demangled_name = llvm::demangle(std::string{name});
+
+  absl::MutexLock lock{&shard.mutex};
+  const size_t name_bytes = name.size() + demangled_name.size();
+  if (shard.cached_bytes + name_bytes <= max_cached_bytes_per_shard_ &&
+      shard.mangled_to_demangled_name.try_emplace(name, demangled_name).second) {
+    shard.cached_bytes += name_bytes;
+  }
+  return demangled_name;
+}
+
+size_t DemangledNameCache::GetCachedNameCount() const {
+  size_t count = 0;
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock{&shard.mutex};
+    count += shard.mangled_to_demangled_name.size();
+  }
+  return count;
+}
+
+}  // namespace orbit_object_utils
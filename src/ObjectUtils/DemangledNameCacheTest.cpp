@@ -0,0 +1,68 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/strings/str_format.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "ObjectUtils/DemangledNameCache.h"
+#include "OrbitBase/ParallelFor.h"
+
+namespace orbit_object_utils {
+
+TEST(DemangledNameCache, DemanglesAndCachesMangledNames) {
+  DemangledNameCache cache{1024 * 1024};
+  EXPECT_EQ(cache.Demangle("_Z3fooi"), "foo(int)");
+  EXPECT_EQ(cache.GetCachedNameCount(), 1);
+  EXPECT_EQ(cache.Demangle("_Z3fooi"), "foo(int)");
+  EXPECT_EQ(cache.GetCachedNameCount(), 1);
+
+  EXPECT_EQ(cache.Demangle("_ZN3bar3bazEv"), "bar::baz()");
+  EXPECT_EQ(cache.GetCachedNameCount(), 2);
+}
+
+TEST(DemangledNameCache, DoesNotCacheNamesThatAreNotMangled) {
+  DemangledNameCache cache{1024 * 1024};
+  EXPECT_EQ(cache.Demangle("main"), "main");
+  EXPECT_EQ(cache.Demangle(""), "");
+  EXPECT_EQ(cache.GetCachedNameCount(), 0);
+
+  // Names that look mangled but are not are returned unchanged.
+  EXPECT_EQ(cache.Demangle("_start"), "_start");
+  EXPECT_EQ(cache.Demangle("_start"), "_start");
+}
+
+TEST(DemangledNameCache, StopsCachingWhenFull) {
+  // Each of the 16 shards can hold 8 bytes, less than any of the names plus their demangled name.
+  DemangledNameCache cache{16 * 8};
+  EXPECT_EQ(cache.Demangle("_Z3fooi"), "foo(int)");
+  EXPECT_EQ(cache.Demangle("_Z3fooi"), "foo(int)");
+  EXPECT_EQ(cache.GetCachedNameCount(), 0);
+}
+
+TEST(DemangledNameCache, CanBeUsedConcurrently) {
+  constexpr size_t kNameCount = 1000;
+  std::vector<std::string> mangled_names;
+  std::vector<std::string> expected_names;
+  for (size_t i = 0; i < kNameCount; ++i) {
+    mangled_names.push_back(absl::StrFormat("_Z8functionILi%uEEvv", i));
+    expected_names.push_back(absl::StrFormat("void function<%u>()", i));
+  }
+
+  DemangledNameCache cache{1024 * 1024};
+  std::vector<std::string> demangled_names(2 * kNameCount);
+  orbit_base::ParallelFor(demangled_names.size(), [&](size_t index) {
+    demangled_names[index] = cache.Demangle(mangled_names[index % kNameCount]);
+  });
+
+  for (size_t i = 0; i < demangled_names.size(); ++i) {
+    EXPECT_EQ(demangled_names[i], expected_names[i % kNameCount]);
+  }
+  EXPECT_EQ(cache.GetCachedNameCount(), kNameCount);
+}
+
+}  // namespace orbit_object_utils
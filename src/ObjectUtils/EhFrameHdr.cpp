@@ -0,0 +1,236 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "EhFrameHdr.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_format.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/BinaryFormat/Dwarf.h>
+#include <llvm/Support/DataExtractor.h>
+#include <llvm/Support/Error.h>
+
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace orbit_object_utils {
+
+namespace {
+
+constexpr uint8_t kEhFrameHdrVersion = 1;
+constexpr uint32_t kDwarf64InitialLength = 0xffffffff;
+
+// Reads a value in the format given by the lower four bits of the DW_EH_PE_* `encoding`.
+[[nodiscard]] std::optional<uint64_t> ReadEncodedValue(const llvm::DataExtractor& extractor,
+                                                       llvm::DataExtractor::Cursor& cursor,
+                                                       uint8_t encoding) {
+  switch (encoding & 0x0f) {
+    case llvm::dwarf::DW_EH_PE_absptr:
+      return extractor.getAddress(cursor);
+    case llvm::dwarf::DW_EH_PE_uleb128:
+      return extractor.getULEB128(cursor);
+    case llvm::dwarf::DW_EH_PE_udata2:
+      return extractor.getU16(cursor);
+    case llvm::dwarf::DW_EH_PE_udata4:
+      return extractor.getU32(cursor);
+    case llvm::dwarf::DW_EH_PE_udata8:
+      return extractor.getU64(cursor);
+    case llvm::dwarf::DW_EH_PE_sleb128:
+      return static_cast<uint64_t>(extractor.getSLEB128(cursor));
+    case llvm::dwarf::DW_EH_PE_sdata2:
+      return static_cast<uint64_t>(static_cast<int16_t>(extractor.getU16(cursor)));
+    case llvm::dwarf::DW_EH_PE_sdata4:
+      return static_cast<uint64_t>(static_cast<int32_t>(extractor.getU32(cursor)));
+    case llvm::dwarf::DW_EH_PE_sdata8:
+      return extractor.getU64(cursor);
+    default:
+      return std::nullopt;
+  }
+}
+
+// Reads a pointer encoded with the DW_EH_PE_* `encoding`. `section_address` is the virtual address
+// of the data of `extractor`, `data_relative_base` the base of DW_EH_PE_datarel pointers.
+[[nodiscard]] std::optional<uint64_t> ReadEncodedPointer(const llvm::DataExtractor& extractor,
+                                                         llvm::DataExtractor::Cursor& cursor,
+                                                         uint8_t encoding, uint64_t section_address,
+                                                         uint64_t data_relative_base) {
+  // Indirect pointers would have to be read from memory of the process.
+  if ((encoding & llvm::dwarf::DW_EH_PE_indirect) != 0) return std::nullopt;
+
+  const uint64_t value_address = section_address + cursor.tell();
+  std::optional<uint64_t> value = ReadEncodedValue(extractor, cursor, encoding);
+  if (!value.has_value()) return std::nullopt;
+
+  switch (encoding & 0x70) {
+    case llvm::dwarf::DW_EH_PE_absptr:
+      return value;
+    case llvm::dwarf::DW_EH_PE_pcrel:
+      return value_address + value.value();
+    case llvm::dwarf::DW_EH_PE_datarel:
+      return data_relative_base + value.value();
+    default:
+      return std::nullopt;
+  }
+}
+
+[[nodiscard]] ErrorMessage CreateErrorMessage(llvm::DataExtractor::Cursor& cursor,
+                                              std::string_view fallback_message) {
+  if (llvm::Error error = cursor.takeError()) {
+    return ErrorMessage{
+        absl::StrFormat("Malformed unwind info: %s", llvm::toString(std::move(error)))};
+  }
+  return ErrorMessage{absl::StrFormat("Malformed unwind info: %s", fallback_message)};
+}
+
+// Skips the length field of the CIE or FDE at `cursor` and returns whether the entry uses the
+// 64-bit DWARF format.
+[[nodiscard]] bool ReadInitialLength(const llvm::DataExtractor& extractor,
+                                     llvm::DataExtractor::Cursor& cursor) {
+  if (extractor.getU32(cursor) != kDwarf64InitialLength) return false;
+  (void)extractor.getU64(cursor);
+  return true;
+}
+
+// Reads the encoding of the initial location in the FDEs that reference the CIE at `cie_offset`
+// from the augmentation data of the CIE.
+[[nodiscard]] ErrorMessageOr<uint8_t> ReadFdePointerEncoding(const llvm::DataExtractor& extractor,
+                                                             uint64_t cie_offset) {
+  llvm::DataExtractor::Cursor cursor{cie_offset};
+  const bool is_dwarf64 = ReadInitialLength(extractor, cursor);
+  const uint64_t cie_id = is_dwarf64 ? extractor.getU64(cursor) : extractor.getU32(cursor);
+  const uint8_t version = extractor.getU8(cursor);
+  const llvm::StringRef augmentation = extractor.getCStrRef(cursor);
+  (void)extractor.getULEB128(cursor);  // Code alignment factor.
+  (void)extractor.getSLEB128(cursor);  // Data alignment factor.
+  // Return address register.
+  if (version == 1) {
+    (void)extractor.getU8(cursor);
+  } else {
+    (void)extractor.getULEB128(cursor);
+  }
+  if (!cursor || cie_id != 0) return CreateErrorMessage(cursor, "invalid CIE.");
+
+  // Without augmentation data, FDEs use absolute pointers.
+  uint8_t fde_pointer_encoding = llvm::dwarf::DW_EH_PE_absptr;
+  if (augmentation.empty() || augmentation.front() != 'z') return fde_pointer_encoding;
+
+  (void)extractor.getULEB128(cursor);  // Augmentation data length.
+  for (char augmentation_character : augmentation.drop_front()) {
+    switch (augmentation_character) {
+      case 'R':
+        fde_pointer_encoding = extractor.getU8(cursor);
+        break;
+      case 'P': {
+        const uint8_t personality_encoding = extractor.getU8(cursor);
+        if (!ReadEncodedValue(extractor, cursor, personality_encoding).has_value()) {
+          return CreateErrorMessage(cursor, "unsupported personality encoding.");
+        }
+        break;
+      }
+      case 'L':
+        (void)extractor.getU8(cursor);
+        break;
+      case 'S':
+      case 'B':
+      case 'G':
+        break;
+      default:
+        return CreateErrorMessage(
+            cursor, absl::StrFormat("unsupported CIE augmentation \"%s\".", augmentation.str()));
+    }
+  }
+  if (!cursor) return CreateErrorMessage(cursor, "unexpected end of CIE.");
+  return fde_pointer_encoding;
+}
+
+}  // namespace
+
+ErrorMessageOr<std::vector<FunctionBounds>> ReadFunctionBoundsFromEhFrameHdr(
+    llvm::ArrayRef<uint8_t> eh_frame_hdr, uint64_t eh_frame_hdr_address,
+    llvm::ArrayRef<uint8_t> eh_frame, uint64_t eh_frame_address, uint8_t address_size) {
+  const llvm::DataExtractor hdr_extractor{eh_frame_hdr, /*IsLittleEndian=*/true, address_size};
+  llvm::DataExtractor::Cursor hdr_cursor{0};
+  const uint8_t version = hdr_extractor.getU8(hdr_cursor);
+  const uint8_t eh_frame_ptr_encoding = hdr_extractor.getU8(hdr_cursor);
+  const uint8_t fde_count_encoding = hdr_extractor.getU8(hdr_cursor);
+  const uint8_t table_encoding = hdr_extractor.getU8(hdr_cursor);
+  if (!hdr_cursor) return CreateErrorMessage(hdr_cursor, "unexpected end of .eh_frame_hdr.");
+  if (version != kEhFrameHdrVersion) {
+    return ErrorMessage{absl::StrFormat("Unsupported .eh_frame_hdr version %u.", version)};
+  }
+  if (fde_count_encoding == llvm::dwarf::DW_EH_PE_omit ||
+      table_encoding == llvm::dwarf::DW_EH_PE_omit) {
+    return ErrorMessage{".eh_frame_hdr does not contain a binary search table."};
+  }
+
+  std::optional<uint64_t> eh_frame_ptr = ReadEncodedPointer(
+      hdr_extractor, hdr_cursor, eh_frame_ptr_encoding, eh_frame_hdr_address, eh_frame_hdr_address);
+  std::optional<uint64_t> fde_count = ReadEncodedPointer(
+      hdr_extractor, hdr_cursor, fde_count_encoding, eh_frame_hdr_address, eh_frame_hdr_address);
+  if (!hdr_cursor || !eh_frame_ptr.has_value() || !fde_count.has_value()) {
+    return CreateErrorMessage(hdr_cursor, "unsupported .eh_frame_hdr encoding.");
+  }
+  if (eh_frame_ptr.value() != eh_frame_address) {
+    return ErrorMessage{".eh_frame_hdr does not refer to the .eh_frame section."};
+  }
+  // Each table entry takes at least two bytes, this rejects absurd counts before reserving memory.
+  if (fde_count.value() > eh_frame_hdr.size()) {
+    return ErrorMessage{"Malformed unwind info: invalid FDE count."};
+  }
+
+  const llvm::DataExtractor eh_frame_extractor{eh_frame, /*IsLittleEndian=*/true, address_size};
+  // There are usually only a few CIEs, shared by all FDEs.
+  absl::flat_hash_map<uint64_t, uint8_t> cie_offset_to_fde_pointer_encoding;
+
+  std::vector<FunctionBounds> function_bounds;
+  function_bounds.reserve(fde_count.value());
+  for (uint64_t i = 0; i < fde_count.value(); ++i) {
+    std::optional<uint64_t> initial_location = ReadEncodedPointer(
+        hdr_extractor, hdr_cursor, table_encoding, eh_frame_hdr_address, eh_frame_hdr_address);
+    std::optional<uint64_t> fde_address = ReadEncodedPointer(
+        hdr_extractor, hdr_cursor, table_encoding, eh_frame_hdr_address, eh_frame_hdr_address);
+    if (!hdr_cursor || !initial_location.has_value() || !fde_address.has_value()) {
+      return CreateErrorMessage(hdr_cursor, "unsupported .eh_frame_hdr table encoding.");
+    }
+    if (fde_address.value() < eh_frame_address) {
+      return ErrorMessage{"Malformed unwind info: FDE outside of .eh_frame."};
+    }
+
+    // The FDE starts with its length, the offset back to its CIE, its initial location (which the
+    // table already contains) and the size of its address range.
+    llvm::DataExtractor::Cursor fde_cursor{fde_address.value() - eh_frame_address};
+    const bool is_dwarf64 = ReadInitialLength(eh_frame_extractor, fde_cursor);
+    const uint64_t cie_pointer_offset = fde_cursor.tell();
+    const uint64_t cie_pointer =
+        is_dwarf64 ? eh_frame_extractor.getU64(fde_cursor) : eh_frame_extractor.getU32(fde_cursor);
+    if (!fde_cursor || cie_pointer == 0 || cie_pointer > cie_pointer_offset) {
+      return CreateErrorMessage(fde_cursor, "invalid FDE.");
+    }
+
+    const uint64_t cie_offset = cie_pointer_offset - cie_pointer;
+    auto cie_it = cie_offset_to_fde_pointer_encoding.find(cie_offset);
+    if (cie_it == cie_offset_to_fde_pointer_encoding.end()) {
+      OUTCOME_TRY(const uint8_t fde_pointer_encoding,
+                  ReadFdePointerEncoding(eh_frame_extractor, cie_offset));
+      cie_it = cie_offset_to_fde_pointer_encoding.emplace(cie_offset, fde_pointer_encoding).first;
+    }
+    const uint8_t fde_pointer_encoding = cie_it->second;
+
+    // The size of the range is not relative to anything, so only the format of the value matters.
+    std::optional<uint64_t> skipped_initial_location =
+        ReadEncodedValue(eh_frame_extractor, fde_cursor, fde_pointer_encoding);
+    std::optional<uint64_t> address_range =
+        ReadEncodedValue(eh_frame_extractor, fde_cursor, fde_pointer_encoding);
+    if (!fde_cursor || !skipped_initial_location.has_value() || !address_range.has_value()) {
+      return CreateErrorMessage(fde_cursor, "unsupported FDE encoding.");
+    }
+
+    function_bounds.push_back({initial_location.value(), address_range.value()});
+  }
+
+  return function_bounds;
+}
+
+}  // namespace orbit_object_utils
@@ -0,0 +1,34 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OBJECT_UTILS_EH_FRAME_HDR_H_
+#define OBJECT_UTILS_EH_FRAME_HDR_H_
+
+#include <llvm/ADT/ArrayRef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "OrbitBase/Result.h"
+
+namespace orbit_object_utils {
+
+struct FunctionBounds {
+  uint64_t address;
+  uint64_t size;
+};
+
+// Reads the address ranges of all Frame Descriptor Entries listed in the binary search table of the
+// .eh_frame_hdr section, sorted by address. Only the header of each FDE (and of the CIEs they
+// reference) is read from .eh_frame, which is much cheaper than parsing the whole section with
+// llvm::DWARFContext, as the call frame instructions are skipped.
+// `eh_frame_hdr` and `eh_frame` are the contents of the sections, `eh_frame_hdr_address` and
+// `eh_frame_address` their virtual addresses. Only little endian files are supported.
+[[nodiscard]] ErrorMessageOr<std::vector<FunctionBounds>> ReadFunctionBoundsFromEhFrameHdr(
+    llvm::ArrayRef<uint8_t> eh_frame_hdr, uint64_t eh_frame_hdr_address,
+    llvm::ArrayRef<uint8_t> eh_frame, uint64_t eh_frame_address, uint8_t address_size);
+
+}  // namespace orbit_object_utils
+
+#endif  // OBJECT_UTILS_EH_FRAME_HDR_H_
@@ -0,0 +1,114 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <vector>
+
+#include "EhFrameHdr.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_object_utils {
+
+namespace {
+
+using orbit_test_utils::HasError;
+using orbit_test_utils::HasNoError;
+
+constexpr uint64_t kEhFrameHdrAddress = 0x1000;
+constexpr uint64_t kEhFrameAddress = 0x2000;
+
+void AppendU32(std::vector<uint8_t>* data, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    data->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+// An .eh_frame section with one CIE at offset 0, whose FDEs use pc-relative 4-byte pointers, and
+// two FDEs at offsets 0x14 and 0x28, for [0x3000, 0x3040) and [0x2f00, 0x3000).
+std::vector<uint8_t> CreateEhFrame() {
+  std::vector<uint8_t> eh_frame;
+  AppendU32(&eh_frame, 0x10);  // Length.
+  AppendU32(&eh_frame, 0);     // CIE id.
+  // Version, augmentation "zR", code and data alignment factors, return address register,
+  // augmentation data length, DW_EH_PE_pcrel | DW_EH_PE_sdata4, three DW_CFA_nop.
+  const uint8_t cie_body[] = {0x01, 'z', 'R', 0x00, 0x01, 0x78, 0x10, 0x01, 0x1b, 0x00, 0x00, 0x00};
+  eh_frame.insert(eh_frame.end(), std::begin(cie_body), std::end(cie_body));
+
+  AppendU32(&eh_frame, 0x10);                               // Length.
+  AppendU32(&eh_frame, 0x18);                               // CIE pointer.
+  AppendU32(&eh_frame, 0x3000 - (kEhFrameAddress + 0x1c));  // Initial location.
+  AppendU32(&eh_frame, 0x40);                               // Address range.
+  AppendU32(&eh_frame, 0);                                  // Augmentation data length, nops.
+
+  AppendU32(&eh_frame, 0x10);
+  AppendU32(&eh_frame, 0x2c);
+  AppendU32(&eh_frame, 0x2f00 - (kEhFrameAddress + 0x30));
+  AppendU32(&eh_frame, 0x100);
+  AppendU32(&eh_frame, 0);
+  return eh_frame;
+}
+
+// The matching .eh_frame_hdr section, with its table sorted by initial location.
+std::vector<uint8_t> CreateEhFrameHdr() {
+  // Version, DW_EH_PE_pcrel | DW_EH_PE_sdata4, DW_EH_PE_udata4, DW_EH_PE_datarel | DW_EH_PE_sdata4.
+  std::vector<uint8_t> eh_frame_hdr{0x01, 0x1b, 0x03, 0x3b};
+  AppendU32(&eh_frame_hdr, kEhFrameAddress - (kEhFrameHdrAddress + 4));  // .eh_frame pointer.
+  AppendU32(&eh_frame_hdr, 2);                                           // FDE count.
+  AppendU32(&eh_frame_hdr, 0x2f00 - kEhFrameHdrAddress);
+  AppendU32(&eh_frame_hdr, kEhFrameAddress + 0x28 - kEhFrameHdrAddress);
+  AppendU32(&eh_frame_hdr, 0x3000 - kEhFrameHdrAddress);
+  AppendU32(&eh_frame_hdr, kEhFrameAddress + 0x14 - kEhFrameHdrAddress);
+  return eh_frame_hdr;
+}
+
+MATCHER_P2(FunctionBoundsEq, address, size, "") {
+  return arg.address == static_cast<uint64_t>(address) &&
+         arg.size == static_cast<uint64_t>(size);
+}
+
+}  // namespace
+
+TEST(EhFrameHdr, ReadsFunctionBoundsSortedByAddress) {
+  const std::vector<uint8_t> eh_frame_hdr = CreateEhFrameHdr();
+  const std::vector<uint8_t> eh_frame = CreateEhFrame();
+
+  ErrorMessageOr<std::vector<FunctionBounds>> function_bounds = ReadFunctionBoundsFromEhFrameHdr(
+      eh_frame_hdr, kEhFrameHdrAddress, eh_frame, kEhFrameAddress, /*address_size=*/8);
+  ASSERT_THAT(function_bounds, HasNoError());
+  EXPECT_THAT(function_bounds.value(), testing::ElementsAre(FunctionBoundsEq(0x2f00, 0x100),
+                                                           FunctionBoundsEq(0x3000, 0x40)));
+}
+
+TEST(EhFrameHdr, RejectsMalformedSections) {
+  const std::vector<uint8_t> eh_frame = CreateEhFrame();
+
+  std::vector<uint8_t> unsupported_version = CreateEhFrameHdr();
+  unsupported_version[0] = 2;
+  EXPECT_THAT(ReadFunctionBoundsFromEhFrameHdr(unsupported_version, kEhFrameHdrAddress, eh_frame,
+                                               kEhFrameAddress, 8),
+              HasError("version"));
+
+  std::vector<uint8_t> without_table = CreateEhFrameHdr();
+  without_table[3] = 0xff;  // DW_EH_PE_omit
+  EXPECT_THAT(ReadFunctionBoundsFromEhFrameHdr(without_table, kEhFrameHdrAddress, eh_frame,
+                                               kEhFrameAddress, 8),
+              HasError("binary search table"));
+
+  std::vector<uint8_t> truncated_table = CreateEhFrameHdr();
+  truncated_table.resize(truncated_table.size() - 2);
+  EXPECT_THAT(ReadFunctionBoundsFromEhFrameHdr(truncated_table, kEhFrameHdrAddress, eh_frame,
+                                               kEhFrameAddress, 8),
+              HasError("Malformed"));
+
+  const std::vector<uint8_t> truncated_eh_frame(eh_frame.begin(), eh_frame.begin() + 0x20);
+  EXPECT_THAT(ReadFunctionBoundsFromEhFrameHdr(CreateEhFrameHdr(), kEhFrameHdrAddress,
+                                               truncated_eh_frame, kEhFrameAddress, 8),
+              HasError("Malformed"));
+}
+
+}  // namespace orbit_object_utils
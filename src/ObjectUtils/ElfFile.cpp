@@ -5,9 +5,10 @@
 #include "ObjectUtils/ElfFile.h"
 
 #include <absl/base/casts.h>
-#include <absl/container/flat_hash_set.h>
+#include <absl/container/flat_hash_map.h>
 #include <absl/strings/str_cat.h>
 #include <absl/strings/str_format.h>
+#include <absl/types/span.h>
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/Twine.h>
@@ -18,6 +19,7 @@
 #include <llvm/DebugInfo/DWARF/DWARFDebugAranges.h>
 #include <llvm/DebugInfo/DWARF/DWARFDebugFrame.h>
 #include <llvm/DebugInfo/DWARF/DWARFDebugLine.h>
+#include <llvm/DebugInfo/DWARF/DWARFDie.h>
 #include <llvm/DebugInfo/DWARF/DWARFFormValue.h>
 #include <llvm/DebugInfo/Symbolize/SymbolizableModule.h>
 #include <llvm/DebugInfo/Symbolize/Symbolize.h>
@@ -34,16 +36,22 @@
 #include <llvm/Support/MathExtras.h>
 #include <llvm/Support/MemoryBuffer.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
+#include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "EhFrameHdr.h"
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/symbol.pb.h"
 #include "Introspection/Introspection.h"
+#include "OrbitBase/Chunk.h"
 #include "OrbitBase/File.h"
 #include "OrbitBase/Logging.h"
+#include "OrbitBase/ParallelFor.h"
 #include "OrbitBase/ReadFileToString.h"
 #include "OrbitBase/Result.h"
 
@@ -77,6 +85,9 @@ class ElfFileImpl : public ElfFile {
   [[nodiscard]] uint64_t GetImageSize() const override;
   [[nodiscard]] const std::vector<orbit_grpc_protos::ModuleInfo::ObjectSegment>& GetObjectSegments()
       const override;
+  void SetSymbolCreationExecutor(orbit_base::Executor* executor) override {
+    symbol_creation_executor_ = executor;
+  }
   [[nodiscard]] bool HasDebugInfo() const override;
   [[nodiscard]] bool HasGnuDebuglink() const override;
   [[nodiscard]] bool Is64Bit() const override;
@@ -96,12 +107,40 @@ class ElfFileImpl : public ElfFile {
   ErrorMessageOr<void> InitSections();
   ErrorMessageOr<void> InitProgramHeaders();
   ErrorMessageOr<void> InitDynamicEntries();
-  ErrorMessageOr<SymbolInfo> CreateSymbolInfo(const llvm::object::ELFSymbolRef& symbol_ref);
+  ErrorMessageOr<SymbolInfo> CreateSymbolInfo(const llvm::object::ELFSymbolRef& symbol_ref) const;
+  [[nodiscard]] llvm::DWARFContext* GetDwarfContext();
+  // Fast path of LoadEhOrDebugFrameEntriesAsSymbols for files with an .eh_frame_hdr section, which
+  // avoids parsing the whole .eh_frame section with llvm::DWARFContext.
+  [[nodiscard]] ErrorMessageOr<ModuleSymbols> LoadEhFrameHdrEntriesAsSymbols();
+  [[nodiscard]] ErrorMessageOr<LineInfo> SymbolizeLineInfo(uint64_t address);
+  [[nodiscard]] std::optional<LineInfo> FindCachedLineInfo(uint64_t address) const;
+  void AddLineInfoToCache(uint64_t address, const LineInfo& line_info);
+  // Creates the SymbolInfos of the function symbols in `symbol_refs`, in the same order, also using
+  // `symbol_creation_executor_` if set.
+  [[nodiscard]] ModuleSymbols CreateFunctionSymbolInfos(
+      llvm::iterator_range<llvm::object::elf_symbol_iterator> symbol_refs) const;
 
   const std::filesystem::path file_path_;
   llvm::object::OwningBinary<llvm::object::ObjectFile> owning_binary_;
   llvm::object::ELFObjectFile<ElfT>* object_file_;
   llvm::symbolize::LLVMSymbolizer symbolizer_;
+  // Created on first use, as parsing the DWARF information is expensive.
+  std::unique_ptr<llvm::DWARFContext> dwarf_context_;
+  orbit_base::Executor* symbol_creation_executor_ = nullptr;
+
+  // Reports query the line info of every address of a function, so the line info of an address is
+  // cached for the whole address range of its row in the DWARF line table, limited to the range of
+  // the same inlined function: all addresses in there have the same line info. The ranges are keyed
+  // by their start address.
+  struct CachedLineInfo {
+    uint64_t end_address;
+    uint32_t source_file_index;
+    uint32_t source_line;
+  };
+  std::map<uint64_t, CachedLineInfo> line_info_cache_;
+  std::vector<std::string> cached_source_files_;
+  absl::flat_hash_map<std::string, uint32_t> cached_source_file_to_index_;
+
   std::string build_id_;
   std::string soname_;
   bool has_symtab_section_;
@@ -332,7 +371,7 @@ ErrorMessageOr<void> ElfFileImpl<ElfT>::InitSections() {
 
 template <typename ElfT>
 ErrorMessageOr<SymbolInfo> ElfFileImpl<ElfT>::CreateSymbolInfo(
-    const llvm::object::ELFSymbolRef& symbol_ref) {
+    const llvm::object::ELFSymbolRef& symbol_ref) const {
   std::string name;
   if (auto maybe_name = symbol_ref.getName(); maybe_name) name = maybe_name.get().str();
 
@@ -377,19 +416,52 @@ ErrorMessageOr<SymbolInfo> ElfFileImpl<ElfT>::CreateSymbolInfo(
 }
 
 template <typename ElfT>
-ErrorMessageOr<ModuleSymbols> ElfFileImpl<ElfT>::LoadDebugSymbols() {
-  if (!has_symtab_section_) {
-    return ErrorMessage("ELF file does not have a .symtab section.");
+ModuleSymbols ElfFileImpl<ElfT>::CreateFunctionSymbolInfos(
+    llvm::iterator_range<llvm::object::elf_symbol_iterator> symbol_refs) const {
+  // Reading a symbol and demangling its name only reads from the (immutable) object file, so
+  // chunks of symbols can be processed concurrently. Each chunk has its own output, and the outputs
+  // are concatenated in order, so the result is the same as with a sequential loop.
+  constexpr size_t kSymbolsPerChunk = 4096;
+  std::vector<llvm::object::ELFSymbolRef> all_symbol_refs(symbol_refs.begin(), symbol_refs.end());
+  std::vector<absl::Span<llvm::object::ELFSymbolRef>> chunks =
+      orbit_base::CreateChunksOfSize(all_symbol_refs, kSymbolsPerChunk);
+  std::vector<std::vector<SymbolInfo>> symbol_infos_per_chunk(chunks.size());
+
+  auto create_chunk = [this, &chunks, &symbol_infos_per_chunk](size_t index) {
+    for (const llvm::object::ELFSymbolRef& symbol_ref : chunks[index]) {
+      ErrorMessageOr<SymbolInfo> symbol_or_error = CreateSymbolInfo(symbol_ref);
+      if (symbol_or_error.has_value()) {
+        symbol_infos_per_chunk[index].push_back(std::move(symbol_or_error.value()));
+      }
+    }
+  };
+  if (symbol_creation_executor_ != nullptr) {
+    orbit_base::ParallelFor(symbol_creation_executor_, chunks.size(), create_chunk);
+  } else {
+    for (size_t index = 0; index < chunks.size(); ++index) create_chunk(index);
   }
 
+  size_t symbol_count = 0;
+  for (const std::vector<SymbolInfo>& symbol_infos : symbol_infos_per_chunk) {
+    symbol_count += symbol_infos.size();
+  }
   ModuleSymbols module_symbols;
-
-  for (const llvm::object::ELFSymbolRef& symbol_ref : object_file_->symbols()) {
-    auto symbol_or_error = CreateSymbolInfo(symbol_ref);
-    if (symbol_or_error.has_value()) {
-      *module_symbols.add_symbol_infos() = std::move(symbol_or_error.value());
+  module_symbols.mutable_symbol_infos()->Reserve(static_cast<int>(symbol_count));
+  for (std::vector<SymbolInfo>& symbol_infos : symbol_infos_per_chunk) {
+    for (SymbolInfo& symbol_info : symbol_infos) {
+      *module_symbols.add_symbol_infos() = std::move(symbol_info);
     }
   }
+  return module_symbols;
+}
+
+template <typename ElfT>
+ErrorMessageOr<ModuleSymbols> ElfFileImpl<ElfT>::LoadDebugSymbols() {
+  if (!has_symtab_section_) {
+    return ErrorMessage("ELF file does not have a .symtab section.");
+  }
+
+  ModuleSymbols module_symbols = CreateFunctionSymbolInfos(object_file_->symbols());
 
   if (module_symbols.symbol_infos_size() == 0) {
     return ErrorMessage(
@@ -404,14 +476,8 @@ ErrorMessageOr<ModuleSymbols> ElfFileImpl<ElfT>::LoadSymbolsFromDynsym() {
     return ErrorMessage("ELF file does not have a .dynsym section.");
   }
 
-  ModuleSymbols module_symbols;
-
-  for (const llvm::object::ELFSymbolRef& symbol_ref : object_file_->getDynamicSymbolIterators()) {
-    auto symbol_or_error = CreateSymbolInfo(symbol_ref);
-    if (symbol_or_error.has_value()) {
-      *module_symbols.add_symbol_infos() = std::move(symbol_or_error.value());
-    }
-  }
+  ModuleSymbols module_symbols =
+      CreateFunctionSymbolInfos(object_file_->getDynamicSymbolIterators());
 
   if (module_symbols.symbol_infos_size() == 0) {
     return ErrorMessage(
@@ -421,9 +487,68 @@ ErrorMessageOr<ModuleSymbols> ElfFileImpl<ElfT>::LoadSymbolsFromDynsym() {
   return module_symbols;
 }
 
+template <typename ElfT>
+ErrorMessageOr<ModuleSymbols> ElfFileImpl<ElfT>::LoadEhFrameHdrEntriesAsSymbols() {
+  std::optional<llvm::object::SectionRef> eh_frame_hdr_section;
+  std::optional<llvm::object::SectionRef> eh_frame_section;
+  for (const llvm::object::SectionRef& section : object_file_->sections()) {
+    llvm::Expected<llvm::StringRef> section_name = section.getName();
+    if (!section_name) {
+      llvm::consumeError(section_name.takeError());
+      continue;
+    }
+    // The most specific unwind information is in .debug_frame, which the slow path handles.
+    if (*section_name == ".debug_frame") {
+      return ErrorMessage{"ELF file has a .debug_frame section."};
+    }
+    if (*section_name == ".eh_frame_hdr") eh_frame_hdr_section = section;
+    if (*section_name == ".eh_frame") eh_frame_section = section;
+  }
+  if (!eh_frame_hdr_section.has_value() || !eh_frame_section.has_value()) {
+    return ErrorMessage{"ELF file does not have an .eh_frame_hdr and an .eh_frame section."};
+  }
+
+  llvm::Expected<llvm::StringRef> eh_frame_hdr = eh_frame_hdr_section->getContents();
+  if (!eh_frame_hdr) {
+    return ErrorMessage{absl::StrFormat("Could not read .eh_frame_hdr section: %s",
+                                        llvm::toString(eh_frame_hdr.takeError()))};
+  }
+  llvm::Expected<llvm::StringRef> eh_frame = eh_frame_section->getContents();
+  if (!eh_frame) {
+    return ErrorMessage{absl::StrFormat("Could not read .eh_frame section: %s",
+                                        llvm::toString(eh_frame.takeError()))};
+  }
+
+  static_assert(ElfT::TargetEndianness == llvm::support::little,
+                "This code only supports little endian architectures.");
+  OUTCOME_TRY(std::vector<FunctionBounds> all_function_bounds,
+              ReadFunctionBoundsFromEhFrameHdr(
+                  llvm::arrayRefFromStringRef(*eh_frame_hdr), eh_frame_hdr_section->getAddress(),
+                  llvm::arrayRefFromStringRef(*eh_frame), eh_frame_section->getAddress(),
+                  object_file_->getBytesInAddress()));
+  if (all_function_bounds.empty()) {
+    return ErrorMessage{".eh_frame_hdr does not contain any address range."};
+  }
+
+  ModuleSymbols module_symbols;
+  module_symbols.mutable_symbol_infos()->Reserve(static_cast<int>(all_function_bounds.size()));
+  for (const FunctionBounds& function_bounds : all_function_bounds) {
+    SymbolInfo* symbol_info = module_symbols.add_symbol_infos();
+    symbol_info->set_demangled_name(absl::StrFormat("[function@%#x]", function_bounds.address));
+    symbol_info->set_address(function_bounds.address);
+    symbol_info->set_size(function_bounds.size);
+  }
+  return module_symbols;
+}
+
 template <typename ElfT>
 ErrorMessageOr<orbit_grpc_protos::ModuleSymbols>
 ElfFileImpl<ElfT>::LoadEhOrDebugFrameEntriesAsSymbols() {
+  // The binary search table of .eh_frame_hdr lists all FDEs already sorted by address, so only the
+  // headers of the FDEs need to be read. Fall back to parsing the sections with LLVM otherwise.
+  ErrorMessageOr<ModuleSymbols> eh_frame_hdr_entries = LoadEhFrameHdrEntriesAsSymbols();
+  if (eh_frame_hdr_entries.has_value()) return eh_frame_hdr_entries;
+
   const std::unique_ptr<llvm::DWARFContext> dwarf_context =
       llvm::DWARFContext::create(*object_file_);
   constexpr const char* kErrorMessagePrefix =
@@ -512,26 +637,51 @@ ElfFileImpl<ElfT>::LoadDynamicLinkingSymbolsAndUnwindRangesAsSymbols() {
                                         dynamic_linking_symbols.error().message(),
                                         unwind_ranges_as_symbols.error().message())};
   }
-  ModuleSymbols dynamic_linking_symbols_and_unwind_ranges_as_symbols;
-
-  absl::flat_hash_set<uint64_t> dynamic_linking_addresses;
-  if (dynamic_linking_symbols.has_value()) {
-    for (SymbolInfo& symbol_info : *dynamic_linking_symbols.value().mutable_symbol_infos()) {
-      dynamic_linking_addresses.insert(symbol_info.address());
-      *dynamic_linking_symbols_and_unwind_ranges_as_symbols.add_symbol_infos() =
-          std::move(symbol_info);
+  if (!dynamic_linking_symbols.has_value()) return unwind_ranges_as_symbols;
+  if (!unwind_ranges_as_symbols.has_value()) return dynamic_linking_symbols;
+
+  // Merge the two lists sorted by address in a single pass, skipping the unwind ranges that start
+  // at the address of a dynamic linking symbol, as those already have a proper name. The unwind
+  // ranges from .eh_frame_hdr are already sorted, the (few) dynamic linking symbols usually not.
+  auto sort_by_address = [](google::protobuf::RepeatedPtrField<SymbolInfo>* symbol_infos) {
+    auto address_less = [](const SymbolInfo* lhs, const SymbolInfo* rhs) {
+      return lhs->address() < rhs->address();
+    };
+    if (std::is_sorted(symbol_infos->pointer_begin(), symbol_infos->pointer_end(), address_less)) {
+      return;
     }
-  }
+    std::stable_sort(symbol_infos->pointer_begin(), symbol_infos->pointer_end(), address_less);
+  };
+  google::protobuf::RepeatedPtrField<SymbolInfo>* dynamic_linking_symbol_infos =
+      dynamic_linking_symbols.value().mutable_symbol_infos();
+  google::protobuf::RepeatedPtrField<SymbolInfo>* unwind_range_symbol_infos =
+      unwind_ranges_as_symbols.value().mutable_symbol_infos();
+  sort_by_address(dynamic_linking_symbol_infos);
+  sort_by_address(unwind_range_symbol_infos);
 
-  if (unwind_ranges_as_symbols.has_value()) {
-    for (SymbolInfo& symbol_info : *unwind_ranges_as_symbols.value().mutable_symbol_infos()) {
-      if (dynamic_linking_addresses.contains(symbol_info.address())) {
-        continue;
-      }
-      *dynamic_linking_symbols_and_unwind_ranges_as_symbols.add_symbol_infos() =
-          std::move(symbol_info);
+  ModuleSymbols dynamic_linking_symbols_and_unwind_ranges_as_symbols;
+  google::protobuf::RepeatedPtrField<SymbolInfo>* merged_symbol_infos =
+      dynamic_linking_symbols_and_unwind_ranges_as_symbols.mutable_symbol_infos();
+  merged_symbol_infos->Reserve(dynamic_linking_symbol_infos->size() +
+                               unwind_range_symbol_infos->size());
+  auto dynamic_linking_it = dynamic_linking_symbol_infos->begin();
+  auto unwind_range_it = unwind_range_symbol_infos->begin();
+  while (dynamic_linking_it != dynamic_linking_symbol_infos->end() &&
+         unwind_range_it != unwind_range_symbol_infos->end()) {
+    if (unwind_range_it->address() < dynamic_linking_it->address()) {
+      *merged_symbol_infos->Add() = std::move(*unwind_range_it++);
+    } else if (unwind_range_it->address() == dynamic_linking_it->address()) {
+      ++unwind_range_it;
+    } else {
+      *merged_symbol_infos->Add() = std::move(*dynamic_linking_it++);
     }
   }
+  for (; dynamic_linking_it != dynamic_linking_symbol_infos->end(); ++dynamic_linking_it) {
+    *merged_symbol_infos->Add() = std::move(*dynamic_linking_it);
+  }
+  for (; unwind_range_it != unwind_range_symbol_infos->end(); ++unwind_range_it) {
+    *merged_symbol_infos->Add() = std::move(*unwind_range_it);
+  }
 
   return dynamic_linking_symbols_and_unwind_ranges_as_symbols;
 }
@@ -642,8 +792,15 @@ const std::filesystem::path& ElfFileImpl<ElfT>::GetFilePath() const {
 }
 
 template <typename ElfT>
-ErrorMessageOr<LineInfo> orbit_object_utils::ElfFileImpl<ElfT>::GetLineInfo(uint64_t address) {
-  ORBIT_CHECK(has_debug_info_section_);
+llvm::DWARFContext* ElfFileImpl<ElfT>::GetDwarfContext() {
+  if (dwarf_context_ == nullptr) {
+    dwarf_context_ = llvm::DWARFContext::create(*owning_binary_.getBinary());
+  }
+  return dwarf_context_.get();
+}
+
+template <typename ElfT>
+ErrorMessageOr<LineInfo> ElfFileImpl<ElfT>::SymbolizeLineInfo(uint64_t address) {
   auto line_info_or_error =
       symbolizer_.symbolizeInlinedCode(std::string{object_file_->getFileName()},
                                        {address, llvm::object::SectionedAddress::UndefSection});
@@ -675,10 +832,131 @@ ErrorMessageOr<LineInfo> orbit_object_utils::ElfFileImpl<ElfT>::GetLineInfo(uint
   return line_info;
 }
 
+template <typename ElfT>
+std::optional<LineInfo> ElfFileImpl<ElfT>::FindCachedLineInfo(uint64_t address) const {
+  auto it = line_info_cache_.upper_bound(address);
+  if (it == line_info_cache_.begin()) return std::nullopt;
+  --it;
+  const CachedLineInfo& cached_line_info = it->second;
+  if (address >= cached_line_info.end_address) return std::nullopt;
+
+  LineInfo line_info;
+  line_info.set_source_file(cached_source_files_[cached_line_info.source_file_index]);
+  line_info.set_source_line(cached_line_info.source_line);
+  return line_info;
+}
+
+// Excludes from [*start_address, *end_address), which contains `address`, the address ranges of all
+// the inlined functions in `die` that do not contain `address`. Nested inlined functions are part
+// of the range of the inlined function they are in, so they don't need to be visited.
+[[nodiscard]] bool ExcludeRangesOfInlinedFunctions(const llvm::DWARFDie& die, uint64_t address,
+                                                   uint64_t* start_address,
+                                                   uint64_t* end_address) {
+  for (const llvm::DWARFDie& child : die.children()) {
+    if (child.getTag() != llvm::dwarf::DW_TAG_inlined_subroutine) {
+      // E.g., lexical blocks can contain inlined functions.
+      if (!ExcludeRangesOfInlinedFunctions(child, address, start_address, end_address)) {
+        return false;
+      }
+      continue;
+    }
+    llvm::Expected<llvm::DWARFAddressRangesVector> ranges = child.getAddressRanges();
+    if (!ranges) {
+      llvm::consumeError(ranges.takeError());
+      return false;
+    }
+    for (const llvm::DWARFAddressRange& range : ranges.get()) {
+      if (range.HighPC <= address) {
+        *start_address = std::max(*start_address, range.HighPC);
+      } else if (range.LowPC > address) {
+        *end_address = std::min(*end_address, range.LowPC);
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Shrinks [*start_address, *end_address), which contains `address`, so that the whole range has the
+// same outermost location as `address`. Within the range of an inlined function, that is the
+// location of the call of the outermost inlined function, so the range is limited to the range of
+// the innermost inlined function, `innermost_die`. Outside of inlined functions, the range is
+// limited to the addresses between the inlined functions of the function. Returns false if the
+// ranges of the functions cannot be read.
+[[nodiscard]] bool ShrinkRangeToSameInlinedFunction(const llvm::DWARFDie& innermost_die,
+                                                    uint64_t address, uint64_t* start_address,
+                                                    uint64_t* end_address) {
+  if (innermost_die.getTag() != llvm::dwarf::DW_TAG_inlined_subroutine) {
+    return ExcludeRangesOfInlinedFunctions(innermost_die, address, start_address, end_address);
+  }
+
+  llvm::Expected<llvm::DWARFAddressRangesVector> ranges = innermost_die.getAddressRanges();
+  if (!ranges) {
+    llvm::consumeError(ranges.takeError());
+    return false;
+  }
+  for (const llvm::DWARFAddressRange& range : ranges.get()) {
+    if (range.LowPC <= address && address < range.HighPC) {
+      *start_address = std::max(*start_address, range.LowPC);
+      *end_address = std::min(*end_address, range.HighPC);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename ElfT>
+void ElfFileImpl<ElfT>::AddLineInfoToCache(uint64_t address, const LineInfo& line_info) {
+  llvm::DWARFContext* dwarf_context = GetDwarfContext();
+  if (dwarf_context == nullptr) return;
+  llvm::DWARFCompileUnit* compile_unit = dwarf_context->getCompileUnitForAddress(address);
+  if (compile_unit == nullptr) return;
+  const llvm::DWARFDebugLine::LineTable* line_table =
+      dwarf_context->getLineTableForUnit(compile_unit);
+  if (line_table == nullptr) return;
+
+  // The row following the one containing the address always exists, as a sequence is terminated by
+  // an end_sequence row.
+  const uint32_t row_index =
+      line_table->lookupAddress({address, llvm::object::SectionedAddress::UndefSection});
+  if (row_index == line_table->UnknownRowIndex || row_index + 1 >= line_table->Rows.size()) return;
+  uint64_t start_address = line_table->Rows[row_index].Address.Address;
+  uint64_t end_address = line_table->Rows[row_index + 1].Address.Address;
+  if (address < start_address || address >= end_address) return;
+
+  // The row gives the innermost location, but the line info is the outermost one, which can change
+  // within a row, e.g., between back-to-back inlined calls of the same function.
+  llvm::SmallVector<llvm::DWARFDie, 4> inlined_chain;
+  compile_unit->getInlinedChainForAddress(address, inlined_chain);
+  if (inlined_chain.empty() ||
+      !ShrinkRangeToSameInlinedFunction(inlined_chain.front(), address, &start_address,
+                                        &end_address)) {
+    return;
+  }
+
+  auto [it, inserted] = cached_source_file_to_index_.try_emplace(
+      line_info.source_file(), static_cast<uint32_t>(cached_source_files_.size()));
+  if (inserted) cached_source_files_.push_back(line_info.source_file());
+  line_info_cache_.try_emplace(start_address,
+                               CachedLineInfo{end_address, it->second, line_info.source_line()});
+}
+
+template <typename ElfT>
+ErrorMessageOr<LineInfo> orbit_object_utils::ElfFileImpl<ElfT>::GetLineInfo(uint64_t address) {
+  ORBIT_CHECK(has_debug_info_section_);
+  std::optional<LineInfo> cached_line_info = FindCachedLineInfo(address);
+  if (cached_line_info.has_value()) return std::move(cached_line_info.value());
+
+  OUTCOME_TRY(LineInfo line_info, SymbolizeLineInfo(address));
+  AddLineInfoToCache(address, line_info);
+  return line_info;
+}
+
 template <typename ElfT>
 ErrorMessageOr<LineInfo> orbit_object_utils::ElfFileImpl<ElfT>::GetDeclarationLocationOfFunction(
     uint64_t address) {
-  const auto dwarf_context = llvm::DWARFContext::create(*owning_binary_.getBinary());
+  llvm::DWARFContext* const dwarf_context = GetDwarfContext();
   if (dwarf_context == nullptr) return ErrorMessage{"Could not read DWARF information."};
 
   const auto offset = dwarf_context->getDebugAranges()->findAddress(address);
@@ -818,6 +1096,15 @@ ErrorMessageOr<std::unique_ptr<ElfFile>> CreateElfFile(
       "Unable to load \"%s\": Big-endian architectures are not supported.", file_path.string()));
 }
 
+std::vector<ErrorMessageOr<LineInfo>> ElfFile::GetLineInfos(absl::Span<const uint64_t> addresses) {
+  std::vector<ErrorMessageOr<LineInfo>> line_infos;
+  line_infos.reserve(addresses.size());
+  for (uint64_t address : addresses) {
+    line_infos.push_back(GetLineInfo(address));
+  }
+  return line_infos;
+}
+
 ErrorMessageOr<uint32_t> ElfFile::CalculateDebuglinkChecksum(
     const std::filesystem::path& file_path) {
   ErrorMessageOr<orbit_base::unique_fd> fd_or_error = orbit_base::OpenFileForReading(file_path);
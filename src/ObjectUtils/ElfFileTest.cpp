@@ -16,6 +16,7 @@
 #include "ObjectUtils/ElfFile.h"
 #include "OrbitBase/ReadFileToString.h"
 #include "OrbitBase/Result.h"
+#include "OrbitBase/ThreadPool.h"
 #include "Test/Path.h"
 #include "TestUtils/TestUtils.h"
 #include "absl/strings/ascii.h"
@@ -54,6 +55,33 @@ TEST(ElfFile, LoadDebugSymbols) {
   EXPECT_EQ(symbol_info.size(), 45);
 }
 
+TEST(ElfFile, LoadDebugSymbolsUsingSymbolCreationExecutor) {
+  std::filesystem::path file_path =
+      orbit_test::GetTestdataDir() / "hello_world_elf_with_debug_info";
+
+  auto elf_file_result = CreateElfFile(file_path);
+  ASSERT_THAT(elf_file_result, HasNoError());
+  std::unique_ptr<ElfFile> elf_file = std::move(elf_file_result.value());
+  const auto serial_symbols_result = elf_file->LoadDebugSymbols();
+  ASSERT_THAT(serial_symbols_result, HasNoError());
+
+  std::shared_ptr<orbit_base::ThreadPool> thread_pool =
+      orbit_base::ThreadPool::Create(1, 2, absl::Seconds(1));
+  elf_file->SetSymbolCreationExecutor(thread_pool.get());
+  const auto symbols_result = elf_file->LoadDebugSymbols();
+  ASSERT_THAT(symbols_result, HasNoError());
+  thread_pool->ShutdownAndWait();
+
+  const auto& serial_symbol_infos = serial_symbols_result.value().symbol_infos();
+  const auto& symbol_infos = symbols_result.value().symbol_infos();
+  ASSERT_EQ(symbol_infos.size(), serial_symbol_infos.size());
+  for (int i = 0; i < symbol_infos.size(); ++i) {
+    EXPECT_EQ(symbol_infos[i].demangled_name(), serial_symbol_infos[i].demangled_name());
+    EXPECT_EQ(symbol_infos[i].address(), serial_symbol_infos[i].address());
+    EXPECT_EQ(symbol_infos[i].size(), serial_symbol_infos[i].size());
+  }
+}
+
 TEST(ElfFile, HasDebugSymbols) {
   {
     const std::filesystem::path elf_with_symbols_path =
@@ -156,11 +184,12 @@ TEST(ElfFile, LoadEhOrDebugFrameEntriesAsSymbolsFromEhFrame) {
   std::vector<SymbolInfo> symbol_infos(symbols_result.value().symbol_infos().begin(),
                                        symbols_result.value().symbol_infos().end());
   // These can be obtained with `objdump hello_world_elf --dwarf=frames` looking at the FDE entries.
+  // They are sorted by address, as they are read from the binary search table of .eh_frame_hdr.
   EXPECT_THAT(
       symbol_infos,
-      testing::ElementsAre(SymbolInfoEq("[function@0x1050]", 0x1050, 43),  // `_start`
-                           SymbolInfoEq("[function@0x1020]", 0x1020, 32),  // no function, `.plt`
+      testing::ElementsAre(SymbolInfoEq("[function@0x1020]", 0x1020, 32),  // no function, `.plt`
                            SymbolInfoEq("[function@0x1040]", 0x1040, 8),  // no function, `.plt.got`
+                           SymbolInfoEq("[function@0x1050]", 0x1050, 43),   // `_start`
                            SymbolInfoEq("[function@0x1135]", 0x1135, 35),   // `main`
                            SymbolInfoEq("[function@0x1160]", 0x1160, 93),   // `__libc_csu_init`
                            SymbolInfoEq("[function@0x11c0]", 0x11c0, 1)));  // `__libc_csu_fini`
@@ -197,9 +226,9 @@ TEST(ElfFile, LoadDynamicLinkingSymbolsAndUnwindRangesAsSymbolsWithoutDynsym) {
                                        fallback_symbols.value().symbol_infos().end());
   EXPECT_THAT(
       symbol_infos,
-      testing::ElementsAre(SymbolInfoEq("[function@0x1050]", 0x1050, 43),  // `_start`
-                           SymbolInfoEq("[function@0x1020]", 0x1020, 32),  // no function, `.plt`
+      testing::ElementsAre(SymbolInfoEq("[function@0x1020]", 0x1020, 32),  // no function, `.plt`
                            SymbolInfoEq("[function@0x1040]", 0x1040, 8),  // no function, `.plt.got`
+                           SymbolInfoEq("[function@0x1050]", 0x1050, 43),   // `_start`
                            SymbolInfoEq("[function@0x1135]", 0x1135, 35),   // `main`
                            SymbolInfoEq("[function@0x1160]", 0x1160, 93),   // `__libc_csu_init`
                            SymbolInfoEq("[function@0x11c0]", 0x11c0, 1)));  // `__libc_csu_fini`
@@ -220,9 +249,9 @@ TEST(ElfFile, LoadDynamicLinkingSymbolsAndUnwindRangesAsSymbolsWithDynsym) {
                                        fallback_symbols.value().symbol_infos().end());
   EXPECT_THAT(symbol_infos,
               testing::ElementsAre(
-                  SymbolInfoEq("PrintHelloWorld", 0x1110, 12),
-                  SymbolInfoEq("[function@0x1020]", 0x1020, 32),   // no function, `.plt`
-                  SymbolInfoEq("[function@0x1040]", 0x1040, 8)));  // no function, `.plt.got`
+                  SymbolInfoEq("[function@0x1020]", 0x1020, 32),  // no function, `.plt`
+                  SymbolInfoEq("[function@0x1040]", 0x1040, 8),   // no function, `.plt.got`
+                  SymbolInfoEq("PrintHelloWorld", 0x1110, 12)));
 }
 
 TEST(ElfFile, LoadBiasAndExecutableSegmentOffsetAndImageSize) {
@@ -489,6 +518,64 @@ TEST(ElfFile, LineInfoInlining) {
             "LineInfoTestBinary.cpp");
 }
 
+TEST(ElfFile, GetLineInfosMatchesGetLineInfoInAnyOrder) {
+  const std::filesystem::path file_path = orbit_test::GetTestdataDir() / "line_info_test_binary";
+
+  // Line infos are cached, so query the addresses in opposite orders on two different instances.
+  auto batch_program = CreateElfFile(file_path);
+  ASSERT_THAT(batch_program, HasNoError());
+  auto single_program = CreateElfFile(file_path);
+  ASSERT_THAT(single_program, HasNoError());
+
+  constexpr uint64_t kFirstInstructionOfInlinedPrintHelloWorld = 0x401141;
+  std::vector<uint64_t> addresses;
+  for (uint64_t address = 0x401100; address < 0x401200; ++address) {
+    addresses.push_back(address);
+  }
+  const std::vector<ErrorMessageOr<orbit_grpc_protos::LineInfo>> line_infos =
+      batch_program.value()->GetLineInfos(addresses);
+  ASSERT_EQ(line_infos.size(), addresses.size());
+
+  for (size_t i = addresses.size(); i-- > 0;) {
+    ErrorMessageOr<orbit_grpc_protos::LineInfo> line_info =
+        single_program.value()->GetLineInfo(addresses[i]);
+    ASSERT_EQ(line_infos[i].has_value(), line_info.has_value()) << addresses[i];
+    if (!line_info.has_value()) continue;
+    EXPECT_EQ(line_infos[i].value().source_file(), line_info.value().source_file());
+    EXPECT_EQ(line_infos[i].value().source_line(), line_info.value().source_line());
+  }
+
+  const ErrorMessageOr<orbit_grpc_protos::LineInfo>& inlined_line_info =
+      line_infos[kFirstInstructionOfInlinedPrintHelloWorld - addresses.front()];
+  ASSERT_THAT(inlined_line_info, HasNoError());
+  EXPECT_EQ(inlined_line_info.value().source_line(), 13);
+}
+
+TEST(ElfFile, LineInfoOfBackToBackInlinedCalls) {
+  const std::filesystem::path file_path =
+      orbit_test::GetTestdataDir() / "inlined_calls_test_binary";
+
+  auto program = CreateElfFile(file_path);
+  ASSERT_THAT(program, HasNoError());
+
+  // A single row of the line table covers the three inlined calls, which are on lines 13 to 15 and
+  // take three bytes each. Query every address in order, so that the line info of a call was cached
+  // before the next one is queried.
+  constexpr uint64_t kFirstInlinedCallAddress = 0x1040;
+  constexpr uint64_t kInlinedCallSize = 3;
+  constexpr uint32_t kFirstInlinedCallLine = 13;
+  for (uint64_t call_index = 0; call_index < 3; ++call_index) {
+    for (uint64_t offset = 0; offset < kInlinedCallSize; ++offset) {
+      const uint64_t address = kFirstInlinedCallAddress + call_index * kInlinedCallSize + offset;
+      ErrorMessageOr<orbit_grpc_protos::LineInfo> line_info = program.value()->GetLineInfo(address);
+      ASSERT_THAT(line_info, HasNoError());
+      EXPECT_EQ(line_info.value().source_line(), kFirstInlinedCallLine + call_index) << address;
+      EXPECT_EQ(std::filesystem::path{line_info.value().source_file()}.filename().string(),
+                "InlinedCallsTestBinary.cpp");
+    }
+  }
+}
+
 TEST(ElfFile, CompressedDebugInfo) {
   const std::filesystem::path file_path =
       orbit_test::GetTestdataDir() / "line_info_test_binary_compressed";
@@ -26,6 +26,7 @@
 
 #include "GrpcProtos/symbol.pb.h"
 #include "ObjectUtils/CoffFile.h"
+#include "ObjectUtils/DemangledNameCache.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/Result.h"
 
@@ -64,14 +65,17 @@ class SymbolInfoVisitor : public llvm::codeview::SymbolVisitorCallbacks {
                     absl::flat_hash_set<uint64_t>* addresses_from_module_debug_stream,
                     const ObjectFileInfo& object_file_info,
                     llvm::FixedStreamArray<llvm::object::coff_section>* section_headers,
-                    llvm::pdb::TpiStream* type_info_stream)
+                    llvm::pdb::TpiStream* type_info_stream,
+                    DemangledNameCache* demangled_name_cache)
       : symbol_infos_(symbol_infos),
         addresses_from_module_debug_stream_(addresses_from_module_debug_stream),
         object_file_info_(object_file_info),
         section_headers_(section_headers),
-        type_info_stream_(type_info_stream) {
+        type_info_stream_(type_info_stream),
+        demangled_name_cache_(demangled_name_cache) {
     ORBIT_CHECK(symbol_infos != nullptr);
     ORBIT_CHECK(type_info_stream != nullptr);
+    ORBIT_CHECK(demangled_name_cache != nullptr);
   }
 
   // This is the only record type (ProcSym) we are interested in, so we only override this
@@ -79,7 +83,7 @@ class SymbolInfoVisitor : public llvm::codeview::SymbolVisitorCallbacks {
   llvm::Error visitKnownRecord(llvm::codeview::CVSymbol& /*unused*/,
                                llvm::codeview::ProcSym& proc) override {
     SymbolInfo symbol_info;
-    symbol_info.set_demangled_name(llvm::demangle(proc.Name.str()));
+    symbol_info.set_demangled_name(demangled_name_cache_->Demangle(proc.Name));
 
     // The ProcSym's name does not contain an argument list. However, this information is required
     // when dealing with overloads and it is available in the type info stream. See:
@@ -164,6 +168,7 @@ class SymbolInfoVisitor : public llvm::codeview::SymbolVisitorCallbacks {
   ObjectFileInfo object_file_info_;
   llvm::FixedStreamArray<llvm::object::coff_section>* section_headers_;
   llvm::pdb::TpiStream* type_info_stream_;
+  DemangledNameCache* demangled_name_cache_;
 };
 
 // This visitor will try to deduce the missing size information from the given symbol using
@@ -210,7 +215,8 @@ ErrorMessageOr<void> LoadDebugSymbolsFromModuleStreams(
     llvm::pdb::PDBFile& pdb_file, llvm::pdb::DbiStream& debug_info_stream,
     llvm::pdb::TpiStream& type_info_stream,
     llvm::FixedStreamArray<llvm::object::coff_section>& section_headers,
-    const ObjectFileInfo& object_file_info, std::vector<SymbolInfo>* symbol_infos,
+    const ObjectFileInfo& object_file_info, DemangledNameCache* demangled_name_cache,
+    std::vector<SymbolInfo>* symbol_infos,
     absl::flat_hash_set<uint64_t>* addresses_from_module_debug_stream) {
   const llvm::pdb::DbiModuleList& modules = debug_info_stream.modules();
 
@@ -239,7 +245,8 @@ ErrorMessageOr<void> LoadDebugSymbolsFromModuleStreams(
                                                     llvm::codeview::CodeViewContainer::Pdb);
     pipeline.addCallbackToPipeline(deserializer);
     SymbolInfoVisitor symbol_visitor(symbol_infos, addresses_from_module_debug_stream,
-                                     object_file_info, &section_headers, &type_info_stream);
+                                     object_file_info, &section_headers, &type_info_stream,
+                                     demangled_name_cache);
     pipeline.addCallbackToPipeline(symbol_visitor);
     llvm::codeview::CVSymbolVisitor visitor(pipeline);
 
@@ -263,7 +270,7 @@ void LoadDebugSymbolsFromPublicSymbolStream(
     llvm::FixedStreamArray<llvm::object::coff_section>& section_headers,
     const ObjectFileInfo& object_file_info,
     const absl::flat_hash_set<uint64_t>& addresses_from_module_debug_stream,
-    std::vector<SymbolInfo>* symbol_infos) {
+    DemangledNameCache* demangled_name_cache, std::vector<SymbolInfo>* symbol_infos) {
   const llvm::pdb::GSIHashTable& public_symbol_has_records = public_symbol_stream.getPublicsTable();
   for (const auto& hash_record : public_symbol_has_records) {
     llvm::Expected<llvm::codeview::PublicSym32> record =
@@ -284,7 +291,7 @@ void LoadDebugSymbolsFromPublicSymbolStream(
 
     SymbolInfo symbol_info;
     symbol_info.set_address(address);
-    symbol_info.set_demangled_name(llvm::demangle(record->Name.str()));
+    symbol_info.set_demangled_name(demangled_name_cache->Demangle(record->Name));
     // The PDB public symbols don't contain the size of symbols. Set a placeholder which indicates
     // that the size is unknown for now and try to deduce it later. We will later use that
     // placeholder to look-up the size in `SectionContributionsVisitor` or in
@@ -343,11 +350,12 @@ uint32_t PdbFileLlvm::GetAge() const {
   llvm::FixedStreamArray<llvm::object::coff_section> section_headers =
       debug_info_stream->getSectionHeaders();
 
+  DemangledNameCache demangled_name_cache;
   std::vector<SymbolInfo> symbol_infos;
   absl::flat_hash_set<uint64_t> addresses_from_module_debug_stream;
   OUTCOME_TRY(LoadDebugSymbolsFromModuleStreams(
       pdb_file, debug_info_stream.get(), type_info_stream.get(), section_headers, object_file_info_,
-      &symbol_infos, &addresses_from_module_debug_stream));
+      &demangled_name_cache, &symbol_infos, &addresses_from_module_debug_stream));
 
   if (!pdb_file.hasPDBPublicsStream()) {
     return ErrorMessage("PDB file does not have a public symbol stream.");
@@ -363,7 +371,8 @@ uint32_t PdbFileLlvm::GetAge() const {
 
   LoadDebugSymbolsFromPublicSymbolStream(public_symbol_stream.get(), symbol_stream.get(),
                                          section_headers, object_file_info_,
-                                         addresses_from_module_debug_stream, &symbol_infos);
+                                         addresses_from_module_debug_stream, &demangled_name_cache,
+                                         &symbol_infos);
 
   // We try to find the missing size information from public symbols from the section contributions.
   // Note that we sometimes have multiple names for the same address, so we use a vector here as
@@ -12,6 +12,7 @@
 
 #include "Introspection/Introspection.h"
 #include "ObjectUtils/ObjectFile.h"
+#include "ObjectUtils/ElfFile.h"
 #include "ObjectUtils/PdbFile.h"
 #include "OrbitBase/File.h"
 #include "OrbitBase/Result.h"
@@ -34,6 +35,10 @@ ErrorMessageOr<std::unique_ptr<SymbolsFile>> CreateSymbolsFile(
   ErrorMessageOr<std::unique_ptr<ObjectFile>> object_file_or_error = CreateObjectFile(file_path);
   if (object_file_or_error.has_value()) {
     if (object_file_or_error.value()->HasDebugSymbols()) {
+      if (object_file_or_error.value()->IsElf()) {
+        static_cast<ElfFile*>(object_file_or_error.value().get())
+            ->SetSymbolCreationExecutor(object_file_info.symbol_creation_executor);
+      }
       return std::move(object_file_or_error.value());
     }
     error_message.append("File does not contain symbols.");
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OBJECT_UTILS_DEMANGLED_NAME_CACHE_H_
+#define OBJECT_UTILS_DEMANGLED_NAME_CACHE_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace orbit_object_utils {
+
+// Demangles symbol names like llvm::demangle, and caches the demangled names of the symbols that
+// are actually mangled. This only pays off where the same names come up again and again, like in
+// the module streams of a PDB file, in which template instantiations and inline functions are
+// present for many compile units. The symbol tables of ELF and COFF files list each symbol once,
+// so they are demangled directly.
+//
+// A cache only lives for the loading of the symbols of one object file, so that it doesn't hold
+// on to memory between loads, e.g., in OrbitService. It is thread-safe, and split in shards with
+// their own mutex, so that the threads that load the symbols of different chunks rarely wait for
+// each other. Once the names in the cache take `max_cached_bytes`, new names are still demangled
+// but no longer cached.
+class DemangledNameCache {
+ public:
+  // Enough for the distinct mangled names of very large modules.
+  static constexpr size_t kDefaultMaxCachedBytes = 64 * 1024 * 1024;
+
+  explicit DemangledNameCache(size_t max_cached_bytes = kDefaultMaxCachedBytes);
+
+  DemangledNameCache(const DemangledNameCache&) = delete;
+  DemangledNameCache& operator=(const DemangledNameCache&) = delete;
+
+  [[nodiscard]] std::string Demangle(std::string_view name);
+
+  [[nodiscard]] size_t GetCachedNameCount() const;
+
+ private:
+  static constexpr int kShardIndexBits = 4;
+  static constexpr size_t kShardCount = size_t{1} << kShardIndexBits;
+
+  struct Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<std::string, std::string> mangled_to_demangled_name ABSL_GUARDED_BY(mutex);
+    size_t cached_bytes ABSL_GUARDED_BY(mutex) = 0;
+  };
+
+  size_t max_cached_bytes_per_shard_;
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace orbit_object_utils
+
+#endif  // OBJECT_UTILS_DEMANGLED_NAME_CACHE_H_
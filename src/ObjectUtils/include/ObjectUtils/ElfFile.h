@@ -5,6 +5,7 @@
 #ifndef OBJECT_UTILS_ELF_FILE_H_
 #define OBJECT_UTILS_ELF_FILE_H_
 
+#include <absl/types/span.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -16,6 +17,7 @@
 
 #include "GrpcProtos/symbol.pb.h"
 #include "ObjectFile.h"
+#include "OrbitBase/Executor.h"
 #include "OrbitBase/Result.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
@@ -42,12 +44,23 @@ class ElfFile : public ObjectFile {
   [[nodiscard]] virtual ErrorMessageOr<orbit_grpc_protos::ModuleSymbols>
   LoadEhOrDebugFrameEntriesAsSymbols() = 0;
 
+  // Function symbols are created on the calling thread, unless an executor to also create them on
+  // is set. See ObjectFileInfo::symbol_creation_executor.
+  virtual void SetSymbolCreationExecutor(orbit_base::Executor* executor) = 0;
+
   [[nodiscard]] virtual bool HasDebugInfo() const = 0;
   [[nodiscard]] virtual bool HasGnuDebuglink() const = 0;
   [[nodiscard]] virtual bool Is64Bit() const = 0;
   [[nodiscard]] virtual std::string GetSoname() const = 0;
+  // Returns the source location of `address`, i.e., the location of the outermost call if the
+  // address is in inlined code. Results are cached per address range in this ElfFile instance only:
+  // queries on another instance of the same file, e.g., one created for another report, start over.
   [[nodiscard]] virtual ErrorMessageOr<orbit_grpc_protos::LineInfo> GetLineInfo(
       uint64_t address) = 0;
+  // Returns the result of GetLineInfo for each of `addresses`, in the same order. Prefer this over
+  // calling GetLineInfo in a loop when querying many addresses, e.g., all addresses of a function.
+  [[nodiscard]] virtual std::vector<ErrorMessageOr<orbit_grpc_protos::LineInfo>> GetLineInfos(
+      absl::Span<const uint64_t> addresses);
 
   // Returns the declaration location of the given function (subprogram) address
   // if available in the DWARF debug information.
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "GrpcProtos/symbol.pb.h"
+#include "OrbitBase/Executor.h"
 #include "OrbitBase/Result.h"
 
 namespace orbit_object_utils {
@@ -18,6 +19,10 @@ struct ObjectFileInfo {
   // For ELF, this is the load bias of the executable segment. For PE/COFF, we use ImageBase here,
   // so that our address computations are consistent between what we do for ELF and for COFF.
   uint64_t load_bias = 0;
+  // The executor on which ELF function symbols are created concurrently, in addition to the calling
+  // thread. Without one, they are only created on the calling thread: OrbitService loads symbols on
+  // the machine being profiled and must not take all of its cores.
+  orbit_base::Executor* symbol_creation_executor = nullptr;
 };
 
 class SymbolsFile {
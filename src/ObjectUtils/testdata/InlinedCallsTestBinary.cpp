@@ -0,0 +1,17 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This file will NOT be compiled as part of Orbit 's build system. It' s meant to generate the
+// testdata. Check out `testdata/Makefile` on how to compile it.
+
+// The three inlined calls to this function are back to back and have the same source location, so
+// that a single row of the line table covers all of them.
+__attribute__((always_inline)) inline void ThreeNops() { asm volatile("nop\n nop\n nop"); }
+
+int main() {
+  ThreeNops();
+  ThreeNops();
+  ThreeNops();
+  return 0;
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/synchronization/mutex.h>
+#include <gtest/gtest.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "OrbitBase/Future.h"
+#include "OrbitBase/ParallelFor.h"
+#include "OrbitBase/ThreadPool.h"
+
+namespace orbit_base {
+
+TEST(ParallelFor, ZeroCountDoesNotCallFunction) {
+  bool called = false;
+  ParallelFor(0, [&called](size_t /*index*/) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ParallelFor, FunctionIsCalledOnceForEachIndex) {
+  constexpr size_t kCount = 1024;
+  std::vector<std::atomic<uint32_t>> counters(kCount);
+
+  ParallelFor(kCount, [&counters](size_t index) { ++counters[index]; });
+
+  for (const std::atomic<uint32_t>& counter : counters) {
+    EXPECT_EQ(counter, 1);
+  }
+}
+
+TEST(ParallelFor, CompletesWhenCalledFromBusyThreadPool) {
+  constexpr size_t kCount = 64;
+  std::shared_ptr<ThreadPool> thread_pool = ThreadPool::Create(1, 1, absl::Milliseconds(500));
+  std::vector<std::atomic<uint32_t>> counters(kCount);
+
+  // The only thread of the pool runs ParallelFor itself, so the helper tasks it schedules cannot
+  // start before it returns.
+  Future<void> future = thread_pool->Schedule([&thread_pool, &counters]() {
+    ParallelFor(thread_pool.get(), kCount, [&counters](size_t index) { ++counters[index]; });
+  });
+  future.Wait();
+
+  for (const std::atomic<uint32_t>& counter : counters) {
+    EXPECT_EQ(counter, 1);
+  }
+  thread_pool->ShutdownAndWait();
+}
+
+}  // namespace orbit_base
@@ -0,0 +1,31 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "OrbitBase/PriorityTaskQueue.h"
+
+#include "OrbitBase/Logging.h"
+
+namespace orbit_base {
+
+PriorityTaskQueue::PriorityTaskQueue(Executor* executor, size_t max_running_tasks)
+    : executor_{executor}, max_running_tasks_{max_running_tasks} {
+  ORBIT_CHECK(executor_ != nullptr);
+  ORBIT_CHECK(max_running_tasks_ > 0);
+}
+
+void PriorityTaskQueue::StartWaitingTasks() {
+  while (running_task_count_ < max_running_tasks_ && !waiting_tasks_.empty()) {
+    auto task_node = waiting_tasks_.extract(waiting_tasks_.begin());
+    ++running_task_count_;
+    task_node.mapped()();
+  }
+}
+
+void PriorityTaskQueue::OnTaskFinished() {
+  ORBIT_CHECK(running_task_count_ > 0);
+  --running_task_count_;
+  StartWaitingTasks();
+}
+
+}  // namespace orbit_base
@@ -0,0 +1,82 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "OrbitBase/Future.h"
+#include "OrbitBase/PriorityTaskQueue.h"
+#include "OrbitBase/Promise.h"
+#include "OrbitBase/SimpleExecutor.h"
+
+namespace orbit_base {
+
+namespace {
+// Creates a task that records its id when started, and completes when `promises[id]` is set.
+auto CreateTask(int id, std::vector<int>* started_ids, std::vector<Promise<int>>* promises) {
+  return [id, started_ids, promises]() -> Future<int> {
+    started_ids->push_back(id);
+    return (*promises)[id].GetFuture();
+  };
+}
+}  // namespace
+
+TEST(PriorityTaskQueue, StartsTasksUpToTheLimit) {
+  std::shared_ptr<SimpleExecutor> executor = SimpleExecutor::Create();
+  PriorityTaskQueue queue{executor.get(), 2};
+  std::vector<int> started_ids;
+  std::vector<Promise<int>> promises(3);
+
+  Future<int> future0 = queue.Schedule(0, CreateTask(0, &started_ids, &promises));
+  Future<int> future1 = queue.Schedule(0, CreateTask(1, &started_ids, &promises));
+  Future<int> future2 = queue.Schedule(0, CreateTask(2, &started_ids, &promises));
+  EXPECT_THAT(started_ids, testing::ElementsAre(0, 1));
+  EXPECT_EQ(queue.GetRunningTaskCount(), 2);
+  EXPECT_EQ(queue.GetWaitingTaskCount(), 1);
+
+  promises[1].SetResult(42);
+  EXPECT_FALSE(future1.IsFinished());
+  executor->ExecuteScheduledTasks();
+  ASSERT_TRUE(future1.IsFinished());
+  EXPECT_EQ(future1.Get(), 42);
+  EXPECT_THAT(started_ids, testing::ElementsAre(0, 1, 2));
+
+  promises[0].SetResult(0);
+  promises[2].SetResult(2);
+  executor->ExecuteScheduledTasks();
+  EXPECT_TRUE(future0.IsFinished());
+  EXPECT_TRUE(future2.IsFinished());
+  EXPECT_EQ(queue.GetRunningTaskCount(), 0);
+  EXPECT_EQ(queue.GetWaitingTaskCount(), 0);
+}
+
+TEST(PriorityTaskQueue, StartsTasksWithHigherPriorityFirst) {
+  std::shared_ptr<SimpleExecutor> executor = SimpleExecutor::Create();
+  PriorityTaskQueue queue{executor.get(), 1};
+  std::vector<int> started_ids;
+  std::vector<Promise<int>> promises(5);
+
+  std::vector<Future<int>> futures;
+  futures.push_back(queue.Schedule(0, CreateTask(0, &started_ids, &promises)));
+  futures.push_back(queue.Schedule(1, CreateTask(1, &started_ids, &promises)));
+  futures.push_back(queue.Schedule(5, CreateTask(2, &started_ids, &promises)));
+  futures.push_back(queue.Schedule(1, CreateTask(3, &started_ids, &promises)));
+  futures.push_back(queue.Schedule(3, CreateTask(4, &started_ids, &promises)));
+
+  for (int i = 0; i < 5; ++i) {
+    promises[started_ids.back()].SetResult(i);
+    executor->ExecuteScheduledTasks();
+  }
+  // Task 0 started right away, as the queue was empty. Tasks with the same priority start in the
+  // order in which they were scheduled.
+  EXPECT_THAT(started_ids, testing::ElementsAre(0, 2, 4, 1, 3));
+  for (const Future<int>& future : futures) {
+    EXPECT_TRUE(future.IsFinished());
+  }
+}
+
+}  // namespace orbit_base
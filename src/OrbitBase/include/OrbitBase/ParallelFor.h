@@ -0,0 +1,89 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_BASE_PARALLEL_FOR_H_
+#define ORBIT_BASE_PARALLEL_FOR_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "OrbitBase/Executor.h"
+#include "OrbitBase/ThreadPool.h"
+
+namespace orbit_base {
+
+// Calls `function(index)` once for each index in [0, count), in parallel, and returns when all the
+// calls have returned. Indices are handed out dynamically, so `function` can take a different
+// amount of time for each index.
+//
+// Unlike with TaskGroup, the calling thread takes part in the work, and waits for the indices to be
+// processed rather than for the tasks scheduled on `executor` to finish. Tasks that only start
+// once all indices have been claimed return right away. This makes it safe to call ParallelFor
+// from a task running on `executor` itself, even when all of its threads are busy: in the worst
+// case the calling thread processes all indices on its own.
+//
+// Usage:
+//
+// std::vector<absl::Span<Object>> chunks = CreateChunksOfSize(objects, 1024);
+// ParallelFor(chunks.size(), [&chunks](size_t index) {
+//   for (Object& object : chunks[index]) Process(object);
+// });
+//
+template <typename Function>
+void ParallelFor(Executor* executor, size_t count, Function&& function) {
+  if (count == 0) return;
+
+  struct State {
+    explicit State(size_t count) : count{count} {}
+    const size_t count;
+    std::atomic<size_t> next_index = 0;
+    absl::Mutex mutex;
+    size_t completed_count ABSL_GUARDED_BY(mutex) = 0;
+  };
+  // Scheduled tasks can outlive this call, hence the shared ownership of the state. They only
+  // access `function` after claiming an index, and this call doesn't return before all claimed
+  // indices were processed.
+  auto state = std::make_shared<State>(count);
+  auto process_indices = [state, &function]() {
+    size_t processed_count = 0;
+    for (size_t index = state->next_index.fetch_add(1); index < state->count;
+         index = state->next_index.fetch_add(1)) {
+      function(index);
+      ++processed_count;
+    }
+    if (processed_count == 0) return;
+    absl::MutexLock lock{&state->mutex};
+    state->completed_count += processed_count;
+  };
+
+  const size_t max_thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  const size_t helper_count = std::min(count, max_thread_count) - 1;
+  for (size_t i = 0; i < helper_count; ++i) {
+    (void)executor->Schedule(process_indices);
+  }
+  process_indices();
+
+  absl::MutexLock lock{&state->mutex};
+  state->mutex.Await(absl::Condition(
+      +[](State* state) ABSL_EXCLUSIVE_LOCKS_REQUIRED(state->mutex) {
+        return state->completed_count == state->count;
+      },
+      state.get()));
+}
+
+template <typename Function>
+void ParallelFor(size_t count, Function&& function) {
+  ParallelFor(ThreadPool::GetDefaultThreadPool(), count, std::forward<Function>(function));
+}
+
+}  // namespace orbit_base
+
+#endif  // ORBIT_BASE_PARALLEL_FOR_H_
@@ -0,0 +1,94 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_BASE_PRIORITY_TASK_QUEUE_H_
+#define ORBIT_BASE_PRIORITY_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <utility>
+
+#include "OrbitBase/AnyInvocable.h"
+#include "OrbitBase/Executor.h"
+#include "OrbitBase/Future.h"
+#include "OrbitBase/Promise.h"
+
+namespace orbit_base_internal {
+template <typename>
+struct FutureValueType;
+
+template <typename T>
+struct FutureValueType<orbit_base::Future<T>> {
+  using Type = T;
+};
+}  // namespace orbit_base_internal
+
+namespace orbit_base {
+
+// PriorityTaskQueue starts asynchronous tasks in the order of their priority, with at most
+// `max_running_tasks` of them running at the same time. A task is a function returning a
+// Future<T>, and it counts as running until that future completes.
+//
+// This is meant for long operations that compete for the same resources, like downloading and
+// loading symbols: the most important ones complete first, instead of all of them progressing
+// slowly at the same time.
+//
+// The queue is not thread-safe. Schedule must be called on the thread of `executor`, where the
+// tasks are also started. The queue must outlive all the tasks scheduled on it.
+//
+// Usage:
+//
+// PriorityTaskQueue queue{main_thread_executor, 4};
+// Future<ErrorMessageOr<void>> future =
+//     queue.Schedule(priority, [this, module]() { return LoadSymbols(module); });
+//
+class PriorityTaskQueue {
+ public:
+  PriorityTaskQueue(Executor* executor, size_t max_running_tasks);
+
+  PriorityTaskQueue(const PriorityTaskQueue&) = delete;
+  PriorityTaskQueue& operator=(const PriorityTaskQueue&) = delete;
+
+  // Tasks with a higher `priority` are started first, tasks with the same priority in the order in
+  // which they were scheduled. The returned future completes with the result of the task's future.
+  template <typename Task, typename T = typename orbit_base_internal::FutureValueType<
+                               std::invoke_result_t<Task>>::Type>
+  [[nodiscard]] Future<T> Schedule(uint64_t priority, Task&& task) {
+    static_assert(!std::is_void_v<T>, "Tasks returning Future<void> are not supported.");
+    Promise<T> promise;
+    Future<T> future = promise.GetFuture();
+    waiting_tasks_.emplace(
+        priority, [this, task = std::forward<Task>(task), promise = std::move(promise)]() mutable {
+          Future<T> task_future = task();
+          (void)task_future.Then(executor_, [this, promise = std::move(promise)](
+                                                const T& result) mutable {
+            promise.SetResult(result);
+            OnTaskFinished();
+          });
+        });
+    StartWaitingTasks();
+    return future;
+  }
+
+  [[nodiscard]] size_t GetRunningTaskCount() const { return running_task_count_; }
+  [[nodiscard]] size_t GetWaitingTaskCount() const { return waiting_tasks_.size(); }
+
+ private:
+  void StartWaitingTasks();
+  void OnTaskFinished();
+
+  Executor* executor_;
+  size_t max_running_tasks_;
+  size_t running_task_count_ = 0;
+  // std::multimap keeps elements with the same key in insertion order.
+  std::multimap<uint64_t, AnyInvocable<void()>, std::greater<>> waiting_tasks_;
+};
+
+}  // namespace orbit_base
+
+#endif  // ORBIT_BASE_PRIORITY_TASK_QUEUE_H_
@@ -37,7 +37,7 @@ void AnnotationTrack::DrawAnnotation(PrimitiveAssembler& primitive_assembler,
 
     if (!GetValueUpperBoundTooltip().empty()) {
       Vec2 text_box_size(string_width, layout->GetTextBoxHeight());
-      auto user_data = std::make_unique<PickingUserData>(
+      PickingUserData user_data(
           nullptr, [&](PickingId /*id*/) { return this->GetValueUpperBoundTooltip(); });
       primitive_assembler.AddShadedBox(text_box_position, text_box_size, z, kFullyTransparent,
                                        std::move(user_data));
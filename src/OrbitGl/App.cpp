@@ -25,6 +25,7 @@
 #include <cstddef>
 #include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
 #include <optional>
 #include <ratio>
@@ -88,10 +89,12 @@
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/MainThreadExecutor.h"
 #include "OrbitBase/NotFoundOr.h"
+#include "OrbitBase/PriorityTaskQueue.h"
 #include "OrbitBase/Result.h"
 #include "OrbitBase/StopSource.h"
 #include "OrbitBase/StopToken.h"
 #include "OrbitBase/ThreadConstants.h"
+#include "OrbitBase/ThreadPool.h"
 #include "OrbitBase/UniqueResource.h"
 #include "OrbitBase/WhenAll.h"
 #include "OrbitPaths/Paths.h"
@@ -182,6 +185,11 @@ constexpr const char* kLibOrbitVulkanLayerSoFileName = "libOrbitVulkanLayer.so";
 constexpr const char* kNtdllSoFileName = "ntdll.so";
 constexpr const char* kWineSyscallDispatcherFunctionName = "__wine_syscall_dispatcher";
 constexpr std::string_view kGgpVlkModulePathSubstring = "ggpvlk.so";
+// Symbol loading operations started by LoadAllSymbols or LoadSymbolsManually mostly compete for
+// the same connection to the instance, so only a few of them run at the same time.
+constexpr size_t kMaxRunningSymbolLoadingOperations = 4;
+// Symbols that the user explicitly asked for are loaded before all others.
+constexpr uint64_t kLoadSymbolsManuallyPriority = std::numeric_limits<uint64_t>::max();
 
 orbit_data_views::PresetLoadState GetPresetLoadStateForProcess(const PresetFile& preset,
                                                                const ProcessData* process) {
@@ -324,6 +332,32 @@ ErrorMessageOr<std::optional<std::filesystem::path>> GetOverrideSymbolFileForMod
   return prioritized_modules;
 }
 
+// Returns how many of the sampled callstack frames of the capture are in each module.
+[[nodiscard]] absl::flat_hash_map<ModuleIdentifier, uint64_t> CountSampledFramesPerModule(
+    const CaptureData& capture_data) {
+  absl::flat_hash_map<ModuleIdentifier, uint64_t> module_id_to_count;
+  if (!capture_data.has_post_processed_sampling_data()) return module_id_to_count;
+  const orbit_client_data::ThreadSampleData* summary =
+      capture_data.post_processed_sampling_data().GetSummary();
+  if (summary == nullptr) return module_id_to_count;
+
+  const std::map<uint64_t, orbit_client_data::ModuleInMemory> memory_map =
+      capture_data.process()->GetMemoryMapCopy();
+  absl::flat_hash_map<const orbit_client_data::ModuleInMemory*, uint64_t> module_to_count;
+  for (const auto& [absolute_address, count] : summary->sampled_address_to_count) {
+    auto it = memory_map.upper_bound(absolute_address);
+    if (it == memory_map.begin()) continue;
+    --it;
+    if (absolute_address >= it->second.end()) continue;
+    module_to_count[&it->second] += count;
+  }
+
+  for (const auto& [module_in_memory, count] : module_to_count) {
+    module_id_to_count[module_in_memory->module_id()] += count;
+  }
+  return module_id_to_count;
+}
+
 }  // namespace
 
 bool DoZoom = false;
@@ -345,6 +379,8 @@ OrbitApp::OrbitApp(orbit_gl::MainWindowInterface* main_window,
         action->Execute();
         ORBIT_STOP();
       });
+  symbol_loading_queue_ = std::make_unique<orbit_base::PriorityTaskQueue>(
+      main_thread_executor_, kMaxRunningSymbolLoadingOperations);
 
   main_thread_id_ = std::this_thread::get_id();
   data_manager_ = std::make_unique<orbit_client_data::DataManager>(main_thread_id_);
@@ -454,6 +490,13 @@ void OrbitApp::OnCaptureStarted(const orbit_grpc_protos::CaptureStarted& capture
                              data_source_);
         GetMutableCaptureData().set_memory_warning_threshold_kb(
             data_manager_->memory_warning_threshold_kb());
+        if (absl::GetFlag(FLAGS_disk_backed_capture) &&
+            data_source_ == CaptureData::DataSource::kLiveCapture) {
+          ErrorMessageOr<void> result = GetMutableCaptureData().EnableDiskBackedStorage();
+          if (result.has_error()) {
+            ORBIT_ERROR("Unable to enable disk-backed capture: %s", result.error().message());
+          }
+        }
         capture_window_->CreateTimeGraph(&GetMutableCaptureData());
         orbit_gl::TrackManager* track_manager = GetMutableTimeGraph()->GetTrackManager();
         track_manager->SetIsDataFromSavedCapture(data_source_ ==
@@ -584,6 +627,19 @@ void OrbitApp::OnTimer(const TimerInfo& timer_info) {
   frame_track_online_processor_.ProcessTimer(timer_info);
 }
 
+void OrbitApp::OnTimers(absl::Span<const TimerInfo> timers) {
+  CaptureData& capture_data = GetMutableCaptureData();
+  for (const TimerInfo& timer_info : timers) {
+    CaptureMetricProcessTimer(timer_info);
+    capture_data.UpdateScopeStats(timer_info);
+  }
+
+  GetMutableTimeGraph()->ProcessTimers(timers);
+  for (const TimerInfo& timer_info : timers) {
+    frame_track_online_processor_.ProcessTimer(timer_info);
+  }
+}
+
 void OrbitApp::OnApiStringEvent(const orbit_client_data::ApiStringEvent& api_string_event) {
   GetMutableTimeGraph()->ProcessApiStringEvent(api_string_event);
 }
@@ -1821,8 +1877,14 @@ Future<void> OrbitApp::LoadSymbolsManually(absl::Span<const ModuleData* const> m
     download_disabled_modules_.erase(module->file_path());
 
     // Explicitly do not handle the result.
-    Future<void> future = RetrieveModuleAndLoadSymbolsAndHandleError(module).Then(
-        &immediate_executor, [](const SymbolLoadingAndErrorHandlingResult & /*result*/) -> void {});
+    Future<void> future =
+        symbol_loading_queue_
+            ->Schedule(kLoadSymbolsManuallyPriority,
+                       [this, module]() {
+                         return RetrieveModuleAndLoadSymbolsAndHandleError(module);
+                       })
+            .Then(&immediate_executor,
+                  [](const SymbolLoadingAndErrorHandlingResult & /*result*/) -> void {});
     futures.emplace_back(std::move(future));
   }
   orbit_client_symbols::QSettingsBasedStorageManager storage_manager;
@@ -1959,6 +2021,44 @@ Future<ErrorMessageOr<CanceledOr<void>>> OrbitApp::RetrieveModuleAndLoadSymbols(
 
 Future<ErrorMessageOr<CanceledOr<void>>> OrbitApp::RetrieveModuleSymbolsAndLoadSymbols(
     const ModuleIdentifier& module_id) {
+  const ModuleData* module_data = GetModuleByModuleIdentifier(module_id);
+  if (module_data == nullptr) {
+    return {ErrorMessage{absl::StrFormat("Module \"%s\" was not found.", module_id.file_path)}};
+  }
+
+  // Unless the symbols file is available locally, the symbols are first loaded on the instance.
+  // This only transfers the symbols themselves, while the symbols file, which can be much larger,
+  // is only downloaded when it is needed, e.g., for line info.
+  Future<ErrorMessageOr<std::filesystem::path>> find_locally_future =
+      FindModuleLocally(module_data);
+
+  return orbit_base::UnwrapFuture(find_locally_future.Then(
+      main_thread_executor_,
+      [this, module_id](const ErrorMessageOr<std::filesystem::path>& find_result)
+          -> Future<ErrorMessageOr<CanceledOr<void>>> {
+        orbit_base::ImmediateExecutor executor;
+        if (find_result.has_value()) {
+          return LoadSymbols(find_result.value(), module_id)
+              .ThenIfSuccess(&executor, []() -> CanceledOr<void> { return CanceledOr<void>{}; });
+        }
+        if (!CanLoadSymbolsOnInstance(module_id)) {
+          return RetrieveModuleSymbolsFileAndLoadSymbols(module_id);
+        }
+
+        return orbit_base::UnwrapFuture(LoadSymbolsFromInstance(module_id).Then(
+            main_thread_executor_,
+            [this, module_id](const ErrorMessageOr<void>& load_result)
+                -> Future<ErrorMessageOr<CanceledOr<void>>> {
+              if (load_result.has_value()) return {CanceledOr<void>{}};
+              ORBIT_LOG("Could not load symbols for \"%s\" on the instance: %s",
+                        module_id.file_path, load_result.error().message());
+              return RetrieveModuleSymbolsFileAndLoadSymbols(module_id);
+            }));
+      }));
+}
+
+Future<ErrorMessageOr<CanceledOr<void>>> OrbitApp::RetrieveModuleSymbolsFileAndLoadSymbols(
+    const ModuleIdentifier& module_id) {
   Future<ErrorMessageOr<CanceledOr<std::filesystem::path>>> retrieve_module_symbols_future =
       RetrieveModuleSymbols(module_id);
 
@@ -1983,6 +2083,14 @@ Future<ErrorMessageOr<CanceledOr<void>>> OrbitApp::RetrieveModuleSymbolsAndLoadS
       }));
 }
 
+bool OrbitApp::CanLoadSymbolsOnInstance(const ModuleIdentifier& module_id) const {
+  // Without an ssh connection to the instance (--local), the service still runs on this machine,
+  // where the symbols file would have been found locally.
+  return !absl::GetFlag(FLAGS_local) && main_window_->IsConnected() &&
+         !absl::GetFlag(FLAGS_disable_instance_symbols) &&
+         !download_disabled_modules_.contains(module_id.file_path);
+}
+
 Future<ErrorMessageOr<CanceledOr<std::filesystem::path>>> OrbitApp::RetrieveModuleSymbols(
     const ModuleIdentifier& module_id) {
   ORBIT_SCOPE_FUNCTION;
@@ -2516,13 +2624,53 @@ Future<ErrorMessageOr<void>> OrbitApp::LoadSymbols(const std::filesystem::path&
                                                    const ModuleIdentifier& module_id) {
   ORBIT_SCOPE_FUNCTION;
 
+  // The function tables are built on the worker thread, so that the main thread only needs to
+  // publish them.
   auto load_symbols_from_file_future = thread_pool_->Schedule(
-      [this, symbols_path, module_id]() -> ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> {
+      [this, symbols_path,
+       module_id]() -> ErrorMessageOr<std::unique_ptr<ModuleData::SymbolsBuilder>> {
         const ModuleData* module_data = GetModuleByModuleIdentifier(module_id);
         orbit_object_utils::ObjectFileInfo object_file_info{module_data->load_bias()};
+        object_file_info.symbol_creation_executor = orbit_base::ThreadPool::GetDefaultThreadPool();
+
+        // Parsing the debug information of large modules is slow. The symbols of modules with a
+        // build id are kept in the cache in a compact form that is much faster to load, as long as
+        // they come from the same symbols file.
+        std::optional<std::string> source_id;
+        if (!module_id.build_id.empty()) {
+          ErrorMessageOr<std::string> source_id_or_error =
+              orbit_symbols::SymbolHelper::GetPreprocessedSymbolsSourceId(symbols_path);
+          if (source_id_or_error.has_value()) source_id = std::move(source_id_or_error.value());
+        }
+        if (source_id.has_value()) {
+          ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> cached_symbols_or_error =
+              symbol_helper_.LoadPreprocessedSymbolsFromCache(module_id.build_id, *source_id,
+                                                              object_file_info.load_bias);
+          if (cached_symbols_or_error.has_value()) {
+            auto builder = std::make_unique<ModuleData::SymbolsBuilder>(module_id);
+            builder->AddSymbols(std::move(cached_symbols_or_error.value()));
+            return builder;
+          }
+          ORBIT_LOG("Unable to load preprocessed symbols for \"%s\" from cache: %s",
+                    module_id.file_path, cached_symbols_or_error.error().message());
+        }
+
         ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> symbols_or_error =
             orbit_symbols::SymbolHelper::LoadSymbolsFromFile(symbols_path, object_file_info);
-        if (symbols_or_error.has_value()) return symbols_or_error;
+        if (symbols_or_error.has_value()) {
+          if (source_id.has_value()) {
+            ErrorMessageOr<void> save_result = symbol_helper_.SavePreprocessedSymbolsToCache(
+                module_id.build_id, *source_id, object_file_info.load_bias,
+                symbols_or_error.value());
+            if (save_result.has_error()) {
+              ORBIT_ERROR("Unable to save preprocessed symbols for \"%s\" to cache: %s",
+                          module_id.file_path, save_result.error().message());
+            }
+          }
+          auto builder = std::make_unique<ModuleData::SymbolsBuilder>(module_id);
+          builder->AddSymbols(std::move(symbols_or_error.value()));
+          return builder;
+        }
         return {ErrorMessage{absl::StrFormat("Could not load debug symbols from \"%s\": %s",
                                              symbols_path.string(),
                                              symbols_or_error.error().message())}};
@@ -2530,10 +2678,11 @@ Future<ErrorMessageOr<void>> OrbitApp::LoadSymbols(const std::filesystem::path&
 
   auto add_symbols_future = load_symbols_from_file_future.ThenIfSuccess(
       main_thread_executor_,
-      [this,
-       module_id](const orbit_grpc_protos::ModuleSymbols& symbols) mutable -> ErrorMessageOr<void> {
-        AddSymbols(module_id, symbols);
-        ORBIT_LOG("Successfully loaded %d symbols for \"%s\"", symbols.symbol_infos_size(),
+      [this, module_id](const std::unique_ptr<ModuleData::SymbolsBuilder>& builder) mutable
+      -> ErrorMessageOr<void> {
+        const size_t function_count = builder->GetFunctionCount();
+        AddSymbols(module_id, std::move(*builder));
+        ORBIT_LOG("Successfully loaded %d symbols for \"%s\"", function_count,
                   module_id.file_path);
         return outcome::success();
       });
@@ -2546,10 +2695,15 @@ Future<ErrorMessageOr<void>> OrbitApp::LoadFallbackSymbols(const std::filesystem
   ORBIT_SCOPE_FUNCTION;
 
   auto load_fallback_symbols_future =
-      thread_pool_->Schedule([object_path]() -> ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> {
+      thread_pool_->Schedule([object_path, module_id]()
+                                 -> ErrorMessageOr<std::unique_ptr<ModuleData::SymbolsBuilder>> {
         ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> fallback_symbols_or_error =
             orbit_symbols::SymbolHelper::LoadFallbackSymbolsFromFile(object_path);
-        if (fallback_symbols_or_error.has_value()) return fallback_symbols_or_error;
+        if (fallback_symbols_or_error.has_value()) {
+          auto builder = std::make_unique<ModuleData::SymbolsBuilder>(module_id);
+          builder->AddSymbols(std::move(fallback_symbols_or_error.value()));
+          return builder;
+        }
         return {ErrorMessage{
             absl::StrFormat("Could not load symbols from dynamic linking and/or stack unwinding "
                             "information as symbols from \"%s\": %s",
@@ -2558,10 +2712,11 @@ Future<ErrorMessageOr<void>> OrbitApp::LoadFallbackSymbols(const std::filesystem
 
   auto add_fallback_symbols_future = load_fallback_symbols_future.ThenIfSuccess(
       main_thread_executor_,
-      [this,
-       module_id](const orbit_grpc_protos::ModuleSymbols& symbols) mutable -> ErrorMessageOr<void> {
-        AddFallbackSymbols(module_id, symbols);
-        ORBIT_LOG("Successfully loaded %d fallback symbols for \"%s\"", symbols.symbol_infos_size(),
+      [this, module_id](const std::unique_ptr<ModuleData::SymbolsBuilder>& builder) mutable
+      -> ErrorMessageOr<void> {
+        const size_t function_count = builder->GetFunctionCount();
+        AddFallbackSymbols(module_id, std::move(*builder));
+        ORBIT_LOG("Successfully loaded %d fallback symbols for \"%s\"", function_count,
                   module_id.file_path);
         return outcome::success();
       });
@@ -2569,15 +2724,78 @@ Future<ErrorMessageOr<void>> OrbitApp::LoadFallbackSymbols(const std::filesystem
   return add_fallback_symbols_future;
 }
 
+Future<ErrorMessageOr<void>> OrbitApp::LoadSymbolsFromInstance(const ModuleIdentifier& module_id) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_CHECK(std::this_thread::get_id() == main_thread_id_);
+  const ModuleData* module_data = GetModuleByModuleIdentifier(module_id);
+  ORBIT_CHECK(module_data != nullptr);
+
+  auto load_symbols_future = thread_pool_->Schedule(
+      [this, process_manager = GetProcessManager(), module_id,
+       load_bias = module_data->load_bias()]()
+          -> ErrorMessageOr<std::unique_ptr<ModuleData::SymbolsBuilder>> {
+        auto builder = std::make_unique<ModuleData::SymbolsBuilder>(module_id);
+        std::vector<std::string> additional_instance_folder;
+        if (!absl::GetFlag(FLAGS_instance_symbols_folder).empty()) {
+          additional_instance_folder.emplace_back(absl::GetFlag(FLAGS_instance_symbols_folder));
+        }
+
+        // Symbols loaded on the instance before are kept in the cache, so they don't need to be
+        // transferred again. They are kept apart from the symbols loaded from local files, and the
+        // instance looks for symbols in the same places as long as the folders don't change.
+        const std::string source_id = absl::StrCat(
+            "instance:", module_id.file_path, ":", absl::StrJoin(additional_instance_folder, ":"));
+        if (!module_id.build_id.empty()) {
+          ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> cached_symbols_or_error =
+              symbol_helper_.LoadPreprocessedSymbolsFromCache(module_id.build_id, source_id,
+                                                              load_bias);
+          if (cached_symbols_or_error.has_value()) {
+            builder->AddSymbols(std::move(cached_symbols_or_error.value()));
+            return builder;
+          }
+        }
+        OUTCOME_TRY(NotFoundOr<orbit_grpc_protos::ModuleSymbols> load_result,
+                    process_manager->LoadModuleSymbols(module_id.file_path, module_id.build_id,
+                                                       load_bias, additional_instance_folder));
+        if (orbit_base::IsNotFound(load_result)) {
+          return ErrorMessage{orbit_base::GetNotFoundMessage(load_result)};
+        }
+        orbit_grpc_protos::ModuleSymbols module_symbols =
+            orbit_base::GetFound(std::move(load_result));
+
+        if (!module_id.build_id.empty()) {
+          ErrorMessageOr<void> save_result = symbol_helper_.SavePreprocessedSymbolsToCache(
+              module_id.build_id, source_id, load_bias, module_symbols);
+          if (save_result.has_error()) {
+            ORBIT_ERROR("Unable to save preprocessed symbols for \"%s\" to cache: %s",
+                        module_id.file_path, save_result.error().message());
+          }
+        }
+        builder->AddSymbols(std::move(module_symbols));
+        return builder;
+      });
+
+  return load_symbols_future.ThenIfSuccess(
+      main_thread_executor_,
+      [this, module_id](const std::unique_ptr<ModuleData::SymbolsBuilder>& builder) mutable
+      -> ErrorMessageOr<void> {
+        const size_t function_count = builder->GetFunctionCount();
+        AddSymbols(module_id, std::move(*builder));
+        ORBIT_LOG("Successfully loaded %d symbols for \"%s\" on the instance", function_count,
+                  module_id.file_path);
+        return outcome::success();
+      });
+}
+
 void OrbitApp::AddSymbols(const ModuleIdentifier& module_id,
-                          const orbit_grpc_protos::ModuleSymbols& module_symbols) {
+                          ModuleData::SymbolsBuilder symbols_builder) {
   ORBIT_SCOPE_FUNCTION;
   ModuleData* module_data = GetMutableModuleByModuleIdentifier(module_id);
   // In case fallback symbols were previously loaded, remove them. Careful to call this before
   // ModuleData::AddSymbols, as it will clear the fallback symbols from the ModuleData, and
   // FunctionsDataView contains pointers to them.
   functions_data_view_->RemoveFunctionsOfModule(module_data->file_path());
-  module_data->AddSymbols(module_symbols);
+  module_data->AddSymbols(std::move(symbols_builder));
 
   const ProcessData* selected_process = GetTargetProcess();
   if (selected_process != nullptr &&
@@ -2592,10 +2810,10 @@ void OrbitApp::AddSymbols(const ModuleIdentifier& module_id,
 }
 
 void OrbitApp::AddFallbackSymbols(const ModuleIdentifier& module_id,
-                                  const orbit_grpc_protos::ModuleSymbols& fallback_symbols) {
+                                  ModuleData::SymbolsBuilder symbols_builder) {
   ORBIT_SCOPE_FUNCTION;
   ModuleData* module_data = GetMutableModuleByModuleIdentifier(module_id);
-  module_data->AddFallbackSymbols(fallback_symbols);
+  module_data->AddFallbackSymbols(std::move(symbols_builder));
 
   const ProcessData* selected_process = GetTargetProcess();
   if (selected_process != nullptr &&
@@ -2876,16 +3094,35 @@ Future<ErrorMessageOr<void>> OrbitApp::UpdateProcessAndModuleList() {
 Future<std::vector<ErrorMessageOr<CanceledOr<void>>>> OrbitApp::LoadAllSymbols() {
   const ProcessData& process = GetConnectedOrLoadedProcess();
 
+  // Modules with more samples come first, so that the functions that appear in the sampling
+  // reports get their names as early as possible.
+  std::vector<const ModuleData*> modules = module_manager_->GetAllModuleData();
+  if (HasCaptureData()) {
+    const absl::flat_hash_map<ModuleIdentifier, uint64_t> sample_counts =
+        CountSampledFramesPerModule(GetCaptureData());
+    auto get_sample_count = [&sample_counts](const ModuleData* module) -> uint64_t {
+      auto it = sample_counts.find(module->module_id());
+      return it != sample_counts.end() ? it->second : 0;
+    };
+    std::stable_sort(modules.begin(), modules.end(),
+                     [&get_sample_count](const ModuleData* lhs, const ModuleData* rhs) {
+                       return get_sample_count(lhs) > get_sample_count(rhs);
+                     });
+  }
   std::vector<const ModuleData*> sorted_module_list = SortModuleListWithPrioritizationList(
-      module_manager_->GetAllModuleData(),
-      {kGgpVlkModulePathSubstring, kNtdllSoFileName, process.full_path()});
+      std::move(modules), {kGgpVlkModulePathSubstring, kNtdllSoFileName, process.full_path()});
 
   std::vector<Future<ErrorMessageOr<CanceledOr<void>>>> loading_futures;
 
-  for (const ModuleData* module : sorted_module_list) {
+  for (size_t i = 0; i < sorted_module_list.size(); ++i) {
+    const ModuleData* module = sorted_module_list[i];
     if (module->AreDebugSymbolsLoaded()) continue;
 
-    loading_futures.push_back(RetrieveModuleAndLoadSymbols(module));
+    // The queue starts the operations with the highest priority first, hence the priority
+    // decreasing along the sorted list.
+    const uint64_t priority = sorted_module_list.size() - i;
+    loading_futures.push_back(symbol_loading_queue_->Schedule(
+        priority, [this, module]() { return RetrieveModuleAndLoadSymbols(module); }));
   }
   if (data_manager_->enable_auto_frame_track()) {
     // Orbit will try to add the default frame track while loading all symbols.
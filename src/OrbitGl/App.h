@@ -81,6 +81,7 @@
 #include "OrbitBase/Future.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/MainThreadExecutor.h"
+#include "OrbitBase/PriorityTaskQueue.h"
 #include "OrbitBase/Result.h"
 #include "OrbitBase/StopSource.h"
 #include "OrbitBase/StopToken.h"
@@ -171,6 +172,7 @@ class OrbitApp final : public DataViewFactory,
                         absl::flat_hash_set<uint64_t> frame_track_function_ids) override;
   void OnCaptureFinished(const orbit_grpc_protos::CaptureFinished& capture_finished) override;
   void OnTimer(const orbit_client_protos::TimerInfo& timer_info) override;
+  void OnTimers(absl::Span<const orbit_client_protos::TimerInfo> timers) override;
   void OnKeyAndString(uint64_t key, std::string str) override;
 
   void OnModuleUpdate(uint64_t timestamp_ns, orbit_grpc_protos::ModuleInfo module_info) override;
@@ -544,8 +546,8 @@ class OrbitApp final : public DataViewFactory,
 
   // Triggers symbol loading for all modules in ModuleManager that are not loaded yet. This is done
   // with a simple prioritization. The module `ggpvlk.so` is queued to be loaded first, the "main
-  // module" (binary of the process) is queued to be loaded second. All other modules are queued in
-  // no particular order.
+  // module" (binary of the process) is queued to be loaded second. All other modules are queued by
+  // decreasing number of samples in the current capture.
   orbit_base::Future<std::vector<ErrorMessageOr<orbit_base::CanceledOr<void>>>> LoadAllSymbols();
 
   // Automatically add a default Frame Track. It will choose only one frame track from an internal
@@ -578,10 +580,18 @@ class OrbitApp final : public DataViewFactory,
   // `RetrieveModuleItselfAndLoadFallbackSymbols`.
   orbit_base::Future<ErrorMessageOr<orbit_base::CanceledOr<void>>> RetrieveModuleAndLoadSymbols(
       const orbit_client_data::ModuleData* module_data);
-  // RetrieveModuleSymbolsAndLoadSymbols retrieves the module symbols by calling
-  // `RetrieveModuleSymbols` and afterwards loads the symbols by calling `LoadSymbols`.
+  // RetrieveModuleSymbolsAndLoadSymbols loads the symbols from the local symbols file if there is
+  // one. Otherwise it tries `LoadSymbolsFromInstance` first, and falls back on
+  // `RetrieveModuleSymbolsFileAndLoadSymbols`.
   orbit_base::Future<ErrorMessageOr<orbit_base::CanceledOr<void>>>
   RetrieveModuleSymbolsAndLoadSymbols(const orbit_symbol_provider::ModuleIdentifier& module_id);
+  // RetrieveModuleSymbolsFileAndLoadSymbols retrieves the module symbols by calling
+  // `RetrieveModuleSymbols` and afterwards loads the symbols by calling `LoadSymbols`.
+  orbit_base::Future<ErrorMessageOr<orbit_base::CanceledOr<void>>>
+  RetrieveModuleSymbolsFileAndLoadSymbols(
+      const orbit_symbol_provider::ModuleIdentifier& module_id);
+  [[nodiscard]] bool CanLoadSymbolsOnInstance(
+      const orbit_symbol_provider::ModuleIdentifier& module_id) const;
   // RetrieveModuleSymbols retrieves a module file and returns the local file path (potentially from
   // the local cache). Only modules with a .symtab section will be considered.
   orbit_base::Future<ErrorMessageOr<orbit_base::CanceledOr<std::filesystem::path>>>
@@ -611,14 +621,18 @@ class OrbitApp final : public DataViewFactory,
   [[nodiscard]] orbit_base::Future<ErrorMessageOr<void>> LoadSymbols(
       const std::filesystem::path& symbols_path,
       const orbit_symbol_provider::ModuleIdentifier& module_id);
+  // LoadSymbolsFromInstance lets OrbitService load the symbols from the symbols file on the
+  // instance, so that only the symbols are transferred, and adds them to the module.
+  [[nodiscard]] orbit_base::Future<ErrorMessageOr<void>> LoadSymbolsFromInstance(
+      const orbit_symbol_provider::ModuleIdentifier& module_id);
   [[nodiscard]] orbit_base::Future<ErrorMessageOr<void>> LoadFallbackSymbols(
       const std::filesystem::path& object_path,
       const orbit_symbol_provider::ModuleIdentifier& module_id);
 
   void AddSymbols(const orbit_symbol_provider::ModuleIdentifier& module_id,
-                  const orbit_grpc_protos::ModuleSymbols& module_symbols);
+                  orbit_client_data::ModuleData::SymbolsBuilder symbols_builder);
   void AddFallbackSymbols(const orbit_symbol_provider::ModuleIdentifier& module_id,
-                          const orbit_grpc_protos::ModuleSymbols& fallback_symbols);
+                          orbit_client_data::ModuleData::SymbolsBuilder symbols_builder);
 
   void RequestSymbolDownloadStop(absl::Span<const orbit_client_data::ModuleData* const> modules,
                                  bool show_dialog);
@@ -735,6 +749,11 @@ class OrbitApp final : public DataViewFactory,
   // ONLY access this from the main thread.
   absl::flat_hash_set<std::string> download_disabled_modules_;
 
+  // Orders the symbol loading operations started by LoadAllSymbols and LoadSymbolsManually, and
+  // limits how many of them run at the same time.
+  // ONLY access this from the main thread.
+  std::unique_ptr<orbit_base::PriorityTaskQueue> symbol_loading_queue_;
+
   // A boolean information about if the default Frame Track was added in the current session.
   bool default_frame_track_was_added_ = false;
 
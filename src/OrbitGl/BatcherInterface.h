@@ -5,6 +5,10 @@
 #ifndef ORBIT_GL_BATCHER_INTERFACE_H_
 #define ORBIT_GL_BATCHER_INTERFACE_H_
 
+#include <functional>
+#include <optional>
+#include <string>
+
 #include "ClientProtos/capture_data.pb.h"
 #include "Geometry.h"
 #include "PickingManager.h"
@@ -34,12 +38,12 @@ class BatcherInterface {
 
   virtual void ResetElements() = 0;
   virtual void AddLine(Vec2 from, Vec2 to, float z, const Color& color, const Color& picking_color,
-                       std::unique_ptr<PickingUserData> user_data) = 0;
+                       std::optional<PickingUserData> user_data) = 0;
   virtual void AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
-                      const Color& picking_color, std::unique_ptr<PickingUserData> user_data) = 0;
+                      const Color& picking_color, std::optional<PickingUserData> user_data) = 0;
   virtual void AddTriangle(const Triangle& triangle, float z, const std::array<Color, 3>& colors,
                            const Color& picking_color,
-                           std::unique_ptr<PickingUserData> user_data) = 0;
+                           std::optional<PickingUserData> user_data) = 0;
   [[nodiscard]] virtual uint32_t GetNumElements() const = 0;
 
   [[nodiscard]] virtual std::vector<float> GetLayers() const = 0;
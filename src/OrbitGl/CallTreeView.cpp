@@ -5,294 +5,498 @@
 #include "CallTreeView.h"
 
 #include <absl/container/flat_hash_map.h>
-#include <absl/container/node_hash_map.h>
-#include <absl/meta/type_traits.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/hash/hash.h>
 #include <absl/strings/str_format.h>
+#include <absl/types/span.h>
 
 #include <algorithm>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <utility>
 
 #include "ClientData/ModuleAndFunctionLookup.h"
 #include "ClientProtos/capture_data.pb.h"
 #include "Introspection/Introspection.h"
+#include "OrbitBase/ParallelFor.h"
 #include "OrbitBase/ThreadConstants.h"
 
+using orbit_client_data::CallstackEvent;
 using orbit_client_data::CallstackInfo;
 using orbit_client_data::CallstackType;
 using orbit_client_data::CaptureData;
 using orbit_client_data::ModuleManager;
 using orbit_client_data::PostProcessedSamplingData;
+using orbit_client_data::SymbolizedAddress;
 using orbit_client_data::ThreadSampleData;
 
-const std::vector<const CallTreeNode*>& CallTreeNode::children() const {
-  if (children_cache_.has_value()) {
-    return *children_cache_;
-  }
+namespace {
 
-  children_cache_.emplace();
-  for (const auto& tid_and_thread : thread_children_) {
-    children_cache_->push_back(&tid_and_thread.second);
-  }
-  for (const auto& address_and_functions : function_children_) {
-    children_cache_->push_back(&address_and_functions.second);
-  }
-  if (unwind_errors_child_ != nullptr) {
-    children_cache_->push_back(unwind_errors_child_.get());
-  }
+// The strings of a CallTreeFunction, interned in the CallTreeView.
+struct InternedFunction {
+  const std::string* function_name;
+  const std::string* module_path;
+  const std::string* module_build_id;
+};
 
-  for (const auto& error_type_and_unwind_error : unwind_error_type_children_) {
-    children_cache_->push_back(&error_type_and_unwind_error.second);
-  }
+using InternedFunctions = absl::flat_hash_map<uint64_t, InternedFunction>;
+
+}  // namespace
 
-  return *children_cache_;
+uint64_t CallTreeNode::thread_count() const {
+  return std::count_if(children_.begin(), children_.end(), [](const CallTreeNode* child) {
+    return dynamic_cast<const CallTreeThread*>(child) != nullptr;
+  });
 }
 
-CallTreeThread* CallTreeNode::GetThreadOrNull(uint32_t thread_id) {
-  auto thread_it = thread_children_.find(thread_id);
-  if (thread_it == thread_children_.end()) {
-    return nullptr;
+// Builds the part of a CallTreeView assigned to one task, into its own NodeStorage. Builders of the
+// same tree can run in parallel as long as they don't create children of the same node, except
+// for the root: its new children are only added by AddNewChildrenOfRoot, which has to be called
+// for one Builder at a time.
+//
+// Callstacks are added in sorted order, so that each shares the longest possible prefix with the
+// previous one: only the nodes of the frames after the shared prefix are created, and no lookup
+// is needed for the shared ones. Nodes are identified by their index in the order of creation,
+// which is also the order of the children of each node.
+class CallTreeView::Builder {
+ public:
+  struct SampledCallstack {
+    uint32_t thread_id;
+    const CallstackInfo* resolved_callstack;
+    const std::vector<CallstackEvent>* callstack_events;
+  };
+
+  explicit Builder(CallTreeView* root, NodeStorage* storage,
+                   const InternedFunctions* interned_functions)
+      : root_{root}, storage_{storage}, interned_functions_{interned_functions} {
+    nodes_.push_back(root);
+    parent_indices_.push_back(kRootIndex);
   }
-  return &thread_it->second;
-}
 
-CallTreeThread* CallTreeNode::AddAndGetThread(uint32_t thread_id, std::string thread_name) {
-  const auto& [it, inserted] = thread_children_.try_emplace(
-      thread_id, CallTreeThread{thread_id, std::move(thread_name), this});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
-}
+  // Adds the subtree of a thread, or of all threads, to the top-down view.
+  [[nodiscard]] CallTreeThread* AddTopDownThread(uint32_t thread_id,
+                                                 const std::string& thread_name,
+                                                 std::vector<SampledCallstack> sampled_callstacks);
+
+  // Adds the callstacks to the bottom-up view. The callstacks added by other Builders of the same
+  // view must have different innermost frames.
+  void AddBottomUpCallstacks(std::vector<SampledCallstack> sampled_callstacks,
+                             const absl::flat_hash_map<uint32_t, std::string>& thread_names);
+
+  // Copies the children and the exclusive CallstackEvents of each node next to each other into the
+  // NodeStorage, and points the nodes to their ranges. Call this once all callstacks are added.
+  void StoreChildrenAndExclusiveCallstackEvents();
+
+  void AddNewChildrenOfRoot();
+
+ private:
+  using NodeIndex = uint32_t;
+  static constexpr NodeIndex kRootIndex = 0;
+
+  // The frames of the previous callstack added below a node, with the node of each frame.
+  using Path = std::vector<std::pair<uint64_t, NodeIndex>>;
+
+  enum class ChildType { kThread, kFunction, kUnwindErrors, kUnwindErrorType };
 
-CallTreeFunction* CallTreeNode::GetFunctionOrNull(uint64_t function_absolute_address) {
-  auto function_it = function_children_.find(function_absolute_address);
-  if (function_it == function_children_.end()) {
-    return nullptr;
+  [[nodiscard]] NodeIndex AddNode(NodeIndex parent_index, CallTreeNode* node);
+
+  [[nodiscard]] NodeIndex CreateFunction(NodeIndex parent_index, uint64_t frame);
+
+  // For the nodes that are not reached through the frames of sorted callstacks.
+  template <typename CreateNode>
+  [[nodiscard]] NodeIndex GetOrCreateChild(NodeIndex parent_index, ChildType child_type,
+                                           uint64_t key, CreateNode&& create_node);
+
+  [[nodiscard]] NodeIndex GetOrCreateThread(NodeIndex parent_index, uint32_t thread_id,
+                                            const std::string& thread_name);
+
+  [[nodiscard]] NodeIndex GetOrCreateFunction(NodeIndex parent_index, uint64_t frame);
+
+  [[nodiscard]] NodeIndex GetOrCreateUnwindErrorType(NodeIndex parent_index,
+                                                     CallstackType error_type);
+
+  // Walks down from `first_node_index` along `frames`, reusing the nodes of the frames shared with
+  // the previous callstack in `path`, increases the sample count of the nodes on the way, and
+  // returns the index of the last one.
+  template <typename FrameIterator>
+  [[nodiscard]] NodeIndex AddFrames(NodeIndex first_node_index, FrameIterator frames_begin,
+                                    FrameIterator frames_end, uint64_t sample_count, Path* path);
+
+  void IncreaseSampleCount(NodeIndex node_index, uint64_t sample_count_increase) {
+    nodes_[node_index]->IncreaseSampleCount(sample_count_increase);
+  }
+
+  void AddExclusiveCallstackEvents(NodeIndex node_index,
+                                   const std::vector<CallstackEvent>& callstack_events) {
+    exclusive_callstack_events_.emplace_back(node_index, &callstack_events);
   }
-  return &function_it->second;
-}
 
-CallTreeFunction* CallTreeNode::AddAndGetFunction(uint64_t function_absolute_address,
-                                                  std::string function_name,
-                                                  std::string module_path,
-                                                  std::string module_build_id) {
-  const auto& [it, inserted] = function_children_.try_emplace(
-      function_absolute_address,
-      CallTreeFunction{function_absolute_address, std::move(function_name), std::move(module_path),
-                       std::move(module_build_id), this});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
+  CallTreeView* root_;
+  NodeStorage* storage_;
+  const InternedFunctions* interned_functions_;
+
+  // Only needed while building, and only copied into the NodeStorage by
+  // StoreChildrenAndExclusiveCallstackEvents.
+  std::vector<CallTreeNode*> nodes_;
+  std::vector<NodeIndex> parent_indices_;
+  absl::flat_hash_map<std::tuple<NodeIndex, ChildType, uint64_t>, NodeIndex> children_;
+  std::vector<std::pair<NodeIndex, const std::vector<CallstackEvent>*>>
+      exclusive_callstack_events_;
+
+  std::vector<const CallTreeNode*> new_children_of_root_;
+};
+
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::AddNode(NodeIndex parent_index,
+                                                                CallTreeNode* node) {
+  ORBIT_CHECK(nodes_.size() < std::numeric_limits<NodeIndex>::max());
+  nodes_.push_back(node);
+  parent_indices_.push_back(parent_index);
+  return static_cast<NodeIndex>(nodes_.size() - 1);
 }
 
-CallTreeUnwindErrorType* CallTreeNode::GetUnwindErrorTypeOrNull(CallstackType type) {
-  auto unwind_error_it = unwind_error_type_children_.find(type);
-  if (unwind_error_it == unwind_error_type_children_.end()) {
-    return nullptr;
-  }
-  return &unwind_error_it->second;
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::CreateFunction(NodeIndex parent_index,
+                                                                       uint64_t frame) {
+  const InternedFunction& function = interned_functions_->at(frame);
+  return AddNode(parent_index, &storage_->functions.emplace_back(
+                                   frame, *function.function_name, *function.module_path,
+                                   *function.module_build_id, nodes_[parent_index]));
 }
 
-CallTreeUnwindErrorType* CallTreeNode::AddAndGetUnwindErrorType(CallstackType type) {
-  const auto& [it, inserted] =
-      unwind_error_type_children_.try_emplace(type, CallTreeUnwindErrorType{this, type});
-  ORBIT_CHECK(inserted);
-  children_cache_.reset();
-  return &it->second;
+template <typename CreateNode>
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::GetOrCreateChild(
+    NodeIndex parent_index, ChildType child_type, uint64_t key, CreateNode&& create_node) {
+  auto [it, inserted] =
+      children_.try_emplace(std::make_tuple(parent_index, child_type, key), kRootIndex);
+  if (inserted) it->second = create_node();
+  return it->second;
 }
 
-CallTreeUnwindErrors* CallTreeNode::GetUnwindErrorsOrNull() { return unwind_errors_child_.get(); }
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::GetOrCreateThread(
+    NodeIndex parent_index, uint32_t thread_id, const std::string& thread_name) {
+  return GetOrCreateChild(parent_index, ChildType::kThread, thread_id, [&]() {
+    return AddNode(parent_index, &storage_->threads.emplace_back(thread_id, thread_name,
+                                                                 nodes_[parent_index]));
+  });
+}
 
-CallTreeUnwindErrors* CallTreeNode::AddAndGetUnwindErrors() {
-  ORBIT_CHECK(unwind_errors_child_ == nullptr);
-  unwind_errors_child_ = std::make_unique<CallTreeUnwindErrors>(this);
-  children_cache_.reset();
-  return unwind_errors_child_.get();
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::GetOrCreateFunction(NodeIndex parent_index,
+                                                                            uint64_t frame) {
+  return GetOrCreateChild(parent_index, ChildType::kFunction, frame,
+                          [&]() { return CreateFunction(parent_index, frame); });
 }
 
-[[nodiscard]] static CallTreeFunction* GetOrCreateFunctionNode(CallTreeNode* current_node,
-                                                               uint64_t frame,
-                                                               const std::string& function_name,
-                                                               const std::string& module_path,
-                                                               const std::string& module_build_id) {
-  CallTreeFunction* function_node = current_node->GetFunctionOrNull(frame);
-  if (function_node == nullptr) {
-    std::string formatted_function_name;
-    if (function_name != orbit_client_data::kUnknownFunctionOrModuleName) {
-      formatted_function_name = function_name;
-    } else {
-      formatted_function_name = absl::StrFormat("[unknown@%#llx]", frame);
-    }
-    function_node = current_node->AddAndGetFunction(frame, std::move(formatted_function_name),
-                                                    module_path, module_build_id);
-  }
-  return function_node;
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::GetOrCreateUnwindErrorType(
+    NodeIndex parent_index, CallstackType error_type) {
+  const NodeIndex unwind_errors_index =
+      GetOrCreateChild(parent_index, ChildType::kUnwindErrors, 0, [&]() {
+        return AddNode(parent_index,
+                       &storage_->unwind_errors.emplace_back(nodes_[parent_index]));
+      });
+  return GetOrCreateChild(
+      unwind_errors_index, ChildType::kUnwindErrorType, static_cast<uint64_t>(error_type), [&]() {
+        return AddNode(unwind_errors_index, &storage_->unwind_error_types.emplace_back(
+                                                nodes_[unwind_errors_index], error_type));
+      });
 }
 
-[[nodiscard]] static CallTreeUnwindErrorType* GetOrCreateUnwindErrorTypeNode(
-    CallTreeNode* current_node, CallstackType error_type) {
-  CallTreeUnwindErrorType* unwind_error = current_node->GetUnwindErrorTypeOrNull(error_type);
-  if (unwind_error == nullptr) {
-    unwind_error = current_node->AddAndGetUnwindErrorType(error_type);
+template <typename FrameIterator>
+CallTreeView::Builder::NodeIndex CallTreeView::Builder::AddFrames(NodeIndex first_node_index,
+                                                                  FrameIterator frames_begin,
+                                                                  FrameIterator frames_end,
+                                                                  uint64_t sample_count,
+                                                                  Path* path) {
+  FrameIterator frame_it = frames_begin;
+  size_t shared_frame_count = 0;
+  while (frame_it != frames_end && shared_frame_count < path->size() &&
+         (*path)[shared_frame_count].first == *frame_it) {
+    ++frame_it;
+    ++shared_frame_count;
+  }
+  path->resize(shared_frame_count);
+  for (; frame_it != frames_end; ++frame_it) {
+    const NodeIndex parent_index = path->empty() ? first_node_index : path->back().second;
+    path->emplace_back(*frame_it, CreateFunction(parent_index, *frame_it));
   }
-  return unwind_error;
-}
 
-static void AddCallstackToTopDownThread(
-    CallTreeThread* thread_node, const CallstackInfo& resolved_callstack,
-    const std::vector<orbit_client_data::CallstackEvent>& callstack_events,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  uint64_t callstack_sample_count = callstack_events.size();
-
-  CallTreeNode* current_thread_or_function = thread_node;
-  for (auto frame_it = resolved_callstack.frames().rbegin();
-       frame_it != resolved_callstack.frames().rend(); ++frame_it) {
-    uint64_t frame = *frame_it;
-    const std::string& function_name =
-        orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-    const auto& [module_path, module_build_id] =
-        orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-    CallTreeFunction* function_node =
-        GetOrCreateFunctionNode(current_thread_or_function, frame, function_name, module_path,
-                                module_build_id.value_or(""));
-    function_node->IncreaseSampleCount(callstack_sample_count);
-    current_thread_or_function = function_node;
+  for (const auto& [unused_frame, node_index] : *path) {
+    IncreaseSampleCount(node_index, sample_count);
   }
-  current_thread_or_function->AddExclusiveCallstackEvents(callstack_events);
+  return path->empty() ? first_node_index : path->back().second;
 }
 
-static void AddUnwindErrorToTopDownThread(
-    CallTreeThread* thread_node, const CallstackInfo& resolved_callstack,
-    const std::vector<orbit_client_data::CallstackEvent>& callstack_events,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  CallTreeUnwindErrors* unwind_errors_node = thread_node->GetUnwindErrorsOrNull();
-  if (unwind_errors_node == nullptr) {
-    unwind_errors_node = thread_node->AddAndGetUnwindErrors();
-  }
-  uint64_t callstack_sample_count = callstack_events.size();
-  unwind_errors_node->IncreaseSampleCount(callstack_sample_count);
+CallTreeThread* CallTreeView::Builder::AddTopDownThread(
+    uint32_t thread_id, const std::string& thread_name,
+    std::vector<SampledCallstack> sampled_callstacks) {
+  const NodeIndex thread_index = GetOrCreateThread(kRootIndex, thread_id, thread_name);
+
+  // Complete callstacks first, sorted from the outermost frame.
+  auto first_unwind_error_it = std::stable_partition(
+      sampled_callstacks.begin(), sampled_callstacks.end(), [](const SampledCallstack& callstack) {
+        return callstack.resolved_callstack->type() == CallstackType::kComplete;
+      });
+  std::sort(sampled_callstacks.begin(), first_unwind_error_it,
+            [](const SampledCallstack& lhs, const SampledCallstack& rhs) {
+              const std::vector<uint64_t>& lhs_frames = lhs.resolved_callstack->frames();
+              const std::vector<uint64_t>& rhs_frames = rhs.resolved_callstack->frames();
+              return std::lexicographical_compare(lhs_frames.rbegin(), lhs_frames.rend(),
+                                                  rhs_frames.rbegin(), rhs_frames.rend());
+            });
+
+  Path path;
+  for (auto it = sampled_callstacks.begin(); it != sampled_callstacks.end(); ++it) {
+    const std::vector<uint64_t>& frames = it->resolved_callstack->frames();
+    const uint64_t callstack_sample_count = it->callstack_events->size();
+    IncreaseSampleCount(thread_index, callstack_sample_count);
+
+    if (it < first_unwind_error_it) {
+      const NodeIndex last_index = AddFrames(thread_index, frames.rbegin(), frames.rend(),
+                                             callstack_sample_count, &path);
+      AddExclusiveCallstackEvents(last_index, *it->callstack_events);
+      continue;
+    }
+
+    const NodeIndex unwind_error_type_index =
+        GetOrCreateUnwindErrorType(thread_index, it->resolved_callstack->type());
+    IncreaseSampleCount(parent_indices_[unwind_error_type_index], callstack_sample_count);
+    IncreaseSampleCount(unwind_error_type_index, callstack_sample_count);
 
-  CallTreeUnwindErrorType* unwind_error_type_node =
-      GetOrCreateUnwindErrorTypeNode(unwind_errors_node, resolved_callstack.type());
-  unwind_error_type_node->IncreaseSampleCount(callstack_sample_count);
+    ORBIT_CHECK(!frames.empty());
+    // Only use the innermost frame for unwind errors.
+    const NodeIndex function_index = GetOrCreateFunction(unwind_error_type_index, frames[0]);
+    IncreaseSampleCount(function_index, callstack_sample_count);
+    AddExclusiveCallstackEvents(function_index, *it->callstack_events);
+  }
+  return static_cast<CallTreeThread*>(nodes_[thread_index]);
+}
 
+// Only the innermost frame is used for unwind errors.
+[[nodiscard]] static absl::Span<const uint64_t> GetBottomUpFrames(
+    const CallstackInfo& resolved_callstack) {
   ORBIT_CHECK(!resolved_callstack.frames().empty());
-  // Only use the innermost frame for unwind errors.
-  uint64_t frame = resolved_callstack.frames()[0];
-  const std::string& function_name =
-      orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-  const auto& [module_path, module_build_id] =
-      orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-  CallTreeFunction* function_node = GetOrCreateFunctionNode(
-      unwind_error_type_node, frame, function_name, module_path, module_build_id.value_or(""));
-  function_node->IncreaseSampleCount(callstack_sample_count);
-  function_node->AddExclusiveCallstackEvents(callstack_events);
+  if (resolved_callstack.type() == CallstackType::kComplete) return resolved_callstack.frames();
+  return absl::MakeConstSpan(resolved_callstack.frames()).subspan(0, 1);
 }
 
-[[nodiscard]] static CallTreeThread* GetOrCreateThreadNode(
-    CallTreeNode* current_node, uint32_t tid, const std::string& process_name,
+void CallTreeView::Builder::AddBottomUpCallstacks(
+    std::vector<SampledCallstack> sampled_callstacks,
     const absl::flat_hash_map<uint32_t, std::string>& thread_names) {
-  CallTreeThread* thread_node = current_node->GetThreadOrNull(tid);
-  if (thread_node == nullptr) {
-    std::string thread_name;
-    if (tid == orbit_base::kAllProcessThreadsTid) {
-      thread_name = process_name;
-    } else if (auto thread_name_it = thread_names.find(tid); thread_name_it != thread_names.end()) {
-      thread_name = thread_name_it->second;
+  // Sorted from the innermost frame, then by thread.
+  std::sort(sampled_callstacks.begin(), sampled_callstacks.end(),
+            [](const SampledCallstack& lhs, const SampledCallstack& rhs) {
+              const absl::Span<const uint64_t> lhs_frames =
+                  GetBottomUpFrames(*lhs.resolved_callstack);
+              const absl::Span<const uint64_t> rhs_frames =
+                  GetBottomUpFrames(*rhs.resolved_callstack);
+              if (lhs_frames != rhs_frames) {
+                return std::lexicographical_compare(lhs_frames.begin(), lhs_frames.end(),
+                                                    rhs_frames.begin(), rhs_frames.end());
+              }
+              return lhs.thread_id < rhs.thread_id;
+            });
+
+  Path path;
+  for (const SampledCallstack& sampled_callstack : sampled_callstacks) {
+    const CallstackInfo& resolved_callstack = *sampled_callstack.resolved_callstack;
+    const absl::Span<const uint64_t> frames = GetBottomUpFrames(resolved_callstack);
+    const uint64_t callstack_sample_count = sampled_callstack.callstack_events->size();
+
+    NodeIndex last_index =
+        AddFrames(kRootIndex, frames.begin(), frames.end(), callstack_sample_count, &path);
+    if (resolved_callstack.type() != CallstackType::kComplete) {
+      last_index = GetOrCreateUnwindErrorType(last_index, resolved_callstack.type());
+      IncreaseSampleCount(parent_indices_[last_index], callstack_sample_count);
+      IncreaseSampleCount(last_index, callstack_sample_count);
     }
-    thread_node = current_node->AddAndGetThread(tid, std::move(thread_name));
+
+    const NodeIndex thread_index = GetOrCreateThread(
+        last_index, sampled_callstack.thread_id, thread_names.at(sampled_callstack.thread_id));
+    IncreaseSampleCount(thread_index, callstack_sample_count);
+    AddExclusiveCallstackEvents(thread_index, *sampled_callstack.callstack_events);
   }
-  return thread_node;
 }
 
-std::unique_ptr<CallTreeView> CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
-    const PostProcessedSamplingData& post_processed_sampling_data,
-    const ModuleManager& module_manager, const CaptureData& capture_data) {
-  ORBIT_SCOPE_FUNCTION;
-  ORBIT_SCOPED_TIMED_LOG("CreateTopDownViewFromPostProcessedSamplingData");
+void CallTreeView::Builder::StoreChildrenAndExclusiveCallstackEvents() {
+  // Counting sort of the nodes by parent: first_child_indices[i] is where the children of node i
+  // start in the NodeStorage, and first_child_indices[i + 1] where they end.
+  std::vector<size_t> first_child_indices(nodes_.size() + 1, 0);
+  for (NodeIndex node_index = kRootIndex + 1; node_index < nodes_.size(); ++node_index) {
+    const NodeIndex parent_index = parent_indices_[node_index];
+    if (parent_index == kRootIndex) {
+      new_children_of_root_.push_back(nodes_[node_index]);
+    } else {
+      ++first_child_indices[parent_index + 1];
+    }
+  }
+  std::partial_sum(first_child_indices.begin(), first_child_indices.end(),
+                   first_child_indices.begin());
+
+  std::vector<const CallTreeNode*>& stored_children = storage_->children;
+  stored_children.resize(first_child_indices.back());
+  std::vector<size_t> next_child_indices = first_child_indices;
+  for (NodeIndex node_index = kRootIndex + 1; node_index < nodes_.size(); ++node_index) {
+    const NodeIndex parent_index = parent_indices_[node_index];
+    if (parent_index == kRootIndex) continue;
+    stored_children[next_child_indices[parent_index]++] = nodes_[node_index];
+  }
+  for (NodeIndex node_index = kRootIndex + 1; node_index < nodes_.size(); ++node_index) {
+    const size_t child_count =
+        first_child_indices[node_index + 1] - first_child_indices[node_index];
+    if (child_count == 0) continue;
+    nodes_[node_index]->SetChildren(
+        absl::MakeConstSpan(stored_children.data() + first_child_indices[node_index], child_count));
+  }
 
-  auto top_down_view = std::make_unique<CallTreeView>();
-  const std::string& process_name = capture_data.process_name();
-  const absl::flat_hash_map<uint32_t, std::string>& thread_names = capture_data.thread_names();
+  size_t event_count = 0;
+  for (const auto& [unused_node_index, callstack_events] : exclusive_callstack_events_) {
+    event_count += callstack_events->size();
+  }
+  // Reserving the exact size guarantees that the ranges stay valid while they are appended.
+  std::vector<CallstackEvent>& stored_events = storage_->exclusive_callstack_events;
+  stored_events.reserve(event_count);
+  std::stable_sort(exclusive_callstack_events_.begin(), exclusive_callstack_events_.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  for (auto it = exclusive_callstack_events_.begin(); it != exclusive_callstack_events_.end();) {
+    const NodeIndex node_index = it->first;
+    const size_t first_index = stored_events.size();
+    for (; it != exclusive_callstack_events_.end() && it->first == node_index; ++it) {
+      stored_events.insert(stored_events.end(), it->second->begin(), it->second->end());
+    }
+    nodes_[node_index]->SetExclusiveCallstackEvents(absl::MakeConstSpan(
+        stored_events.data() + first_index, stored_events.size() - first_index));
+  }
 
+  // Free what was only needed while building.
+  nodes_ = {};
+  parent_indices_ = {};
+  children_ = {};
+  exclusive_callstack_events_ = {};
+}
+
+void CallTreeView::Builder::AddNewChildrenOfRoot() {
+  root_->children_of_root_.insert(root_->children_of_root_.end(), new_children_of_root_.begin(),
+                                  new_children_of_root_.end());
+  root_->SetChildren(root_->children_of_root_);
+}
+
+// Symbolizes at once all the frames that the call tree will contain, which is much faster than
+// symbolizing them one by one while building the tree, and interns the resulting strings so that
+// each is only stored once however many nodes refer to it.
+[[nodiscard]] static InternedFunctions SymbolizeAndInternFramesOfSampledCallstacks(
+    const PostProcessedSamplingData& post_processed_sampling_data,
+    const ModuleManager& module_manager, const CaptureData& capture_data,
+    absl::node_hash_set<std::string>* interned_strings) {
+  absl::flat_hash_set<uint64_t> unique_frames;
   for (const ThreadSampleData* thread_sample_data :
        post_processed_sampling_data.GetSortedThreadSampleData()) {
-    const uint32_t tid = thread_sample_data->thread_id;
-
-    for (const auto& [callstack_id, callstack_events] :
+    for (const auto& [callstack_id, unused_callstack_events] :
          thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t sample_count = callstack_events.size();
-
-      // Don't count samples from the all-thread case again.
-      if (tid != orbit_base::kAllProcessThreadsTid) {
-        top_down_view->IncreaseSampleCount(sample_count);
-      }
-
-      CallTreeThread* thread_node =
-          GetOrCreateThreadNode(top_down_view.get(), tid, process_name, thread_names);
-      thread_node->IncreaseSampleCount(sample_count);
-
       const CallstackInfo& resolved_callstack =
           post_processed_sampling_data.GetResolvedCallstack(callstack_id);
       if (resolved_callstack.type() == CallstackType::kComplete) {
-        AddCallstackToTopDownThread(thread_node, resolved_callstack, callstack_events,
-                                    module_manager, capture_data);
+        unique_frames.insert(resolved_callstack.frames().begin(),
+                             resolved_callstack.frames().end());
       } else {
-        AddUnwindErrorToTopDownThread(thread_node, resolved_callstack, callstack_events,
-                                      module_manager, capture_data);
+        // Only the innermost frame is used for unwind errors.
+        unique_frames.insert(resolved_callstack.frames()[0]);
       }
     }
   }
-  return top_down_view;
+
+  const std::vector<uint64_t> frames(unique_frames.begin(), unique_frames.end());
+  std::vector<SymbolizedAddress> symbolized_addresses =
+      orbit_client_data::SymbolizeAddresses(module_manager, capture_data, frames);
+  auto intern = [interned_strings](std::string string) {
+    return &*interned_strings->insert(std::move(string)).first;
+  };
+  InternedFunctions interned_functions;
+  interned_functions.reserve(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const SymbolizedAddress& symbolized_frame = symbolized_addresses[i];
+    const std::string& function_name = *symbolized_frame.function_name;
+    std::string formatted_function_name;
+    if (function_name != orbit_client_data::kUnknownFunctionOrModuleName) {
+      formatted_function_name = function_name;
+    } else {
+      formatted_function_name = absl::StrFormat("[unknown@%#llx]", frames[i]);
+    }
+    std::string module_build_id;
+    if (symbolized_frame.module_build_id != nullptr) {
+      module_build_id = *symbolized_frame.module_build_id;
+    }
+    interned_functions.emplace(frames[i],
+                               InternedFunction{intern(std::move(formatted_function_name)),
+                                                intern(*symbolized_frame.module_path),
+                                                intern(std::move(module_build_id))});
+  }
+  return interned_functions;
 }
 
-[[nodiscard]] static CallTreeNode* AddReversedCallstackToBottomUpViewAndReturnLastFunction(
-    CallTreeView* bottom_up_view, const CallstackInfo& resolved_callstack,
-    uint64_t callstack_sample_count, const ModuleManager& module_manager,
-    const CaptureData& capture_data) {
-  CallTreeNode* current_node = bottom_up_view;
-  for (uint64_t frame : resolved_callstack.frames()) {
-    const std::string& function_name =
-        orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-    const auto& [module_path, module_build_id] =
-        orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-
-    CallTreeFunction* function_node = GetOrCreateFunctionNode(
-        current_node, frame, function_name, module_path, module_build_id.value_or(""));
-    function_node->IncreaseSampleCount(callstack_sample_count);
-    current_node = function_node;
+[[nodiscard]] static std::string GetThreadName(
+    uint32_t tid, const std::string& process_name,
+    const absl::flat_hash_map<uint32_t, std::string>& thread_names) {
+  if (tid == orbit_base::kAllProcessThreadsTid) {
+    return process_name;
   }
-  return current_node;
+  if (auto thread_name_it = thread_names.find(tid); thread_name_it != thread_names.end()) {
+    return thread_name_it->second;
+  }
+  return "";
 }
 
-[[nodiscard]] static CallTreeUnwindErrorType*
-AddUnwindErrorToBottomUpViewAndReturnUnwindErrorTypeNode(CallTreeView* bottom_up_view,
-                                                         const CallstackInfo& resolved_callstack,
-                                                         uint64_t callstack_sample_count,
-                                                         const ModuleManager& module_manager,
-                                                         const CaptureData& capture_data) {
-  ORBIT_CHECK(!resolved_callstack.frames().empty());
-  // Only use the innermost frame for unwind errors.
-  uint64_t frame = resolved_callstack.frames()[0];
-  const std::string& function_name =
-      orbit_client_data::GetFunctionNameByAddress(module_manager, capture_data, frame);
-  const auto& [module_path, module_build_id] =
-      orbit_client_data::FindModulePathAndBuildIdByAddress(module_manager, capture_data, frame);
-  CallTreeFunction* function_node = GetOrCreateFunctionNode(
-      bottom_up_view, frame, function_name, module_path, module_build_id.value_or(""));
-  function_node->IncreaseSampleCount(callstack_sample_count);
-
-  CallTreeUnwindErrors* unwind_errors_node = function_node->GetUnwindErrorsOrNull();
-  if (unwind_errors_node == nullptr) {
-    unwind_errors_node = function_node->AddAndGetUnwindErrors();
+std::unique_ptr<CallTreeView> CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
+    const PostProcessedSamplingData& post_processed_sampling_data,
+    const ModuleManager& module_manager, const CaptureData& capture_data) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_SCOPED_TIMED_LOG("CreateTopDownViewFromPostProcessedSamplingData");
+
+  auto top_down_view = std::make_unique<CallTreeView>();
+  const InternedFunctions interned_functions = SymbolizeAndInternFramesOfSampledCallstacks(
+      post_processed_sampling_data, module_manager, capture_data,
+      &top_down_view->interned_strings_);
+  const std::string process_name = capture_data.process_name();
+  const absl::flat_hash_map<uint32_t, std::string>& thread_names = capture_data.thread_names();
+
+  // Each thread, including the "all threads" summary that SamplingDataPostProcessor already merged,
+  // has its own subtree, so each is built by a separate task.
+  const std::vector<const ThreadSampleData*> sorted_thread_sample_data =
+      post_processed_sampling_data.GetSortedThreadSampleData();
+  top_down_view->node_storages_.resize(sorted_thread_sample_data.size());
+  std::vector<CallTreeThread*> thread_nodes(sorted_thread_sample_data.size());
+  std::vector<Builder> builders;
+  builders.reserve(sorted_thread_sample_data.size());
+  for (NodeStorage& node_storage : top_down_view->node_storages_) {
+    builders.emplace_back(top_down_view.get(), &node_storage, &interned_functions);
   }
-  unwind_errors_node->IncreaseSampleCount(callstack_sample_count);
 
-  CallTreeUnwindErrorType* unwind_error_type_node =
-      GetOrCreateUnwindErrorTypeNode(unwind_errors_node, resolved_callstack.type());
-  unwind_error_type_node->IncreaseSampleCount(callstack_sample_count);
+  orbit_base::ParallelFor(sorted_thread_sample_data.size(), [&](size_t task_index) {
+    const ThreadSampleData& thread_sample_data = *sorted_thread_sample_data[task_index];
+    const uint32_t tid = thread_sample_data.thread_id;
+    std::vector<Builder::SampledCallstack> sampled_callstacks;
+    sampled_callstacks.reserve(thread_sample_data.sampled_callstack_id_to_events.size());
+    for (const auto& [callstack_id, callstack_events] :
+         thread_sample_data.sampled_callstack_id_to_events) {
+      sampled_callstacks.push_back(
+          {tid, &post_processed_sampling_data.GetResolvedCallstack(callstack_id),
+           &callstack_events});
+    }
 
-  return unwind_error_type_node;
+    Builder& builder = builders[task_index];
+    thread_nodes[task_index] =
+        builder.AddTopDownThread(tid, GetThreadName(tid, process_name, thread_names),
+                                 std::move(sampled_callstacks));
+    builder.StoreChildrenAndExclusiveCallstackEvents();
+  });
+
+  for (size_t task_index = 0; task_index < builders.size(); ++task_index) {
+    builders[task_index].AddNewChildrenOfRoot();
+    // Don't count samples from the all-thread case again.
+    if (thread_nodes[task_index]->thread_id() != orbit_base::kAllProcessThreadsTid) {
+      top_down_view->IncreaseSampleCount(thread_nodes[task_index]->sample_count());
+    }
+  }
+  return top_down_view;
 }
 
 std::unique_ptr<CallTreeView> CallTreeView::CreateBottomUpViewFromPostProcessedSamplingData(
@@ -302,37 +506,54 @@ std::unique_ptr<CallTreeView> CallTreeView::CreateBottomUpViewFromPostProcessedS
   ORBIT_SCOPED_TIMED_LOG("CreateBottomUpViewFromPostProcessedSamplingData");
 
   auto bottom_up_view = std::make_unique<CallTreeView>();
-  const std::string& process_name = capture_data.process_name();
+  const InternedFunctions interned_functions = SymbolizeAndInternFramesOfSampledCallstacks(
+      post_processed_sampling_data, module_manager, capture_data,
+      &bottom_up_view->interned_strings_);
+  const std::string process_name = capture_data.process_name();
   const absl::flat_hash_map<uint32_t, std::string>& thread_names = capture_data.thread_names();
 
+  // All the callstacks with the same innermost frame end up in the same subtree of the root, so
+  // they are assigned to the same task.
+  const size_t task_count = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::vector<Builder::SampledCallstack>> sampled_callstacks_per_task(task_count);
+  absl::flat_hash_map<uint32_t, std::string> thread_name_by_tid;
   for (const ThreadSampleData* thread_sample_data :
        post_processed_sampling_data.GetSortedThreadSampleData()) {
     const uint32_t tid = thread_sample_data->thread_id;
     if (tid == orbit_base::kAllProcessThreadsTid) {
       continue;
     }
+    thread_name_by_tid.emplace(tid, GetThreadName(tid, process_name, thread_names));
 
     for (const auto& [callstack_id, callstack_events] :
          thread_sample_data->sampled_callstack_id_to_events) {
-      uint64_t sample_count = callstack_events.size();
-      bottom_up_view->IncreaseSampleCount(sample_count);
-
+      bottom_up_view->IncreaseSampleCount(callstack_events.size());
       const CallstackInfo& resolved_callstack =
           post_processed_sampling_data.GetResolvedCallstack(callstack_id);
-      CallTreeNode* last_node;
-      if (resolved_callstack.type() == CallstackType::kComplete) {
-        last_node = AddReversedCallstackToBottomUpViewAndReturnLastFunction(
-            bottom_up_view.get(), resolved_callstack, sample_count, module_manager, capture_data);
-      } else {
-        last_node = AddUnwindErrorToBottomUpViewAndReturnUnwindErrorTypeNode(
-            bottom_up_view.get(), resolved_callstack, sample_count, module_manager, capture_data);
-      }
-      CallTreeThread* thread_node =
-          GetOrCreateThreadNode(last_node, tid, process_name, thread_names);
-      thread_node->IncreaseSampleCount(sample_count);
-      thread_node->AddExclusiveCallstackEvents(callstack_events);
+      ORBIT_CHECK(!resolved_callstack.frames().empty());
+      const size_t task_index =
+          absl::Hash<uint64_t>{}(resolved_callstack.frames()[0]) % task_count;
+      sampled_callstacks_per_task[task_index].push_back(
+          {tid, &resolved_callstack, &callstack_events});
     }
   }
 
+  bottom_up_view->node_storages_.resize(task_count);
+  std::vector<Builder> builders;
+  builders.reserve(task_count);
+  for (NodeStorage& node_storage : bottom_up_view->node_storages_) {
+    builders.emplace_back(bottom_up_view.get(), &node_storage, &interned_functions);
+  }
+
+  orbit_base::ParallelFor(task_count, [&](size_t task_index) {
+    Builder& builder = builders[task_index];
+    builder.AddBottomUpCallstacks(std::move(sampled_callstacks_per_task[task_index]),
+                                  thread_name_by_tid);
+    builder.StoreChildrenAndExclusiveCallstackEvents();
+  });
+
+  for (Builder& builder : builders) {
+    builder.AddNewChildrenOfRoot();
+  }
   return bottom_up_view;
 }
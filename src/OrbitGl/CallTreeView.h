@@ -5,15 +5,18 @@
 #ifndef ORBIT_GL_CALL_TREE_VIEW_H_
 #define ORBIT_GL_CALL_TREE_VIEW_H_
 
-#include <absl/container/node_hash_map.h>
+#include <absl/container/node_hash_set.h>
+#include <absl/types/span.h>
 
 #include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ClientData/CallstackEvent.h"
 #include "ClientData/CallstackType.h"
 #include "ClientData/CaptureData.h"
 #include "ClientData/PostProcessedSamplingData.h"
@@ -23,6 +26,8 @@ class CallTreeFunction;
 class CallTreeUnwindErrors;
 class CallTreeUnwindErrorType;
 
+// A node of a CallTreeView. Nodes don't own their children: all the nodes of a tree are owned by
+// its CallTreeView, and are only created and modified while the tree is built.
 class CallTreeNode {
  public:
   explicit CallTreeNode(CallTreeNode* parent) : parent_{parent} {}
@@ -31,35 +36,15 @@ class CallTreeNode {
   // parent(), child_count(), children() are needed by CallTreeViewItemModel.
   [[nodiscard]] const CallTreeNode* parent() const { return parent_; }
 
-  [[nodiscard]] uint64_t child_count() const {
-    return thread_children_.size() + function_children_.size() +
-           unwind_error_type_children_.size() + (unwind_errors_child_ != nullptr ? 1 : 0);
-  }
-
-  [[nodiscard]] uint64_t thread_count() const { return thread_children_.size(); }
-
-  [[nodiscard]] const std::vector<const CallTreeNode*>& children() const;
-
-  [[nodiscard]] CallTreeThread* GetThreadOrNull(uint32_t thread_id);
-
-  [[nodiscard]] CallTreeThread* AddAndGetThread(uint32_t thread_id, std::string thread_name);
-
-  [[nodiscard]] CallTreeFunction* GetFunctionOrNull(uint64_t function_absolute_address);
+  [[nodiscard]] uint64_t child_count() const { return children_.size(); }
 
-  [[nodiscard]] CallTreeFunction* AddAndGetFunction(uint64_t function_absolute_address,
-                                                    std::string function_name,
-                                                    std::string module_path,
-                                                    std::string module_build_id);
+  [[nodiscard]] uint64_t thread_count() const;
 
-  [[nodiscard]] CallTreeUnwindErrorType* GetUnwindErrorTypeOrNull(
-      orbit_client_data::CallstackType type);
+  [[nodiscard]] absl::Span<const CallTreeNode* const> children() const { return children_; }
 
-  [[nodiscard]] CallTreeUnwindErrorType* AddAndGetUnwindErrorType(
-      orbit_client_data::CallstackType type);
-
-  [[nodiscard]] CallTreeUnwindErrors* GetUnwindErrorsOrNull();
-
-  [[nodiscard]] CallTreeUnwindErrors* AddAndGetUnwindErrors();
+  // The children must outlive the node, which is the case for the children stored in its
+  // CallTreeView.
+  void SetChildren(absl::Span<const CallTreeNode* const> children) { children_ = children; }
 
   [[nodiscard]] uint64_t sample_count() const { return sample_count_; }
 
@@ -86,55 +71,45 @@ class CallTreeNode {
     return 100.0f * GetExclusiveSampleCount() / total_sample_count;
   }
 
-  void AddExclusiveCallstackEvents(
-      const std::vector<orbit_client_data::CallstackEvent>& callstack_events) {
-    exclusive_callstack_events_.insert(exclusive_callstack_events_.end(), callstack_events.begin(),
-                                       callstack_events.end());
+  // The events must outlive the node, which is the case for the events stored in its CallTreeView.
+  void SetExclusiveCallstackEvents(
+      absl::Span<const orbit_client_data::CallstackEvent> callstack_events) {
+    exclusive_callstack_events_ = callstack_events;
   }
 
-  [[nodiscard]] const std::vector<orbit_client_data::CallstackEvent>& exclusive_callstack_events()
+  [[nodiscard]] absl::Span<const orbit_client_data::CallstackEvent> exclusive_callstack_events()
       const {
     return exclusive_callstack_events_;
   }
 
  private:
-  // absl::node_hash_map instead of absl::flat_hash_map as pointer stability is
-  // needed for the CallTreeNode::parent_ field.
-  absl::node_hash_map<uint32_t, CallTreeThread> thread_children_;
-  absl::node_hash_map<uint64_t, CallTreeFunction> function_children_;
-  absl::node_hash_map<orbit_client_data::CallstackType, CallTreeUnwindErrorType>
-      unwind_error_type_children_;
-  // std::shared_ptr instead of std::unique_ptr because absl::node_hash_map
-  // needs the copy constructor (even for try_emplace).
-  std::shared_ptr<CallTreeUnwindErrors> unwind_errors_child_;
-
   CallTreeNode* parent_;
+  // Ranges of the children and of the CallstackEvents stored in the CallTreeView, instead of a
+  // container per node.
+  absl::Span<const CallTreeNode* const> children_;
   uint64_t sample_count_ = 0;
-  // Note that we are copying the CallstackEvents into the tree.
-  std::vector<orbit_client_data::CallstackEvent> exclusive_callstack_events_;
-
-  // Filled lazily when children() is called, invalidated when children are invalidated.
-  mutable std::optional<std::vector<const CallTreeNode*>> children_cache_;
+  absl::Span<const orbit_client_data::CallstackEvent> exclusive_callstack_events_;
 };
 
 class CallTreeFunction : public CallTreeNode {
  public:
-  explicit CallTreeFunction(uint64_t function_absolute_address, std::string function_name,
-                            std::string module_path, std::string module_build_id,
+  // The strings are interned by the CallTreeView, which makes them outlive the node.
+  explicit CallTreeFunction(uint64_t function_absolute_address, const std::string& function_name,
+                            const std::string& module_path, const std::string& module_build_id,
                             CallTreeNode* parent)
       : CallTreeNode{parent},
         function_absolute_address_{function_absolute_address},
-        function_name_{std::move(function_name)},
-        module_path_{std::move(module_path)},
-        module_build_id_{std::move(module_build_id)} {}
+        function_name_{&function_name},
+        module_path_{&module_path},
+        module_build_id_{&module_build_id} {}
 
   [[nodiscard]] uint64_t function_absolute_address() const { return function_absolute_address_; }
 
-  [[nodiscard]] const std::string& function_name() const { return function_name_; }
+  [[nodiscard]] const std::string& function_name() const { return *function_name_; }
 
-  [[nodiscard]] const std::string& module_path() const { return module_path_; }
+  [[nodiscard]] const std::string& module_path() const { return *module_path_; }
 
-  [[nodiscard]] const std::string& module_build_id() const { return module_build_id_; }
+  [[nodiscard]] const std::string& module_build_id() const { return *module_build_id_; }
 
   [[nodiscard]] std::string GetModuleName() const {
     return std::filesystem::path(module_path()).filename().string();
@@ -142,9 +117,9 @@ class CallTreeFunction : public CallTreeNode {
 
  private:
   uint64_t function_absolute_address_;
-  std::string function_name_;
-  std::string module_path_;
-  std::string module_build_id_;
+  const std::string* function_name_;
+  const std::string* module_path_;
+  const std::string* module_build_id_;
 };
 
 class CallTreeThread : public CallTreeNode {
@@ -182,11 +157,13 @@ class CallTreeUnwindErrorType : public CallTreeNode {
 
 class CallTreeView : public CallTreeNode {
  public:
+  // The subtree of each thread, including the one of all threads, is built in parallel.
   [[nodiscard]] static std::unique_ptr<CallTreeView> CreateTopDownViewFromPostProcessedSamplingData(
       const orbit_client_data::PostProcessedSamplingData& post_processed_sampling_data,
       const orbit_client_data::ModuleManager& module_manager,
       const orbit_client_data::CaptureData& capture_data);
 
+  // The subtrees of the innermost functions are built in parallel.
   [[nodiscard]] static std::unique_ptr<CallTreeView>
   CreateBottomUpViewFromPostProcessedSamplingData(
       const orbit_client_data::PostProcessedSamplingData& post_processed_sampling_data,
@@ -194,6 +171,28 @@ class CallTreeView : public CallTreeNode {
       const orbit_client_data::CaptureData& capture_data);
 
   CallTreeView() : CallTreeNode{nullptr} {}
+  // The nodes point to each other and to the strings and CallstackEvents of their CallTreeView.
+  CallTreeView(const CallTreeView&) = delete;
+  CallTreeView& operator=(const CallTreeView&) = delete;
+
+ private:
+  class Builder;
+
+  // The nodes of the part of the tree built by one task, with their children and their exclusive
+  // CallstackEvents. std::deque keeps the nodes at the same address as more are added.
+  struct NodeStorage {
+    std::deque<CallTreeThread> threads;
+    std::deque<CallTreeFunction> functions;
+    std::deque<CallTreeUnwindErrors> unwind_errors;
+    std::deque<CallTreeUnwindErrorType> unwind_error_types;
+    std::vector<const CallTreeNode*> children;
+    std::vector<orbit_client_data::CallstackEvent> exclusive_callstack_events;
+  };
+
+  // absl::node_hash_set as CallTreeFunctions point to the strings.
+  absl::node_hash_set<std::string> interned_strings_;
+  std::vector<NodeStorage> node_storages_;
+  std::vector<const CallTreeNode*> children_of_root_;
 };
 
 #endif  // ORBIT_GL_CALL_TREE_VIEW_H_
@@ -0,0 +1,239 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/container/flat_hash_set.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "CallTreeView.h"
+#include "ClientData/CallstackEvent.h"
+#include "ClientData/CallstackInfo.h"
+#include "ClientData/CallstackType.h"
+#include "ClientData/CaptureData.h"
+#include "ClientData/LinuxAddressInfo.h"
+#include "ClientData/ModuleManager.h"
+#include "ClientData/PostProcessedSamplingData.h"
+#include "ClientModel/SamplingDataPostProcessor.h"
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/ThreadConstants.h"
+
+using orbit_client_data::CallstackEvent;
+using orbit_client_data::CallstackInfo;
+using orbit_client_data::CallstackType;
+using orbit_client_data::CaptureData;
+using orbit_client_data::PostProcessedSamplingData;
+using testing::UnorderedElementsAre;
+
+namespace {
+
+constexpr uint64_t kMainAddress = 0x100;
+constexpr uint64_t kFooAddress = 0x200;
+constexpr uint64_t kBarAddress = 0x300;
+constexpr uint64_t kMainToFooCallstackId = 1;
+constexpr uint64_t kMainToFooToBarCallstackId = 2;
+constexpr uint64_t kUnwindErrorInBarCallstackId = 3;
+constexpr uint32_t kThreadId1 = 1;
+constexpr uint32_t kThreadId2 = 2;
+constexpr const char* kModulePath = "/path/to/module";
+
+// Thread 1 samples main -> foo once and main -> foo -> bar twice, thread 2 samples main -> foo
+// once and an unwind error in bar once.
+std::unique_ptr<CaptureData> GenerateTestCaptureData() {
+  auto capture_data = std::make_unique<CaptureData>(orbit_grpc_protos::CaptureStarted{},
+                                                    std::nullopt, absl::flat_hash_set<uint64_t>{},
+                                                    CaptureData::DataSource::kLiveCapture);
+  capture_data->InsertAddressInfo(
+      orbit_client_data::LinuxAddressInfo{kMainAddress + 1, 1, kModulePath, "main"});
+  capture_data->InsertAddressInfo(
+      orbit_client_data::LinuxAddressInfo{kFooAddress + 1, 1, kModulePath, "foo"});
+  capture_data->InsertAddressInfo(
+      orbit_client_data::LinuxAddressInfo{kBarAddress + 1, 1, kModulePath, "bar"});
+
+  capture_data->AddUniqueCallstack(
+      kMainToFooCallstackId,
+      CallstackInfo{{kFooAddress + 1, kMainAddress + 1}, CallstackType::kComplete});
+  capture_data->AddUniqueCallstack(
+      kMainToFooToBarCallstackId,
+      CallstackInfo{{kBarAddress + 1, kFooAddress + 1, kMainAddress + 1},
+                    CallstackType::kComplete});
+  capture_data->AddUniqueCallstack(
+      kUnwindErrorInBarCallstackId,
+      CallstackInfo{{kBarAddress + 1}, CallstackType::kDwarfUnwindingError});
+
+  capture_data->AddCallstackEvent(CallstackEvent{10, kMainToFooCallstackId, kThreadId1});
+  capture_data->AddCallstackEvent(CallstackEvent{20, kMainToFooToBarCallstackId, kThreadId1});
+  capture_data->AddCallstackEvent(CallstackEvent{30, kMainToFooToBarCallstackId, kThreadId1});
+  capture_data->AddCallstackEvent(CallstackEvent{40, kMainToFooCallstackId, kThreadId2});
+  capture_data->AddCallstackEvent(CallstackEvent{50, kUnwindErrorInBarCallstackId, kThreadId2});
+
+  capture_data->AddOrAssignThreadName(kThreadId1, "thread 1");
+  capture_data->AddOrAssignThreadName(kThreadId2, "thread 2");
+  return capture_data;
+}
+
+template <typename ChildType, typename Predicate>
+const ChildType* FindChild(const CallTreeNode* node, Predicate&& predicate) {
+  if (node == nullptr) return nullptr;
+  for (const CallTreeNode* child : node->children()) {
+    const auto* typed_child = dynamic_cast<const ChildType*>(child);
+    if (typed_child != nullptr && predicate(*typed_child)) return typed_child;
+  }
+  return nullptr;
+}
+
+const CallTreeFunction* FindFunction(const CallTreeNode* node, uint64_t function_address) {
+  return FindChild<CallTreeFunction>(node, [function_address](const CallTreeFunction& function) {
+    return function.function_absolute_address() == function_address;
+  });
+}
+
+const CallTreeThread* FindThread(const CallTreeNode* node, uint32_t thread_id) {
+  return FindChild<CallTreeThread>(
+      node, [thread_id](const CallTreeThread& thread) { return thread.thread_id() == thread_id; });
+}
+
+const CallTreeUnwindErrorType* FindUnwindErrorType(const CallTreeNode* node,
+                                                   CallstackType error_type) {
+  const auto* unwind_errors =
+      FindChild<CallTreeUnwindErrors>(node, [](const CallTreeUnwindErrors&) { return true; });
+  return FindChild<CallTreeUnwindErrorType>(
+      unwind_errors, [error_type](const CallTreeUnwindErrorType& unwind_error_type) {
+        return unwind_error_type.error_type() == error_type;
+      });
+}
+
+std::vector<uint64_t> GetExclusiveTimestamps(const CallTreeNode* node) {
+  std::vector<uint64_t> timestamps;
+  for (const CallstackEvent& event : node->exclusive_callstack_events()) {
+    timestamps.push_back(event.timestamp_ns());
+  }
+  return timestamps;
+}
+
+class CallTreeViewTest : public testing::Test {
+ protected:
+  CallTreeViewTest()
+      : capture_data_{GenerateTestCaptureData()},
+        post_processed_sampling_data_{orbit_client_model::CreatePostProcessedSamplingData(
+            capture_data_->GetCallstackData(), *capture_data_, module_manager_)} {}
+
+  orbit_client_data::ModuleManager module_manager_;
+  std::unique_ptr<CaptureData> capture_data_;
+  PostProcessedSamplingData post_processed_sampling_data_;
+};
+
+}  // namespace
+
+TEST_F(CallTreeViewTest, TopDownViewHasASubtreePerThreadAndOneForAllThreads) {
+  std::unique_ptr<CallTreeView> view = CallTreeView::CreateTopDownViewFromPostProcessedSamplingData(
+      post_processed_sampling_data_, module_manager_, *capture_data_);
+  EXPECT_EQ(view->sample_count(), 5);
+  EXPECT_EQ(view->thread_count(), 3);
+  EXPECT_EQ(view->child_count(), 3);
+
+  const CallTreeThread* all_threads = FindThread(view.get(), orbit_base::kAllProcessThreadsTid);
+  ASSERT_NE(all_threads, nullptr);
+  EXPECT_EQ(all_threads->parent(), view.get());
+  EXPECT_EQ(all_threads->sample_count(), 5);
+  EXPECT_EQ(all_threads->child_count(), 2);
+
+  const CallTreeFunction* main = FindFunction(all_threads, kMainAddress);
+  ASSERT_NE(main, nullptr);
+  EXPECT_EQ(main->function_name(), "main");
+  EXPECT_EQ(main->module_path(), kModulePath);
+  EXPECT_EQ(main->sample_count(), 4);
+  EXPECT_EQ(main->GetExclusiveSampleCount(), 0);
+  const CallTreeFunction* foo = FindFunction(main, kFooAddress);
+  ASSERT_NE(foo, nullptr);
+  EXPECT_EQ(foo->parent(), main);
+  EXPECT_EQ(foo->sample_count(), 4);
+  EXPECT_THAT(GetExclusiveTimestamps(foo), UnorderedElementsAre(10, 40));
+  const CallTreeFunction* bar = FindFunction(foo, kBarAddress);
+  ASSERT_NE(bar, nullptr);
+  EXPECT_EQ(bar->sample_count(), 2);
+  EXPECT_EQ(bar->child_count(), 0);
+  EXPECT_THAT(GetExclusiveTimestamps(bar), UnorderedElementsAre(20, 30));
+
+  const CallTreeUnwindErrorType* unwind_error =
+      FindUnwindErrorType(all_threads, CallstackType::kDwarfUnwindingError);
+  ASSERT_NE(unwind_error, nullptr);
+  EXPECT_EQ(unwind_error->sample_count(), 1);
+  EXPECT_EQ(unwind_error->parent()->sample_count(), 1);
+  const CallTreeFunction* bar_with_unwind_error = FindFunction(unwind_error, kBarAddress);
+  ASSERT_NE(bar_with_unwind_error, nullptr);
+  EXPECT_THAT(GetExclusiveTimestamps(bar_with_unwind_error), UnorderedElementsAre(50));
+
+  const CallTreeThread* thread_1 = FindThread(view.get(), kThreadId1);
+  ASSERT_NE(thread_1, nullptr);
+  EXPECT_EQ(thread_1->thread_name(), "thread 1");
+  EXPECT_EQ(thread_1->sample_count(), 3);
+  EXPECT_EQ(thread_1->child_count(), 1);
+  const CallTreeFunction* foo_of_thread_1 =
+      FindFunction(FindFunction(thread_1, kMainAddress), kFooAddress);
+  ASSERT_NE(foo_of_thread_1, nullptr);
+  EXPECT_THAT(GetExclusiveTimestamps(foo_of_thread_1), UnorderedElementsAre(10));
+  // The strings of the nodes of the same function are only stored once.
+  EXPECT_EQ(&foo_of_thread_1->function_name(), &foo->function_name());
+  EXPECT_EQ(&foo_of_thread_1->module_path(), &main->module_path());
+
+  const CallTreeThread* thread_2 = FindThread(view.get(), kThreadId2);
+  ASSERT_NE(thread_2, nullptr);
+  EXPECT_EQ(thread_2->sample_count(), 2);
+  EXPECT_EQ(thread_2->child_count(), 2);
+}
+
+TEST_F(CallTreeViewTest, BottomUpViewStartsFromTheInnermostFunctions) {
+  std::unique_ptr<CallTreeView> view =
+      CallTreeView::CreateBottomUpViewFromPostProcessedSamplingData(
+          post_processed_sampling_data_, module_manager_, *capture_data_);
+  EXPECT_EQ(view->sample_count(), 5);
+  EXPECT_EQ(view->thread_count(), 0);
+  EXPECT_EQ(view->child_count(), 2);
+
+  const CallTreeFunction* foo = FindFunction(view.get(), kFooAddress);
+  ASSERT_NE(foo, nullptr);
+  EXPECT_EQ(foo->parent(), view.get());
+  EXPECT_EQ(foo->sample_count(), 2);
+  const CallTreeFunction* main_calling_foo = FindFunction(foo, kMainAddress);
+  ASSERT_NE(main_calling_foo, nullptr);
+  EXPECT_EQ(main_calling_foo->sample_count(), 2);
+  EXPECT_EQ(main_calling_foo->thread_count(), 2);
+  const CallTreeThread* thread_1 = FindThread(main_calling_foo, kThreadId1);
+  ASSERT_NE(thread_1, nullptr);
+  EXPECT_EQ(thread_1->thread_name(), "thread 1");
+  EXPECT_THAT(GetExclusiveTimestamps(thread_1), UnorderedElementsAre(10));
+  const CallTreeThread* thread_2 = FindThread(main_calling_foo, kThreadId2);
+  ASSERT_NE(thread_2, nullptr);
+  EXPECT_THAT(GetExclusiveTimestamps(thread_2), UnorderedElementsAre(40));
+
+  const CallTreeFunction* bar = FindFunction(view.get(), kBarAddress);
+  ASSERT_NE(bar, nullptr);
+  EXPECT_EQ(bar->sample_count(), 3);
+  const CallTreeThread* thread_1_calling_bar =
+      FindThread(FindFunction(FindFunction(bar, kFooAddress), kMainAddress), kThreadId1);
+  ASSERT_NE(thread_1_calling_bar, nullptr);
+  EXPECT_EQ(thread_1_calling_bar->sample_count(), 2);
+  EXPECT_THAT(GetExclusiveTimestamps(thread_1_calling_bar), UnorderedElementsAre(20, 30));
+
+  const CallTreeUnwindErrorType* unwind_error =
+      FindUnwindErrorType(bar, CallstackType::kDwarfUnwindingError);
+  ASSERT_NE(unwind_error, nullptr);
+  EXPECT_EQ(unwind_error->sample_count(), 1);
+  const CallTreeThread* thread_2_with_unwind_error = FindThread(unwind_error, kThreadId2);
+  ASSERT_NE(thread_2_with_unwind_error, nullptr);
+  EXPECT_THAT(GetExclusiveTimestamps(thread_2_with_unwind_error), UnorderedElementsAre(50));
+}
+
+TEST(CallTreeView, EmptyViewHasNoChildren) {
+  CallTreeView view;
+  EXPECT_EQ(view.sample_count(), 0);
+  EXPECT_EQ(view.child_count(), 0);
+  EXPECT_TRUE(view.children().empty());
+  EXPECT_TRUE(view.exclusive_callstack_events().empty());
+}
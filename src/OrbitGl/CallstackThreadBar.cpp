@@ -159,11 +159,11 @@ void CallstackThreadBar::DoUpdatePrimitives(PrimitiveAssembler& primitive_assemb
       ORBIT_CHECK(time >= min_tick && time <= max_tick);
       Vec2 pos(timeline_info_->GetWorldFromTick(time) - kPickingBoxOffset, GetPos()[1]);
       Vec2 size(kPickingBoxWidth, track_height);
-      auto user_data = std::make_unique<PickingUserData>(
+      PickingUserData user_data(
           nullptr, [this, &primitive_assembler](PickingId id) -> std::string {
             return GetSampleTooltip(primitive_assembler, id);
           });
-      user_data->custom_data_ = &event;
+      user_data.custom_data_ = &event;
       primitive_assembler.AddShadedBox(pos, size, z, kGreenSelection, std::move(user_data));
     };
     if (GetThreadId() == orbit_base::kAllProcessThreadsTid) {
@@ -4,11 +4,27 @@
 
 #include "CaptureViewElement.h"
 
+#include <absl/synchronization/mutex.h>
+
 #include "Introspection/Introspection.h"
+#include "OrbitBase/ParallelFor.h"
+#include "PrimitiveCache.h"
 #include "Viewport.h"
 
 namespace orbit_gl {
 
+namespace {
+
+[[nodiscard]] PrimitiveCache::Key MakePrimitiveCacheKey(const CaptureViewElement& element,
+                                                        const TimeGraphLayout& layout,
+                                                        uint64_t min_tick, uint64_t max_tick,
+                                                        PickingMode picking_mode) {
+  return {min_tick, max_tick, picking_mode, element.GetPos(), element.GetSize(),
+          layout.GetVersion()};
+}
+
+}  // namespace
+
 CaptureViewElement::CaptureViewElement(CaptureViewElement* parent, const Viewport* viewport,
                                        const TimeGraphLayout* layout)
     : viewport_(viewport), layout_(layout), parent_(parent) {
@@ -36,18 +52,43 @@ void CaptureViewElement::Draw(PrimitiveAssembler& primitive_assembler, TextRende
 void CaptureViewElement::UpdatePrimitives(PrimitiveAssembler& primitive_assembler,
                                           TextRenderer& text_renderer, uint64_t min_tick,
                                           uint64_t max_tick, PickingMode picking_mode) {
+  UpdatePrimitivesRecursively(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode,
+                              /*invalidate_primitive_caches=*/false);
+}
+
+void CaptureViewElement::UpdatePrimitivesRecursively(PrimitiveAssembler& primitive_assembler,
+                                                     TextRenderer& text_renderer,
+                                                     uint64_t min_tick, uint64_t max_tick,
+                                                     PickingMode picking_mode,
+                                                     bool invalidate_primitive_caches) {
   ORBIT_SCOPE_FUNCTION;
 
+  invalidate_primitive_caches |= update_primitives_requested_for_subtree_;
+  PrimitiveCache* primitive_cache = GetPrimitiveCache();
+  if (primitive_cache != nullptr && (invalidate_primitive_caches || update_primitives_requested_)) {
+    primitive_cache->Clear();
+  }
   update_primitives_requested_ = false;
+  update_primitives_requested_for_subtree_ = false;
 
   primitive_assembler.PushTranslation(0, 0, DetermineZOffset());
   text_renderer.PushTranslation(0, 0, DetermineZOffset());
 
-  DoUpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
-
-  for (CaptureViewElement* child : GetChildrenVisibleInViewport()) {
-    if (child->ShouldBeRendered()) {
-      child->UpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
+  if (primitive_cache == nullptr) {
+    UpdatePrimitivesOfSubtree(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode,
+                              invalidate_primitive_caches);
+  } else {
+    const PrimitiveCache::Key key =
+        MakePrimitiveCacheKey(*this, *layout_, min_tick, max_tick, picking_mode);
+    if (!primitive_cache->Replay(key, primitive_assembler, text_renderer)) {
+      primitive_cache->Record(
+          key, primitive_assembler, text_renderer,
+          [&](PrimitiveAssembler& recording_primitive_assembler,
+              TextRenderer& recording_text_renderer) {
+            UpdatePrimitivesOfSubtree(recording_primitive_assembler, recording_text_renderer,
+                                      min_tick, max_tick, picking_mode,
+                                      invalidate_primitive_caches);
+          });
     }
   }
 
@@ -55,6 +96,57 @@ void CaptureViewElement::UpdatePrimitives(PrimitiveAssembler& primitive_assemble
   primitive_assembler.PopTranslation();
 }
 
+void CaptureViewElement::UpdatePrimitivesOfSubtree(PrimitiveAssembler& primitive_assembler,
+                                                   TextRenderer& text_renderer, uint64_t min_tick,
+                                                   uint64_t max_tick, PickingMode picking_mode,
+                                                   bool invalidate_primitive_caches) {
+  DoUpdatePrimitives(primitive_assembler, text_renderer, min_tick, max_tick, picking_mode);
+
+  std::vector<CaptureViewElement*> children;
+  for (CaptureViewElement* child : GetChildrenVisibleInViewport()) {
+    if (child->ShouldBeRendered()) children.push_back(child);
+  }
+
+  if (children.size() > 1 && ShouldUpdatePrimitivesOfChildrenInParallel()) {
+    UpdatePrimitivesOfChildrenInParallel(children, primitive_assembler, text_renderer, min_tick,
+                                         max_tick, picking_mode, invalidate_primitive_caches);
+    return;
+  }
+
+  for (CaptureViewElement* child : children) {
+    child->UpdatePrimitivesRecursively(primitive_assembler, text_renderer, min_tick, max_tick,
+                                       picking_mode, invalidate_primitive_caches);
+  }
+}
+
+void CaptureViewElement::UpdatePrimitivesOfChildrenInParallel(
+    const std::vector<CaptureViewElement*>& children, PrimitiveAssembler& primitive_assembler,
+    TextRenderer& text_renderer, uint64_t min_tick, uint64_t max_tick, PickingMode picking_mode,
+    bool invalidate_primitive_caches) {
+  ORBIT_SCOPE_FUNCTION;
+  std::vector<PrimitiveCache> buffers(children.size());
+  std::vector<PrimitiveCache::Key> keys(children.size());
+  // Measuring texts can load glyphs into the font atlas of the text renderer.
+  absl::Mutex text_renderer_mutex;
+
+  orbit_base::ParallelFor(children.size(), [&](size_t index) {
+    CaptureViewElement* child = children[index];
+    keys[index] = MakePrimitiveCacheKey(*child, *layout_, min_tick, max_tick, picking_mode);
+    buffers[index].RecordWithoutAdding(
+        keys[index], primitive_assembler, text_renderer, &text_renderer_mutex,
+        [&](PrimitiveAssembler& buffer_primitive_assembler, TextRenderer& buffer_text_renderer) {
+          child->UpdatePrimitivesRecursively(buffer_primitive_assembler, buffer_text_renderer,
+                                             min_tick, max_tick, picking_mode,
+                                             invalidate_primitive_caches);
+        });
+  });
+
+  for (size_t index = 0; index < children.size(); ++index) {
+    const bool added = buffers[index].Replay(keys[index], primitive_assembler, text_renderer);
+    ORBIT_CHECK(added);
+  }
+}
+
 CaptureViewElement::EventResult CaptureViewElement::OnMouseWheel(
     const Vec2& /*mouse_pos*/, int /*delta*/, const ModifierKeys& /*modifiers*/) {
   return EventResult::kIgnored;
@@ -224,6 +316,13 @@ std::vector<CaptureViewElement*> CaptureViewElement::GetChildrenVisibleInViewpor
 }
 
 void CaptureViewElement::RequestUpdate(RequestUpdateScope scope) {
+  if (scope == RequestUpdateScope::kDrawAndUpdatePrimitives) {
+    update_primitives_requested_for_subtree_ = true;
+  }
+  PropagateUpdateRequest(scope);
+}
+
+void CaptureViewElement::PropagateUpdateRequest(RequestUpdateScope scope) {
   switch (scope) {
     case orbit_gl::CaptureViewElement::RequestUpdateScope::kDraw:
       draw_requested_ = true;
@@ -238,7 +337,7 @@ void CaptureViewElement::RequestUpdate(RequestUpdateScope scope) {
   has_layout_changed_ = true;
 
   if (parent_ != nullptr) {
-    parent_->RequestUpdate(scope);
+    parent_->PropagateUpdateRequest(scope);
   }
 }
 
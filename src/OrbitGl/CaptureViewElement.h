@@ -16,6 +16,8 @@
 
 namespace orbit_gl {
 
+class PrimitiveCache;
+
 struct ModifierKeys {
   bool ctrl = false;
   bool shift = false;
@@ -103,7 +105,8 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
   // Indicate that data has changed that requires an update of the UI.
   // This will bubble up and notify the parent. In the next frame, *all* elements will be redrawn
   // (i.e. will have `Draw` and / or `UpdatePrimitives` called, depending on the
-  // `RequestUpdateScope`), not only the ones that called this method.
+  // `RequestUpdateScope`), not only the ones that called this method. The exception are elements
+  // with a `PrimitiveCache`, see `GetPrimitiveCache`.
   //
   // Usage:
   // * Call this whenever your element performs any action that requires redrawing.
@@ -153,6 +156,19 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
 
   virtual void DoUpdateLayout() {}
 
+  // Elements that return a cache here have the primitives of their subtree recorded, and replayed
+  // instead of updated again as long as the time range, picking mode, position, size and layout
+  // are the same and no update of the primitives was requested for the element, one of its
+  // descendants or one of its ancestors.
+  [[nodiscard]] virtual PrimitiveCache* GetPrimitiveCache() { return nullptr; }
+
+  // Elements that return true here update the primitives of each of their children on a thread of
+  // the default thread pool. The children record their primitives into separate buffers, which are
+  // added to the batcher and text renderer in the order of the children, so the result is the same
+  // as with a serial update. The children must not access state shared with their siblings without
+  // synchronization, and must not request the position or size of the texts they add.
+  [[nodiscard]] virtual bool ShouldUpdatePrimitivesOfChildrenInParallel() const { return false; }
+
   [[nodiscard]] bool ContainsPoint(const Vec2& pos) const;
   [[nodiscard]] virtual EventResult OnMouseWheel(const Vec2& mouse_pos, int delta,
                                                  const ModifierKeys& modifiers);
@@ -161,7 +177,24 @@ class CaptureViewElement : public Pickable, public AccessibleInterfaceProvider {
   [[nodiscard]] virtual EventResult OnMouseLeave();
 
  private:
+  void UpdatePrimitivesOfSubtree(PrimitiveAssembler& primitive_assembler,
+                                 TextRenderer& text_renderer, uint64_t min_tick, uint64_t max_tick,
+                                 PickingMode picking_mode, bool invalidate_primitive_caches);
+  void UpdatePrimitivesRecursively(PrimitiveAssembler& primitive_assembler,
+                                   TextRenderer& text_renderer, uint64_t min_tick,
+                                   uint64_t max_tick, PickingMode picking_mode,
+                                   bool invalidate_primitive_caches);
+  void UpdatePrimitivesOfChildrenInParallel(const std::vector<CaptureViewElement*>& children,
+                                            PrimitiveAssembler& primitive_assembler,
+                                            TextRenderer& text_renderer, uint64_t min_tick,
+                                            uint64_t max_tick, PickingMode picking_mode,
+                                            bool invalidate_primitive_caches);
+  void PropagateUpdateRequest(RequestUpdateScope scope);
+
   bool is_mouse_over_ = false;
+  // Whether RequestUpdate was called on this element itself (and not on one of its descendants)
+  // since the last update of the primitives. Its own state might then affect its whole subtree.
+  bool update_primitives_requested_for_subtree_ = false;
 
   float width_ = 0.;
   Vec2 pos_ = Vec2(0, 0);
@@ -0,0 +1,134 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_GL_GLYPH_RUN_CACHE_H_
+#define ORBIT_GL_GLYPH_RUN_CACHE_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/string_view.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace orbit_gl {
+
+// Caches the glyphs of each character of the strings rendered by a text renderer, for each font
+// size, together with the width and height of their first line. Looking up glyphs and kerning in
+// the font is much more expensive than laying out the glyphs, and the same labels are typically
+// rendered frame after frame.
+//
+// Only a pointer to the glyph, which is owned by the font, and the kerning are stored for each
+// character. `Glyph` needs the `advance_x` and `offset_y` members of ftgl::texture_glyph_t. The
+// memory taken by the glyph runs is bounded, the least recently used ones are evicted first.
+template <typename Glyph>
+class GlyphRunCache {
+ public:
+  struct KernedGlyph {
+    // Null where the font has no glyph.
+    const Glyph* glyph = nullptr;
+    // Kerning relative to the previous character of the text, 0 for the first character.
+    float kerning = 0.f;
+  };
+
+  struct GlyphRun {
+    // One element per byte of the string.
+    std::vector<KernedGlyph> glyphs;
+    // Sum of the kerning and advance of the glyphs of the first line, including the line break.
+    float first_line_advance = 0.f;
+    // Maximum vertical offset of the glyphs of the first line, including the line break.
+    int first_line_height = 0;
+  };
+
+  // Returns the glyph of the character at `text + index` and its kerning.
+  using GlyphProvider = std::function<KernedGlyph(const char* text, size_t index)>;
+
+  static constexpr size_t kDefaultMaxByteCount = 16 * 1024 * 1024;
+
+  explicit GlyphRunCache(size_t max_byte_count = kDefaultMaxByteCount)
+      : max_byte_count_(max_byte_count) {}
+
+  // Returns the glyph run of the null-terminated `text` for `font_size`, and creates it with
+  // `glyph_provider` if it's not cached yet. Creating a glyph run can evict others, so the returned
+  // reference is only valid until the next call.
+  [[nodiscard]] const GlyphRun& GetOrCreate(const char* text, uint32_t font_size,
+                                            const GlyphProvider& glyph_provider);
+
+  void Clear() {
+    entry_by_font_size_and_text_.clear();
+    entries_.clear();
+    byte_count_ = 0;
+  }
+
+  [[nodiscard]] size_t GetGlyphRunCount() const { return entries_.size(); }
+  // An estimate of the memory taken by the glyph runs.
+  [[nodiscard]] size_t GetByteCount() const { return byte_count_; }
+
+ private:
+  struct Entry {
+    uint32_t font_size;
+    std::string text;
+    GlyphRun glyph_run;
+  };
+
+  [[nodiscard]] static size_t GetByteCount(const Entry& entry) {
+    return sizeof(Entry) + entry.text.size() + entry.glyph_run.glyphs.size() * sizeof(KernedGlyph);
+  }
+
+  size_t max_byte_count_;
+  size_t byte_count_ = 0;
+  // Ordered from the most recently to the least recently used.
+  std::list<Entry> entries_;
+  // The text of the keys is the one of the entries.
+  absl::flat_hash_map<std::pair<uint32_t, absl::string_view>, typename std::list<Entry>::iterator>
+      entry_by_font_size_and_text_;
+};
+
+template <typename Glyph>
+const typename GlyphRunCache<Glyph>::GlyphRun& GlyphRunCache<Glyph>::GetOrCreate(
+    const char* text, uint32_t font_size, const GlyphProvider& glyph_provider) {
+  const absl::string_view text_view{text};
+  auto entry_it = entry_by_font_size_and_text_.find(std::make_pair(font_size, text_view));
+  if (entry_it != entry_by_font_size_and_text_.end()) {
+    entries_.splice(entries_.begin(), entries_, entry_it->second);
+    return entry_it->second->glyph_run;
+  }
+
+  Entry& entry = entries_.emplace_front(Entry{font_size, std::string{text_view}, GlyphRun{}});
+  GlyphRun& glyph_run = entry.glyph_run;
+  glyph_run.glyphs.reserve(text_view.size());
+  bool is_first_line = true;
+  for (size_t i = 0; i < text_view.size(); ++i) {
+    const KernedGlyph& kerned_glyph = glyph_run.glyphs.emplace_back(glyph_provider(text, i));
+    if (is_first_line && kerned_glyph.glyph != nullptr) {
+      glyph_run.first_line_advance += kerned_glyph.kerning;
+      glyph_run.first_line_advance += kerned_glyph.glyph->advance_x;
+      glyph_run.first_line_height =
+          std::max(glyph_run.first_line_height, static_cast<int>(kerned_glyph.glyph->offset_y));
+    }
+    if (text_view[i] == '\n') is_first_line = false;
+  }
+  entry_by_font_size_and_text_.emplace(std::make_pair(font_size, absl::string_view{entry.text}),
+                                       entries_.begin());
+  byte_count_ += GetByteCount(entry);
+
+  // The new glyph run is never evicted, even if it takes more than the maximum on its own.
+  while (byte_count_ > max_byte_count_ && entries_.size() > 1) {
+    const Entry& least_recently_used_entry = entries_.back();
+    byte_count_ -= GetByteCount(least_recently_used_entry);
+    entry_by_font_size_and_text_.erase(std::make_pair(
+        least_recently_used_entry.font_size, absl::string_view{least_recently_used_entry.text}));
+    entries_.pop_back();
+  }
+  return glyph_run;
+}
+
+}  // namespace orbit_gl
+
+#endif  // ORBIT_GL_GLYPH_RUN_CACHE_H_
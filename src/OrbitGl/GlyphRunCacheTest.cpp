@@ -0,0 +1,174 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <tuple>
+
+#include "GlyphRunCache.h"
+
+namespace orbit_gl {
+
+namespace {
+
+struct FakeGlyph {
+  float advance_x = 0.f;
+  int offset_y = 0;
+};
+
+using FakeGlyphRunCache = GlyphRunCache<FakeGlyph>;
+
+// A font without a glyph for ' ', with glyphs as wide as the position of the letter in the
+// alphabet, and kerning between "A" and "V".
+class FakeFont {
+ public:
+  FakeFont() {
+    for (size_t character = 0; character < glyphs_.size(); ++character) {
+      glyphs_[character].advance_x = static_cast<float>(character % 26) + 0.25f;
+      glyphs_[character].offset_y =
+          character == '\n' ? 0 : (static_cast<int>(character) - 'A') % 7 + 5;
+    }
+  }
+
+  [[nodiscard]] FakeGlyphRunCache::KernedGlyph GetKernedGlyph(const char* text, size_t index) {
+    ++glyph_request_count_;
+    const char character = text[index];
+    if (character == ' ') return {};
+    const float kerning = (index > 0 && text[index - 1] == 'A' && character == 'V') ? -1.5f : 0.f;
+    return {&glyphs_[static_cast<uint8_t>(character)], kerning};
+  }
+
+  [[nodiscard]] FakeGlyphRunCache::GlyphProvider GetGlyphProvider() {
+    return [this](const char* text, size_t index) { return GetKernedGlyph(text, index); };
+  }
+
+  [[nodiscard]] size_t GetGlyphRequestCount() const { return glyph_request_count_; }
+
+ private:
+  std::array<FakeGlyph, 256> glyphs_;
+  size_t glyph_request_count_ = 0;
+};
+
+// What OpenGlTextRenderer used to compute for each call of GetStringWidthScreenSpace, by looking up
+// each glyph in the font.
+int ComputeWidthOfFirstLine(FakeFont& font, const char* text) {
+  float string_width = 0;
+  for (size_t i = 0; i < strlen(text); ++i) {
+    auto [glyph, kerning] = font.GetKernedGlyph(text, i);
+    if (glyph != nullptr) {
+      string_width += kerning;
+      string_width += glyph->advance_x;
+    }
+    if (text[i] == '\n') break;
+  }
+  return static_cast<int>(ceil(string_width));
+}
+
+// What OpenGlTextRenderer used to compute for each call of GetStringHeightScreenSpace.
+int ComputeHeightOfFirstLine(FakeFont& font, const char* text) {
+  int max_height = 0;
+  for (size_t i = 0; i < strlen(text); ++i) {
+    auto [glyph, unused_kerning] = font.GetKernedGlyph(text, i);
+    if (glyph != nullptr) max_height = std::max(max_height, glyph->offset_y);
+    if (text[i] == '\n') break;
+  }
+  return max_height;
+}
+
+}  // namespace
+
+TEST(GlyphRunCache, HasTheGlyphOfEachCharacter) {
+  FakeFont font;
+  FakeGlyphRunCache cache;
+  const char* kText = "AVA B";
+
+  const FakeGlyphRunCache::GlyphRun& glyph_run =
+      cache.GetOrCreate(kText, 12, font.GetGlyphProvider());
+  ASSERT_EQ(glyph_run.glyphs.size(), strlen(kText));
+  for (size_t i = 0; i < strlen(kText); ++i) {
+    FakeGlyphRunCache::KernedGlyph expected_glyph = font.GetKernedGlyph(kText, i);
+    EXPECT_EQ(glyph_run.glyphs[i].glyph, expected_glyph.glyph);
+    EXPECT_EQ(glyph_run.glyphs[i].kerning, expected_glyph.kerning);
+  }
+  EXPECT_EQ(glyph_run.glyphs[1].kerning, -1.5f);
+  EXPECT_EQ(glyph_run.glyphs[3].glyph, nullptr);
+}
+
+TEST(GlyphRunCache, MeasuresTheFirstLineLikeLookingUpEachGlyph) {
+  FakeFont font;
+  FakeGlyphRunCache cache;
+  for (const char* text : {"", "A", "AVAV", "Timer 1: 12 ms", "first\nsecond line", "\nsecond"}) {
+    const FakeGlyphRunCache::GlyphRun& glyph_run =
+        cache.GetOrCreate(text, 12, font.GetGlyphProvider());
+    EXPECT_EQ(static_cast<int>(ceil(glyph_run.first_line_advance)),
+              ComputeWidthOfFirstLine(font, text))
+        << text;
+    EXPECT_EQ(glyph_run.first_line_height, ComputeHeightOfFirstLine(font, text)) << text;
+  }
+}
+
+TEST(GlyphRunCache, LooksUpGlyphsOnlyOncePerStringAndFontSize) {
+  FakeFont font;
+  FakeGlyphRunCache cache;
+  const std::string text = "label";
+
+  std::ignore = cache.GetOrCreate(text.c_str(), 12, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), text.size());
+  std::ignore = cache.GetOrCreate(text.c_str(), 12, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), text.size());
+  EXPECT_EQ(cache.GetGlyphRunCount(), 1);
+
+  std::ignore = cache.GetOrCreate(text.c_str(), 14, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), 2 * text.size());
+  EXPECT_EQ(cache.GetGlyphRunCount(), 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetGlyphRunCount(), 0);
+  EXPECT_EQ(cache.GetByteCount(), 0);
+  std::ignore = cache.GetOrCreate(text.c_str(), 12, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), 3 * text.size());
+}
+
+TEST(GlyphRunCache, EvictsTheLeastRecentlyUsedGlyphRunsWhenFull) {
+  FakeFont font;
+  // Room for exactly two glyph runs of texts of two characters.
+  FakeGlyphRunCache unbounded_cache;
+  std::ignore = unbounded_cache.GetOrCreate("AB", 12, font.GetGlyphProvider());
+  std::ignore = unbounded_cache.GetOrCreate("CD", 12, font.GetGlyphProvider());
+  FakeGlyphRunCache cache{unbounded_cache.GetByteCount()};
+
+  std::ignore = cache.GetOrCreate("AB", 12, font.GetGlyphProvider());
+  std::ignore = cache.GetOrCreate("CD", 12, font.GetGlyphProvider());
+  EXPECT_EQ(cache.GetGlyphRunCount(), 2);
+  EXPECT_EQ(cache.GetByteCount(), unbounded_cache.GetByteCount());
+
+  // "AB" is used more recently than "CD", so "CD" is evicted.
+  std::ignore = cache.GetOrCreate("AB", 12, font.GetGlyphProvider());
+  const FakeGlyphRunCache::GlyphRun& glyph_run =
+      cache.GetOrCreate("EF", 12, font.GetGlyphProvider());
+  EXPECT_EQ(cache.GetGlyphRunCount(), 2);
+  EXPECT_EQ(glyph_run.glyphs.size(), 2);
+  EXPECT_LE(cache.GetByteCount(), unbounded_cache.GetByteCount());
+
+  const size_t request_count = font.GetGlyphRequestCount();
+  std::ignore = cache.GetOrCreate("AB", 12, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), request_count);
+  std::ignore = cache.GetOrCreate("CD", 12, font.GetGlyphProvider());
+  EXPECT_EQ(font.GetGlyphRequestCount(), request_count + 2);
+
+  // A glyph run larger than the maximum on its own is still returned.
+  const char* kLongText = "A very long label that doesn't fit";
+  const FakeGlyphRunCache::GlyphRun& long_glyph_run =
+      cache.GetOrCreate(kLongText, 12, font.GetGlyphProvider());
+  EXPECT_EQ(cache.GetGlyphRunCount(), 1);
+  EXPECT_EQ(long_glyph_run.glyphs.size(), strlen(kLongText));
+}
+
+}  // namespace orbit_gl
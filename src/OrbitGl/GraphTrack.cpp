@@ -247,7 +247,7 @@ void GraphTrack<Dimension>::DrawLegend(PrimitiveAssembler& primitive_assembler,
 
     text_renderer.AddText(series_names[i].c_str(), x0, y0 + legend_symbol_height / 2.f, text_z,
                           formatting);
-    auto user_data = std::make_unique<PickingUserData>(
+    PickingUserData user_data(
         nullptr, [this, i](PickingId /*id*/) { return GetLegendTooltips(i); });
     primitive_assembler.AddShadedBox(Vec2(x0, y0), legend_text_box_size, text_z, kFullyTransparent,
                                      std::move(user_data));
@@ -12,7 +12,7 @@ MockBatcher::MockBatcher(BatcherId batcher_id) : Batcher(batcher_id) { ResetElem
 
 void MockBatcher::AddLine(Vec2 from, Vec2 to, float z, const Color& color,
                           const Color& /*picking_color*/,
-                          std::unique_ptr<PickingUserData> /*user_data*/) {
+                          std::optional<PickingUserData> /*user_data*/) {
   num_lines_by_color_[color]++;
   if (from[0] == to[0]) num_vertical_lines_++;
   if (from[1] == to[1]) num_horizontal_lines_++;
@@ -22,7 +22,7 @@ void MockBatcher::AddLine(Vec2 from, Vec2 to, float z, const Color& color,
 }
 void MockBatcher::AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
                          const Color& /*picking_color*/,
-                         std::unique_ptr<PickingUserData> /*user_data*/) {
+                         std::optional<PickingUserData> /*user_data*/) {
   num_boxes_by_color_[colors[0]]++;
   for (int i = 0; i < 4; i++) {
     AdjustDrawingBoundaries(box.vertices[i]);
@@ -31,7 +31,7 @@ void MockBatcher::AddBox(const Quad& box, float z, const std::array<Color, 4>& c
 }
 void MockBatcher::AddTriangle(const Triangle& triangle, float z, const std::array<Color, 3>& colors,
                               const Color& /*picking_color*/,
-                              std::unique_ptr<PickingUserData> /*user_data*/) {
+                              std::optional<PickingUserData> /*user_data*/) {
   num_triangles_by_color_[colors[0]]++;
   for (int i = 0; i < 3; i++) {
     AdjustDrawingBoundaries(triangle.vertices[i]);
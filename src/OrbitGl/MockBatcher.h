@@ -6,6 +6,7 @@
 #define ORBIT_GL_MOCK_BATCHER_H_
 
 #include <limits>
+#include <optional>
 
 #include "Batcher.h"
 #include "Geometry.h"
@@ -17,13 +18,13 @@ class MockBatcher : public Batcher {
  public:
   explicit MockBatcher(BatcherId batcher_id = BatcherId::kTimeGraph);
   void AddLine(Vec2 from, Vec2 to, float z, const Color& color, const Color& /*picking_color*/,
-               std::unique_ptr<PickingUserData> /*user_data*/) override;
+               std::optional<PickingUserData> /*user_data*/) override;
   void AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
               const Color& /*picking_color*/,
-              std::unique_ptr<PickingUserData> /*user_data*/) override;
+              std::optional<PickingUserData> /*user_data*/) override;
   void AddTriangle(const Triangle& triangle, float z, const std::array<Color, 3>& colors,
                    const Color& /*picking_color*/,
-                   std::unique_ptr<PickingUserData> /*user_data*/) override;
+                   std::optional<PickingUserData> /*user_data*/) override;
 
   void ResetElements() override;
   [[nodiscard]] uint32_t GetNumElements() const override;
@@ -27,7 +27,7 @@ static void MoveLineToPixelCenterIfHorizontal(Line& line) {
 
 void OpenGlBatcher::AddLine(Vec2 from, Vec2 to, float z, const Color& color,
                             const Color& picking_color,
-                            std::unique_ptr<PickingUserData> user_data) {
+                            std::optional<PickingUserData> user_data) {
   Line line;
   LayeredVec2 translated_start_with_z =
       translations_.TranslateXYZAndFloorXY({{from[0], from[1]}, z});
@@ -47,7 +47,7 @@ void OpenGlBatcher::AddLine(Vec2 from, Vec2 to, float z, const Color& color,
 }
 
 void OpenGlBatcher::AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
-                           const Color& picking_color, std::unique_ptr<PickingUserData> user_data) {
+                           const Color& picking_color, std::optional<PickingUserData> user_data) {
   Quad rounded_box = box;
   float layer_z_value{};
   for (size_t v = 0; v < 4; ++v) {
@@ -65,7 +65,7 @@ void OpenGlBatcher::AddBox(const Quad& box, float z, const std::array<Color, 4>&
 
 void OpenGlBatcher::AddTriangle(const Triangle& triangle, float z,
                                 const std::array<Color, 3>& colors, const Color& picking_color,
-                                std::unique_ptr<PickingUserData> user_data) {
+                                std::optional<PickingUserData> user_data) {
   Triangle rounded_tri = triangle;
   float layer_z_value{};
   for (auto& vertex : rounded_tri.vertices) {
@@ -187,7 +187,7 @@ const PickingUserData* OpenGlBatcher::GetUserData(PickingId id) const {
     case PickingType::kTriangle:
     case PickingType::kLine:
       ORBIT_CHECK(id.element_id < user_data_.size());
-      return user_data_[id.element_id].get();
+      return user_data_[id.element_id].has_value() ? &*user_data_[id.element_id] : nullptr;
     case PickingType::kPickable:
       return nullptr;
     case PickingType::kCount:
@@ -9,6 +9,7 @@
 #include <array>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -83,13 +84,13 @@ class OpenGlBatcher : public Batcher {
 
   void ResetElements() override;
   void AddLine(Vec2 from, Vec2 to, float z, const Color& color, const Color& picking_color,
-               std::unique_ptr<PickingUserData> user_data = nullptr) override;
+               std::optional<PickingUserData> user_data = std::nullopt) override;
   void AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
               const Color& picking_color,
-              std::unique_ptr<PickingUserData> user_data = nullptr) override;
+              std::optional<PickingUserData> user_data = std::nullopt) override;
   void AddTriangle(const Triangle& triangle, float z, const std::array<Color, 3>& colors,
                    const Color& picking_color,
-                   std::unique_ptr<PickingUserData> user_data = nullptr) override;
+                   std::optional<PickingUserData> user_data = std::nullopt) override;
 
   [[nodiscard]] uint32_t GetNumElements() const override { return user_data_.size(); }
   [[nodiscard]] std::vector<float> GetLayers() const override;
@@ -99,7 +100,9 @@ class OpenGlBatcher : public Batcher {
 
  protected:
   std::unordered_map<float, orbit_gl_internal::PrimitiveBuffers> primitive_buffers_by_layer_;
-  std::vector<std::unique_ptr<PickingUserData>> user_data_;
+  // Indexed by element id. The user data is stored inline, and the vector keeps its capacity across
+  // frames, so that adding primitives does not allocate once the batcher has warmed up.
+  std::vector<std::optional<PickingUserData>> user_data_;
 
  private:
   void DrawLineBuffer(float layer, bool picking) const;
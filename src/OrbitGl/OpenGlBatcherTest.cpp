@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,17 +31,17 @@ class FakeOpenGlBatcher : public OpenGlBatcher {
 
   // Auxiliary methods to simplify the addition of lines, boxes and triangles.
   void AddLineHelper(Vec2 from, Vec2 to, float z, const Color& color,
-                     std::unique_ptr<PickingUserData> user_data = nullptr) {
+                     std::optional<PickingUserData> user_data = std::nullopt) {
     Color picking_color = PickingId::ToColor(PickingType::kLine, GetNumElements(), GetBatcherId());
     return AddLine(from, to, z, color, picking_color, std::move(user_data));
   }
   void AddBoxHelper(const Quad& box, float z, const Color& color,
-                    std::unique_ptr<PickingUserData> user_data = nullptr) {
+                    std::optional<PickingUserData> user_data = std::nullopt) {
     Color picking_color = PickingId::ToColor(PickingType::kBox, GetNumElements(), GetBatcherId());
     return AddBox(box, z, {color, color, color, color}, picking_color, std::move(user_data));
   }
   void AddTriangleHelper(const Triangle& triangle, float z, const Color& color,
-                         std::unique_ptr<PickingUserData> user_data = nullptr) {
+                         std::optional<PickingUserData> user_data = std::nullopt) {
     Color picking_color =
         PickingId::ToColor(PickingType::kTriangle, GetNumElements(), GetBatcherId());
     return AddTriangle(triangle, z, {color, color, color}, picking_color, std::move(user_data));
@@ -153,16 +154,16 @@ TEST(OpenGlBatcher, PickingSimpleElements) {
   EXPECT_EQ(batcher.GetBatcherId(), BatcherId::kUi);
 
   std::string line_custom_data = "line custom data";
-  auto line_user_data = std::make_unique<PickingUserData>();
-  line_user_data->custom_data_ = &line_custom_data;
+  PickingUserData line_user_data;
+  line_user_data.custom_data_ = &line_custom_data;
 
   std::string triangle_custom_data = "triangle custom data";
-  auto triangle_user_data = std::make_unique<PickingUserData>();
-  triangle_user_data->custom_data_ = &triangle_custom_data;
+  PickingUserData triangle_user_data;
+  triangle_user_data.custom_data_ = &triangle_custom_data;
 
   std::string box_custom_data = "box custom data";
-  auto box_user_data = std::make_unique<PickingUserData>();
-  box_user_data->custom_data_ = &box_custom_data;
+  PickingUserData box_user_data;
+  box_user_data.custom_data_ = &box_custom_data;
 
   batcher.AddLineHelper(Vec2(0, 0), Vec2(1, 0), 0, Color(255, 255, 255, 255),
                         std::move(line_user_data));
@@ -184,16 +185,16 @@ TEST(OpenGlBatcher, MultipleDrawCalls) {
   FakeOpenGlBatcher batcher(BatcherId::kUi);
 
   std::string line_custom_data = "line custom data";
-  auto line_user_data = std::make_unique<PickingUserData>();
-  line_user_data->custom_data_ = &line_custom_data;
+  PickingUserData line_user_data;
+  line_user_data.custom_data_ = &line_custom_data;
 
   std::string triangle_custom_data = "triangle custom data";
-  auto triangle_user_data = std::make_unique<PickingUserData>();
-  triangle_user_data->custom_data_ = &triangle_custom_data;
+  PickingUserData triangle_user_data;
+  triangle_user_data.custom_data_ = &triangle_custom_data;
 
   std::string box_custom_data = "box custom data";
-  auto box_user_data = std::make_unique<PickingUserData>();
-  box_user_data->custom_data_ = &box_custom_data;
+  PickingUserData box_user_data;
+  box_user_data.custom_data_ = &box_custom_data;
 
   batcher.AddLineHelper(Vec2(0, 0), Vec2(1, 0), 0, Color(255, 255, 255, 255),
                         std::move(line_user_data));
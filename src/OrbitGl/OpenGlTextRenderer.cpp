@@ -19,6 +19,7 @@
 #include <iosfwd>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Geometry.h"
 #include "GlCanvas.h"
@@ -148,6 +149,19 @@ ftgl::texture_glyph_t* OpenGlTextRenderer::MaybeLoadAndGetGlyph(ftgl::texture_fo
   return texture_font_get_glyph(font, character);
 }
 
+const GlyphRunCache<ftgl::texture_glyph_t>::GlyphRun& OpenGlTextRenderer::GetGlyphRun(
+    const char* text, uint32_t font_size) {
+  using KernedGlyph = GlyphRunCache<ftgl::texture_glyph_t>::KernedGlyph;
+  ftgl::texture_font_t* font = GetFont(font_size);
+  // Glyphs are owned by their font, which lives as long as this renderer.
+  return glyph_run_cache_.GetOrCreate(
+      text, font_size, [this, font](const char* run_text, size_t index) -> KernedGlyph {
+        ftgl::texture_glyph_t* glyph = MaybeLoadAndGetGlyph(font, run_text + index);
+        if (glyph == nullptr) return {};
+        return {glyph, index == 0 ? 0.f : texture_glyph_get_kerning(glyph, run_text + index - 1)};
+      });
+}
+
 void OpenGlTextRenderer::RenderLayer(float layer) {
   ORBIT_SCOPE_FUNCTION;
   if (vertex_buffers_by_layer_.count(layer) == 0) return;
@@ -254,34 +268,28 @@ void OpenGlTextRenderer::AddTextInternal(const char* text, ftgl::vec2* pen,
   float max_y = -FLT_MAX;
   constexpr std::array<GLuint, 6> kIndices = {0, 1, 2, 0, 2, 3};
   ftgl::vec2 initial_pen = *pen;
+  // All glyphs of the text are on the same layer, and are added to its vertex buffer at once.
+  const float transformed_z = translations_.TranslateXYZAndFloorXY({{0.f, 0.f}, z}).z;
+  std::vector<vertex_t> vertices;
+  std::vector<GLuint> indices;
 
-  for (size_t i = 0; i < strlen(text); ++i) {
+  const auto& glyph_run = GetGlyphRun(text, formatting.font_size);
+  for (size_t i = 0; i < glyph_run.glyphs.size(); ++i) {
     if (text[i] == '\n') {
       pen->x = initial_pen.x;
       pen->y += font->height;
       continue;
     }
 
-    ftgl::texture_glyph_t* glyph = MaybeLoadAndGetGlyph(font, text + i);
+    const auto& [glyph, kerning] = glyph_run.glyphs[i];
     if (glyph != nullptr) {
-      float kerning = (i == 0) ? 0.0f : texture_glyph_get_kerning(glyph, text + i - 1);
       pen->x += kerning;
 
-      orbit_gl::LayeredVec2 pos0_layered = translations_.TranslateXYZAndFloorXY(
-          {{pen->x + glyph->offset_x, pen->y - glyph->offset_y}, z});
-      const Vec2& pos0 = pos0_layered.xy;
+      const Vec2 pos0 = translations_
+                            .TranslateXYZAndFloorXY(
+                                {{pen->x + glyph->offset_x, pen->y - glyph->offset_y}, z})
+                            .xy;
       Vec2 pos1 = Vec2(pos0[0] + glyph->width, pos0[1] + glyph->height);
-      const float transformed_z = pos0_layered.z;
-
-      float s0 = glyph->s0;
-      float t0 = glyph->t0;
-      float s1 = glyph->s1;
-      float t1 = glyph->t1;
-
-      vertex_t vertices[4] = {{pos0[0], pos0[1], transformed_z, s0, t0, r, g, b, a},
-                              {pos0[0], pos1[1], transformed_z, s0, t1, r, g, b, a},
-                              {pos1[0], pos1[1], transformed_z, s1, t1, r, g, b, a},
-                              {pos1[0], pos0[1], transformed_z, s1, t0, r, g, b, a}};
 
       min_x = std::min(min_x, pos0[0]);
       max_x = std::max(max_x, pos1[0]);
@@ -294,15 +302,25 @@ void OpenGlTextRenderer::AddTextInternal(const char* text, ftgl::vec2* pen,
         break;
       }
 
-      ftgl::vertex_buffer_t*& vertex_buffer = vertex_buffers_by_layer_[transformed_z];
-      if (vertex_buffer == nullptr) {
-        vertex_buffer = ftgl::vertex_buffer_new("vertex:3f,tex_coord:2f,color:4f");
-      }
-      vertex_buffer_push_back(vertex_buffer, vertices, 4, kIndices.data(), 6);
+      const auto first_index = static_cast<GLuint>(vertices.size());
+      vertices.push_back({pos0[0], pos0[1], transformed_z, glyph->s0, glyph->t0, r, g, b, a});
+      vertices.push_back({pos0[0], pos1[1], transformed_z, glyph->s0, glyph->t1, r, g, b, a});
+      vertices.push_back({pos1[0], pos1[1], transformed_z, glyph->s1, glyph->t1, r, g, b, a});
+      vertices.push_back({pos1[0], pos0[1], transformed_z, glyph->s1, glyph->t0, r, g, b, a});
+      for (GLuint index : kIndices) indices.push_back(first_index + index);
       pen->x += glyph->advance_x;
     }
   }
 
+  if (!vertices.empty()) {
+    ftgl::vertex_buffer_t*& vertex_buffer = vertex_buffers_by_layer_[transformed_z];
+    if (vertex_buffer == nullptr) {
+      vertex_buffer = ftgl::vertex_buffer_new("vertex:3f,tex_coord:2f,color:4f");
+    }
+    vertex_buffer_push_back(vertex_buffer, vertices.data(), vertices.size(), indices.data(),
+                            indices.size());
+  }
+
   if (out_text_pos) {
     out_text_pos->x = min_x;
     out_text_pos->y = min_y;
@@ -409,15 +427,11 @@ float OpenGlTextRenderer::AddTextTrailingCharsPrioritized(const char* text, floa
   int min_x = INT_MAX;
   int max_x = -INT_MAX;
 
-  ftgl::texture_font_t* font = GetFont(formatting.font_size);
+  const auto& glyph_run = GetGlyphRun(text, formatting.font_size);
   size_t i;
   for (i = 0; i < text_length; ++i) {
-    ftgl::texture_glyph_t* glyph = MaybeLoadAndGetGlyph(font, text + i);
+    const auto& [glyph, kerning] = glyph_run.glyphs[i];
     if (glyph != nullptr) {
-      float kerning = 0.0f;
-      if (i > 0) {
-        kerning = texture_glyph_get_kerning(glyph, text + i - 1);
-      }
       temp_pen_x += kerning;
       int x0 = static_cast<int>(temp_pen_x + glyph->offset_x);
       int x1 = static_cast<int>(x0 + glyph->width);
@@ -472,43 +486,14 @@ float OpenGlTextRenderer::GetStringHeight(const char* text, uint32_t font_size)
   return viewport_->ScreenToWorld({0, GetStringHeightScreenSpace(text, font_size)})[1];
 }
 
+// Only returns the width of the first line.
 int OpenGlTextRenderer::GetStringWidthScreenSpace(const char* text, uint32_t font_size) {
-  float string_width = 0;
-
-  std::size_t len = strlen(text);
-  for (std::size_t i = 0; i < len; ++i) {
-    ftgl::texture_font_t* font = GetFont(font_size);
-    ftgl::texture_glyph_t* glyph = MaybeLoadAndGetGlyph(font, text + i);
-    if (glyph != nullptr) {
-      float kerning = 0.0f;
-      if (i > 0) {
-        kerning = texture_glyph_get_kerning(glyph, text + i - 1);
-      }
-
-      string_width += kerning;
-      string_width += glyph->advance_x;
-    }
-
-    // Only return width of first line.
-    if (text[i] == '\n') break;
-  }
-
-  return static_cast<int>(ceil(string_width));
+  return static_cast<int>(ceil(GetGlyphRun(text, font_size).first_line_advance));
 }
 
+// Only returns the height of the first line.
 int OpenGlTextRenderer::GetStringHeightScreenSpace(const char* text, uint32_t font_size) {
-  int max_height = 0.f;
-  ftgl::texture_font_t* font = GetFont(font_size);
-  for (std::size_t i = 0; i < strlen(text); ++i) {
-    ftgl::texture_glyph_t* glyph = MaybeLoadAndGetGlyph(font, text + i);
-    if (glyph != nullptr) {
-      max_height = std::max(max_height, glyph->offset_y);
-    }
-
-    // Only return height of first line.
-    if (text[i] == '\n') break;
-  }
-  return max_height;
+  return GetGlyphRun(text, font_size).first_line_height;
 }
 
 std::vector<float> OpenGlTextRenderer::GetLayers() const {
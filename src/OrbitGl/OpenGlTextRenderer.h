@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "CoreMath.h"
+#include "GlyphRunCache.h"
 #include "PickingManager.h"
 #include "PrimitiveAssembler.h"
 #include "TextRenderer.h"
@@ -63,6 +64,8 @@ class OpenGlTextRenderer : public TextRenderer {
   [[nodiscard]] ftgl::texture_font_t* GetFont(uint32_t size);
   [[nodiscard]] ftgl::texture_glyph_t* MaybeLoadAndGetGlyph(ftgl::texture_font_t* self,
                                                             const char* character);
+  [[nodiscard]] const GlyphRunCache<ftgl::texture_glyph_t>::GlyphRun& GetGlyphRun(
+      const char* text, uint32_t font_size);
 
   void DrawOutline(PrimitiveAssembler* primitive_assembler, ftgl::vertex_buffer_t* buffer);
 
@@ -74,6 +77,7 @@ class OpenGlTextRenderer : public TextRenderer {
   bool texture_atlas_changed_;
   std::unordered_map<float, ftgl::vertex_buffer_t*> vertex_buffers_by_layer_;
   std::map<uint32_t, ftgl::texture_font_t*> fonts_by_size_;
+  GlyphRunCache<ftgl::texture_glyph_t> glyph_run_cache_;
   GLuint shader_;
   ftgl::mat4 model_;
   ftgl::mat4 view_;
@@ -14,37 +14,38 @@
 PickingId PickingManager::GetOrCreatePickableId(const std::shared_ptr<Pickable>& pickable,
                                                 BatcherId batcher_id) {
   absl::MutexLock lock(&mutex_);
-  uint32_t pickable_id = 0;
-
-  auto it = pickable_pid_map_.find(pickable.get());
-  if (it == pickable_pid_map_.end()) {
-    pickable_id = ++pickable_id_counter_;
-    pid_pickable_map_[pickable_id] = pickable;
-    pickable_pid_map_[pickable.get()] = pickable_id;
-  } else {
-    pickable_id = it->second;
+  PickableIdEntry& entry = pickable_ids_[pickable.get()];
+  // A pickable that was destroyed during this frame can leave its address to a new one.
+  if (entry.id == 0 || entry.generation != generation_ || pickables_[entry.id - 1].expired()) {
+    pickables_.push_back(pickable);
+    entry.generation = generation_;
+    entry.id = static_cast<uint32_t>(pickables_.size());
   }
 
-  PickingId id = PickingId::Create(PickingType::kPickable, pickable_id, batcher_id);
+  PickingId id = PickingId::Create(PickingType::kPickable, entry.id, batcher_id);
   return id;
 }
 
 void PickingManager::Reset() {
+  // Above this many stale entries, the map of ids is cleared rather than kept for the next frame.
+  constexpr size_t kMaxStalePickableIdCount = 1024;
+
   absl::MutexLock lock(&mutex_);
-  pid_pickable_map_.clear();
-  pickable_pid_map_.clear();
-  pickable_id_counter_ = 0;
+  if (pickable_ids_.size() > 2 * pickables_.size() + kMaxStalePickableIdCount) {
+    pickable_ids_.clear();
+  }
+  pickables_.clear();
+  ++generation_;
 }
 
 std::shared_ptr<Pickable> PickingManager::GetPickableFromId(PickingId id) const {
   ORBIT_CHECK(id.type == PickingType::kPickable);
 
   absl::MutexLock lock(&mutex_);
-  auto it = pid_pickable_map_.find(id.element_id);
-  if (it == pid_pickable_map_.end()) {
+  if (id.element_id == 0 || id.element_id > pickables_.size()) {
     return nullptr;
   }
-  return it->second.lock();
+  return pickables_[id.element_id - 1].lock();
 }
 
 std::shared_ptr<Pickable> PickingManager::GetPicked() const {
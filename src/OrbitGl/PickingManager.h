@@ -11,12 +11,12 @@
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <vector>
 
 #include "CoreMath.h"
 #include "OrbitBase/Logging.h"
 #include "absl/base/casts.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 class GlCanvas;
@@ -136,9 +136,18 @@ class PickingManager {
   [[nodiscard]] Color ColorFromPickingID(PickingId id) const;
 
  private:
-  uint32_t pickable_id_counter_ = 0;
-  std::unordered_map<uint32_t, std::weak_ptr<Pickable>> pid_pickable_map_;
-  std::unordered_map<Pickable*, uint32_t> pickable_pid_map_;
+  struct PickableIdEntry {
+    uint64_t generation = 0;
+    uint32_t id = 0;
+  };
+
+  // The pickables of the current frame, indexed by their id minus one. Pickables are registered
+  // again every frame, so `Reset` only clears the vector and keeps its capacity.
+  std::vector<std::weak_ptr<Pickable>> pickables_;
+  // The last id given to each pickable. An entry is only valid in the frame (generation) it was
+  // created in, which spares clearing and rebuilding the map on every `Reset`.
+  absl::flat_hash_map<const Pickable*, PickableIdEntry> pickable_ids_;
+  uint64_t generation_ = 0;
   std::weak_ptr<Pickable> currently_picked_;
   mutable absl::Mutex mutex_;
 };
@@ -126,6 +126,37 @@ TEST(PickingManager, RobustnessOnReset) {
   pickable.reset(new PickableMock());
 }
 
+TEST(PickingManager, AssignsIdsPerFrame) {
+  auto pickable1 = std::make_shared<PickableMock>();
+  auto pickable2 = std::make_shared<PickableMock>();
+  PickingManager pm;
+
+  Color col_vec1 = pm.GetPickableColor(pickable1, BatcherId::kUi);
+  Color col_vec2 = pm.GetPickableColor(pickable2, BatcherId::kUi);
+  ASSERT_NE(col_vec1, col_vec2);
+
+  // After a reset, ids are given out again in the order the pickables are registered.
+  pm.Reset();
+  ASSERT_FALSE(pm.GetPickableFromId(MockRenderPickingColor(col_vec2)));
+  ASSERT_EQ(pm.GetPickableColor(pickable2, BatcherId::kUi), col_vec1);
+  ASSERT_EQ(pm.GetPickableColor(pickable2, BatcherId::kUi), col_vec1);
+  ASSERT_EQ(pm.GetPickableColor(pickable1, BatcherId::kUi), col_vec2);
+  ASSERT_EQ(pm.GetPickableFromId(MockRenderPickingColor(col_vec1)), pickable2);
+  ASSERT_EQ(pm.GetPickableFromId(MockRenderPickingColor(col_vec2)), pickable1);
+
+  // Many frames with short-lived pickables don't keep ids of other frames alive.
+  for (int frame = 0; frame < 10; ++frame) {
+    pm.Reset();
+    for (int i = 0; i < 1000; ++i) {
+      auto pickable = std::make_shared<PickableMock>();
+      Color color = pm.GetPickableColor(pickable, BatcherId::kUi);
+      ASSERT_EQ(pm.GetPickableFromId(MockRenderPickingColor(color)), pickable);
+    }
+  }
+  pm.Reset();
+  ASSERT_EQ(pm.GetPickableColor(pickable1, BatcherId::kUi), col_vec1);
+}
+
 TEST(PickingManager, Overflow) {
   ASSERT_DEATH((void)PickingId::Create(PickingType::kLine, 1 << PickingId::kElementIDBitSize),
                "kElementIDBitSize");
@@ -16,7 +16,7 @@
 namespace orbit_gl {
 
 void PrimitiveAssembler::AddLine(Vec2 from, Vec2 to, float z, const Color& color,
-                                 std::unique_ptr<PickingUserData> user_data) {
+                                 std::optional<PickingUserData> user_data) {
   Color picking_color =
       PickingId::ToColor(PickingType::kLine, batcher_->GetNumElements(), GetBatcherId());
 
@@ -29,11 +29,11 @@ void PrimitiveAssembler::AddLine(Vec2 from, Vec2 to, float z, const Color& color
 
   Color picking_color = picking_manager_->GetPickableColor(pickable, GetBatcherId());
 
-  batcher_->AddLine(from, to, z, color, picking_color, nullptr);
+  batcher_->AddLine(from, to, z, color, picking_color, std::nullopt);
 }
 
 void PrimitiveAssembler::AddVerticalLine(Vec2 pos, float size, float z, const Color& color,
-                                         std::unique_ptr<PickingUserData> user_data) {
+                                         std::optional<PickingUserData> user_data) {
   AddLine(pos, pos + Vec2(0, size), z, color, std::move(user_data));
 }
 
@@ -43,18 +43,18 @@ void PrimitiveAssembler::AddVerticalLine(Vec2 pos, float size, float z, const Co
 
   Color picking_color = picking_manager_->GetPickableColor(pickable, GetBatcherId());
 
-  batcher_->AddLine(pos, pos + Vec2(0, size), z, color, picking_color, nullptr);
+  batcher_->AddLine(pos, pos + Vec2(0, size), z, color, picking_color, std::nullopt);
 }
 
 void PrimitiveAssembler::AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
-                                std::unique_ptr<PickingUserData> user_data) {
+                                std::optional<PickingUserData> user_data) {
   Color picking_color =
       PickingId::ToColor(PickingType::kBox, batcher_->GetNumElements(), GetBatcherId());
   batcher_->AddBox(box, z, colors, picking_color, std::move(user_data));
 }
 
 void PrimitiveAssembler::AddBox(const Quad& box, float z, const Color& color,
-                                std::unique_ptr<PickingUserData> user_data) {
+                                std::optional<PickingUserData> user_data) {
   std::array<Color, 4> colors;
   colors.fill(color);
   AddBox(box, z, colors, std::move(user_data));
@@ -68,21 +68,21 @@ void PrimitiveAssembler::AddBox(const Quad& box, float z, const Color& color,
   std::array<Color, 4> colors;
   colors.fill(color);
 
-  batcher_->AddBox(box, z, colors, picking_color, nullptr);
+  batcher_->AddBox(box, z, colors, picking_color, std::nullopt);
 }
 
 void PrimitiveAssembler::AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color) {
-  AddShadedBox(pos, size, z, color, std::unique_ptr<PickingUserData>(),
+  AddShadedBox(pos, size, z, color, std::nullopt,
                ShadingDirection::kLeftToRight);
 }
 
 void PrimitiveAssembler::AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color,
                                       ShadingDirection shading_direction) {
-  AddShadedBox(pos, size, z, color, std::unique_ptr<PickingUserData>(), shading_direction);
+  AddShadedBox(pos, size, z, color, std::nullopt, shading_direction);
 }
 
 void PrimitiveAssembler::AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color,
-                                      std::unique_ptr<PickingUserData> user_data,
+                                      std::optional<PickingUserData> user_data,
                                       ShadingDirection shading_direction) {
   std::array<Color, 4> colors;
   GetBoxGradientColors(color, &colors, shading_direction);
@@ -180,11 +180,11 @@ void PrimitiveAssembler::AddShadedBox(Vec2 pos, Vec2 size, float z, const Color&
   GetBoxGradientColors(color, &colors, shading_direction);
   Color picking_color = picking_manager_->GetPickableColor(pickable, GetBatcherId());
   Quad box = MakeBox(pos, size);
-  batcher_->AddBox(box, z, colors, picking_color, nullptr);
+  batcher_->AddBox(box, z, colors, picking_color, std::nullopt);
 }
 
 void PrimitiveAssembler::AddTriangle(const Triangle& triangle, float z, const Color& color,
-                                     std::unique_ptr<PickingUserData> user_data) {
+                                     std::optional<PickingUserData> user_data) {
   Color picking_color =
       PickingId::ToColor(PickingType::kTriangle, batcher_->GetNumElements(), GetBatcherId());
 
@@ -197,12 +197,12 @@ void PrimitiveAssembler::AddTriangle(const Triangle& triangle, float z, const Co
 
   Color picking_color = picking_manager_->GetPickableColor(pickable, GetBatcherId());
 
-  AddTriangle(triangle, z, color, picking_color, nullptr);
+  AddTriangle(triangle, z, color, picking_color, std::nullopt);
 }
 
 void PrimitiveAssembler::AddTriangle(const Triangle& triangle, float z, const Color& color,
                                      const Color& picking_color,
-                                     std::unique_ptr<PickingUserData> user_data) {
+                                     std::optional<PickingUserData> user_data) {
   std::array<Color, 3> colors;
   colors.fill(color);
   batcher_->AddTriangle(triangle, z, colors, picking_color, std::move(user_data));
@@ -210,7 +210,7 @@ void PrimitiveAssembler::AddTriangle(const Triangle& triangle, float z, const Co
 
 // Draw a shaded trapezium with two sides parallel to the x-axis or y-axis.
 void PrimitiveAssembler::AddShadedTrapezium(const Quad& trapezium, float z, const Color& color,
-                                            std::unique_ptr<PickingUserData> user_data,
+                                            std::optional<PickingUserData> user_data,
                                             ShadingDirection shading_direction) {
   std::array<Color, 4> colors;  // top_left, bottom_left, bottom_right, top_right.
   GetBoxGradientColors(color, &colors, shading_direction);
@@ -218,8 +218,7 @@ void PrimitiveAssembler::AddShadedTrapezium(const Quad& trapezium, float z, cons
       PickingId::ToColor(PickingType::kTriangle, batcher_->GetNumElements(), GetBatcherId());
   Triangle triangle_1{trapezium.vertices[0], trapezium.vertices[3], trapezium.vertices[1]};
   std::array<Color, 3> colors_1{colors[0], colors[1], colors[2]};
-  batcher_->AddTriangle(triangle_1, z, colors_1, picking_color,
-                        std::make_unique<PickingUserData>(*user_data));
+  batcher_->AddTriangle(triangle_1, z, colors_1, picking_color, user_data);
   Triangle triangle_2{trapezium.vertices[3], trapezium.vertices[2], trapezium.vertices[1]};
   std::array<Color, 3> colors_2{colors[1], colors[2], colors[3]};
   batcher_->AddTriangle(triangle_2, z, colors_2, picking_color, std::move(user_data));
@@ -279,13 +278,10 @@ void PrimitiveAssembler::AddVerticalArrow(Vec2 starting_pos, Vec2 arrow_body_siz
 }
 
 void PrimitiveAssembler::AddQuadBorder(const Quad& quad, float z, const Color& color,
-                                       std::unique_ptr<orbit_gl::PickingUserData> user_data) {
-  AddLine(quad.vertices[0], quad.vertices[1], z, color,
-          std::make_unique<PickingUserData>(*user_data));
-  AddLine(quad.vertices[1], quad.vertices[2], z, color,
-          std::make_unique<PickingUserData>(*user_data));
-  AddLine(quad.vertices[2], quad.vertices[3], z, color,
-          std::make_unique<PickingUserData>(*user_data));
+                                       std::optional<orbit_gl::PickingUserData> user_data) {
+  AddLine(quad.vertices[0], quad.vertices[1], z, color, user_data);
+  AddLine(quad.vertices[1], quad.vertices[2], z, color, user_data);
+  AddLine(quad.vertices[2], quad.vertices[3], z, color, user_data);
   AddLine(quad.vertices[3], quad.vertices[0], z, color, std::move(user_data));
 }
 
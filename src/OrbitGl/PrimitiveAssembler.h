@@ -12,6 +12,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -59,24 +60,24 @@ class PrimitiveAssembler {
   void PopTranslation() { batcher_->PopTranslation(); }
 
   void AddLine(Vec2 from, Vec2 to, float z, const Color& color,
-               std::unique_ptr<PickingUserData> user_data = nullptr);
+               std::optional<PickingUserData> user_data = std::nullopt);
   void AddVerticalLine(Vec2 pos, float size, float z, const Color& color,
-                       std::unique_ptr<PickingUserData> user_data = nullptr);
+                       std::optional<PickingUserData> user_data = std::nullopt);
   void AddLine(Vec2 from, Vec2 to, float z, const Color& color, std::shared_ptr<Pickable> pickable);
   void AddVerticalLine(Vec2 pos, float size, float z, const Color& color,
                        std::shared_ptr<Pickable> pickable);
 
   void AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
-              std::unique_ptr<PickingUserData> user_data = nullptr);
+              std::optional<PickingUserData> user_data = std::nullopt);
   void AddBox(const Quad& box, float z, const Color& color,
-              std::unique_ptr<PickingUserData> user_data = nullptr);
+              std::optional<PickingUserData> user_data = std::nullopt);
   void AddBox(const Quad& box, float z, const Color& color, std::shared_ptr<Pickable> pickable);
 
   void AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color);
   void AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color,
                     ShadingDirection shading_direction);
   void AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color,
-                    std::unique_ptr<PickingUserData> user_data,
+                    std::optional<PickingUserData> user_data,
                     ShadingDirection shading_direction = ShadingDirection::kLeftToRight);
   void AddShadedBox(Vec2 pos, Vec2 size, float z, const Color& color,
                     std::shared_ptr<Pickable> pickable,
@@ -86,15 +87,15 @@ class PrimitiveAssembler {
 
   // TODO(b/227744958) This should probably be removed and AddBox should be used instead
   void AddShadedTrapezium(const Quad& trapezium, float z, const Color& color,
-                          std::unique_ptr<PickingUserData> user_data,
+                          std::optional<PickingUserData> user_data,
                           ShadingDirection shading_direction = ShadingDirection::kLeftToRight);
   void AddTriangle(const Triangle& triangle, float z, const Color& color,
                    std::shared_ptr<Pickable> pickable);
   void AddTriangle(const Triangle& triangle, float z, const Color& color,
-                   std::unique_ptr<PickingUserData> user_data = nullptr);
+                   std::optional<PickingUserData> user_data = std::nullopt);
 
   void AddQuadBorder(const Quad& quad, float z, const Color& color,
-                     std::unique_ptr<orbit_gl::PickingUserData> user_data);
+                     std::optional<orbit_gl::PickingUserData> user_data);
   void AddQuadBorder(const Quad& quad, float z, const Color& color);
   void AddCircle(const Vec2& position, float radius, float z, const Color& color);
 
@@ -118,6 +119,7 @@ class PrimitiveAssembler {
 
   void StartNewFrame();
 
+  [[nodiscard]] Batcher* GetBatcher() const { return batcher_; }
   [[nodiscard]] PickingManager* GetPickingManager() const { return picking_manager_; }
   [[nodiscard]] const PickingUserData* GetUserData(PickingId id) const {
     return batcher_->GetUserData(id);
@@ -135,7 +137,7 @@ class PrimitiveAssembler {
   void AddBottomRightRoundedCorner(Vec2 pos, float radius, float z, const Color& color);
   void AddTriangle(const Triangle& triangle, float z, const Color& color,
                    const Color& picking_color,
-                   std::unique_ptr<PickingUserData> user_data = nullptr);
+                   std::optional<PickingUserData> user_data = std::nullopt);
 
   void GetBoxGradientColors(const Color& color, std::array<Color, 4>* colors,
                             ShadingDirection shading_direction = ShadingDirection::kLeftToRight);
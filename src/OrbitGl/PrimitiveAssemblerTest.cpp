@@ -102,7 +102,7 @@ TEST(PrimitiveAssembler, ComplexShapes) {
   primitive_assembler_tester.AddShadedBox(kTopLeft, kBoxSize, 0, kFakeColor,
                                           ShadingDirection::kRightToLeft);
   primitive_assembler_tester.AddShadedBox(kTopLeft, kBoxSize, 0, kFakeColor,
-                                          std::make_unique<PickingUserData>(),
+                                          PickingUserData(),
                                           ShadingDirection::kTopToBottom);
   primitive_assembler_tester.AddShadedBox(kTopLeft, kBoxSize, 0, kFakeColor, pickable,
                                           ShadingDirection::kLeftToRight);
@@ -129,7 +129,7 @@ TEST(PrimitiveAssembler, ComplexShapes) {
   Vec2 kTopCentred = {(kTopLeft[0] + kTopRight[0]) / 2.f, kTopLeft[1]};
   primitive_assembler_tester.AddShadedTrapezium(
       Quad{{kTopLeft, kTopCentred, kBottomRight, kBottomLeft}}, 0, kFakeColor,
-      std::make_unique<PickingUserData>());
+      PickingUserData());
   EXPECT_EQ(primitive_assembler_tester.GetNumTriangles(), 2);
   EXPECT_EQ(primitive_assembler_tester.GetNumElements(), 2);
   EXPECT_TRUE(primitive_assembler_tester.IsEverythingInsideRectangle(kTopLeft, kBoxSize));
@@ -138,7 +138,7 @@ TEST(PrimitiveAssembler, ComplexShapes) {
 
   // AddQuadBorder -> 4 Lines
   primitive_assembler_tester.AddQuadBorder(Quad{{kBottomRight, kBottomLeft, kTopLeft, kTopRight}},
-                                           0, kFakeColor, std::make_unique<PickingUserData>());
+                                           0, kFakeColor, PickingUserData());
   EXPECT_EQ(primitive_assembler_tester.GetNumLines(), 4);
   EXPECT_EQ(primitive_assembler_tester.GetNumElements(), 4);
   EXPECT_TRUE(primitive_assembler_tester.IsEverythingInsideRectangle(kTopLeft, kBoxSize));
@@ -0,0 +1,327 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "PrimitiveCache.h"
+
+#include <absl/base/casts.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "Batcher.h"
+#include "Geometry.h"
+#include "Introspection/Introspection.h"
+#include "OrbitBase/Logging.h"
+
+namespace orbit_gl {
+
+namespace {
+
+[[nodiscard]] PickingId::Layout GetPickingIdLayout(const Color& color) {
+  // Inverse of PickingId::ToColor. Unlike PickingId::FromPixelValue, this doesn't check the
+  // values, as picking colors don't necessarily come from a PickingId.
+  return absl::bit_cast<PickingId::Layout>(std::array<uint8_t, 4>{color[0], color[1], color[2],
+                                                                   color[3]});
+}
+
+}  // namespace
+
+// Adds everything to another batcher, if any, while recording it relative to the translations
+// pushed on this batcher.
+class PrimitiveCache::RecordingBatcher : public Batcher {
+ public:
+  explicit RecordingBatcher(BatcherId batcher_id, Batcher* batcher,
+                            PickingManager* picking_manager, Recording* recording)
+      : Batcher(batcher_id),
+        batcher_(batcher),
+        picking_manager_(picking_manager),
+        recording_(recording),
+        first_element_id_(batcher != nullptr ? batcher->GetNumElements() : 0) {}
+
+  // Only the owner of the batcher resets it.
+  void ResetElements() override { ORBIT_UNREACHABLE(); }
+
+  void AddLine(Vec2 from, Vec2 to, float z, const Color& color, const Color& picking_color,
+               std::optional<PickingUserData> user_data) override {
+    RecordedPrimitive& primitive = Record(RecordedPrimitive::Type::kLine, picking_color, user_data);
+    const LayeredVec2 translated_from = translations_.TranslateXYZ({from, z});
+    const LayeredVec2 translated_to = translations_.TranslateXYZ({to, z});
+    primitive.vertices[0] = translated_from.xy;
+    primitive.vertices[1] = translated_to.xy;
+    primitive.z = translated_from.z;
+    primitive.colors.fill(color);
+    if (batcher_ == nullptr) return;
+    batcher_->AddLine(translated_from.xy, translated_to.xy, translated_from.z, color,
+                      picking_color, std::move(user_data));
+  }
+
+  void AddBox(const Quad& box, float z, const std::array<Color, 4>& colors,
+              const Color& picking_color, std::optional<PickingUserData> user_data) override {
+    RecordedPrimitive& primitive = Record(RecordedPrimitive::Type::kBox, picking_color, user_data);
+    Quad translated_box;
+    for (size_t i = 0; i < translated_box.vertices.size(); ++i) {
+      const LayeredVec2 translated_vertex = translations_.TranslateXYZ({box.vertices[i], z});
+      translated_box.vertices[i] = translated_vertex.xy;
+      primitive.vertices[i] = translated_vertex.xy;
+      primitive.z = translated_vertex.z;
+    }
+    primitive.colors = colors;
+    if (batcher_ == nullptr) return;
+    batcher_->AddBox(translated_box, primitive.z, colors, picking_color, std::move(user_data));
+  }
+
+  void AddTriangle(const Triangle& triangle, float z, const std::array<Color, 3>& colors,
+                   const Color& picking_color,
+                   std::optional<PickingUserData> user_data) override {
+    RecordedPrimitive& primitive =
+        Record(RecordedPrimitive::Type::kTriangle, picking_color, user_data);
+    Triangle translated_triangle;
+    for (size_t i = 0; i < translated_triangle.vertices.size(); ++i) {
+      const LayeredVec2 translated_vertex = translations_.TranslateXYZ({triangle.vertices[i], z});
+      translated_triangle.vertices[i] = translated_vertex.xy;
+      primitive.vertices[i] = translated_vertex.xy;
+      primitive.z = translated_vertex.z;
+    }
+    std::copy(colors.begin(), colors.end(), primitive.colors.begin());
+    if (batcher_ == nullptr) return;
+    batcher_->AddTriangle(translated_triangle, primitive.z, colors, picking_color,
+                          std::move(user_data));
+  }
+
+  [[nodiscard]] uint32_t GetNumElements() const override {
+    return batcher_ != nullptr ? batcher_->GetNumElements()
+                               : static_cast<uint32_t>(recording_->primitives.size());
+  }
+  [[nodiscard]] std::vector<float> GetLayers() const override {
+    ORBIT_CHECK(batcher_ != nullptr);
+    return batcher_->GetLayers();
+  }
+  void DrawLayer(float layer, bool picking) const override {
+    ORBIT_CHECK(batcher_ != nullptr);
+    batcher_->DrawLayer(layer, picking);
+  }
+  [[nodiscard]] const PickingUserData* GetUserData(PickingId id) const override {
+    ORBIT_CHECK(batcher_ != nullptr);
+    return batcher_->GetUserData(id);
+  }
+
+ private:
+  RecordedPrimitive& Record(RecordedPrimitive::Type type, const Color& picking_color,
+                            const std::optional<PickingUserData>& user_data) {
+    RecordedPrimitive& primitive = recording_->primitives.emplace_back();
+    primitive.type = type;
+    primitive.picking_color = picking_color;
+    primitive.user_data = user_data;
+
+    const PickingId::Layout picking_id = GetPickingIdLayout(picking_color);
+    if (picking_id.batcher_id != static_cast<uint32_t>(GetBatcherId())) return primitive;
+    const auto picking_type = static_cast<PickingType>(picking_id.type);
+    switch (picking_type) {
+      case PickingType::kLine:
+      case PickingType::kBox:
+      case PickingType::kTriangle:
+        if (picking_id.element_id >= first_element_id_) {
+          primitive.picking_color_source = RecordedPrimitive::PickingColorSource::kElementId;
+          primitive.picking_type = picking_type;
+          primitive.picking_index = picking_id.element_id - first_element_id_;
+        }
+        break;
+      case PickingType::kPickable:
+        if (picking_manager_ != nullptr) {
+          std::shared_ptr<Pickable> pickable = picking_manager_->GetPickableFromId(
+              PickingId::Create(picking_type, picking_id.element_id, GetBatcherId()));
+          if (pickable != nullptr) {
+            primitive.picking_color_source = RecordedPrimitive::PickingColorSource::kPickable;
+            primitive.picking_index = recording_->pickables.size();
+            recording_->pickables.push_back(pickable);
+          }
+        }
+        break;
+      default:
+        break;
+    }
+    return primitive;
+  }
+
+  Batcher* batcher_;
+  PickingManager* picking_manager_;
+  Recording* recording_;
+  uint32_t first_element_id_;
+};
+
+// Adds all texts to another text renderer, while recording them relative to the translations
+// pushed on this text renderer. With a `text_renderer_mutex`, texts are only recorded, and the
+// other text renderer is only used to measure them, while holding the mutex.
+class PrimitiveCache::RecordingTextRenderer : public TextRenderer {
+ public:
+  explicit RecordingTextRenderer(TextRenderer* text_renderer, Recording* recording,
+                                 absl::Mutex* text_renderer_mutex = nullptr)
+      : text_renderer_(text_renderer),
+        recording_(recording),
+        text_renderer_mutex_(text_renderer_mutex) {}
+
+  // Only the owner of the text renderer initializes and clears it.
+  void Init() override { ORBIT_UNREACHABLE(); }
+  void Clear() override { ORBIT_UNREACHABLE(); }
+
+  void RenderLayer(float layer) override { text_renderer_->RenderLayer(layer); }
+  void RenderDebug(PrimitiveAssembler* primitive_assembler) override {
+    text_renderer_->RenderDebug(primitive_assembler);
+  }
+  [[nodiscard]] std::vector<float> GetLayers() const override {
+    return text_renderer_->GetLayers();
+  }
+
+  void AddText(const char* text, float x, float y, float z, TextFormatting formatting) override {
+    AddText(text, x, y, z, formatting, nullptr, nullptr);
+  }
+  void AddText(const char* text, float x, float y, float z, TextFormatting formatting,
+               Vec2* out_text_pos, Vec2* out_text_size) override {
+    const LayeredVec2 position = Record(text, x, y, z, formatting, std::nullopt);
+    if (text_renderer_mutex_ != nullptr) {
+      // The position and size of the text are only known once it is actually added.
+      ORBIT_CHECK(out_text_pos == nullptr && out_text_size == nullptr);
+      return;
+    }
+    text_renderer_->AddText(text, position.xy[0], position.xy[1], position.z, formatting,
+                            out_text_pos, out_text_size);
+  }
+
+  float AddTextTrailingCharsPrioritized(const char* text, float x, float y, float z,
+                                        TextFormatting formatting,
+                                        size_t trailing_chars_length) override {
+    const LayeredVec2 position = Record(text, x, y, z, formatting, trailing_chars_length);
+    if (text_renderer_mutex_ != nullptr) {
+      // The text is only shortened once it is actually added, so this is an upper bound.
+      const float width = GetStringWidth(text, formatting.font_size);
+      return formatting.max_size >= 0 ? std::min(width, formatting.max_size) : width;
+    }
+    return text_renderer_->AddTextTrailingCharsPrioritized(
+        text, position.xy[0], position.xy[1], position.z, formatting, trailing_chars_length);
+  }
+
+  [[nodiscard]] float GetStringWidth(const char* text, uint32_t font_size) override {
+    absl::MutexLockMaybe lock{text_renderer_mutex_};
+    return text_renderer_->GetStringWidth(text, font_size);
+  }
+  [[nodiscard]] float GetStringHeight(const char* text, uint32_t font_size) override {
+    absl::MutexLockMaybe lock{text_renderer_mutex_};
+    return text_renderer_->GetStringHeight(text, font_size);
+  }
+
+ private:
+  LayeredVec2 Record(const char* text, float x, float y, float z, const TextFormatting& formatting,
+                     std::optional<size_t> trailing_chars_length) {
+    const LayeredVec2 position = translations_.TranslateXYZ({{x, y}, z});
+    recording_->texts.push_back({text, position, formatting, trailing_chars_length});
+    return position;
+  }
+
+  TextRenderer* text_renderer_;
+  Recording* recording_;
+  absl::Mutex* text_renderer_mutex_;
+};
+
+bool PrimitiveCache::Replay(const Key& key, PrimitiveAssembler& primitive_assembler,
+                            TextRenderer& text_renderer) const {
+  ORBIT_SCOPE_FUNCTION;
+  auto recording_it = recordings_by_picking_mode_.find(key.picking_mode);
+  if (recording_it == recordings_by_picking_mode_.end() || recording_it->second.key != key) {
+    return false;
+  }
+  const Recording& recording = recording_it->second;
+
+  Batcher* batcher = primitive_assembler.GetBatcher();
+  const BatcherId batcher_id = batcher->GetBatcherId();
+  std::vector<Color> pickable_colors;
+  pickable_colors.reserve(recording.pickables.size());
+  for (const std::weak_ptr<Pickable>& weak_pickable : recording.pickables) {
+    std::shared_ptr<Pickable> pickable = weak_pickable.lock();
+    // A Pickable that no longer exists can't have been recorded with the current state.
+    if (pickable == nullptr) return false;
+    pickable_colors.push_back(
+        primitive_assembler.GetPickingManager()->GetPickableColor(pickable, batcher_id));
+  }
+
+  const uint32_t first_element_id = batcher->GetNumElements();
+  for (const RecordedPrimitive& primitive : recording.primitives) {
+    Color picking_color = primitive.picking_color;
+    switch (primitive.picking_color_source) {
+      case RecordedPrimitive::PickingColorSource::kRecorded:
+        break;
+      case RecordedPrimitive::PickingColorSource::kElementId:
+        picking_color = PickingId::ToColor(primitive.picking_type,
+                                           first_element_id + primitive.picking_index, batcher_id);
+        break;
+      case RecordedPrimitive::PickingColorSource::kPickable:
+        picking_color = pickable_colors[primitive.picking_index];
+        break;
+    }
+    switch (primitive.type) {
+      case RecordedPrimitive::Type::kLine:
+        batcher->AddLine(primitive.vertices[0], primitive.vertices[1], primitive.z,
+                         primitive.colors[0], picking_color, primitive.user_data);
+        break;
+      case RecordedPrimitive::Type::kBox:
+        batcher->AddBox(Quad{primitive.vertices}, primitive.z, primitive.colors, picking_color,
+                        primitive.user_data);
+        break;
+      case RecordedPrimitive::Type::kTriangle:
+        batcher->AddTriangle(
+            Triangle{primitive.vertices[0], primitive.vertices[1], primitive.vertices[2]},
+            primitive.z, {primitive.colors[0], primitive.colors[1], primitive.colors[2]},
+            picking_color, primitive.user_data);
+        break;
+    }
+  }
+
+  for (const RecordedText& text : recording.texts) {
+    if (text.trailing_chars_length.has_value()) {
+      text_renderer.AddTextTrailingCharsPrioritized(text.text.c_str(), text.position.xy[0],
+                                                    text.position.xy[1], text.position.z,
+                                                    text.formatting,
+                                                    text.trailing_chars_length.value());
+    } else {
+      text_renderer.AddText(text.text.c_str(), text.position.xy[0], text.position.xy[1],
+                            text.position.z, text.formatting);
+    }
+  }
+  return true;
+}
+
+void PrimitiveCache::Record(
+    const Key& key, PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+    const std::function<void(PrimitiveAssembler&, TextRenderer&)>& update_primitives) {
+  ORBIT_SCOPE_FUNCTION;
+  Recording recording{key};
+  RecordingBatcher recording_batcher{primitive_assembler.GetBatcher()->GetBatcherId(),
+                                     primitive_assembler.GetBatcher(),
+                                     primitive_assembler.GetPickingManager(), &recording};
+  PrimitiveAssembler recording_primitive_assembler{&recording_batcher,
+                                                   primitive_assembler.GetPickingManager()};
+  RecordingTextRenderer recording_text_renderer{&text_renderer, &recording};
+  update_primitives(recording_primitive_assembler, recording_text_renderer);
+
+  recordings_by_picking_mode_.insert_or_assign(key.picking_mode, std::move(recording));
+}
+
+void PrimitiveCache::RecordWithoutAdding(
+    const Key& key, const PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+    absl::Mutex* text_renderer_mutex,
+    const std::function<void(PrimitiveAssembler&, TextRenderer&)>& update_primitives) {
+  ORBIT_SCOPE_FUNCTION;
+  ORBIT_CHECK(text_renderer_mutex != nullptr);
+  Recording recording{key};
+  RecordingBatcher recording_batcher{primitive_assembler.GetBatcher()->GetBatcherId(),
+                                     /*batcher=*/nullptr, primitive_assembler.GetPickingManager(),
+                                     &recording};
+  PrimitiveAssembler recording_primitive_assembler{&recording_batcher,
+                                                   primitive_assembler.GetPickingManager()};
+  RecordingTextRenderer recording_text_renderer{&text_renderer, &recording, text_renderer_mutex};
+  update_primitives(recording_primitive_assembler, recording_text_renderer);
+
+  recordings_by_picking_mode_.insert_or_assign(key.picking_mode, std::move(recording));
+}
+
+}  // namespace orbit_gl
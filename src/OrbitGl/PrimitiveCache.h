@@ -0,0 +1,121 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ORBIT_GL_PRIMITIVE_CACHE_H_
+#define ORBIT_GL_PRIMITIVE_CACHE_H_
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BatcherInterface.h"
+#include "CoreMath.h"
+#include "PickingManager.h"
+#include "PrimitiveAssembler.h"
+#include "TextRenderer.h"
+#include "TranslationStack.h"
+
+namespace orbit_gl {
+
+// Retains the primitives of a capture view element and its subtree. The lines, boxes, triangles
+// and texts added while updating the primitives are recorded, and can be added again as long as
+// nothing they depend on has changed. This is much cheaper than generating them again, which for a
+// track means iterating over its timers, computing colors, tooltips and labels.
+//
+// The recorded coordinates are relative to the translations in effect when the recording starts.
+// Picking colors are not replayed as they were recorded: the element ids of the primitives with
+// user data are relative to the number of elements already in the batcher, and Pickables get their
+// current id from the PickingManager, which is reset every frame.
+class PrimitiveCache {
+ public:
+  // What the recorded primitives depend on, other than the state of the elements themselves.
+  struct Key {
+    uint64_t min_tick = 0;
+    uint64_t max_tick = 0;
+    PickingMode picking_mode = PickingMode::kNone;
+    Vec2 pos;
+    Vec2 size;
+    uint64_t layout_version = 0;
+
+    friend bool operator==(const Key& lhs, const Key& rhs) {
+      return lhs.min_tick == rhs.min_tick && lhs.max_tick == rhs.max_tick &&
+             lhs.picking_mode == rhs.picking_mode && lhs.pos == rhs.pos && lhs.size == rhs.size &&
+             lhs.layout_version == rhs.layout_version;
+    }
+    friend bool operator!=(const Key& lhs, const Key& rhs) { return !(lhs == rhs); }
+  };
+
+  // Adds the primitives and texts recorded for `key`, if any, and returns whether it did.
+  [[nodiscard]] bool Replay(const Key& key, PrimitiveAssembler& primitive_assembler,
+                            TextRenderer& text_renderer) const;
+
+  // Calls `update_primitives` with a primitive assembler and a text renderer that add everything
+  // to `primitive_assembler` and `text_renderer`, and records it for `key`.
+  void Record(
+      const Key& key, PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+      const std::function<void(PrimitiveAssembler&, TextRenderer&)>& update_primitives);
+
+  // Like Record, but nothing is added to `primitive_assembler` and `text_renderer` until Replay is
+  // called with the same key. This allows calling `update_primitives` on another thread: it only
+  // uses `text_renderer` to measure texts, while holding `text_renderer_mutex`.
+  // `primitive_assembler` only provides the batcher id and the picking manager.
+  void RecordWithoutAdding(
+      const Key& key, const PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+      absl::Mutex* text_renderer_mutex,
+      const std::function<void(PrimitiveAssembler&, TextRenderer&)>& update_primitives);
+
+  void Clear() { recordings_by_picking_mode_.clear(); }
+  [[nodiscard]] size_t GetRecordingCount() const { return recordings_by_picking_mode_.size(); }
+
+ private:
+  class RecordingBatcher;
+  class RecordingTextRenderer;
+
+  struct RecordedPrimitive {
+    enum class Type { kLine, kBox, kTriangle };
+    enum class PickingColorSource { kRecorded, kElementId, kPickable };
+
+    Type type = Type::kLine;
+    std::array<Vec2, 4> vertices;
+    float z = 0.f;
+    std::array<Color, 4> colors;
+    PickingColorSource picking_color_source = PickingColorSource::kRecorded;
+    // For kRecorded.
+    Color picking_color;
+    // For kElementId, `picking_index` is the element id relative to the first element of the
+    // recording. For kPickable, it is the index in `Recording::pickables`.
+    PickingType picking_type = PickingType::kInvalid;
+    uint32_t picking_index = 0;
+    std::optional<PickingUserData> user_data;
+  };
+
+  struct RecordedText {
+    std::string text;
+    LayeredVec2 position;
+    TextRenderer::TextFormatting formatting;
+    std::optional<size_t> trailing_chars_length;
+  };
+
+  struct Recording {
+    Key key;
+    std::vector<RecordedPrimitive> primitives;
+    std::vector<std::weak_ptr<Pickable>> pickables;
+    std::vector<RecordedText> texts;
+  };
+
+  // Picking and drawing frames alternate, so there is one recording for each picking mode.
+  absl::flat_hash_map<PickingMode, Recording> recordings_by_picking_mode_;
+};
+
+}  // namespace orbit_gl
+
+#endif  // ORBIT_GL_PRIMITIVE_CACHE_H_
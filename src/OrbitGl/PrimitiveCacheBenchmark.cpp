@@ -0,0 +1,211 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how long updating the primitives of thousands of tracks takes when only a few of them
+// change from one frame to the next: with and without PrimitiveCache, and without it but with the
+// tracks updated on multiple threads. Runs headless, on MockBatcher and MockTextRenderer.
+
+#include <absl/flags/flag.h>
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+#include <absl/strings/str_format.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CaptureViewElement.h"
+#include "MockBatcher.h"
+#include "MockTextRenderer.h"
+#include "OrbitBase/Logging.h"
+#include "PrimitiveAssembler.h"
+#include "PrimitiveCache.h"
+#include "TimeGraphLayout.h"
+#include "Viewport.h"
+
+ABSL_FLAG(uint32_t, tracks, 5'000, "Number of tracks");
+ABSL_FLAG(uint32_t, timers, 50, "Number of visible timers in each track");
+ABSL_FLAG(uint32_t, changed_tracks, 10, "Number of tracks that change in each frame");
+ABSL_FLAG(uint32_t, frames, 20, "Number of frames to update");
+
+namespace {
+
+using orbit_gl::CaptureViewElement;
+using orbit_gl::PickingUserData;
+using orbit_gl::PrimitiveAssembler;
+using orbit_gl::PrimitiveCache;
+using orbit_gl::TextRenderer;
+
+constexpr float kTrackHeight = 20.f;
+constexpr float kTrackWidth = 2'000.f;
+
+// Generates primitives like a timer track: a box with a tooltip and a label for each timer.
+class BenchmarkTrack : public CaptureViewElement {
+ public:
+  explicit BenchmarkTrack(CaptureViewElement* parent, const orbit_gl::Viewport* viewport,
+                          const TimeGraphLayout* layout, uint32_t timer_count, bool use_cache)
+      : CaptureViewElement(parent, viewport, layout),
+        timer_count_(timer_count),
+        use_cache_(use_cache) {}
+
+  [[nodiscard]] float GetHeight() const override { return kTrackHeight; }
+
+ protected:
+  void DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer,
+                          uint64_t min_tick, uint64_t max_tick,
+                          PickingMode /*picking_mode*/) override {
+    const float timer_width = GetWidth() / static_cast<float>(timer_count_);
+    const uint64_t ticks_per_timer = (max_tick - min_tick) / timer_count_;
+    for (uint32_t i = 0; i < timer_count_; ++i) {
+      const Vec2 pos{GetPos()[0] + static_cast<float>(i) * timer_width, GetPos()[1]};
+      const Vec2 size{timer_width, kTrackHeight};
+      const uint64_t start_tick = min_tick + i * ticks_per_timer;
+      const Color color{static_cast<uint8_t>(i), 128, static_cast<uint8_t>(255 - i), 255};
+      PickingUserData user_data(
+          nullptr, [start_tick](PickingId /*id*/) { return absl::StrFormat("%u", start_tick); });
+      primitive_assembler.AddShadedBox(pos, size, 0.f, color, std::move(user_data));
+
+      const std::string label = absl::StrFormat("Timer %u: %u ticks", i, ticks_per_timer);
+      TextRenderer::TextFormatting formatting;
+      formatting.max_size = timer_width;
+      text_renderer.AddTextTrailingCharsPrioritized(label.c_str(), pos[0], pos[1], 0.1f,
+                                                    formatting, 8);
+    }
+  }
+
+  [[nodiscard]] PrimitiveCache* GetPrimitiveCache() override {
+    return use_cache_ ? &primitive_cache_ : nullptr;
+  }
+
+ private:
+  [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
+  CreateAccessibleInterface() override {
+    return nullptr;
+  }
+
+  uint32_t timer_count_;
+  bool use_cache_;
+  PrimitiveCache primitive_cache_;
+};
+
+class BenchmarkTrackContainer : public CaptureViewElement {
+ public:
+  explicit BenchmarkTrackContainer(const orbit_gl::Viewport* viewport,
+                                   const TimeGraphLayout* layout, uint32_t track_count,
+                                   uint32_t timer_count, bool use_cache, bool in_parallel)
+      : CaptureViewElement(nullptr, viewport, layout), in_parallel_(in_parallel) {
+    for (uint32_t i = 0; i < track_count; ++i) {
+      auto& track = tracks_.emplace_back(
+          std::make_unique<BenchmarkTrack>(this, viewport, layout, timer_count, use_cache));
+      track->SetPos(0, static_cast<float>(i) * kTrackHeight);
+      track->SetWidth(kTrackWidth);
+    }
+  }
+
+  [[nodiscard]] float GetHeight() const override {
+    return static_cast<float>(tracks_.size()) * kTrackHeight;
+  }
+  [[nodiscard]] std::vector<CaptureViewElement*> GetAllChildren() const override {
+    std::vector<CaptureViewElement*> children;
+    children.reserve(tracks_.size());
+    for (const std::unique_ptr<BenchmarkTrack>& track : tracks_) children.push_back(track.get());
+    return children;
+  }
+
+  void RequestUpdateOfTrack(size_t index) { tracks_[index]->RequestUpdate(); }
+
+  using CaptureViewElement::UpdatePrimitives;
+
+ protected:
+  [[nodiscard]] bool ShouldUpdatePrimitivesOfChildrenInParallel() const override {
+    return in_parallel_;
+  }
+
+ private:
+  [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
+  CreateAccessibleInterface() override {
+    return nullptr;
+  }
+
+  bool in_parallel_;
+  std::vector<std::unique_ptr<BenchmarkTrack>> tracks_;
+};
+
+absl::Duration MeasureUpdates(uint32_t track_count, uint32_t timer_count,
+                              uint32_t changed_track_count, uint32_t frame_count, bool use_cache,
+                              bool in_parallel) {
+  // The viewport is as high as all tracks, so that they are all visible.
+  orbit_gl::Viewport viewport(static_cast<int>(kTrackWidth),
+                              static_cast<int>(static_cast<float>(track_count) * kTrackHeight));
+  TimeGraphLayout layout;
+  BenchmarkTrackContainer container(&viewport, &layout, track_count, timer_count, use_cache,
+                                    in_parallel);
+  orbit_gl::MockBatcher batcher;
+  orbit_gl::MockTextRenderer text_renderer;
+  PrimitiveAssembler primitive_assembler(&batcher);
+
+  auto update_primitives = [&]() {
+    primitive_assembler.StartNewFrame();
+    text_renderer.Clear();
+    container.UpdatePrimitives(primitive_assembler, text_renderer, 0, 1'000'000,
+                               PickingMode::kNone);
+  };
+
+  // The first frame generates the primitives of all tracks in any case.
+  update_primitives();
+
+  std::mt19937 random{42};
+  std::uniform_int_distribution<size_t> track_index_distribution{0, track_count - 1};
+  const absl::Time start = absl::Now();
+  for (uint32_t frame = 0; frame < frame_count; ++frame) {
+    for (uint32_t i = 0; i < changed_track_count; ++i) {
+      container.RequestUpdateOfTrack(track_index_distribution(random));
+    }
+    update_primitives();
+  }
+  const absl::Duration duration = absl::Now() - start;
+
+  ORBIT_CHECK(batcher.GetNumBoxes() == static_cast<int>(track_count * timer_count));
+  ORBIT_CHECK(text_renderer.GetNumAddTextCalls() == static_cast<int>(track_count * timer_count));
+  return duration / frame_count;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  absl::SetProgramUsageMessage(
+      "Measures the time to update the primitives of many tracks, with and without caching");
+  absl::ParseCommandLine(argc, argv);
+
+  const uint32_t track_count = absl::GetFlag(FLAGS_tracks);
+  const uint32_t timer_count = absl::GetFlag(FLAGS_timers);
+  const uint32_t changed_track_count = absl::GetFlag(FLAGS_changed_tracks);
+  const uint32_t frame_count = absl::GetFlag(FLAGS_frames);
+  ORBIT_CHECK(track_count > 0 && timer_count > 0 && frame_count > 0);
+
+  const absl::Duration uncached_duration = MeasureUpdates(
+      track_count, timer_count, changed_track_count, frame_count, /*use_cache=*/false,
+      /*in_parallel=*/false);
+  const absl::Duration cached_duration = MeasureUpdates(
+      track_count, timer_count, changed_track_count, frame_count, /*use_cache=*/true,
+      /*in_parallel=*/false);
+  const absl::Duration parallel_duration = MeasureUpdates(
+      track_count, timer_count, changed_track_count, frame_count, /*use_cache=*/false,
+      /*in_parallel=*/true);
+
+  ORBIT_LOG("Updated %u tracks with %u timers each, %u of them changed per frame", track_count,
+            timer_count, changed_track_count);
+  ORBIT_LOG("Without cache: %s per frame", absl::FormatDuration(uncached_duration));
+  ORBIT_LOG("With cache: %s per frame (%.1fx)", absl::FormatDuration(cached_duration),
+            absl::FDivDuration(uncached_duration, cached_duration));
+  ORBIT_LOG("Without cache, in parallel on %u threads: %s per frame (%.1fx)",
+            std::thread::hardware_concurrency(), absl::FormatDuration(parallel_duration),
+            absl::FDivDuration(uncached_duration, parallel_duration));
+  return 0;
+}
@@ -0,0 +1,391 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/synchronization/mutex.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "Batcher.h"
+#include "CaptureViewElement.h"
+#include "ClientProtos/capture_data.pb.h"
+#include "MockBatcher.h"
+#include "MockTextRenderer.h"
+#include "PickingManager.h"
+#include "PrimitiveAssembler.h"
+#include "PrimitiveCache.h"
+#include "TimeGraphLayout.h"
+#include "Viewport.h"
+
+namespace orbit_gl {
+
+namespace {
+
+// Keeps the picking colors and user data of the primitives, which MockBatcher discards.
+class PickingBatcher : public Batcher {
+ public:
+  PickingBatcher() : Batcher(BatcherId::kTimeGraph) {}
+
+  void ResetElements() override {
+    first_vertices_.clear();
+    picking_colors_.clear();
+    user_data_.clear();
+  }
+  void AddLine(Vec2 from, Vec2 /*to*/, float /*z*/, const Color& /*color*/,
+               const Color& picking_color, std::optional<PickingUserData> user_data) override {
+    first_vertices_.push_back(from);
+    picking_colors_.push_back(picking_color);
+    user_data_.push_back(std::move(user_data));
+  }
+  void AddBox(const Quad& box, float /*z*/, const std::array<Color, 4>& /*colors*/,
+              const Color& picking_color, std::optional<PickingUserData> user_data) override {
+    first_vertices_.push_back(box.vertices[0]);
+    picking_colors_.push_back(picking_color);
+    user_data_.push_back(std::move(user_data));
+  }
+  void AddTriangle(const Triangle& triangle, float /*z*/, const std::array<Color, 3>& /*colors*/,
+                   const Color& picking_color,
+                   std::optional<PickingUserData> user_data) override {
+    first_vertices_.push_back(triangle.vertices[0]);
+    picking_colors_.push_back(picking_color);
+    user_data_.push_back(std::move(user_data));
+  }
+
+  [[nodiscard]] uint32_t GetNumElements() const override { return user_data_.size(); }
+  [[nodiscard]] std::vector<float> GetLayers() const override { return {}; }
+  void DrawLayer(float /*layer*/, bool /*picking*/) const override {}
+  [[nodiscard]] const PickingUserData* GetUserData(PickingId id) const override {
+    return user_data_[id.element_id].has_value() ? &*user_data_[id.element_id] : nullptr;
+  }
+
+  [[nodiscard]] const std::vector<Vec2>& GetFirstVertices() const { return first_vertices_; }
+  [[nodiscard]] const std::vector<Color>& GetPickingColors() const { return picking_colors_; }
+
+ private:
+  std::vector<Vec2> first_vertices_;
+  std::vector<Color> picking_colors_;
+  std::vector<std::optional<PickingUserData>> user_data_;
+};
+
+class PickableMock : public Pickable {
+ public:
+  void OnPick(int /*x*/, int /*y*/) override {}
+};
+
+void AddPrimitivesAndTexts(PrimitiveAssembler& primitive_assembler, TextRenderer& text_renderer) {
+  const Color kRed{255, 0, 0, 255};
+  const Color kGreen{0, 255, 0, 255};
+  primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f, kRed);
+  primitive_assembler.AddBox(MakeBox({10, 0}, {10, 10}), 0.f, kRed);
+  primitive_assembler.AddLine({0, 0}, {20, 0}, 0.1f, kGreen);
+  primitive_assembler.AddTriangle(Triangle{{0, 0}, {5, 5}, {0, 5}}, 0.2f, kGreen);
+  text_renderer.AddText("text", 0, 0, 0.3f, {});
+  text_renderer.AddTextTrailingCharsPrioritized("more text", 0, 10, 0.3f, {}, 4);
+}
+
+}  // namespace
+
+TEST(PrimitiveCache, ReplaysRecordedPrimitivesAndTexts) {
+  MockBatcher batcher;
+  MockTextRenderer text_renderer;
+  PrimitiveAssembler primitive_assembler(&batcher);
+  PrimitiveCache cache;
+  const PrimitiveCache::Key key{0, 100, PickingMode::kNone, {0, 0}, {20, 10}, 0};
+
+  EXPECT_FALSE(cache.Replay(key, primitive_assembler, text_renderer));
+  cache.Record(key, primitive_assembler, text_renderer, AddPrimitivesAndTexts);
+  EXPECT_EQ(batcher.GetNumBoxes(), 2);
+  EXPECT_EQ(batcher.GetNumLines(), 1);
+  EXPECT_EQ(batcher.GetNumTriangles(), 1);
+  EXPECT_EQ(text_renderer.GetNumAddTextCalls(), 2);
+
+  primitive_assembler.StartNewFrame();
+  text_renderer.Clear();
+  EXPECT_TRUE(cache.Replay(key, primitive_assembler, text_renderer));
+  EXPECT_EQ(batcher.GetNumBoxes(), 2);
+  EXPECT_EQ(batcher.GetNumLines(), 1);
+  EXPECT_EQ(batcher.GetNumTriangles(), 1);
+  EXPECT_EQ(text_renderer.GetNumAddTextCalls(), 2);
+  EXPECT_TRUE(batcher.IsEverythingInsideRectangle({0, 0}, {20, 10}));
+  EXPECT_TRUE(batcher.IsEverythingBetweenZLayers(0.f, 0.2f));
+
+  PrimitiveCache::Key other_key = key;
+  other_key.max_tick = 200;
+  EXPECT_FALSE(cache.Replay(other_key, primitive_assembler, text_renderer));
+  other_key = key;
+  other_key.layout_version = 1;
+  EXPECT_FALSE(cache.Replay(other_key, primitive_assembler, text_renderer));
+
+  // Recordings for different picking modes are kept side by side.
+  other_key = key;
+  other_key.picking_mode = PickingMode::kHover;
+  cache.Record(other_key, primitive_assembler, text_renderer, AddPrimitivesAndTexts);
+  EXPECT_EQ(cache.GetRecordingCount(), 2);
+  EXPECT_TRUE(cache.Replay(key, primitive_assembler, text_renderer));
+  EXPECT_TRUE(cache.Replay(other_key, primitive_assembler, text_renderer));
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Replay(key, primitive_assembler, text_renderer));
+}
+
+TEST(PrimitiveCache, RecordsRelativeToTheTranslationsAtTheStartOfTheRecording) {
+  MockBatcher batcher;
+  MockTextRenderer text_renderer;
+  PrimitiveAssembler primitive_assembler(&batcher);
+  PrimitiveCache cache;
+  const PrimitiveCache::Key key{};
+
+  primitive_assembler.PushTranslation(0, 0, 0.5f);
+  text_renderer.PushTranslation(0, 0, 0.5f);
+  cache.Record(key, primitive_assembler, text_renderer,
+               [](PrimitiveAssembler& recording_primitive_assembler,
+                  TextRenderer& recording_text_renderer) {
+                 recording_primitive_assembler.PushTranslation(0, 0, 0.25f);
+                 recording_text_renderer.PushTranslation(0, 0, 0.25f);
+                 AddPrimitivesAndTexts(recording_primitive_assembler, recording_text_renderer);
+                 recording_text_renderer.PopTranslation();
+                 recording_primitive_assembler.PopTranslation();
+               });
+  text_renderer.PopTranslation();
+  primitive_assembler.PopTranslation();
+
+  // MockBatcher and MockTextRenderer ignore their own translations.
+  EXPECT_TRUE(batcher.IsEverythingBetweenZLayers(0.2f, 0.5f));
+  EXPECT_TRUE(text_renderer.IsTextBetweenZLayers(0.5f, 0.6f));
+
+  primitive_assembler.StartNewFrame();
+  text_renderer.Clear();
+  EXPECT_TRUE(cache.Replay(key, primitive_assembler, text_renderer));
+  EXPECT_TRUE(batcher.IsEverythingBetweenZLayers(0.2f, 0.5f));
+  EXPECT_TRUE(text_renderer.IsTextBetweenZLayers(0.5f, 0.6f));
+}
+
+TEST(PrimitiveCache, GeneratesPickingColorsAgainWhenReplaying) {
+  PickingBatcher batcher;
+  MockTextRenderer text_renderer;
+  PickingManager picking_manager;
+  PrimitiveAssembler primitive_assembler(&batcher, &picking_manager);
+  PrimitiveCache cache;
+  const PrimitiveCache::Key key{};
+  const Color kColor{255, 255, 255, 255};
+  auto pickable = std::make_shared<PickableMock>();
+  orbit_client_protos::TimerInfo timer_info;
+
+  auto add_pickable_primitives = [&](PrimitiveAssembler& recording_primitive_assembler,
+                                     TextRenderer& /*recording_text_renderer*/) {
+    recording_primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f, kColor,
+                                         PickingUserData(&timer_info));
+    recording_primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f, kColor, pickable);
+    recording_primitive_assembler.AddLine({0, 0}, {10, 0}, 0.f, kColor);
+  };
+
+  // Something else is in the batcher before the recorded primitives.
+  primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f, kColor);
+  cache.Record(key, primitive_assembler, text_renderer, add_pickable_primitives);
+  ASSERT_EQ(batcher.GetPickingColors().size(), 4);
+
+  // In the next frame, the recorded primitives come first and the pickable gets another id.
+  primitive_assembler.StartNewFrame();
+  picking_manager.Reset();
+  std::ignore = picking_manager.GetPickableColor(std::make_shared<PickableMock>(),
+                                                 BatcherId::kTimeGraph);
+  ASSERT_TRUE(cache.Replay(key, primitive_assembler, text_renderer));
+  const std::vector<Color>& picking_colors = batcher.GetPickingColors();
+  ASSERT_EQ(picking_colors.size(), 3);
+  EXPECT_EQ(picking_colors[0], PickingId::ToColor(PickingType::kBox, 0, BatcherId::kTimeGraph));
+  EXPECT_EQ(picking_colors[1], picking_manager.GetPickableColor(pickable, BatcherId::kTimeGraph));
+  EXPECT_EQ(picking_colors[2], PickingId::ToColor(PickingType::kLine, 2, BatcherId::kTimeGraph));
+  EXPECT_EQ(primitive_assembler.GetTimerInfo(PickingId::Create(PickingType::kBox, 0)),
+            &timer_info);
+
+  // Without the pickable, the recording can't be replayed.
+  primitive_assembler.StartNewFrame();
+  pickable.reset();
+  EXPECT_FALSE(cache.Replay(key, primitive_assembler, text_renderer));
+  EXPECT_EQ(batcher.GetNumElements(), 0);
+}
+
+TEST(PrimitiveCache, RecordsWithoutAddingUntilReplayed) {
+  PickingBatcher batcher;
+  MockTextRenderer text_renderer;
+  PickingManager picking_manager;
+  PrimitiveAssembler primitive_assembler(&batcher, &picking_manager);
+  PrimitiveCache cache;
+  const PrimitiveCache::Key key{};
+  const Color kColor{255, 255, 255, 255};
+  auto pickable = std::make_shared<PickableMock>();
+  absl::Mutex text_renderer_mutex;
+
+  primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f, kColor);
+  cache.RecordWithoutAdding(key, primitive_assembler, text_renderer, &text_renderer_mutex,
+                            [&](PrimitiveAssembler& recording_primitive_assembler,
+                                TextRenderer& recording_text_renderer) {
+                              AddPrimitivesAndTexts(recording_primitive_assembler,
+                                                    recording_text_renderer);
+                              recording_primitive_assembler.AddBox(MakeBox({0, 0}, {10, 10}), 0.f,
+                                                                   kColor, pickable);
+                            });
+  EXPECT_EQ(batcher.GetNumElements(), 1);
+  EXPECT_EQ(text_renderer.GetNumAddTextCalls(), 0);
+
+  ASSERT_TRUE(cache.Replay(key, primitive_assembler, text_renderer));
+  EXPECT_EQ(text_renderer.GetNumAddTextCalls(), 2);
+  const std::vector<Color>& picking_colors = batcher.GetPickingColors();
+  ASSERT_EQ(picking_colors.size(), 6);
+  EXPECT_EQ(picking_colors[1], PickingId::ToColor(PickingType::kBox, 1, BatcherId::kTimeGraph));
+  EXPECT_EQ(picking_colors[3], PickingId::ToColor(PickingType::kLine, 3, BatcherId::kTimeGraph));
+  EXPECT_EQ(picking_colors[5], picking_manager.GetPickableColor(pickable, BatcherId::kTimeGraph));
+}
+
+namespace {
+
+constexpr float kLeafHeight = 20.f;
+
+class CachedLeafElement : public CaptureViewElement {
+ public:
+  explicit CachedLeafElement(CaptureViewElement* parent, const Viewport* viewport,
+                             const TimeGraphLayout* layout)
+      : CaptureViewElement(parent, viewport, layout) {}
+
+  [[nodiscard]] float GetHeight() const override { return kLeafHeight; }
+  [[nodiscard]] int GetUpdateCount() const { return update_count_; }
+
+ protected:
+  void DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
+                          TextRenderer& /*text_renderer*/, uint64_t /*min_tick*/,
+                          uint64_t /*max_tick*/, PickingMode /*picking_mode*/) override {
+    ++update_count_;
+    primitive_assembler.AddBox(MakeBox(GetPos(), GetSize()), 0.f, Color{255, 0, 0, 255});
+  }
+  [[nodiscard]] PrimitiveCache* GetPrimitiveCache() override { return &primitive_cache_; }
+
+ private:
+  [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
+  CreateAccessibleInterface() override {
+    return nullptr;
+  }
+
+  int update_count_ = 0;
+  PrimitiveCache primitive_cache_;
+};
+
+class ContainerElement : public CaptureViewElement {
+ public:
+  explicit ContainerElement(const Viewport* viewport, const TimeGraphLayout* layout,
+                            bool update_children_in_parallel = false)
+      : CaptureViewElement(nullptr, viewport, layout),
+        update_children_in_parallel_(update_children_in_parallel) {
+    for (int i = 0; i < 3; ++i) {
+      children_.push_back(std::make_unique<CachedLeafElement>(this, viewport, layout));
+      children_.back()->SetPos(0, i * kLeafHeight);
+      children_.back()->SetWidth(viewport->GetWorldWidth());
+    }
+  }
+
+  [[nodiscard]] float GetHeight() const override {
+    return static_cast<float>(children_.size()) * kLeafHeight;
+  }
+  [[nodiscard]] std::vector<CaptureViewElement*> GetAllChildren() const override {
+    std::vector<CaptureViewElement*> result;
+    for (const auto& child : children_) result.push_back(child.get());
+    return result;
+  }
+  [[nodiscard]] CachedLeafElement* GetChild(size_t index) const { return children_[index].get(); }
+
+  using CaptureViewElement::UpdatePrimitives;
+
+ protected:
+  [[nodiscard]] bool ShouldUpdatePrimitivesOfChildrenInParallel() const override {
+    return update_children_in_parallel_;
+  }
+
+ private:
+  [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
+  CreateAccessibleInterface() override {
+    return nullptr;
+  }
+
+  bool update_children_in_parallel_;
+  std::vector<std::unique_ptr<CachedLeafElement>> children_;
+};
+
+}  // namespace
+
+TEST(PrimitiveCache, UpdatesOnlyTheElementsThatChanged) {
+  Viewport viewport(100, 100);
+  TimeGraphLayout layout;
+  ContainerElement container(&viewport, &layout);
+  MockBatcher batcher;
+  MockTextRenderer text_renderer;
+  PrimitiveAssembler primitive_assembler(&batcher);
+
+  auto update_primitives = [&](uint64_t max_tick) {
+    primitive_assembler.StartNewFrame();
+    container.UpdatePrimitives(primitive_assembler, text_renderer, 0, max_tick,
+                               PickingMode::kNone);
+    EXPECT_EQ(batcher.GetNumBoxes(), 3);
+  };
+  auto get_update_counts = [&]() {
+    return std::vector<int>{container.GetChild(0)->GetUpdateCount(),
+                            container.GetChild(1)->GetUpdateCount(),
+                            container.GetChild(2)->GetUpdateCount()};
+  };
+
+  update_primitives(/*max_tick=*/100);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(1, 1, 1));
+  update_primitives(/*max_tick=*/100);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(1, 1, 1));
+
+  container.GetChild(1)->RequestUpdate();
+  update_primitives(/*max_tick=*/100);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(1, 2, 1));
+
+  // Requesting an update only for drawing doesn't invalidate the primitives.
+  container.GetChild(2)->RequestUpdate(CaptureViewElement::RequestUpdateScope::kDraw);
+  update_primitives(/*max_tick=*/100);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(1, 2, 1));
+
+  // The state of an ancestor might affect all its descendants.
+  container.RequestUpdate();
+  update_primitives(/*max_tick=*/100);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(2, 3, 2));
+
+  update_primitives(/*max_tick=*/200);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(3, 4, 3));
+
+  layout.SetScale(2.f);
+  update_primitives(/*max_tick=*/200);
+  EXPECT_THAT(get_update_counts(), testing::ElementsAre(4, 5, 4));
+}
+
+TEST(PrimitiveCache, UpdatesChildrenInParallelInTheirOrder) {
+  Viewport viewport(100, 100);
+  TimeGraphLayout layout;
+  ContainerElement container(&viewport, &layout, /*update_children_in_parallel=*/true);
+  PickingBatcher batcher;
+  MockTextRenderer text_renderer;
+  PrimitiveAssembler primitive_assembler(&batcher);
+  const BatcherId kBatcherId = batcher.GetBatcherId();
+
+  for (int frame = 0; frame < 2; ++frame) {
+    primitive_assembler.StartNewFrame();
+    container.UpdatePrimitives(primitive_assembler, text_renderer, 0, 100, PickingMode::kNone);
+    EXPECT_THAT(batcher.GetFirstVertices(),
+                testing::ElementsAre(Vec2{0, 0}, Vec2{0, kLeafHeight}, Vec2{0, 2 * kLeafHeight}));
+    EXPECT_THAT(batcher.GetPickingColors(),
+                testing::ElementsAre(PickingId::ToColor(PickingType::kBox, 0, kBatcherId),
+                                     PickingId::ToColor(PickingType::kBox, 1, kBatcherId),
+                                     PickingId::ToColor(PickingType::kBox, 2, kBatcherId)));
+  }
+  // The caches of the children work the same as with a serial update.
+  EXPECT_EQ(container.GetChild(0)->GetUpdateCount(), 1);
+  EXPECT_EQ(container.GetChild(1)->GetUpdateCount(), 1);
+  EXPECT_EQ(container.GetChild(2)->GetUpdateCount(), 1);
+}
+
+}  // namespace orbit_gl
@@ -95,8 +95,7 @@ void SchedulerTrack::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
       const bool is_selected = timer_info == draw_data.selected_timer;
 
       Color color = GetTimerColor(*timer_info, is_selected, /*is_highlighted=*/false, draw_data);
-      std::unique_ptr<PickingUserData> user_data =
-          CreatePickingUserData(primitive_assembler, *timer_info);
+      PickingUserData user_data = CreatePickingUserData(primitive_assembler, *timer_info);
 
       auto [box_start_x, box_width] = GetBoxPosXAndWidth(*timer_info, timeline_info_);
       const Vec2 pos = {box_start_x, world_timer_y};
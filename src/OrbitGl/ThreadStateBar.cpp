@@ -313,10 +313,10 @@ void ThreadStateBar::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
 
         const Color color = GetThreadStateColor(slice.thread_state());
 
-        auto user_data = std::make_unique<PickingUserData>(nullptr, [&](PickingId id) {
+        PickingUserData user_data(nullptr, [&](PickingId id) {
           return GetThreadStateSliceTooltip(primitive_assembler, id);
         });
-        user_data->custom_data_ = &slice;
+        user_data.custom_data_ = &slice;
 
         if (slice.end_timestamp_ns() - slice.begin_timestamp_ns() > pixel_delta_ns) {
           Quad box = MakeBox(pos, size);
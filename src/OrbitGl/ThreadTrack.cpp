@@ -413,8 +413,7 @@ void ThreadTrack::DoUpdatePrimitives(PrimitiveAssembler& primitive_assembler,
       ++visible_timer_count_;
 
       Color color = GetTimerColor(*timer_info, draw_data);
-      std::unique_ptr<PickingUserData> user_data =
-          CreatePickingUserData(primitive_assembler, *timer_info);
+      PickingUserData user_data = CreatePickingUserData(primitive_assembler, *timer_info);
 
       auto box_height = GetDefaultBoxHeight();
       const auto [pos_x, size_x] = GetBoxPosXAndWidth(draw_data, timeline_info_, *timer_info);
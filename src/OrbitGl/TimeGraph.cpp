@@ -5,6 +5,7 @@
 #include "TimeGraph.h"
 
 #include <GteVector.h>
+#include <absl/container/flat_hash_set.h>
 #include <absl/flags/flag.h>
 #include <absl/strings/str_format.h>
 #include <absl/time/time.h>
@@ -55,6 +56,18 @@ using orbit_gl::VariableTrack;
 
 using orbit_grpc_protos::InstrumentedFunction;
 
+namespace {
+
+// TODO (http://b/198135618): Create tracks only before drawing.
+// TODO(b/176962090): We need to create the `ThreadTrack` for core activity timers even we don't use
+//  it, as we don't create it on new callstack events, yet.
+[[nodiscard]] bool TimerNeedsThreadTrack(const TimerInfo& timer_info) {
+  return timer_info.type() == TimerInfo::kCoreActivity || timer_info.type() == TimerInfo::kNone ||
+         timer_info.type() == TimerInfo::kApiScope;
+}
+
+}  // namespace
+
 TimeGraph::TimeGraph(AccessibleInterfaceProvider* parent, OrbitApp* app,
                      orbit_gl::Viewport* viewport, CaptureData* capture_data,
                      PickingManager* picking_manager)
@@ -285,6 +298,27 @@ double TimeGraph::GetTime(double ratio) const {
 }
 
 void TimeGraph::ProcessTimer(const TimerInfo& timer_info) {
+  if (TimerNeedsThreadTrack(timer_info)) {
+    GetTrackManager()->GetOrCreateThreadTrack(timer_info.thread_id());
+  }
+  AddTimerToTrack(timer_info);
+  RequestUpdate();
+}
+
+void TimeGraph::ProcessTimers(absl::Span<const TimerInfo> timers) {
+  // Each lookup of a thread track locks the TrackManager, so only do it once per thread.
+  absl::flat_hash_set<uint32_t> thread_ids_with_track;
+  for (const TimerInfo& timer_info : timers) {
+    if (TimerNeedsThreadTrack(timer_info) &&
+        thread_ids_with_track.insert(timer_info.thread_id()).second) {
+      GetTrackManager()->GetOrCreateThreadTrack(timer_info.thread_id());
+    }
+    AddTimerToTrack(timer_info);
+  }
+  RequestUpdate();
+}
+
+void TimeGraph::AddTimerToTrack(const TimerInfo& timer_info) {
   TrackManager* track_manager = GetTrackManager();
   // TODO(b/175869409): Change the way to create and get the tracks. Move this part to TrackManager.
   switch (timer_info.type()) {
@@ -306,9 +340,6 @@ void TimeGraph::ProcessTimer(const TimerInfo& timer_info) {
       break;
     }
     case TimerInfo::kCoreActivity: {
-      // TODO(b/176962090): We need to create the `ThreadTrack` here even we don't use it, as we
-      //  don't create it on new callstack events, yet.
-      track_manager->GetOrCreateThreadTrack(timer_info.thread_id());
       SchedulerTrack* scheduler_track = track_manager->GetOrCreateSchedulerTrack();
       scheduler_track->OnTimer(timer_info);
       break;
@@ -326,14 +357,10 @@ void TimeGraph::ProcessTimer(const TimerInfo& timer_info) {
       break;
     }
     case TimerInfo::kNone: {
-      // TODO (http://b/198135618): Create tracks only before drawing.
-      track_manager->GetOrCreateThreadTrack(timer_info.thread_id());
       thread_track_data_provider_->AddTimer(timer_info);
       break;
     }
     case TimerInfo::kApiScope: {
-      // TODO (http://b/198135618): Create tracks only before drawing.
-      track_manager->GetOrCreateThreadTrack(timer_info.thread_id());
       thread_track_data_provider_->AddTimer(timer_info);
       break;
     }
@@ -344,8 +371,6 @@ void TimeGraph::ProcessTimer(const TimerInfo& timer_info) {
     default:
       ORBIT_UNREACHABLE();
   }
-
-  RequestUpdate();
 }
 
 void TimeGraph::ProcessApiStringEvent(const orbit_client_data::ApiStringEvent& string_event) {
@@ -5,6 +5,8 @@
 #ifndef ORBIT_GL_TIME_GRAPH_H_
 #define ORBIT_GL_TIME_GRAPH_H_
 
+#include <absl/types/span.h>
+
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -47,6 +49,9 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
 
   // TODO(b/214282122): Move Process Timers function outside the UI.
   void ProcessTimer(const orbit_client_protos::TimerInfo& timer_info);
+  // Same as calling ProcessTimer on each of `timers`, but looks up the track of each thread and
+  // requests the update of the view only once for the whole batch.
+  void ProcessTimers(absl::Span<const orbit_client_protos::TimerInfo> timers);
   void ProcessApiStringEvent(const orbit_client_data::ApiStringEvent& string_event);
   void ProcessApiTrackValueEvent(const orbit_client_data::ApiTrackValue& track_event);
 
@@ -167,6 +172,9 @@ class TimeGraph : public orbit_gl::CaptureViewElement, public orbit_gl::Timeline
 
   [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
   CreateAccessibleInterface() override;
+  // Adds the timer to its track, which has to exist already for timers of a thread track, without
+  // requesting an update.
+  void AddTimerToTrack(const orbit_client_protos::TimerInfo& timer_info);
   void ProcessAsyncTimer(const orbit_client_protos::TimerInfo& timer_info);
   void ProcessSystemMemoryTrackingTimer(const orbit_client_protos::TimerInfo& timer_info);
   void ProcessCGroupAndProcessMemoryTrackingTimer(const orbit_client_protos::TimerInfo& timer_info);
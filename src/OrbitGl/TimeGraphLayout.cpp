@@ -95,12 +95,15 @@ bool TimeGraphLayout::DrawProperties() {
   FLOAT_SLIDER(toolbar_icon_height_);
   FLOAT_SLIDER(generic_fixed_spacer_width_);
   FLOAT_SLIDER_MIN_MAX(scale_, kMinScale, kMaxScale);
-  ImGui::Checkbox("Draw Track Background", &draw_track_background_);
+  if (ImGui::Checkbox("Draw Track Background", &draw_track_background_)) {
+    needs_redraw = true;
+  }
 
   if (ImGui::SliderInt("Maximum # of layout loops", &max_layouting_loops_, 1, 100)) {
     needs_redraw = true;
   }
 
+  if (needs_redraw) ++version_;
   return needs_redraw;
 }
 
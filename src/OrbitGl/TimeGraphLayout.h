@@ -63,7 +63,10 @@ class TimeGraphLayout {
     return thread_dependency_arrow_body_width_ * scale_;
   }
   float GetScale() const { return scale_; }
-  void SetScale(float value) { scale_ = std::clamp(value, kMinScale, kMaxScale); }
+  void SetScale(float value) {
+    scale_ = std::clamp(value, kMinScale, kMaxScale);
+    ++version_;
+  }
   void SetDrawProperties(bool value) { draw_properties_ = value; }
   bool DrawProperties();
   bool GetDrawTrackBackground() const { return draw_track_background_; }
@@ -71,6 +74,10 @@ class TimeGraphLayout {
 
   int GetMaxLayoutingLoops() const { return max_layouting_loops_; }
 
+  // Incremented whenever a property of the layout changes, so that primitives generated for a
+  // previous layout can be told apart.
+  uint64_t GetVersion() const { return version_; }
+
  protected:
   float text_box_height_;
   float core_height_;
@@ -120,6 +127,8 @@ class TimeGraphLayout {
 
   int max_layouting_loops_ = 10;
 
+  uint64_t version_ = 0;
+
  private:
   float GetEventTrackHeight() const { return event_track_height_ * scale_; }
   float GetAllThreadsEventTrackScale() const { return all_threads_event_track_scale_; }
@@ -237,10 +237,9 @@ bool TimerTrack::DrawTimer(TextRenderer& text_renderer, const TimerInfo* prev_ti
     }
   } else {
     PrimitiveAssembler* primitive_assembler = draw_data.primitive_assembler;
-    auto user_data = std::make_unique<PickingUserData>(
-        current_timer_info, [&, primitive_assembler](PickingId id) {
-          return this->GetBoxTooltip(*primitive_assembler, id);
-        });
+    PickingUserData user_data(current_timer_info, [&, primitive_assembler](PickingId id) {
+      return this->GetBoxTooltip(*primitive_assembler, id);
+    });
 
     WorldXInfo world_x_info = ToWorldX(start_us, end_us, draw_data.inv_time_window,
                                        draw_data.track_start_x, draw_data.track_width);
@@ -151,13 +151,12 @@ class TimerTrack : public Track {
 
   [[nodiscard]] virtual std::string GetBoxTooltip(
       const orbit_gl::PrimitiveAssembler& primitive_assembler, PickingId id) const;
-  [[nodiscard]] std::unique_ptr<orbit_gl::PickingUserData> CreatePickingUserData(
+  [[nodiscard]] orbit_gl::PickingUserData CreatePickingUserData(
       const orbit_gl::PrimitiveAssembler& primitive_assembler,
       const orbit_client_protos::TimerInfo& timer_info) {
-    return std::make_unique<orbit_gl::PickingUserData>(
-        &timer_info, [this, &primitive_assembler](PickingId id) {
-          return this->GetBoxTooltip(primitive_assembler, id);
-        });
+    return orbit_gl::PickingUserData(&timer_info, [this, &primitive_assembler](PickingId id) {
+      return this->GetBoxTooltip(primitive_assembler, id);
+    });
   }
 
   [[nodiscard]] inline bool BoxHasRoomForText(orbit_gl::TextRenderer& text_renderer,
@@ -100,11 +100,10 @@ void TracepointThreadBar::DoUpdatePrimitives(PrimitiveAssembler& primitive_assem
           Vec2 pos(timeline_info_->GetWorldFromTick(time) - kPickingBoxOffset,
                    GetPos()[1] - track_height + 1);
           Vec2 size(kPickingBoxWidth, track_height);
-          auto user_data =
-              std::make_unique<PickingUserData>(nullptr, [&](PickingId id) -> std::string {
-                return GetTracepointTooltip(primitive_assembler, id);
-              });
-          user_data->custom_data_ = &tracepoint;
+          PickingUserData user_data(nullptr, [&](PickingId id) -> std::string {
+            return GetTracepointTooltip(primitive_assembler, id);
+          });
+          user_data.custom_data_ = &tracepoint;
           primitive_assembler.AddShadedBox(pos, size, z, kWhite, std::move(user_data));
         });
   }
@@ -24,6 +24,7 @@
 #include "GteVector.h"
 #include "OrbitBase/Profiling.h"
 #include "PrimitiveAssembler.h"
+#include "PrimitiveCache.h"
 #include "TextRenderer.h"
 #include "TimeGraphLayout.h"
 #include "TimelineInfoInterface.h"
@@ -127,6 +128,7 @@ class Track : public orbit_gl::CaptureViewElement,
   void DoDraw(orbit_gl::PrimitiveAssembler& primitive_assembler,
               orbit_gl::TextRenderer& text_renderer, const DrawContext& draw_context) override;
   void DoUpdateLayout() override;
+  [[nodiscard]] orbit_gl::PrimitiveCache* GetPrimitiveCache() override { return &primitive_cache_; }
 
   virtual void UpdatePositionOfSubtracks() {}
 
@@ -138,6 +140,7 @@ class Track : public orbit_gl::CaptureViewElement,
   Type type_ = Type::kUnknown;
 
   std::shared_ptr<orbit_gl::TrackHeader> header_;
+  orbit_gl::PrimitiveCache primitive_cache_;
 
   const orbit_gl::TimelineInfoInterface* timeline_info_;
   const orbit_client_data::ModuleManager* module_manager_ = nullptr;
@@ -17,6 +17,7 @@
 
 #include "AccessibleCaptureViewElement.h"
 #include "App.h"
+#include "ClientFlags/ClientFlags.h"
 #include "ClientData/ScopeId.h"
 #include "CoreMath.h"
 #include "DisplayFormats/DisplayFormats.h"
@@ -317,13 +318,13 @@ void TrackContainer::DrawIncompleteDataIntervals(PrimitiveAssembler& primitive_a
     const Vec2 size{end_x - start_x, world_height};
     float z_value = GlCanvas::kZValueIncompleteDataOverlay;
 
-    std::unique_ptr<PickingUserData> user_data = nullptr;
+    std::optional<PickingUserData> user_data;
     // Show a tooltip when hovering.
     if (picking_mode == PickingMode::kHover) {
       // This overlay is placed in front of the tracks (with transparency), but when it comes to
       // tooltips give it a much lower Z value, so that it's possible to "hover through" it.
       z_value = GlCanvas::kZValueIncompleteDataOverlayPicking;
-      user_data = std::make_unique<PickingUserData>(nullptr, [](PickingId /*id*/) {
+      user_data.emplace(nullptr, [](PickingId /*id*/) {
         return std::string{
             "Capture data is incomplete in this time range. Some information might be inaccurate."};
       });
@@ -475,6 +476,10 @@ void TrackContainer::RemoveFrameTrack(uint64_t function_id) {
   RequestUpdate();
 }
 
+bool TrackContainer::ShouldUpdatePrimitivesOfChildrenInParallel() const {
+  return absl::GetFlag(FLAGS_parallel_track_updates);
+}
+
 std::vector<CaptureViewElement*> TrackContainer::GetAllChildren() const {
   std::vector<Track*> all_tracks = track_manager_->GetAllTracks();
   return {all_tracks.begin(), all_tracks.end()};
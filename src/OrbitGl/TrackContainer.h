@@ -76,6 +76,8 @@ class TrackContainer final : public CaptureViewElement {
 
   void UpdateTracksPosition();
 
+  [[nodiscard]] bool ShouldUpdatePrimitivesOfChildrenInParallel() const override;
+
   [[nodiscard]] std::unique_ptr<orbit_accessibility::AccessibleInterface>
   CreateAccessibleInterface() override;
 
@@ -23,6 +23,10 @@ class TranslationStack {
   void PopTranslation();
   [[nodiscard]] bool IsEmpty() const { return translation_stack_.empty(); }
 
+  [[nodiscard]] LayeredVec2 TranslateXYZ(const LayeredVec2& input) const {
+    return {input.xy + current_translation_.xy, input.z + current_translation_.z};
+  }
+
   // TODO(b/227341686) if we change the type of z-values to be non-float, the name should be made
   // less verbose, as it would be clear `z` is not floored.
   [[nodiscard]] LayeredVec2 TranslateXYZAndFloorXY(const LayeredVec2& input) const {
@@ -5,6 +5,7 @@
 #include "CallTreeViewItemModel.h"
 
 #include <absl/strings/str_format.h>
+#include <absl/types/span.h>
 #include <stddef.h>
 
 #include <QColor>
@@ -275,7 +276,7 @@ QVariant CallTreeViewItemModel::GetCopyableValueRoleData(const QModelIndex& inde
 QVariant CallTreeViewItemModel::GetExclusiveCallstackEventsRoleData(const QModelIndex& index) {
   ORBIT_CHECK(index.isValid());
   auto* item = static_cast<CallTreeNode*>(index.internalPointer());
-  return QVariant::fromValue(&item->exclusive_callstack_events());
+  return QVariant::fromValue(item->exclusive_callstack_events());
 }
 
 QVariant CallTreeViewItemModel::data(const QModelIndex& index, int role) const {
@@ -368,7 +369,7 @@ QModelIndex CallTreeViewItemModel::index(int row, int column, const QModelIndex&
     parent_item = static_cast<CallTreeNode*>(parent.internalPointer());
   }
 
-  const std::vector<const CallTreeNode*>& siblings = parent_item->children();
+  const absl::Span<const CallTreeNode* const> siblings = parent_item->children();
   if (row < 0 || static_cast<size_t>(row) >= siblings.size()) {
     return QModelIndex();
   }
@@ -392,7 +393,7 @@ QModelIndex CallTreeViewItemModel::parent(const QModelIndex& index) const {
     return createIndex(0, 0, const_cast<CallTreeNode*>(item));
   }
 
-  const std::vector<const CallTreeNode*>& siblings = parent_item->children();
+  const absl::Span<const CallTreeNode* const> siblings = parent_item->children();
   int row = static_cast<int>(
       std::distance(siblings.begin(), std::find(siblings.begin(), siblings.end(), item)));
   return createIndex(row, 0, const_cast<CallTreeNode*>(item));
@@ -5,6 +5,8 @@
 #ifndef ORBIT_QT_CALL_TREE_VIEW_ITEM_MODEL_H_
 #define ORBIT_QT_CALL_TREE_VIEW_ITEM_MODEL_H_
 
+#include <absl/types/span.h>
+
 #include <QAbstractItemModel>
 #include <QModelIndex>
 #include <QObject>
@@ -15,7 +17,7 @@
 
 #include "CallTreeView.h"
 
-Q_DECLARE_METATYPE(const std::vector<orbit_client_data::CallstackEvent>*)
+Q_DECLARE_METATYPE(absl::Span<const orbit_client_data::CallstackEvent>)
 
 class CallTreeViewItemModel : public QAbstractItemModel {
   Q_OBJECT
@@ -9,6 +9,7 @@
 #include <absl/flags/flag.h>
 #include <absl/flags/internal/flag.h>
 #include <absl/strings/match.h>
+#include <absl/types/span.h>
 #include <math.h>
 #include <stdint.h>
 
@@ -570,10 +571,10 @@ static void GetCallstackEventsUnderSelectionRecursively(
     absl::flat_hash_set<QModelIndex, QModelIndexHash>* indices_already_visited) {
   indices_already_visited->emplace(index);
 
-  const auto* index_callstack_events =
+  const auto index_callstack_events =
       index.data(CallTreeViewItemModel::kExclusiveCallstackEventsRole)
-          .value<const std::vector<orbit_client_data::CallstackEvent>*>();
-  for (const orbit_client_data::CallstackEvent& index_callstack_event : *index_callstack_events) {
+          .value<absl::Span<const orbit_client_data::CallstackEvent>>();
+  for (const orbit_client_data::CallstackEvent& index_callstack_event : index_callstack_events) {
     callstack_events->emplace(index_callstack_event);
   }
 
@@ -11,11 +11,13 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "GrpcProtos/process.pb.h"
 #include "GrpcProtos/services.pb.h"
+#include "GrpcProtos/symbol.pb.h"
 #include "ModuleUtils/ReadLinuxModules.h"
 #include "OrbitBase/Logging.h"
 #include "OrbitBase/NotFoundOr.h"
@@ -25,6 +27,7 @@
 namespace orbit_process_service {
 
 using grpc::ServerContext;
+using grpc::ServerWriter;
 using grpc::Status;
 using grpc::StatusCode;
 
@@ -34,10 +37,13 @@ using orbit_grpc_protos::GetDebugInfoFileRequest;
 using orbit_grpc_protos::GetDebugInfoFileResponse;
 using orbit_grpc_protos::GetModuleListRequest;
 using orbit_grpc_protos::GetModuleListResponse;
+using orbit_grpc_protos::GetModuleSymbolsRequest;
+using orbit_grpc_protos::GetModuleSymbolsResponse;
 using orbit_grpc_protos::GetProcessListRequest;
 using orbit_grpc_protos::GetProcessListResponse;
 using orbit_grpc_protos::GetProcessMemoryRequest;
 using orbit_grpc_protos::GetProcessMemoryResponse;
+using orbit_grpc_protos::ModuleSymbols;
 using orbit_grpc_protos::ProcessInfo;
 
 Status ProcessServiceImpl::GetProcessList(ServerContext* /*context*/,
@@ -122,4 +128,33 @@ Status ProcessServiceImpl::GetDebugInfoFile(ServerContext* /*context*/,
   return Status::OK;
 }
 
+Status ProcessServiceImpl::GetModuleSymbols(ServerContext* context,
+                                            const GetModuleSymbolsRequest* request,
+                                            ServerWriter<GetModuleSymbolsResponse>* writer) {
+  ORBIT_CHECK(request != nullptr);
+  ORBIT_LOG("Loading symbols of \"%s\" for the client", request->module_path());
+
+  ErrorMessageOr<NotFoundOr<ModuleSymbols>> load_result_or_error = LoadModuleSymbols(*request);
+  if (load_result_or_error.has_error()) {
+    return {StatusCode::UNKNOWN, load_result_or_error.error().message()};
+  }
+  NotFoundOr<ModuleSymbols>& load_result = load_result_or_error.value();
+  if (orbit_base::IsNotFound(load_result)) {
+    return {StatusCode::NOT_FOUND, orbit_base::GetNotFoundMessage(load_result)};
+  }
+  ModuleSymbols module_symbols = orbit_base::GetFound(std::move(load_result));
+
+  // Symbol names are long and repetitive, so they compress well.
+  context->set_compression_algorithm(GRPC_COMPRESS_GZIP);
+
+  const std::vector<GetModuleSymbolsResponse> responses =
+      SplitModuleSymbolsIntoResponses(std::move(module_symbols), kMaxGetModuleSymbolsResponseSize);
+  for (const GetModuleSymbolsResponse& response : responses) {
+    if (!writer->Write(response)) {
+      return {StatusCode::CANCELLED, "The client stopped receiving the symbols."};
+    }
+  }
+  return Status::OK;
+}
+
 }  // namespace orbit_process_service
@@ -11,6 +11,7 @@
 #include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/str_split.h>
+#include <google/protobuf/io/coded_stream.h>
 #include <sys/uio.h>
 
 #include <algorithm>
@@ -39,6 +40,7 @@
 #include "SymbolProvider/ModuleIdentifier.h"
 #include "SymbolProvider/StructuredDebugDirectorySymbolProvider.h"
 #include "SymbolProvider/SymbolLoadingOutcome.h"
+#include "Symbols/SymbolHelper.h"
 #include "Symbols/SymbolUtils.h"
 #include "absl/strings/str_format.h"
 
@@ -342,6 +344,58 @@ ErrorMessageOr<orbit_base::NotFoundOr<fs::path>> FindSymbolsFilePath(
   return orbit_base::NotFound{not_found_message_for_client};
 }
 
+ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>> LoadModuleSymbols(
+    const orbit_grpc_protos::GetModuleSymbolsRequest& request) {
+  // The client identifies the module by path and build id, but the file at that path might have
+  // been replaced in the meantime.
+  if (!request.build_id().empty()) {
+    OUTCOME_TRY(std::unique_ptr<orbit_object_utils::ObjectFile> object_file,
+                CreateObjectFile(request.module_path()));
+    if (object_file->GetBuildId() != request.build_id()) {
+      return ErrorMessage{absl::StrFormat(
+          "Module \"%s\" on the instance has a different build id than the module requested by "
+          "the client: \"%s\" != \"%s\"",
+          request.module_path(), object_file->GetBuildId(), request.build_id())};
+    }
+  }
+
+  orbit_grpc_protos::GetDebugInfoFileRequest debug_info_file_request;
+  debug_info_file_request.set_module_path(request.module_path());
+  *debug_info_file_request.mutable_additional_search_directories() =
+      request.additional_search_directories();
+  OUTCOME_TRY(orbit_base::NotFoundOr<fs::path> find_result,
+              FindSymbolsFilePath(debug_info_file_request));
+  if (orbit_base::IsNotFound(find_result)) {
+    return orbit_base::NotFound{orbit_base::GetNotFoundMessage(find_result)};
+  }
+
+  OUTCOME_TRY(orbit_grpc_protos::ModuleSymbols module_symbols,
+              orbit_symbols::SymbolHelper::LoadSymbolsFromFile(
+                  orbit_base::GetFound(find_result),
+                  orbit_object_utils::ObjectFileInfo{request.load_bias()}));
+  return module_symbols;
+}
+
+std::vector<orbit_grpc_protos::GetModuleSymbolsResponse> SplitModuleSymbolsIntoResponses(
+    orbit_grpc_protos::ModuleSymbols module_symbols, size_t max_response_size) {
+  std::vector<orbit_grpc_protos::GetModuleSymbolsResponse> responses;
+  size_t response_size = 0;
+  for (orbit_grpc_protos::SymbolInfo& symbol_info : *module_symbols.mutable_symbol_infos()) {
+    // Each element of `symbol_infos` is serialized with a one-byte tag and its size as a varint.
+    const size_t symbol_info_size = symbol_info.ByteSizeLong();
+    const size_t field_size =
+        1 + google::protobuf::io::CodedOutputStream::VarintSize64(symbol_info_size) +
+        symbol_info_size;
+    if (responses.empty() || response_size + field_size > max_response_size) {
+      responses.emplace_back();
+      response_size = 0;
+    }
+    *responses.back().add_symbol_infos() = std::move(symbol_info);
+    response_size += field_size;
+  }
+  return responses;
+}
+
 bool ReadProcessMemory(uint32_t pid, uintptr_t address, void* buffer, uint64_t size,
                        uint64_t* num_bytes_read) {
   iovec local_iov[] = {{buffer, size}};
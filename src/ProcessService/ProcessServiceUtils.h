@@ -5,6 +5,7 @@
 #ifndef PROCESS_SERVICE_PROCESS_SERVICE_UTILS_H_
 #define PROCESS_SERVICE_PROCESS_SERVICE_UTILS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <ctime>
@@ -19,6 +20,7 @@
 
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/services.pb.h"
+#include "GrpcProtos/symbol.pb.h"
 #include "GrpcProtos/tracepoint.pb.h"
 #include "OrbitBase/NotFoundOr.h"
 #include "OrbitBase/Result.h"
@@ -33,6 +35,14 @@ std::optional<orbit_process_service_internal::Jiffies> GetCumulativeCpuTimeFromP
 // success. In the success case it returns the symbol file path.
 ErrorMessageOr<orbit_base::NotFoundOr<std::filesystem::path>> FindSymbolsFilePath(
     const orbit_grpc_protos::GetDebugInfoFileRequest& request);
+// Finds the symbols file of a module on the instance like FindSymbolsFilePath, and loads the
+// symbols from it, so that they can be sent to the client without the file itself.
+ErrorMessageOr<orbit_base::NotFoundOr<orbit_grpc_protos::ModuleSymbols>> LoadModuleSymbols(
+    const orbit_grpc_protos::GetModuleSymbolsRequest& request);
+// Splits the symbols into responses of at most `max_response_size` bytes once serialized, in order.
+// A symbol that is larger on its own gets a response of its own.
+std::vector<orbit_grpc_protos::GetModuleSymbolsResponse> SplitModuleSymbolsIntoResponses(
+    orbit_grpc_protos::ModuleSymbols module_symbols, size_t max_response_size);
 bool ReadProcessMemory(uint32_t pid, uintptr_t address, void* buffer, uint64_t size,
                        uint64_t* num_bytes_read);
 
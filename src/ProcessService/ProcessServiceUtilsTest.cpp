@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "GrpcProtos/services.pb.h"
+#include "GrpcProtos/symbol.pb.h"
 #include "GrpcProtos/tracepoint.pb.h"
 #include "OrbitBase/NotFoundOr.h"
 #include "OrbitBase/Result.h"
@@ -29,6 +30,9 @@ namespace orbit_process_service {
 
 using orbit_base::NotFoundOr;
 using orbit_grpc_protos::GetDebugInfoFileRequest;
+using orbit_grpc_protos::GetModuleSymbolsRequest;
+using orbit_grpc_protos::GetModuleSymbolsResponse;
+using orbit_grpc_protos::ModuleSymbols;
 using orbit_test_utils::HasError;
 using orbit_test_utils::HasValue;
 
@@ -155,4 +159,77 @@ TEST(ProcessServiceUtils, FindSymbolsFilePath) {
   }
 }
 
+TEST(ProcessServiceUtils, LoadModuleSymbols) {
+  const std::filesystem::path test_directory = orbit_test::GetTestdataDir();
+
+  {  // elf - separate file
+    GetModuleSymbolsRequest request;
+    request.set_module_path((test_directory / "no_symbols_elf").string());
+    request.set_build_id("b5413574bbacec6eacb3b89b1012d0e2cd92ec6b");
+    request.add_additional_search_directories(test_directory);
+    const ErrorMessageOr<NotFoundOr<ModuleSymbols>> result = LoadModuleSymbols(request);
+    ASSERT_THAT(result, HasValue());
+    ASSERT_FALSE(orbit_base::IsNotFound(result.value()));
+    const ModuleSymbols& module_symbols = orbit_base::GetFound(result.value());
+    EXPECT_TRUE(std::any_of(module_symbols.symbol_infos().begin(),
+                            module_symbols.symbol_infos().end(),
+                            [](const orbit_grpc_protos::SymbolInfo& symbol_info) {
+                              return symbol_info.demangled_name() == "main";
+                            }));
+  }
+
+  {  // elf - different build id
+    GetModuleSymbolsRequest request;
+    request.set_module_path((test_directory / "no_symbols_elf").string());
+    request.set_build_id("0000000000000000000000000000000000000000");
+    request.add_additional_search_directories(test_directory);
+    EXPECT_THAT(LoadModuleSymbols(request), HasError("different build id"));
+  }
+
+  {  // elf - no build id, no symbols
+    GetModuleSymbolsRequest request;
+    request.set_module_path((test_directory / "no_symbols_no_build_id").string());
+    request.add_additional_search_directories(test_directory);
+    const ErrorMessageOr<NotFoundOr<ModuleSymbols>> result = LoadModuleSymbols(request);
+    ASSERT_THAT(result, HasValue());
+    EXPECT_TRUE(orbit_base::IsNotFound(result.value()));
+  }
+}
+
+TEST(ProcessServiceUtils, SplitModuleSymbolsIntoResponses) {
+  constexpr size_t kMaxResponseSize = 64 * 1024;
+  // Long names, like the ones of templates, make the size of the symbols vary a lot.
+  ModuleSymbols module_symbols;
+  for (int i = 0; i < 1000; ++i) {
+    orbit_grpc_protos::SymbolInfo* symbol_info = module_symbols.add_symbol_infos();
+    symbol_info->set_demangled_name(std::string(100 + (i % 10) * 500, 'a') + std::to_string(i));
+    symbol_info->set_address(0x1000 + i);
+    symbol_info->set_size(1);
+  }
+  // A symbol that doesn't fit in a response on its own.
+  module_symbols.mutable_symbol_infos(500)->set_demangled_name(
+      std::string(kMaxResponseSize, 'b'));
+  const ModuleSymbols expected_symbols = module_symbols;
+
+  const std::vector<GetModuleSymbolsResponse> responses =
+      SplitModuleSymbolsIntoResponses(module_symbols, kMaxResponseSize);
+  ASSERT_GT(responses.size(), 1);
+  int symbol_index = 0;
+  for (const GetModuleSymbolsResponse& response : responses) {
+    ASSERT_GT(response.symbol_infos_size(), 0);
+    if (response.symbol_infos_size() > 1) {
+      EXPECT_LE(response.ByteSizeLong(), kMaxResponseSize);
+    }
+    for (const orbit_grpc_protos::SymbolInfo& symbol_info : response.symbol_infos()) {
+      ASSERT_LT(symbol_index, expected_symbols.symbol_infos_size());
+      EXPECT_EQ(symbol_info.SerializeAsString(),
+                expected_symbols.symbol_infos(symbol_index).SerializeAsString());
+      ++symbol_index;
+    }
+  }
+  EXPECT_EQ(symbol_index, expected_symbols.symbol_infos_size());
+
+  EXPECT_TRUE(SplitModuleSymbolsIntoResponses(ModuleSymbols{}, kMaxResponseSize).empty());
+}
+
 }  // namespace orbit_process_service
@@ -36,11 +36,18 @@ class ProcessServiceImpl final : public orbit_grpc_protos::ProcessService::Servi
       grpc::ServerContext* context, const orbit_grpc_protos::GetDebugInfoFileRequest* request,
       orbit_grpc_protos::GetDebugInfoFileResponse* response) override;
 
+  [[nodiscard]] grpc::Status GetModuleSymbols(
+      grpc::ServerContext* context, const orbit_grpc_protos::GetModuleSymbolsRequest* request,
+      grpc::ServerWriter<orbit_grpc_protos::GetModuleSymbolsResponse>* writer) override;
+
  private:
   absl::Mutex mutex_;
   orbit_process_service_internal::ProcessList process_list_;
 
   static constexpr size_t kMaxGetProcessMemoryResponseSize = 8 * 1024 * 1024;
+  // Keeps each streamed message of symbols well below the 4 MB maximum size of received messages of
+  // the client's channel, which uses gRPC's default.
+  static constexpr size_t kMaxGetModuleSymbolsResponseSize = 1024 * 1024;
 };
 
 }  // namespace orbit_process_service
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "InternPool.h"
+
+#include <absl/hash/hash.h>
+#include <xxhash.h>
+
+namespace orbit_producer_event_processor {
+
+Fingerprint ComputeFingerprint(const void* data, size_t size, const Fingerprint& seed) {
+  // Two 64-bit hashes with unrelated seeds make up the 128 bits.
+  constexpr uint64_t kLowSeed = 0x9E3779B97F4A7C15;
+  constexpr uint64_t kHighSeed = 0xC2B2AE3D27D4EB4F;
+  return Fingerprint{XXH64(data, size, seed.low ^ kLowSeed),
+                     XXH64(data, size, seed.high ^ kHighSeed)};
+}
+
+bool ProducerInternIdMap::Insert(uint64_t producer_id, uint64_t producer_key, uint64_t client_id) {
+  Shard& shard = shards_[GetShardIndex(producer_id, producer_key)];
+  absl::MutexLock lock{&shard.mutex};
+  return shard.producer_key_to_client_id.try_emplace({producer_id, producer_key}, client_id)
+      .second;
+}
+
+std::optional<uint64_t> ProducerInternIdMap::Find(uint64_t producer_id,
+                                                  uint64_t producer_key) const {
+  const Shard& shard = shards_[GetShardIndex(producer_id, producer_key)];
+  absl::ReaderMutexLock lock{&shard.mutex};
+  auto it = shard.producer_key_to_client_id.find({producer_id, producer_key});
+  if (it == shard.producer_key_to_client_id.end()) return std::nullopt;
+  return it->second;
+}
+
+size_t ProducerInternIdMap::GetShardIndex(uint64_t producer_id, uint64_t producer_key) {
+  // The flat_hash_map of each shard takes the 7-bit tags of its slots from the low bits of the same
+  // hash, so the shard comes from the high bits: otherwise all keys of a shard share part of a tag.
+  constexpr int kShardIndexBits = 4;
+  static_assert(size_t{1} << kShardIndexBits == kShardCount);
+  const uint64_t hash = absl::Hash<std::pair<uint64_t, uint64_t>>{}({producer_id, producer_key});
+  return static_cast<size_t>(hash >> (64 - kShardIndexBits));
+}
+
+}  // namespace orbit_producer_event_processor
@@ -0,0 +1,129 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
+#define PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
+
+#include <absl/base/thread_annotations.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/inlined_vector.h>
+#include <absl/synchronization/mutex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace orbit_producer_event_processor {
+
+// 128-bit hash of the content of an entry. Equal entries have equal fingerprints, different entries
+// have different fingerprints with overwhelming probability.
+struct Fingerprint {
+  uint64_t low = 0;
+  uint64_t high = 0;
+
+  friend bool operator==(const Fingerprint& lhs, const Fingerprint& rhs) {
+    return lhs.low == rhs.low && lhs.high == rhs.high;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const Fingerprint& fingerprint) {
+    // The bits are already well mixed, no need to hash the whole fingerprint again.
+    return H::combine(std::move(h), fingerprint.low);
+  }
+};
+
+// Computes the fingerprint of `size` bytes at `data`. Fingerprints of entries made of several
+// parts can be computed by passing the fingerprint of the previous parts as `seed`.
+[[nodiscard]] Fingerprint ComputeFingerprint(const void* data, size_t size,
+                                             const Fingerprint& seed = {});
+
+// Thread-safe pool that assigns unique ids, starting from 1, to entries of type T.
+//
+// Entries are looked up by their Fingerprint, which callers compute in place from whatever
+// representation of the entry they have, so that no T needs to be constructed unless the entry is
+// new. The pool is split into shards, each with its own lock. Looking up an entry that is already
+// in the pool, which is by far the most common case, only takes a shared lock on its shard.
+template <typename T>
+class InternPool final {
+ public:
+  InternPool() = default;
+
+  // Returns pair of <id, assigned>, where assigned is true if the entry was assigned a new id
+  // and false if returning id for already existing entry.
+  // `equals(const T&)` confirms that a stored entry with the same fingerprint is the one we are
+  // looking for; `create()` returns the T to store and is only called for a new entry.
+  template <typename Equals, typename Create>
+  std::pair<uint64_t, bool> GetOrAssignId(const Fingerprint& fingerprint, Equals&& equals,
+                                          Create&& create) {
+    Shard& shard = shards_[fingerprint.high % kShardCount];
+    {
+      absl::ReaderMutexLock lock{&shard.mutex};
+      std::optional<uint64_t> id = FindInShard(shard, fingerprint, equals);
+      if (id.has_value()) return std::make_pair(id.value(), false);
+    }
+
+    absl::MutexLock lock{&shard.mutex};
+    // Another thread might have added the entry between the two critical sections.
+    std::optional<uint64_t> id = FindInShard(shard, fingerprint, equals);
+    if (id.has_value()) return std::make_pair(id.value(), false);
+
+    uint64_t new_id = id_counter_.fetch_add(1, std::memory_order_relaxed);
+    shard.fingerprint_to_entries[fingerprint].emplace_back(create(), new_id);
+    return std::make_pair(new_id, true);
+  }
+
+ private:
+  static constexpr size_t kShardCount = 64;
+
+  struct Shard {
+    absl::Mutex mutex;
+    // Several entries only share a vector in case of a fingerprint collision.
+    absl::flat_hash_map<Fingerprint, absl::InlinedVector<std::pair<T, uint64_t>, 1>>
+        fingerprint_to_entries ABSL_GUARDED_BY(mutex);
+  };
+
+  template <typename Equals>
+  static std::optional<uint64_t> FindInShard(const Shard& shard, const Fingerprint& fingerprint,
+                                             Equals& equals)
+      ABSL_SHARED_LOCKS_REQUIRED(shard.mutex) {
+    auto it = shard.fingerprint_to_entries.find(fingerprint);
+    if (it == shard.fingerprint_to_entries.end()) return std::nullopt;
+    for (const auto& [entry, id] : it->second) {
+      if (equals(entry)) return id;
+    }
+    return std::nullopt;
+  }
+
+  std::array<Shard, kShardCount> shards_;
+  std::atomic<uint64_t> id_counter_ = 1;  // 0 is reserved for invalid_id
+};
+
+// Thread-safe map from the keys producers use for their interned entries, which are only unique
+// per producer, to the ids assigned by an InternPool. Sharded like InternPool.
+class ProducerInternIdMap final {
+ public:
+  // Returns false if there already is a mapping for <producer_id, producer_key>.
+  bool Insert(uint64_t producer_id, uint64_t producer_key, uint64_t client_id);
+  [[nodiscard]] std::optional<uint64_t> Find(uint64_t producer_id, uint64_t producer_key) const;
+
+ private:
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<std::pair<uint64_t, uint64_t>, uint64_t> producer_key_to_client_id
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  [[nodiscard]] static size_t GetShardIndex(uint64_t producer_id, uint64_t producer_key);
+
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace orbit_producer_event_processor
+
+#endif  // PRODUCER_EVENT_PROCESSOR_INTERN_POOL_H_
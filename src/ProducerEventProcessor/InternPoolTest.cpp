@@ -0,0 +1,89 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InternPool.h"
+
+namespace orbit_producer_event_processor {
+
+namespace {
+
+std::pair<uint64_t, bool> GetOrAssignId(InternPool<std::string>& pool, const std::string& str) {
+  return pool.GetOrAssignId(
+      ComputeFingerprint(str.data(), str.size()),
+      [&str](const std::string& entry) { return entry == str; }, [&str] { return str; });
+}
+
+}  // namespace
+
+TEST(InternPool, AssignsIdsStartingFromOne) {
+  InternPool<std::string> pool;
+  EXPECT_EQ(GetOrAssignId(pool, "a"), std::make_pair(uint64_t{1}, true));
+  EXPECT_EQ(GetOrAssignId(pool, "b"), std::make_pair(uint64_t{2}, true));
+  EXPECT_EQ(GetOrAssignId(pool, "a"), std::make_pair(uint64_t{1}, false));
+  EXPECT_EQ(GetOrAssignId(pool, "b"), std::make_pair(uint64_t{2}, false));
+}
+
+TEST(InternPool, DistinguishesEntriesWithTheSameFingerprint) {
+  InternPool<std::string> pool;
+  constexpr Fingerprint kFingerprint{1, 2};
+  auto get_or_assign_id = [&pool, kFingerprint](const std::string& str) {
+    return pool.GetOrAssignId(
+        kFingerprint, [&str](const std::string& entry) { return entry == str; },
+        [&str] { return str; });
+  };
+  EXPECT_EQ(get_or_assign_id("a"), std::make_pair(uint64_t{1}, true));
+  EXPECT_EQ(get_or_assign_id("b"), std::make_pair(uint64_t{2}, true));
+  EXPECT_EQ(get_or_assign_id("a"), std::make_pair(uint64_t{1}, false));
+  EXPECT_EQ(get_or_assign_id("b"), std::make_pair(uint64_t{2}, false));
+}
+
+TEST(InternPool, ConcurrentThreadsAgreeOnIds) {
+  constexpr size_t kThreadCount = 8;
+  constexpr size_t kEntryCount = 10'000;
+  InternPool<std::string> pool;
+
+  std::vector<std::vector<uint64_t>> ids_by_thread(kThreadCount);
+  std::vector<std::vector<bool>> assigned_by_thread(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < kThreadCount; ++thread_index) {
+    threads.emplace_back([&, thread_index] {
+      for (size_t entry = 0; entry < kEntryCount; ++entry) {
+        auto [id, assigned] = GetOrAssignId(pool, std::to_string(entry));
+        ids_by_thread[thread_index].push_back(id);
+        assigned_by_thread[thread_index].push_back(assigned);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  for (size_t entry = 0; entry < kEntryCount; ++entry) {
+    size_t assigned_count = 0;
+    for (size_t thread_index = 0; thread_index < kThreadCount; ++thread_index) {
+      EXPECT_EQ(ids_by_thread[thread_index][entry], ids_by_thread[0][entry]);
+      if (assigned_by_thread[thread_index][entry]) ++assigned_count;
+    }
+    EXPECT_EQ(assigned_count, 1);
+  }
+  EXPECT_EQ(GetOrAssignId(pool, "new"), std::make_pair(uint64_t{kEntryCount + 1}, true));
+}
+
+TEST(ProducerInternIdMap, InsertAndFind) {
+  ProducerInternIdMap map;
+  EXPECT_TRUE(map.Insert(1, 13, 42));
+  EXPECT_TRUE(map.Insert(2, 13, 43));
+  EXPECT_FALSE(map.Insert(1, 13, 44));
+
+  EXPECT_EQ(map.Find(1, 13), 42);
+  EXPECT_EQ(map.Find(2, 13), 43);
+  EXPECT_FALSE(map.Find(3, 13).has_value());
+}
+
+}  // namespace orbit_producer_event_processor
@@ -6,7 +6,15 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 #include "GrpcProtos/capture.pb.h"
+#include "InternPool.h"
 #include "OrbitBase/Logging.h"
 
 using orbit_grpc_protos::AddressInfo;
@@ -55,6 +63,7 @@ using orbit_grpc_protos::ThreadNamesSnapshot;
 using orbit_grpc_protos::ThreadStateSlice;
 using orbit_grpc_protos::ThreadStateSliceCallstack;
 using orbit_grpc_protos::TracepointEvent;
+using orbit_grpc_protos::TracepointInfo;
 using orbit_grpc_protos::WarningEvent;
 using orbit_grpc_protos::WarningInstrumentingWithUprobesEvent;
 using orbit_grpc_protos::WarningInstrumentingWithUserSpaceInstrumentationEvent;
@@ -63,32 +72,6 @@ namespace orbit_producer_event_processor {
 
 namespace {
 
-template <typename T>
-class InternPool final {
- public:
-  InternPool() = default;
-
-  // Return pair of <id, assigned>, where assigned is true if the entry was assigned a new id
-  // and false if returning id for already existing entry.
-  std::pair<uint64_t, bool> GetOrAssignId(const T& entry) {
-    absl::MutexLock lock(&entry_to_id_mutex_);
-    auto it = entry_to_id_.find(entry);
-    if (it != entry_to_id_.end()) {
-      return std::make_pair(it->second, false);
-    }
-
-    uint64_t new_id = id_counter_++;
-    auto [unused_it, inserted] = entry_to_id_.insert_or_assign(entry, new_id);
-    ORBIT_CHECK(inserted);
-    return std::make_pair(new_id, true);
-  }
-
- private:
-  uint64_t id_counter_ = 1;  // 0 is reserved for invalid_id
-  absl::flat_hash_map<T, uint64_t> entry_to_id_;
-  absl::Mutex entry_to_id_mutex_;
-};
-
 class ProducerEventProcessorImpl : public ProducerEventProcessor {
  public:
   ProducerEventProcessorImpl() = delete;
@@ -156,6 +139,12 @@ class ProducerEventProcessorImpl : public ProducerEventProcessor {
       WarningInstrumentingWithUserSpaceInstrumentationEvent* warning_event);
 
   void SendInternedStringEvent(uint64_t key, std::string value);
+
+  // The following compute the fingerprint of the entry in place and only copy the entry when it is
+  // new to the pool.
+  std::pair<uint64_t, bool> GetOrAssignCallstackId(const Callstack& callstack);
+  std::pair<uint64_t, bool> GetOrAssignStringId(std::string_view str);
+  std::pair<uint64_t, bool> GetOrAssignTracepointId(const TracepointInfo& tracepoint_info);
   void MergeThreadStateSliceWithCallstackAndTransferOwnership(ThreadStateSlice* thread_state_slice);
 
   ClientCaptureEventCollector* client_capture_event_collector_;
@@ -167,11 +156,9 @@ class ProducerEventProcessorImpl : public ProducerEventProcessor {
   // These are mapping InternStrings and InternedCallstacks from producer ids
   // to client ids:
   // <producer_id, producer_callstack_id> -> client_callstack_id
-  absl::flat_hash_map<std::pair<uint64_t, uint64_t>, uint64_t>
-      producer_interned_callstack_id_to_client_callstack_id_;
+  ProducerInternIdMap producer_interned_callstack_id_to_client_callstack_id_;
   // <producer_id, producer_string_id> -> client_string_id
-  absl::flat_hash_map<std::pair<uint64_t, uint64_t>, uint64_t>
-      producer_interned_string_id_to_client_string_id_;
+  ProducerInternIdMap producer_interned_string_id_to_client_string_id_;
 
   // Needed to allow merging of thread state slices and their callstacks, see:
   // http://go/stadia-orbit-tracepoint-callstack.
@@ -309,11 +296,12 @@ void ProducerEventProcessorImpl::ProcessApiTrackUint64AndTransferOwnership(
 void ProducerEventProcessorImpl::ProcessCallstackSampleAndTransferOwnership(
     uint64_t producer_id, CallstackSample* callstack_sample) {
   // translate producer id to client id
-  auto it = producer_interned_callstack_id_to_client_callstack_id_.find(
-      {producer_id, callstack_sample->callstack_id()});
+  std::optional<uint64_t> client_callstack_id =
+      producer_interned_callstack_id_to_client_callstack_id_.Find(
+          producer_id, callstack_sample->callstack_id());
   // TODO(b/180235290): replace with error message
-  ORBIT_CHECK(it != producer_interned_callstack_id_to_client_callstack_id_.end());
-  callstack_sample->set_callstack_id(it->second);
+  ORBIT_CHECK(client_callstack_id.has_value());
+  callstack_sample->set_callstack_id(client_callstack_id.value());
 
   ClientCaptureEvent event;
   event.set_allocated_callstack_sample(callstack_sample);
@@ -372,10 +360,7 @@ void ProducerEventProcessorImpl::ProcessErrorsWithPerfEventOpenEventAndTransferO
 
 void ProducerEventProcessorImpl::ProcessFullCallstackSample(
     FullCallstackSample* full_callstack_sample) {
-  const Callstack& callstack = full_callstack_sample->callstack();
-  std::pair<std::vector<uint64_t>, Callstack::CallstackType> callstack_data{
-      {callstack.pcs().begin(), callstack.pcs().end()}, callstack.type()};
-  auto [callstack_id, assigned] = callstack_pool_.GetOrAssignId(callstack_data);
+  auto [callstack_id, assigned] = GetOrAssignCallstackId(full_callstack_sample->callstack());
 
   if (assigned) {
     ClientCaptureEvent interned_callstack_event;
@@ -396,13 +381,13 @@ void ProducerEventProcessorImpl::ProcessFullCallstackSample(
 
 void ProducerEventProcessorImpl::ProcessFullAddressInfo(FullAddressInfo* full_address_info) {
   auto [function_name_key, function_key_assigned] =
-      string_pool_.GetOrAssignId(full_address_info->function_name());
+      GetOrAssignStringId(full_address_info->function_name());
   if (function_key_assigned) {
     SendInternedStringEvent(function_name_key, full_address_info->function_name());
   }
 
   auto [module_name_key, module_key_assigned] =
-      string_pool_.GetOrAssignId(full_address_info->module_name());
+      GetOrAssignStringId(full_address_info->module_name());
   if (module_key_assigned) {
     SendInternedStringEvent(module_name_key, full_address_info->module_name());
   }
@@ -418,7 +403,7 @@ void ProducerEventProcessorImpl::ProcessFullAddressInfo(FullAddressInfo* full_ad
 }
 
 void ProducerEventProcessorImpl::ProcessFullGpuJob(FullGpuJob* full_gpu_job_event) {
-  auto [timeline_key, assigned] = string_pool_.GetOrAssignId(full_gpu_job_event->timeline());
+  auto [timeline_key, assigned] = GetOrAssignStringId(full_gpu_job_event->timeline());
   if (assigned) {
     SendInternedStringEvent(timeline_key, full_gpu_job_event->timeline());
   }
@@ -442,8 +427,7 @@ void ProducerEventProcessorImpl::ProcessFullGpuJob(FullGpuJob* full_gpu_job_even
 void ProducerEventProcessorImpl::ProcessFullTracepointEvent(
     FullTracepointEvent* full_tracepoint_event) {
   auto [tracepoint_key, assigned] =
-      tracepoint_pool_.GetOrAssignId({full_tracepoint_event->tracepoint_info().category(),
-                                      full_tracepoint_event->tracepoint_info().name()});
+      GetOrAssignTracepointId(full_tracepoint_event->tracepoint_info());
   if (assigned) {
     ClientCaptureEvent event;
     InternedTracepointInfo* interned_tracepoint_info = event.mutable_interned_tracepoint_info();
@@ -474,10 +458,11 @@ void ProducerEventProcessorImpl::ProcessGpuQueueSubmissionAndTransferOwnership(
     uint64_t producer_id, GpuQueueSubmission* gpu_queue_submission) {
   // Translate debug marker keys
   for (GpuDebugMarker& mutable_marker : *gpu_queue_submission->mutable_completed_markers()) {
-    auto it = producer_interned_string_id_to_client_string_id_.find(
-        {producer_id, mutable_marker.text_key()});
-    ORBIT_CHECK(it != producer_interned_string_id_to_client_string_id_.end());
-    mutable_marker.set_text_key(it->second);
+    std::optional<uint64_t> client_string_id =
+        producer_interned_string_id_to_client_string_id_.Find(producer_id,
+                                                              mutable_marker.text_key());
+    ORBIT_CHECK(client_string_id.has_value());
+    mutable_marker.set_text_key(client_string_id.value());
   }
 
   ClientCaptureEvent event;
@@ -487,17 +472,11 @@ void ProducerEventProcessorImpl::ProcessGpuQueueSubmissionAndTransferOwnership(
 
 void ProducerEventProcessorImpl::ProcessInternedCallstack(uint64_t producer_id,
                                                           InternedCallstack* interned_callstack) {
-  // TODO(b/180235290): replace with error message
-  ORBIT_CHECK(!producer_interned_callstack_id_to_client_callstack_id_.contains(
-      {producer_id, interned_callstack->key()}));
-
-  std::pair<std::vector<uint64_t>, Callstack::CallstackType> callstack_data{
-      {interned_callstack->intern().pcs().begin(), interned_callstack->intern().pcs().end()},
-      interned_callstack->intern().type()};
-  auto [interned_callstack_id, assigned] = callstack_pool_.GetOrAssignId(callstack_data);
+  auto [interned_callstack_id, assigned] = GetOrAssignCallstackId(interned_callstack->intern());
 
-  producer_interned_callstack_id_to_client_callstack_id_.insert_or_assign(
-      {producer_id, interned_callstack->key()}, interned_callstack_id);
+  // TODO(b/180235290): replace with error message
+  ORBIT_CHECK(producer_interned_callstack_id_to_client_callstack_id_.Insert(
+      producer_id, interned_callstack->key(), interned_callstack_id));
 
   if (!assigned) {
     return;
@@ -512,13 +491,11 @@ void ProducerEventProcessorImpl::ProcessInternedCallstack(uint64_t producer_id,
 
 void ProducerEventProcessorImpl::ProcessInternedString(uint64_t producer_id,
                                                        InternedString* interned_string) {
-  // TODO(b/180235290): replace with error message
-  ORBIT_CHECK(!producer_interned_string_id_to_client_string_id_.contains(
-      {producer_id, interned_string->key()}));
+  auto [client_string_id, assigned] = GetOrAssignStringId(interned_string->intern());
 
-  auto [client_string_id, assigned] = string_pool_.GetOrAssignId(interned_string->intern());
-  producer_interned_string_id_to_client_string_id_.insert_or_assign(
-      {producer_id, interned_string->key()}, client_string_id);
+  // TODO(b/180235290): replace with error message
+  ORBIT_CHECK(producer_interned_string_id_to_client_string_id_.Insert(
+      producer_id, interned_string->key(), client_string_id));
 
   if (!assigned) {
     return;
@@ -623,11 +600,8 @@ void ProducerEventProcessorImpl::ProcessWarningInstrumentingWithUprobesEventAndT
 
 void ProducerEventProcessorImpl::ProcessThreadStateSliceCallstack(
     ThreadStateSliceCallstack* thread_state_slice_callstack) {
-  const Callstack& callstack = thread_state_slice_callstack->callstack();
-
-  std::pair<std::vector<uint64_t>, Callstack::CallstackType> callstack_data{
-      {callstack.pcs().begin(), callstack.pcs().end()}, callstack.type()};
-  auto [callstack_id, assigned] = callstack_pool_.GetOrAssignId(callstack_data);
+  auto [callstack_id, assigned] =
+      GetOrAssignCallstackId(thread_state_slice_callstack->callstack());
 
   if (assigned) {
     ClientCaptureEvent interned_callstack_event;
@@ -803,6 +777,45 @@ void ProducerEventProcessorImpl::SendInternedStringEvent(uint64_t key, std::stri
   client_capture_event_collector_->AddEvent(std::move(event));
 }
 
+std::pair<uint64_t, bool> ProducerEventProcessorImpl::GetOrAssignCallstackId(
+    const Callstack& callstack) {
+  const Callstack::CallstackType type = callstack.type();
+  const auto& pcs = callstack.pcs();
+  const Fingerprint fingerprint =
+      ComputeFingerprint(pcs.data(), pcs.size() * sizeof(uint64_t),
+                         ComputeFingerprint(&type, sizeof(Callstack::CallstackType)));
+  return callstack_pool_.GetOrAssignId(
+      fingerprint,
+      [type, &pcs](const std::pair<std::vector<uint64_t>, Callstack::CallstackType>& entry) {
+        return entry.second == type &&
+               std::equal(entry.first.begin(), entry.first.end(), pcs.begin(), pcs.end());
+      },
+      [type, &pcs] {
+        return std::make_pair(std::vector<uint64_t>{pcs.begin(), pcs.end()}, type);
+      });
+}
+
+std::pair<uint64_t, bool> ProducerEventProcessorImpl::GetOrAssignStringId(std::string_view str) {
+  return string_pool_.GetOrAssignId(
+      ComputeFingerprint(str.data(), str.size()),
+      [str](const std::string& entry) { return entry == str; },
+      [str] { return std::string{str}; });
+}
+
+std::pair<uint64_t, bool> ProducerEventProcessorImpl::GetOrAssignTracepointId(
+    const TracepointInfo& tracepoint_info) {
+  const std::string& category = tracepoint_info.category();
+  const std::string& name = tracepoint_info.name();
+  const Fingerprint fingerprint = ComputeFingerprint(
+      name.data(), name.size(), ComputeFingerprint(category.data(), category.size()));
+  return tracepoint_pool_.GetOrAssignId(
+      fingerprint,
+      [&category, &name](const std::pair<std::string, std::string>& entry) {
+        return entry.first == category && entry.second == name;
+      },
+      [&category, &name] { return std::make_pair(category, name); });
+}
+
 }  // namespace
 
 std::unique_ptr<ProducerEventProcessor> ProducerEventProcessor::Create(
@@ -0,0 +1,128 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the throughput of ProducerEventProcessor::ProcessEvent when several producers send
+// interned callstacks and callstack samples referencing them at the same time.
+
+#include <absl/flags/flag.h>
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "GrpcProtos/capture.pb.h"
+#include "OrbitBase/Logging.h"
+#include "ProducerEventProcessor/ClientCaptureEventCollector.h"
+#include "ProducerEventProcessor/ProducerEventProcessor.h"
+
+ABSL_FLAG(uint32_t, producers, 4, "Number of producers sending events concurrently");
+ABSL_FLAG(uint64_t, callstacks, 100'000,
+          "Number of distinct callstacks; each producer interns all of them");
+ABSL_FLAG(uint64_t, samples, 2'000'000, "Number of callstack samples sent by each producer");
+ABSL_FLAG(uint32_t, frames, 32, "Number of frames of each callstack");
+
+namespace {
+
+using orbit_grpc_protos::Callstack;
+using orbit_grpc_protos::ClientCaptureEvent;
+using orbit_grpc_protos::ProducerCaptureEvent;
+
+// Only counts the events, so that the benchmark measures the ProducerEventProcessor alone.
+class CountingClientCaptureEventCollector
+    : public orbit_producer_event_processor::ClientCaptureEventCollector {
+ public:
+  void AddEvent(ClientCaptureEvent&& /*event*/) override {
+    event_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void StopAndWait() override {}
+
+  [[nodiscard]] uint64_t event_count() const { return event_count_.load(); }
+
+ private:
+  std::atomic<uint64_t> event_count_ = 0;
+};
+
+std::vector<std::vector<uint64_t>> CreateCallstacks(uint64_t callstack_count,
+                                                    uint32_t frame_count) {
+  std::mt19937_64 random{42};
+  std::vector<std::vector<uint64_t>> callstacks(callstack_count);
+  for (std::vector<uint64_t>& frames : callstacks) {
+    frames.resize(frame_count);
+    for (uint64_t& frame : frames) frame = random();
+  }
+  return callstacks;
+}
+
+void RunProducer(orbit_producer_event_processor::ProducerEventProcessor* processor,
+                 uint64_t producer_id, const std::vector<std::vector<uint64_t>>& callstacks,
+                 uint64_t sample_count) {
+  // Each producer uses its own keys for the callstacks, in a different order than the others.
+  std::mt19937_64 random{producer_id};
+  std::vector<uint64_t> indices(callstacks.size());
+  for (uint64_t i = 0; i < indices.size(); ++i) indices[i] = i;
+  std::shuffle(indices.begin(), indices.end(), random);
+
+  for (uint64_t key = 0; key < indices.size(); ++key) {
+    ProducerCaptureEvent event;
+    auto* interned_callstack = event.mutable_interned_callstack();
+    interned_callstack->set_key(key + 1);
+    Callstack* callstack = interned_callstack->mutable_intern();
+    const std::vector<uint64_t>& frames = callstacks[indices[key]];
+    callstack->mutable_pcs()->Add(frames.begin(), frames.end());
+    callstack->set_type(Callstack::kComplete);
+    processor->ProcessEvent(producer_id, std::move(event));
+  }
+
+  std::uniform_int_distribution<uint64_t> key_distribution{1, callstacks.size()};
+  for (uint64_t i = 0; i < sample_count; ++i) {
+    ProducerCaptureEvent event;
+    auto* callstack_sample = event.mutable_callstack_sample();
+    callstack_sample->set_pid(producer_id);
+    callstack_sample->set_tid(producer_id);
+    callstack_sample->set_timestamp_ns(i);
+    callstack_sample->set_callstack_id(key_distribution(random));
+    processor->ProcessEvent(producer_id, std::move(event));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  absl::SetProgramUsageMessage(
+      "Measures the throughput of ProducerEventProcessor with several concurrent producers");
+  absl::ParseCommandLine(argc, argv);
+
+  const uint32_t producer_count = absl::GetFlag(FLAGS_producers);
+  const uint64_t sample_count = absl::GetFlag(FLAGS_samples);
+  const std::vector<std::vector<uint64_t>> callstacks =
+      CreateCallstacks(absl::GetFlag(FLAGS_callstacks), absl::GetFlag(FLAGS_frames));
+
+  CountingClientCaptureEventCollector collector;
+  std::unique_ptr<orbit_producer_event_processor::ProducerEventProcessor> processor =
+      orbit_producer_event_processor::ProducerEventProcessor::Create(&collector);
+
+  const absl::Time start = absl::Now();
+  std::vector<std::thread> producers;
+  for (uint64_t producer_id = 1; producer_id <= producer_count; ++producer_id) {
+    producers.emplace_back(RunProducer, processor.get(), producer_id, std::cref(callstacks),
+                           sample_count);
+  }
+  for (std::thread& producer : producers) producer.join();
+  const absl::Duration duration = absl::Now() - start;
+
+  const uint64_t processed_event_count = producer_count * (callstacks.size() + sample_count);
+  ORBIT_LOG("Processed %u events from %u producers in %s (%.0f events/s), %u events sent",
+            processed_event_count, producer_count, absl::FormatDuration(duration),
+            processed_event_count / absl::ToDoubleSeconds(duration), collector.event_count());
+  return 0;
+}
@@ -0,0 +1,216 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "Symbols/PreprocessedSymbolsFile.h"
+
+#include <absl/strings/str_format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "OrbitBase/Align.h"
+#include "OrbitBase/File.h"
+#include "OrbitBase/Logging.h"
+#include "OrbitBase/ThreadUtils.h"
+
+namespace fs = std::filesystem;
+using orbit_grpc_protos::ModuleSymbols;
+using orbit_grpc_protos::SymbolInfo;
+
+namespace orbit_symbols {
+
+namespace {
+
+constexpr std::string_view kMagic = "ORBITSYM";
+// Needs to be incremented whenever the format changes, so that stale files are rejected.
+constexpr uint32_t kVersion = 2;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t build_id_size;
+  uint64_t load_bias;
+  uint64_t symbol_count;
+  uint64_t names_size;
+  uint32_t source_id_size;
+  uint32_t padding;
+};
+static_assert(sizeof(Header) == 48);
+
+}  // namespace
+
+struct PreprocessedSymbolsFile::Entry {
+  uint64_t address;
+  uint64_t size;
+  uint64_t name_offset;
+  uint64_t name_size;
+};
+
+// The build id and the source id are padded so that the entries are 8-byte aligned in the file.
+[[nodiscard]] static uint64_t GetEntriesOffset(uint64_t build_id_size, uint64_t source_id_size) {
+  return orbit_base::AlignUp<8>(sizeof(Header) + build_id_size + source_id_size);
+}
+
+ErrorMessageOr<void> PreprocessedSymbolsFile::Write(const fs::path& file_path,
+                                                    std::string_view build_id,
+                                                    std::string_view source_id, uint64_t load_bias,
+                                                    const ModuleSymbols& module_symbols) {
+  const int symbol_count = module_symbols.symbol_infos_size();
+  // Sort by address, keeping the original order of symbols with the same address: consumers of
+  // ModuleSymbols give precedence to the first one.
+  std::vector<int> order(symbol_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&module_symbols](int lhs, int rhs) {
+    return module_symbols.symbol_infos(lhs).address() < module_symbols.symbol_infos(rhs).address();
+  });
+
+  std::vector<Entry> entries;
+  entries.reserve(symbol_count);
+  uint64_t names_size = 0;
+  for (int index : order) {
+    const SymbolInfo& symbol_info = module_symbols.symbol_infos(index);
+    entries.push_back(Entry{symbol_info.address(), symbol_info.size(), names_size,
+                            symbol_info.demangled_name().size()});
+    names_size += symbol_info.demangled_name().size();
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic.data(), sizeof(header.magic));
+  header.version = kVersion;
+  header.build_id_size = static_cast<uint32_t>(build_id.size());
+  header.load_bias = load_bias;
+  header.symbol_count = entries.size();
+  header.names_size = names_size;
+  header.source_id_size = static_cast<uint32_t>(source_id.size());
+
+  const uint64_t entries_offset = GetEntriesOffset(build_id.size(), source_id.size());
+  std::string contents;
+  contents.reserve(entries_offset + entries.size() * sizeof(Entry) + names_size);
+  contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  contents.append(build_id);
+  contents.append(source_id);
+  contents.resize(entries_offset, '\0');
+  contents.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+  for (int index : order) {
+    contents.append(module_symbols.symbol_infos(index).demangled_name());
+  }
+
+  // The same file can be written by several threads or processes at the same time, so each writes
+  // its own temporary file and then atomically replaces `file_path`.
+  fs::path temporary_file_path = file_path;
+  temporary_file_path += absl::StrFormat(".%u.%u.tmp", orbit_base::GetCurrentProcessId(),
+                                         orbit_base::GetCurrentThreadId());
+  {
+    OUTCOME_TRY(auto fd, orbit_base::OpenFileForWriting(temporary_file_path));
+    OUTCOME_TRY(orbit_base::WriteFully(fd, contents));
+  }
+  OUTCOME_TRY(orbit_base::MoveOrRenameFile(temporary_file_path, file_path));
+  return outcome::success();
+}
+
+ErrorMessageOr<std::unique_ptr<PreprocessedSymbolsFile>> PreprocessedSymbolsFile::Open(
+    const fs::path& file_path, std::string_view expected_build_id,
+    std::string_view expected_source_id, uint64_t expected_load_bias) {
+  // MemoryBuffer maps the file into memory unless it is small.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer_or_error =
+      llvm::MemoryBuffer::getFile(file_path.string());
+  if (!buffer_or_error) {
+    return ErrorMessage{absl::StrFormat("Unable to open \"%s\": %s", file_path.string(),
+                                        buffer_or_error.getError().message())};
+  }
+  std::unique_ptr<llvm::MemoryBuffer> buffer = std::move(buffer_or_error.get());
+  const char* data = buffer->getBufferStart();
+  const uint64_t file_size = buffer->getBufferSize();
+
+  Header header{};
+  if (file_size < sizeof(header)) {
+    return ErrorMessage{absl::StrFormat("\"%s\" is too small to be a preprocessed symbols file",
+                                        file_path.string())};
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (std::string_view(header.magic, sizeof(header.magic)) != kMagic) {
+    return ErrorMessage{
+        absl::StrFormat("\"%s\" is not a preprocessed symbols file", file_path.string())};
+  }
+  if (header.version != kVersion) {
+    return ErrorMessage{absl::StrFormat("\"%s\" has unsupported version %d (expected %d)",
+                                        file_path.string(), header.version, kVersion)};
+  }
+
+  // Check each size against what is left of the file, so that corrupted sizes cannot overflow.
+  const uint64_t entries_offset = GetEntriesOffset(header.build_id_size, header.source_id_size);
+  if (entries_offset > file_size ||
+      header.symbol_count > (file_size - entries_offset) / sizeof(Entry)) {
+    return ErrorMessage{absl::StrFormat("\"%s\" is truncated", file_path.string())};
+  }
+  const uint64_t names_offset = entries_offset + header.symbol_count * sizeof(Entry);
+  if (header.names_size != file_size - names_offset) {
+    return ErrorMessage{absl::StrFormat("\"%s\" has an unexpected size", file_path.string())};
+  }
+
+  std::string_view build_id(data + sizeof(header), header.build_id_size);
+  if (build_id != expected_build_id) {
+    return ErrorMessage{absl::StrFormat("\"%s\" has build id \"%s\" instead of \"%s\"",
+                                        file_path.string(), build_id, expected_build_id)};
+  }
+  std::string_view source_id(data + sizeof(header) + header.build_id_size, header.source_id_size);
+  if (source_id != expected_source_id) {
+    return ErrorMessage{absl::StrFormat("\"%s\" was created from \"%s\" instead of \"%s\"",
+                                        file_path.string(), source_id, expected_source_id)};
+  }
+  if (header.load_bias != expected_load_bias) {
+    return ErrorMessage{absl::StrFormat("\"%s\" has load bias %#x instead of %#x",
+                                        file_path.string(), header.load_bias, expected_load_bias)};
+  }
+
+  // The buffer is either page-aligned or allocated with 16-byte alignment, and the entries start at
+  // an 8-byte aligned offset.
+  const auto* entries = reinterpret_cast<const Entry*>(data + entries_offset);
+  std::string_view names(data + names_offset, header.names_size);
+  return std::unique_ptr<PreprocessedSymbolsFile>(new PreprocessedSymbolsFile(
+      std::move(buffer), entries, header.symbol_count, names));
+}
+
+ErrorMessageOr<PreprocessedSymbolsFile::Symbol> PreprocessedSymbolsFile::GetSymbol(
+    size_t index) const {
+  ORBIT_CHECK(index < symbol_count_);
+  const Entry& entry = entries_[index];
+  if (entry.name_offset > names_.size() || entry.name_size > names_.size() - entry.name_offset) {
+    return ErrorMessage{absl::StrFormat("The name of symbol %d is out of bounds", index)};
+  }
+  return Symbol{entry.address, entry.size, names_.substr(entry.name_offset, entry.name_size)};
+}
+
+std::optional<size_t> PreprocessedSymbolsFile::FindSymbolIndexByAddress(
+    uint64_t virtual_address) const {
+  const Entry* end = entries_ + symbol_count_;
+  const Entry* it = std::upper_bound(
+      entries_, end, virtual_address,
+      [](uint64_t address, const Entry& entry) { return address < entry.address; });
+  if (it == entries_) return std::nullopt;
+  --it;
+  if (virtual_address - it->address >= it->size) return std::nullopt;
+  // Among several symbols at the same address, the first one takes precedence.
+  while (it != entries_ && (it - 1)->address == it->address) --it;
+  return static_cast<size_t>(it - entries_);
+}
+
+ErrorMessageOr<ModuleSymbols> PreprocessedSymbolsFile::ToModuleSymbols() const {
+  ModuleSymbols module_symbols;
+  module_symbols.mutable_symbol_infos()->Reserve(static_cast<int>(symbol_count_));
+  for (size_t index = 0; index < symbol_count_; ++index) {
+    OUTCOME_TRY(const Symbol symbol, GetSymbol(index));
+    SymbolInfo* symbol_info = module_symbols.add_symbol_infos();
+    symbol_info->set_address(symbol.address);
+    symbol_info->set_size(symbol.size);
+    symbol_info->set_demangled_name(std::string{symbol.demangled_name});
+  }
+  return module_symbols;
+}
+
+}  // namespace orbit_symbols
@@ -0,0 +1,189 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <absl/strings/match.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GrpcProtos/symbol.pb.h"
+#include "OrbitBase/File.h"
+#include "OrbitBase/Result.h"
+#include "OrbitBase/TemporaryFile.h"
+#include "Symbols/PreprocessedSymbolsFile.h"
+#include "TestUtils/TestUtils.h"
+
+namespace orbit_symbols {
+
+using orbit_grpc_protos::ModuleSymbols;
+using orbit_grpc_protos::SymbolInfo;
+using orbit_test_utils::HasError;
+using orbit_test_utils::HasNoError;
+
+namespace {
+
+constexpr const char* kBuildId = "0123456789abcdef";
+constexpr const char* kSourceId = "/path/to/module.debug:1234:5678";
+constexpr uint64_t kLoadBias = 0x400000;
+
+void AddSymbol(ModuleSymbols* module_symbols, uint64_t address, uint64_t size,
+               std::string demangled_name) {
+  SymbolInfo* symbol_info = module_symbols->add_symbol_infos();
+  symbol_info->set_address(address);
+  symbol_info->set_size(size);
+  symbol_info->set_demangled_name(std::move(demangled_name));
+}
+
+class PreprocessedSymbolsFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ErrorMessageOr<orbit_base::TemporaryFile> temporary_file_or_error =
+        orbit_base::TemporaryFile::Create();
+    ASSERT_THAT(temporary_file_or_error, HasNoError());
+    temporary_file_.emplace(std::move(temporary_file_or_error.value()));
+    temporary_file_->CloseAndRemove();
+
+    AddSymbol(&module_symbols_, 0x2000, 0x10, "b()");
+    AddSymbol(&module_symbols_, 0x1000, 0x20, "a()");
+    AddSymbol(&module_symbols_, 0x3000, 0x30, "c()");
+    AddSymbol(&module_symbols_, 0x1000, 0x20, "alias_of_a()");
+  }
+
+  [[nodiscard]] const std::filesystem::path& file_path() const {
+    return temporary_file_->file_path();
+  }
+
+  std::optional<orbit_base::TemporaryFile> temporary_file_;
+  ModuleSymbols module_symbols_;
+};
+
+}  // namespace
+
+TEST_F(PreprocessedSymbolsFileTest, WriteAndOpen) {
+  ASSERT_THAT(PreprocessedSymbolsFile::Write(file_path(), kBuildId, kSourceId, kLoadBias,
+                                             module_symbols_),
+              HasNoError());
+
+  auto file_or_error = PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias);
+  ASSERT_THAT(file_or_error, HasNoError());
+  const PreprocessedSymbolsFile& file = *file_or_error.value();
+  ASSERT_EQ(file.GetSymbolCount(), 4);
+
+  // Symbols are sorted by address, keeping the order of symbols with the same address.
+  auto symbol_or_error = file.GetSymbol(1);
+  ASSERT_THAT(symbol_or_error, HasNoError());
+  EXPECT_EQ(symbol_or_error.value().address, 0x1000);
+  EXPECT_EQ(symbol_or_error.value().size, 0x20);
+  EXPECT_EQ(symbol_or_error.value().demangled_name, "alias_of_a()");
+
+  ErrorMessageOr<ModuleSymbols> module_symbols_or_error = file.ToModuleSymbols();
+  ASSERT_THAT(module_symbols_or_error, HasNoError());
+  const ModuleSymbols& module_symbols = module_symbols_or_error.value();
+  ASSERT_EQ(module_symbols.symbol_infos_size(), 4);
+  EXPECT_EQ(module_symbols.symbol_infos(0).demangled_name(), "a()");
+  EXPECT_EQ(module_symbols.symbol_infos(1).demangled_name(), "alias_of_a()");
+  EXPECT_EQ(module_symbols.symbol_infos(2).demangled_name(), "b()");
+  EXPECT_EQ(module_symbols.symbol_infos(3).demangled_name(), "c()");
+  EXPECT_EQ(module_symbols.symbol_infos(3).address(), 0x3000);
+  EXPECT_EQ(module_symbols.symbol_infos(3).size(), 0x30);
+}
+
+TEST_F(PreprocessedSymbolsFileTest, FindSymbolIndexByAddress) {
+  ASSERT_THAT(PreprocessedSymbolsFile::Write(file_path(), kBuildId, kSourceId, kLoadBias,
+                                             module_symbols_),
+              HasNoError());
+  auto file_or_error = PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias);
+  ASSERT_THAT(file_or_error, HasNoError());
+  const PreprocessedSymbolsFile& file = *file_or_error.value();
+
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0xfff), std::nullopt);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x1000), 0);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x101f), 0);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x1020), std::nullopt);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x2008), 2);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x302f), 3);
+  EXPECT_EQ(file.FindSymbolIndexByAddress(0x3030), std::nullopt);
+}
+
+TEST_F(PreprocessedSymbolsFileTest, EmptyModuleSymbols) {
+  ASSERT_THAT(PreprocessedSymbolsFile::Write(file_path(), "", "", 0, ModuleSymbols{}),
+              HasNoError());
+  auto file_or_error = PreprocessedSymbolsFile::Open(file_path(), "", "", 0);
+  ASSERT_THAT(file_or_error, HasNoError());
+  EXPECT_EQ(file_or_error.value()->GetSymbolCount(), 0);
+  EXPECT_EQ(file_or_error.value()->FindSymbolIndexByAddress(0x1000), std::nullopt);
+}
+
+TEST_F(PreprocessedSymbolsFileTest, OpenFailsForDifferentModule) {
+  ASSERT_THAT(PreprocessedSymbolsFile::Write(file_path(), kBuildId, kSourceId, kLoadBias,
+                                             module_symbols_),
+              HasNoError());
+
+  EXPECT_THAT(
+      PreprocessedSymbolsFile::Open(file_path(), "fedcba9876543210", kSourceId, kLoadBias),
+      HasError("has build id"));
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, "/path/to/module:1234:5678",
+                                            kLoadBias),
+              HasError("was created from"));
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, 0),
+              HasError("has load bias"));
+}
+
+TEST_F(PreprocessedSymbolsFileTest, OpenFailsForInvalidFiles) {
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias),
+              HasError("Unable to open"));
+
+  {
+    auto fd_or_error = orbit_base::OpenFileForWriting(file_path());
+    ASSERT_THAT(fd_or_error, HasNoError());
+    ASSERT_THAT(orbit_base::WriteFully(fd_or_error.value(),
+                                       "This is some text, but not preprocessed symbols."),
+                HasNoError());
+  }
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias),
+              HasError("is not a preprocessed symbols file"));
+
+  ASSERT_THAT(PreprocessedSymbolsFile::Write(file_path(), kBuildId, kSourceId, kLoadBias,
+                                             module_symbols_),
+              HasNoError());
+  ErrorMessageOr<uint64_t> file_size_or_error = orbit_base::FileSize(file_path());
+  ASSERT_THAT(file_size_or_error, HasNoError());
+  ASSERT_THAT(orbit_base::ResizeFile(file_path(), file_size_or_error.value() - 1), HasNoError());
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias),
+              HasError("has an unexpected size"));
+  ASSERT_THAT(orbit_base::ResizeFile(file_path(), 64), HasNoError());
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias),
+              HasError("is truncated"));
+}
+
+TEST_F(PreprocessedSymbolsFileTest, ConcurrentWritesOfTheSameFile) {
+  constexpr int kThreadCount = 8;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([this] {
+      EXPECT_THAT(PreprocessedSymbolsFile::Write(file_path(), kBuildId, kSourceId, kLoadBias,
+                                                 module_symbols_),
+                  HasNoError());
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  EXPECT_THAT(PreprocessedSymbolsFile::Open(file_path(), kBuildId, kSourceId, kLoadBias),
+              HasNoError());
+  // No temporary file is left behind.
+  const std::string temporary_file_prefix = file_path().filename().string() + ".";
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(file_path().parent_path())) {
+    EXPECT_FALSE(absl::StartsWith(entry.path().filename().string(), temporary_file_prefix))
+        << entry.path();
+  }
+}
+
+}  // namespace orbit_symbols
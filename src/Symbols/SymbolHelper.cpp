@@ -10,6 +10,7 @@
 #include <absl/strings/str_format.h>
 #include <absl/strings/str_replace.h>
 #include <absl/strings/str_split.h>
+#include <absl/time/time.h>
 #include <absl/types/span.h>
 #include <llvm/Object/Binary.h>
 #include <llvm/Object/ObjectFile.h>
@@ -37,6 +38,7 @@
 #include "SymbolProvider/StructuredDebugDirectorySymbolProvider.h"
 #include "SymbolProvider/SymbolLoadingOutcome.h"
 #include "SymbolProvider/SymbolProvider.h"
+#include "Symbols/PreprocessedSymbolsFile.h"
 #include "Symbols/SymbolUtils.h"
 
 using orbit_grpc_protos::ModuleSymbols;
@@ -57,6 +59,9 @@ constexpr const char* kDeprecationNote =
     "use: Menu > Settings > Symbol Locations...\n// This file can still used by Orbit versions "
     "prior to 1.68. If that is relevant to you, do not delete this file.\n";
 
+constexpr const char* kPreprocessedSymbolsDirectoryName = "preprocessed_symbols";
+constexpr const char* kPreprocessedSymbolsFileExtension = ".symbols";
+
 namespace orbit_symbols {
 
 std::vector<fs::path> ReadSymbolsFile(const fs::path& file_name) {
@@ -301,6 +306,99 @@ fs::path SymbolHelper::GenerateCachedFilePath(const fs::path& file_path) const {
   return cache_directory_ / file_name;
 }
 
+fs::path SymbolHelper::GeneratePreprocessedSymbolsFilePath(std::string_view build_id) const {
+  return cache_directory_ / kPreprocessedSymbolsDirectoryName /
+         absl::StrCat(build_id, kPreprocessedSymbolsFileExtension);
+}
+
+ErrorMessageOr<std::string> SymbolHelper::GetPreprocessedSymbolsSourceId(
+    const fs::path& symbols_path) {
+  OUTCOME_TRY(const uint64_t file_size, orbit_base::FileSize(symbols_path));
+  // Not orbit_base::GetFileDateModified, which only has a precision of seconds.
+  std::error_code error;
+  const fs::file_time_type last_write_time = fs::last_write_time(symbols_path, error);
+  if (error) {
+    return ErrorMessage{absl::StrFormat("Unable to get the last write time of \"%s\": %s",
+                                        symbols_path.string(), error.message())};
+  }
+  return absl::StrFormat("%s:%u:%d", symbols_path.string(), file_size,
+                         last_write_time.time_since_epoch().count());
+}
+
+ErrorMessageOr<ModuleSymbols> SymbolHelper::LoadPreprocessedSymbolsFromCache(
+    std::string_view build_id, std::string_view source_id, uint64_t load_bias) const {
+  ORBIT_SCOPE_FUNCTION;
+  if (build_id.empty()) {
+    return ErrorMessage{"Preprocessed symbols are only cached for modules with a build id"};
+  }
+  fs::path file_path = GeneratePreprocessedSymbolsFilePath(build_id);
+  OUTCOME_TRY(const bool exists, orbit_base::FileOrDirectoryExists(file_path));
+  if (!exists) {
+    return ErrorMessage{
+        absl::StrFormat("No preprocessed symbols in cache for build id \"%s\"", build_id)};
+  }
+  ORBIT_SCOPED_TIMED_LOG("LoadPreprocessedSymbolsFromCache: %s", file_path.string());
+  OUTCOME_TRY(auto preprocessed_symbols_file,
+              PreprocessedSymbolsFile::Open(file_path, build_id, source_id, load_bias));
+  // The modification time orders the entries for eviction, so it is updated on every use.
+  std::error_code error;
+  fs::last_write_time(file_path, fs::file_time_type::clock::now(), error);
+  if (error) {
+    ORBIT_ERROR("Unable to update the modification time of \"%s\": %s", file_path.string(),
+                error.message());
+  }
+  return preprocessed_symbols_file->ToModuleSymbols();
+}
+
+ErrorMessageOr<void> SymbolHelper::SavePreprocessedSymbolsToCache(
+    std::string_view build_id, std::string_view source_id, uint64_t load_bias,
+    const ModuleSymbols& module_symbols) const {
+  ORBIT_SCOPE_FUNCTION;
+  if (build_id.empty()) {
+    return ErrorMessage{"Preprocessed symbols are only cached for modules with a build id"};
+  }
+  fs::path file_path = GeneratePreprocessedSymbolsFilePath(build_id);
+  OUTCOME_TRY(orbit_base::CreateDirectories(file_path.parent_path()));
+  OUTCOME_TRY(
+      PreprocessedSymbolsFile::Write(file_path, build_id, source_id, load_bias, module_symbols));
+  return TrimPreprocessedSymbolsCache(kMaxPreprocessedSymbolsCacheSize);
+}
+
+ErrorMessageOr<void> SymbolHelper::TrimPreprocessedSymbolsCache(uint64_t max_size) const {
+  ORBIT_SCOPE_FUNCTION;
+  const fs::path directory = cache_directory_ / kPreprocessedSymbolsDirectoryName;
+  OUTCOME_TRY(const bool exists, orbit_base::FileOrDirectoryExists(directory));
+  if (!exists) return outcome::success();
+
+  struct CachedFile {
+    fs::path path;
+    uint64_t size;
+    absl::Time last_used;
+  };
+  std::vector<CachedFile> cached_files;
+  uint64_t total_size = 0;
+  OUTCOME_TRY(const std::vector<fs::path> file_paths,
+              orbit_base::ListFilesInDirectory(directory));
+  for (const fs::path& file_path : file_paths) {
+    OUTCOME_TRY(const uint64_t size, orbit_base::FileSize(file_path));
+    OUTCOME_TRY(const absl::Time last_used, orbit_base::GetFileDateModified(file_path));
+    cached_files.push_back({file_path, size, last_used});
+    total_size += size;
+  }
+  if (total_size <= max_size) return outcome::success();
+
+  std::sort(cached_files.begin(), cached_files.end(),
+            [](const CachedFile& lhs, const CachedFile& rhs) {
+              return lhs.last_used < rhs.last_used;
+            });
+  for (const CachedFile& cached_file : cached_files) {
+    if (total_size <= max_size) break;
+    OUTCOME_TRY(orbit_base::RemoveFile(cached_file.path));
+    total_size -= cached_file.size;
+  }
+  return outcome::success();
+}
+
 ErrorMessageOr<ModuleSymbols> SymbolHelper::LoadSymbolsFromFile(
     const fs::path& file_path, const ObjectFileInfo& object_file_info) {
   ORBIT_SCOPE_FUNCTION;
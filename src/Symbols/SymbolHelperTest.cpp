@@ -6,10 +6,13 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <system_error>
 
 #include "GrpcProtos/module.pb.h"
 #include "GrpcProtos/symbol.pb.h"
@@ -491,6 +494,106 @@ TEST(SymbolHelper, GenerateCachedFilePath) {
   EXPECT_EQ(symbol_helper.GenerateCachedFilePath(file_path), cache_file_path);
 }
 
+TEST(SymbolHelper, SaveAndLoadPreprocessedSymbols) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  // Only used to get a unique name for the cache directory.
+  temporary_file_or_error.value().CloseAndRemove();
+  const fs::path cache_directory = temporary_file_or_error.value().file_path();
+  SymbolHelper symbol_helper{cache_directory, {}};
+
+  const fs::path file_path = orbit_test::GetTestdataDir() / "no_symbols_elf.debug";
+  const auto symbols_or_error =
+      SymbolHelper::LoadSymbolsFromFile(file_path, ObjectFileInfo{0x10000});
+  ASSERT_THAT(symbols_or_error, HasValue());
+  const ModuleSymbols& symbols = symbols_or_error.value();
+  const auto source_id_or_error = SymbolHelper::GetPreprocessedSymbolsSourceId(file_path);
+  ASSERT_THAT(source_id_or_error, HasValue());
+  const std::string& source_id = source_id_or_error.value();
+  EXPECT_THAT(source_id, testing::StartsWith(file_path.string()));
+
+  constexpr const char* kBuildId = "b5413574bbacec6eacb3b89b1012d0e2cd92ec6b";
+  EXPECT_THAT(symbol_helper.LoadPreprocessedSymbolsFromCache(kBuildId, source_id, 0x10000),
+              HasError("No preprocessed symbols in cache"));
+  EXPECT_THAT(symbol_helper.SavePreprocessedSymbolsToCache("", source_id, 0x10000, symbols),
+              HasError("only cached for modules with a build id"));
+
+  ASSERT_THAT(symbol_helper.SavePreprocessedSymbolsToCache(kBuildId, source_id, 0x10000, symbols),
+              HasNoError());
+  EXPECT_EQ(symbol_helper.GeneratePreprocessedSymbolsFilePath(kBuildId).parent_path().parent_path(),
+            cache_directory);
+
+  const auto cached_symbols_or_error =
+      symbol_helper.LoadPreprocessedSymbolsFromCache(kBuildId, source_id, 0x10000);
+  ASSERT_THAT(cached_symbols_or_error, HasValue());
+  const ModuleSymbols& cached_symbols = cached_symbols_or_error.value();
+  ASSERT_EQ(cached_symbols.symbol_infos_size(), symbols.symbol_infos_size());
+  // Both contain the same symbols, the cached ones are sorted by address.
+  for (const orbit_grpc_protos::SymbolInfo& symbol_info : symbols.symbol_infos()) {
+    EXPECT_TRUE(std::any_of(
+        cached_symbols.symbol_infos().begin(), cached_symbols.symbol_infos().end(),
+        [&symbol_info](const orbit_grpc_protos::SymbolInfo& cached_symbol_info) {
+          return cached_symbol_info.address() == symbol_info.address() &&
+                 cached_symbol_info.size() == symbol_info.size() &&
+                 cached_symbol_info.demangled_name() == symbol_info.demangled_name();
+        }));
+  }
+
+  EXPECT_THAT(symbol_helper.LoadPreprocessedSymbolsFromCache(kBuildId, source_id, 0x20000),
+              HasError("has load bias"));
+  // The symbols of the same module loaded from another file are not taken from the cache.
+  const auto other_source_id_or_error = SymbolHelper::GetPreprocessedSymbolsSourceId(
+      orbit_test::GetTestdataDir() / "debugstore" / ".build-id" / "b5" /
+      "413574bbacec6eacb3b89b1012d0e2cd92ec6b.debug");
+  ASSERT_THAT(other_source_id_or_error, HasValue());
+  EXPECT_THAT(symbol_helper.LoadPreprocessedSymbolsFromCache(
+                  kBuildId, other_source_id_or_error.value(), 0x10000),
+              HasError("was created from"));
+
+  std::error_code error;
+  fs::remove_all(cache_directory, error);
+}
+
+TEST(SymbolHelper, TrimPreprocessedSymbolsCache) {
+  auto temporary_file_or_error = orbit_base::TemporaryFile::Create();
+  ASSERT_THAT(temporary_file_or_error, HasNoError());
+  temporary_file_or_error.value().CloseAndRemove();
+  const fs::path cache_directory = temporary_file_or_error.value().file_path();
+  SymbolHelper symbol_helper{cache_directory, {}};
+  EXPECT_THAT(symbol_helper.TrimPreprocessedSymbolsCache(0), HasNoError());
+
+  const auto symbols_or_error = SymbolHelper::LoadSymbolsFromFile(
+      orbit_test::GetTestdataDir() / "no_symbols_elf.debug", ObjectFileInfo{0x10000});
+  ASSERT_THAT(symbols_or_error, HasValue());
+  ASSERT_THAT(symbol_helper.SavePreprocessedSymbolsToCache("old", "source", 0x10000,
+                                                           symbols_or_error.value()),
+              HasNoError());
+  ASSERT_THAT(symbol_helper.SavePreprocessedSymbolsToCache("new", "source", 0x10000,
+                                                           symbols_or_error.value()),
+              HasNoError());
+  const fs::path old_file_path = symbol_helper.GeneratePreprocessedSymbolsFilePath("old");
+  const fs::path new_file_path = symbol_helper.GeneratePreprocessedSymbolsFilePath("new");
+  std::error_code error;
+  fs::last_write_time(old_file_path, fs::last_write_time(new_file_path) - std::chrono::hours(1),
+                      error);
+  ASSERT_FALSE(error);
+  const auto file_size_or_error = orbit_base::FileSize(new_file_path);
+  ASSERT_THAT(file_size_or_error, HasValue());
+
+  // The least recently used file is removed first.
+  EXPECT_THAT(symbol_helper.TrimPreprocessedSymbolsCache(file_size_or_error.value()),
+              HasNoError());
+  EXPECT_FALSE(fs::exists(old_file_path));
+  EXPECT_TRUE(fs::exists(new_file_path));
+  EXPECT_THAT(symbol_helper.LoadPreprocessedSymbolsFromCache("new", "source", 0x10000),
+              HasValue());
+
+  EXPECT_THAT(symbol_helper.TrimPreprocessedSymbolsCache(0), HasNoError());
+  EXPECT_FALSE(fs::exists(new_file_path));
+
+  fs::remove_all(cache_directory, error);
+}
+
 TEST(SymbolHelper, FindDebugInfoFileLocally) {
   const std::filesystem::path testdata_directory = orbit_test::GetTestdataDir();
   SymbolHelper symbol_helper("", {});
@@ -0,0 +1,82 @@
+// Copyright (c) 2022 The Orbit Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SYMBOLS_PREPROCESSED_SYMBOLS_FILE_H_
+#define SYMBOLS_PREPROCESSED_SYMBOLS_FILE_H_
+
+#include <llvm/Support/MemoryBuffer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "GrpcProtos/symbol.pb.h"
+#include "OrbitBase/Result.h"
+
+namespace orbit_symbols {
+
+// Compact binary representation of the symbols of a module, as produced by parsing its debug
+// information, that can be used instead of parsing the debug information again.
+//
+// The file consists of a header, the build id of the module, the identifier of the file the symbols
+// were read from, a table of fixed-size entries (address, size, name offset, name size) sorted by
+// address, and a blob with all the names. It is
+// memory mapped when opened, and only the header is validated eagerly, so opening it takes
+// constant time regardless of the number of symbols.
+class PreprocessedSymbolsFile {
+ public:
+  struct Symbol {
+    uint64_t address;
+    uint64_t size;
+    std::string_view demangled_name;
+  };
+
+  // Writes `module_symbols` to `file_path`. The file is written to a temporary file first and then
+  // renamed, so that a concurrent or interrupted write never leaves a truncated file behind.
+  // `source_id` identifies the file the symbols were read from, see SymbolHelper.
+  static ErrorMessageOr<void> Write(const std::filesystem::path& file_path,
+                                    std::string_view build_id, std::string_view source_id,
+                                    uint64_t load_bias,
+                                    const orbit_grpc_protos::ModuleSymbols& module_symbols);
+
+  // Fails if the file is not a valid preprocessed symbols file, or if it was created for a module
+  // with a different build id or load bias, or from a different source.
+  static ErrorMessageOr<std::unique_ptr<PreprocessedSymbolsFile>> Open(
+      const std::filesystem::path& file_path, std::string_view expected_build_id,
+      std::string_view expected_source_id, uint64_t expected_load_bias);
+
+  [[nodiscard]] size_t GetSymbolCount() const { return symbol_count_; }
+  // Fails if the entry refers to a name outside of the name blob, which can only happen if the
+  // file is corrupted.
+  [[nodiscard]] ErrorMessageOr<Symbol> GetSymbol(size_t index) const;
+  // Returns the index of the symbol whose range [address, address + size) contains
+  // `virtual_address`, if any. With several such symbols, the one with the largest address wins.
+  [[nodiscard]] std::optional<size_t> FindSymbolIndexByAddress(uint64_t virtual_address) const;
+
+  // Converts back to the representation obtained from parsing the debug information, with the
+  // symbols ordered by address.
+  [[nodiscard]] ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> ToModuleSymbols() const;
+
+ private:
+  struct Entry;
+
+  PreprocessedSymbolsFile(std::unique_ptr<llvm::MemoryBuffer> buffer, const Entry* entries,
+                          size_t symbol_count, std::string_view names)
+      : buffer_{std::move(buffer)},
+        entries_{entries},
+        symbol_count_{symbol_count},
+        names_{names} {}
+
+  std::unique_ptr<llvm::MemoryBuffer> buffer_;
+  const Entry* entries_;
+  size_t symbol_count_;
+  std::string_view names_;
+};
+
+}  // namespace orbit_symbols
+
+#endif  // SYMBOLS_PREPROCESSED_SYMBOLS_FILE_H_
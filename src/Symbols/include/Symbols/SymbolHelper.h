@@ -45,6 +45,26 @@ class SymbolHelper : public SymbolCacheInterface {
   [[nodiscard]] std::filesystem::path GenerateCachedFilePath(
       const std::filesystem::path& file_path) const override;
 
+  // Symbols loaded from debug information can be stored in the cache directory as a
+  // PreprocessedSymbolsFile, keyed by build id, so that they don't need to be parsed again. Each
+  // entry also records the source it was created from, and is only used for the same source, so
+  // that loading symbols from another file (e.g. a full debug file instead of a stripped binary)
+  // reads that file. When the preprocessed symbols exceed `kMaxPreprocessedSymbolsCacheSize`, the
+  // least recently used ones are removed.
+  static constexpr uint64_t kMaxPreprocessedSymbolsCacheSize = 512ULL * 1024 * 1024;
+  [[nodiscard]] std::filesystem::path GeneratePreprocessedSymbolsFilePath(
+      std::string_view build_id) const;
+  // Identifies a local symbols file by its path, size and modification time.
+  [[nodiscard]] static ErrorMessageOr<std::string> GetPreprocessedSymbolsSourceId(
+      const std::filesystem::path& symbols_path);
+  [[nodiscard]] ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> LoadPreprocessedSymbolsFromCache(
+      std::string_view build_id, std::string_view source_id, uint64_t load_bias) const;
+  [[nodiscard]] ErrorMessageOr<void> SavePreprocessedSymbolsToCache(
+      std::string_view build_id, std::string_view source_id, uint64_t load_bias,
+      const orbit_grpc_protos::ModuleSymbols& module_symbols) const;
+  // Removes the least recently used preprocessed symbols until they take at most `max_size` bytes.
+  ErrorMessageOr<void> TrimPreprocessedSymbolsCache(uint64_t max_size) const;
+
   static ErrorMessageOr<orbit_grpc_protos::ModuleSymbols> LoadSymbolsFromFile(
       const std::filesystem::path& file_path,
       const orbit_object_utils::ObjectFileInfo& object_file_info);